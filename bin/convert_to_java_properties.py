@@ -38,7 +38,16 @@ nameMap = {
     'SCSOLVER_STR_OPTION_VAR_POSITIVE': 'OptionDialog.cbPositiveValue.Label',
     'SCSOLVER_STR_OPTION_VAR_INTEGER': 'OptionDialog.cbIntegerValue.Label',
     'SCSOLVER_STR_TARGET_NOT_SET': 'Common.TargetNotSet.Label',
-    'SCSOLVER_STR_DECISIONVAR_NOT_SET': 'Common.DecisionNotSet.Label'
+    'SCSOLVER_STR_DECISIONVAR_NOT_SET': 'Common.DecisionNotSet.Label',
+    'SCSOLVER_STR_OPTION_BUILTIN_ENGINE': 'OptionDialog.rbBuiltinEngine.Label',
+    'SCSOLVER_STR_BTN_STOP': 'SolverDialog.btnStop.Label',
+    'SCSOLVER_STR_MSG_SOLVE_CANCELLED': 'Common.SolveCancelled.Label',
+    'SCSOLVER_STR_PROGRESS_ITERATION': 'SolverDialog.ftProgressIteration.Label',
+    'SCSOLVER_STR_PROGRESS_NODE': 'SolverDialog.ftProgressNode.Label',
+    'SCSOLVER_STR_PROGRESS_OBJECTIVE': 'SolverDialog.ftProgressObjective.Label',
+    'SCSOLVER_STR_PROGRESS_GAP': 'SolverDialog.ftProgressGap.Label',
+    'SCSOLVER_STR_OPTION_PORTFOLIO': 'OptionDialog.rbPortfolio.Label',
+    'SCSOLVER_STR_OPTION_DEFAULT_ENGINE': 'OptionDialog.rbDefaultEngine.Label'
 }
 
 def warn (msg):
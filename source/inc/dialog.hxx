@@ -173,6 +173,18 @@ public:
 
     void enableAllWidgets(bool enable);
 
+    /**
+     * Switch the dialog into the state of a running solve, in which only
+     * the solve button, labelled "Stop", and the progress text stay
+     * enabled, or back to the normal state.
+     */
+    void setSolveRunning(bool bRunning);
+
+    /**
+     * Show the progress of the running solve below the buttons.
+     */
+    void showProgress(const rtl::OUString& sProgress);
+
 protected:
     
     virtual void registerListeners();
@@ -0,0 +1,190 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef _SCSOLVER_NUMERIC_DECOMPOSITION_HXX_
+#define _SCSOLVER_NUMERIC_DECOMPOSITION_HXX_
+
+#include <vector>
+#include <cstddef>
+
+namespace scsolver { namespace numeric {
+
+class Matrix;
+
+/**
+ * Cholesky factorization A = L L^T of a symmetric positive definite
+ * matrix.  Only the lower triangle of A is referenced.  The factorization
+ * is computed in place, in column-major storage, one block of columns at a
+ * time, so the trailing update runs over contiguous memory.
+ *
+ * Use this instead of Matrix::inverse() to solve symmetric positive
+ * definite systems; it needs about half the work of an LU factorization
+ * and no pivoting.
+ */
+class CholeskyDecomposition
+{
+public:
+    /** number of columns factorized per block. */
+    static const size_t BLOCK_SIZE = 32;
+
+    CholeskyDecomposition();
+
+    /**
+     * Factorize a matrix upon construction.  See factorize().
+     */
+    explicit CholeskyDecomposition(const Matrix& mxA);
+    ~CholeskyDecomposition() throw();
+
+    /**
+     * Factorize a square matrix.  It throws NonSquareMatrix if the matrix is
+     * not square, and MatrixNotPositiveDefinite if a non-positive pivot is
+     * encountered.
+     *
+     * @param mxA symmetric positive definite matrix
+     */
+    void factorize(const Matrix& mxA);
+
+    /**
+     * Solve A X = B, overwriting B with X.  B may have more than one
+     * column.
+     *
+     * @param mxB (reference) right hand side on input, solution on output
+     */
+    void solveInPlace(Matrix& mxB) const;
+
+    /**
+     * Solve A X = B.
+     *
+     * @param mxB right hand side
+     *
+     * @return solution X
+     */
+    const Matrix solve(const Matrix& mxB) const;
+
+    /**
+     * @return double determinant of the original matrix
+     */
+    double det() const;
+
+    /**
+     * @return Matrix lower triangular factor L
+     */
+    const Matrix getL() const;
+
+    /**
+     * @return size_t row (or column) size of the factorized matrix
+     */
+    size_t size() const;
+
+private:
+    double& at(size_t row, size_t col) { return m_aData[col*m_nSize + row]; }
+    double at(size_t row, size_t col) const { return m_aData[col*m_nSize + row]; }
+
+    void factorizePanel(size_t nColStart, size_t nColEnd);
+    void updateTrailing(size_t nColStart, size_t nColEnd);
+
+    /** lower triangular factor in column-major order. */
+    ::std::vector<double> m_aData;
+    size_t m_nSize;
+};
+
+/**
+ * Householder QR factorization A = Q R of an m x n matrix with m >= n.
+ * The factorization is computed in place: R occupies the upper triangle and
+ * the Householder vectors are stored below the diagonal.  Reflectors are
+ * generated one panel of columns at a time, and each panel is accumulated
+ * into a block reflector I - V T V^T (compact WY form) that updates the
+ * trailing columns.
+ *
+ * solve() returns the least squares solution when m > n.
+ */
+class QRDecomposition
+{
+public:
+    /** number of columns factorized per block. */
+    static const size_t BLOCK_SIZE = 32;
+
+    QRDecomposition();
+
+    /**
+     * Factorize a matrix upon construction.  See factorize().
+     */
+    explicit QRDecomposition(const Matrix& mxA);
+    ~QRDecomposition() throw();
+
+    /**
+     * Factorize a matrix.  It throws MatrixSizeMismatch if the matrix has
+     * fewer rows than columns.
+     *
+     * @param mxA matrix to factorize
+     */
+    void factorize(const Matrix& mxA);
+
+    /**
+     * Solve min || A X - B || for X.  This is the exact solution when A is
+     * square.  B may have more than one column.  It throws SingularMatrix
+     * if A does not have full column rank.
+     *
+     * @param mxB right hand side whose row size equals that of A
+     *
+     * @return solution X
+     */
+    const Matrix solve(const Matrix& mxB) const;
+
+    /**
+     * Overwrite B with Q^T B.
+     *
+     * @param mxB (reference) matrix whose row size equals that of A
+     */
+    void applyQTrans(Matrix& mxB) const;
+
+    /**
+     * @return Matrix the first n columns of the orthogonal factor Q (m x n)
+     */
+    const Matrix getQ() const;
+
+    /**
+     * @return Matrix the upper triangular factor R (n x n)
+     */
+    const Matrix getR() const;
+
+    size_t rows() const;
+    size_t cols() const;
+
+private:
+    double& at(size_t row, size_t col) { return m_aData[col*m_nRows + row]; }
+    double at(size_t row, size_t col) const { return m_aData[col*m_nRows + row]; }
+
+    void makeReflector(size_t nCol);
+    void applyReflector(size_t nRefl, double* pCol) const;
+    void makeBlockFactor(size_t nColStart, size_t nColEnd, ::std::vector<double>& aT) const;
+    void applyBlockReflector(size_t nColStart, size_t nColEnd, const ::std::vector<double>& aT,
+                             double* pCol, ::std::vector<double>& aWork) const;
+
+    /** R and Householder vectors in column-major order. */
+    ::std::vector<double> m_aData;
+
+    /** scaling factors of the Householder reflectors. */
+    ::std::vector<double> m_aTau;
+
+    size_t m_nRows;
+    size_t m_nCols;
+};
+
+}}
+
+#endif
@@ -76,6 +76,13 @@ public:
     virtual const char* what() const throw() { return "Iteration timed out"; }
 };
 
+/// Exception for a solve stopped on request, see SolveControl::cancel().
+class SolveCancelled : public ::std::exception
+{
+public:
+    virtual const char* what() const throw() { return "Solve cancelled"; }
+};
+
 /// Exception for request of a non-existing boundary value.
 /**
  * This exception is thrown when the caller attempts to retrieve a boundary
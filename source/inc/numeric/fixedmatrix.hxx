@@ -0,0 +1,354 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef _SCSOLVER_NUMERIC_FIXEDMATRIX_HXX_
+#define _SCSOLVER_NUMERIC_FIXEDMATRIX_HXX_
+
+#include "numeric/matrix.hxx"
+
+#include <boost/static_assert.hpp>
+
+#include <cmath>
+#include <cstddef>
+
+namespace scsolver { namespace numeric {
+
+template<size_t R, size_t C> class FixedMatrix;
+
+namespace fixedmx {
+
+/**
+ * Determinant of a square matrix stored in row-major order.  The
+ * specializations for 1x1, 2x2 and 3x3 matrices use the closed-form
+ * expressions; larger matrices go through Gaussian elimination on a local
+ * copy.
+ */
+template<size_t N>
+struct Determinant
+{
+    static double get(const double* p)
+    {
+        double a[N*N];
+        for (size_t i = 0; i < N*N; ++i)
+            a[i] = p[i];
+
+        double fDet = 1.0;
+        for (size_t k = 0; k < N; ++k)
+        {
+            size_t nPivot = k;
+            for (size_t i = k + 1; i < N; ++i)
+                if (::std::fabs(a[i*N+k]) > ::std::fabs(a[nPivot*N+k]))
+                    nPivot = i;
+
+            if (a[nPivot*N+k] == 0.0)
+                return 0.0;
+
+            if (nPivot != k)
+            {
+                for (size_t j = 0; j < N; ++j)
+                {
+                    double f = a[k*N+j];
+                    a[k*N+j] = a[nPivot*N+j];
+                    a[nPivot*N+j] = f;
+                }
+                fDet = -fDet;
+            }
+
+            fDet *= a[k*N+k];
+            for (size_t i = k + 1; i < N; ++i)
+            {
+                double fFactor = a[i*N+k] / a[k*N+k];
+                for (size_t j = k + 1; j < N; ++j)
+                    a[i*N+j] -= fFactor*a[k*N+j];
+            }
+        }
+        return fDet;
+    }
+};
+
+template<>
+struct Determinant<1>
+{
+    static double get(const double* p)
+    {
+        return p[0];
+    }
+};
+
+template<>
+struct Determinant<2>
+{
+    static double get(const double* p)
+    {
+        return p[0]*p[3] - p[1]*p[2];
+    }
+};
+
+template<>
+struct Determinant<3>
+{
+    static double get(const double* p)
+    {
+        return p[0]*p[4]*p[8] - p[0]*p[5]*p[7] -
+            p[3]*p[1]*p[8] + p[3]*p[2]*p[7] +
+            p[6]*p[1]*p[5] - p[6]*p[2]*p[4];
+    }
+};
+
+}
+
+/**
+ * Matrix whose dimension is fixed at compile time.  The elements are stored
+ * on the stack, so none of its operations allocate memory.  Use this in
+ * place of Matrix for small systems whose size is known in advance, e.g.
+ * the 3x3 Vandermonde system of a quadratic fit.  All loops have
+ * compile-time bounds, which lets the compiler unroll them.
+ */
+template<size_t R, size_t C>
+class FixedMatrix
+{
+public:
+    /**
+     * Construct a zero matrix, or an identity matrix if the matrix is square
+     * and identity_matrix is true.
+     */
+    explicit FixedMatrix(bool identity_matrix = false)
+    {
+        for (size_t i = 0; i < R; ++i)
+            for (size_t j = 0; j < C; ++j)
+                m_aArray[i][j] = (identity_matrix && i == j) ? 1.0 : 0.0;
+    }
+
+    /**
+     * Construct from a dynamically-sized matrix.  The dimension of the
+     * source matrix must match.
+     */
+    explicit FixedMatrix(const Matrix& mx)
+    {
+        if (mx.rows() != R || mx.cols() != C)
+            throw MatrixSizeMismatch();
+
+        for (size_t i = 0; i < R; ++i)
+            for (size_t j = 0; j < C; ++j)
+                m_aArray[i][j] = mx(i, j);
+    }
+
+    size_t rows() const { return R; }
+    size_t cols() const { return C; }
+
+    double operator()(size_t row, size_t col) const
+    {
+        return m_aArray[row][col];
+    }
+
+    double& operator()(size_t row, size_t col)
+    {
+        return m_aArray[row][col];
+    }
+
+    const double* data() const { return &m_aArray[0][0]; }
+
+    /**
+     * Copy the content into a dynamically-sized matrix.
+     */
+    void toMatrix(Matrix& mx) const
+    {
+        mx.resize(R, C);
+        for (size_t i = 0; i < R; ++i)
+            for (size_t j = 0; j < C; ++j)
+                mx(i, j) = m_aArray[i][j];
+    }
+
+    Matrix toMatrix() const
+    {
+        Matrix mx(R, C);
+        toMatrix(mx);
+        return mx;
+    }
+
+    void print(size_t prec = 2, size_t colspace = 1) const
+    {
+        toMatrix().print(prec, colspace);
+    }
+
+    const FixedMatrix<C, R> trans() const
+    {
+        FixedMatrix<C, R> mx;
+        for (size_t i = 0; i < R; ++i)
+            for (size_t j = 0; j < C; ++j)
+                mx(j, i) = m_aArray[i][j];
+        return mx;
+    }
+
+    /**
+     * Calculate the determinant.  This is only defined for square
+     * matrices.
+     */
+    double det() const
+    {
+        BOOST_STATIC_ASSERT(R == C);
+        return fixedmx::Determinant<R>::get(data());
+    }
+
+    /**
+     * Solve A x = b via Gaussian elimination with partial pivoting, where
+     * A is this matrix.  This is only defined for square matrices.
+     *
+     * @param b right hand side vector
+     *
+     * @return solution vector x
+     */
+    const FixedMatrix<R, 1> solve(const FixedMatrix<R, 1>& b) const
+    {
+        BOOST_STATIC_ASSERT(R == C);
+
+        FixedMatrix<R, C> A(*this);
+        FixedMatrix<R, 1> x(b);
+        for (size_t k = 0; k < R; ++k)
+        {
+            size_t nPivot = k;
+            for (size_t i = k + 1; i < R; ++i)
+                if (::std::fabs(A(i, k)) > ::std::fabs(A(nPivot, k)))
+                    nPivot = i;
+
+            if (A(nPivot, k) == 0.0)
+                throw SingularMatrix();
+
+            if (nPivot != k)
+            {
+                for (size_t j = k; j < C; ++j)
+                {
+                    double f = A(k, j);
+                    A(k, j) = A(nPivot, j);
+                    A(nPivot, j) = f;
+                }
+                double f = x(k, 0);
+                x(k, 0) = x(nPivot, 0);
+                x(nPivot, 0) = f;
+            }
+
+            for (size_t i = k + 1; i < R; ++i)
+            {
+                double fFactor = A(i, k) / A(k, k);
+                for (size_t j = k + 1; j < C; ++j)
+                    A(i, j) -= fFactor*A(k, j);
+                x(i, 0) -= fFactor*x(k, 0);
+            }
+        }
+
+        // back substitution
+        size_t i = R;
+        do
+        {
+            --i;
+            double fSum = x(i, 0);
+            for (size_t j = i + 1; j < C; ++j)
+                fSum -= A(i, j)*x(j, 0);
+            x(i, 0) = fSum / A(i, i);
+        }
+        while (i != 0);
+
+        return x;
+    }
+
+    FixedMatrix& operator+=(const FixedMatrix& r)
+    {
+        for (size_t i = 0; i < R; ++i)
+            for (size_t j = 0; j < C; ++j)
+                m_aArray[i][j] += r.m_aArray[i][j];
+        return *this;
+    }
+
+    FixedMatrix& operator-=(const FixedMatrix& r)
+    {
+        for (size_t i = 0; i < R; ++i)
+            for (size_t j = 0; j < C; ++j)
+                m_aArray[i][j] -= r.m_aArray[i][j];
+        return *this;
+    }
+
+    FixedMatrix& operator*=(double f)
+    {
+        for (size_t i = 0; i < R; ++i)
+            for (size_t j = 0; j < C; ++j)
+                m_aArray[i][j] *= f;
+        return *this;
+    }
+
+    const FixedMatrix operator+(const FixedMatrix& r) const
+    {
+        FixedMatrix mx(*this);
+        mx += r;
+        return mx;
+    }
+
+    const FixedMatrix operator-(const FixedMatrix& r) const
+    {
+        FixedMatrix mx(*this);
+        mx -= r;
+        return mx;
+    }
+
+    const FixedMatrix operator*(double f) const
+    {
+        FixedMatrix mx(*this);
+        mx *= f;
+        return mx;
+    }
+
+    template<size_t K>
+    const FixedMatrix<R, K> operator*(const FixedMatrix<C, K>& r) const
+    {
+        FixedMatrix<R, K> mx;
+        for (size_t i = 0; i < R; ++i)
+            for (size_t j = 0; j < K; ++j)
+            {
+                double fSum = 0.0;
+                for (size_t k = 0; k < C; ++k)
+                    fSum += m_aArray[i][k]*r(k, j);
+                mx(i, j) = fSum;
+            }
+        return mx;
+    }
+
+    bool operator==(const FixedMatrix& r) const
+    {
+        for (size_t i = 0; i < R; ++i)
+            for (size_t j = 0; j < C; ++j)
+                if (m_aArray[i][j] != r.m_aArray[i][j])
+                    return false;
+        return true;
+    }
+
+    bool operator!=(const FixedMatrix& r) const
+    {
+        return !operator==(r);
+    }
+
+private:
+    double m_aArray[R][C];
+};
+
+template<size_t R, size_t C>
+const FixedMatrix<R, C> operator*(double f, const FixedMatrix<R, C>& mx)
+{
+    return mx * f;
+}
+
+}}
+
+#endif
@@ -59,6 +59,13 @@ public:
     SingleVarFuncObj& getSingleVarFuncObj(size_t varIndex);
     /// Returns a functor to change in one specific direction.
     SingleVarFuncObj& getSingleVarFuncObjByRatio(const ::std::vector<double>& ratios);
+    /// Returns an independent copy, or an empty pointer if there is none.
+    /**
+     * A copy lets another thread evaluate the function at the same time.
+     * The default returns an empty pointer, for function objects that
+     * cannot be evaluated in parallel, e.g. ones that work on cells.
+     */
+    virtual ::std::auto_ptr<BaseFuncObj> clone() const;
 
 private:
     /// Pointer to the private implementation.
@@ -19,16 +19,64 @@
 #define _LPBASE_HXX_
 
 #include <memory>
+#include <vector>
+#include <cstddef>
 
 namespace scsolver { namespace numeric {
 
 class Matrix;
+class SolveControl;
 
 namespace lp {
 
 class Model;
 class BaseAlgorithmImpl;
 
+/**
+ * Status of a variable in a simplex basis.
+ */
+enum BasisStatus
+{
+	BASIS_BASIC,
+
+	/** non-basic at its lower bound, or at zero when it has no bound. */
+	BASIS_LOWER,
+
+	/** non-basic at its upper bound. */
+	BASIS_UPPER
+};
+
+/**
+ * Simplex basis of a model, which can be saved after one solve and used to
+ * start the next one.  It stores the status of each decision variable, and
+ * of each constraint row, the latter referring to the row activity a_i x
+ * treated as a variable bounded by the right hand side.  A row at its
+ * lower bound is therefore a tight >= (or =) constraint, and a row at its
+ * upper bound a tight <= constraint.  A basis is complete when the number
+ * of basic variables and rows equals the number of rows.
+ */
+class Basis
+{
+public:
+	Basis();
+	Basis( size_t nVarCount, size_t nRowCount );
+	~Basis() throw();
+
+	bool empty() const;
+	size_t getVarCount() const;
+	size_t getRowCount() const;
+
+	BasisStatus getVarStatus( size_t nVar ) const;
+	void setVarStatus( size_t nVar, BasisStatus eStatus );
+
+	BasisStatus getRowStatus( size_t nRow ) const;
+	void setRowStatus( size_t nRow, BasisStatus eStatus );
+
+private:
+	::std::vector<BasisStatus> m_aVarStatus;
+	::std::vector<BasisStatus> m_aRowStatus;
+};
+
 class BaseAlgorithm
 {
 public:
@@ -43,10 +91,67 @@ public:
 	::scsolver::numeric::Matrix getSolution() const;
 	void setSolution( const ::scsolver::numeric::Matrix& );
 
+	/**
+	 * Set the basis to start the next solve from.  Algorithms that do not
+	 * support warm starts ignore it, and so do the others when the basis
+	 * does not fit the model.  An empty basis (default) means a cold start.
+	 */
+	void setStartBasis( const Basis& );
+	const Basis getStartBasis() const;
+
+	/**
+	 * @return const Basis optimal basis found by the last solve, or an empty
+	 *         basis if the algorithm does not provide one.
+	 */
+	const Basis getBasis() const;
+	void setBasis( const Basis& );
+
+	/**
+	 * @return bool true if the solution of the last solve is proven
+	 *         optimal.  An algorithm that can return a solution without
+	 *         such a proof, e.g. when stopped by a limit, overrides this;
+	 *         the others end a solve either optimal or with an exception.
+	 */
+	virtual bool isOptimal() const;
+
+	/**
+	 * Set the limits and the cancel flag the algorithm honors.  The caller
+	 * keeps ownership, and must start() the control before each solve that
+	 * has a time limit.  NULL (default) means an own control without any
+	 * limit.
+	 */
+	void setSolveControl( SolveControl* p );
+	SolveControl* getSolveControl() const;
+
 private:
 	::std::auto_ptr<BaseAlgorithmImpl> m_pImpl;
 };
 
+/**
+ * Creates new instances of an algorithm, for drivers that solve several
+ * models at the same time and need an instance per thread.
+ */
+class AlgorithmFactory
+{
+public:
+	virtual ~AlgorithmFactory() throw() {}
+
+	virtual ::std::auto_ptr<BaseAlgorithm> create() const = 0;
+};
+
+/**
+ * Factory for an algorithm class that is default constructible.
+ */
+template<typename AlgorithmType>
+class DefaultAlgorithmFactory : public AlgorithmFactory
+{
+public:
+	virtual ::std::auto_ptr<BaseAlgorithm> create() const
+	{
+		return ::std::auto_ptr<BaseAlgorithm>( new AlgorithmType );
+	}
+};
+
 }}}
 
 #endif
@@ -0,0 +1,192 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef _SCSOLVER_LPBRANCHBOUND_HXX_
+#define _SCSOLVER_LPBRANCHBOUND_HXX_
+
+#include "lpbase.hxx"
+#include <memory>
+#include <cstddef>
+
+namespace scsolver { namespace numeric { namespace lp {
+
+class BranchAndBoundImpl;
+
+/**
+ * Order in which the open nodes of the search tree are solved.
+ */
+enum NodeSelection
+{
+	/** the node with the best bound, which solves the fewest nodes. */
+	NODESEL_BEST_BOUND,
+
+	/** the most recently created node, which finds incumbents early and
+		keeps few nodes open. */
+	NODESEL_DEPTH_FIRST,
+
+	/** depth first until the first incumbent is found, best bound after. */
+	NODESEL_HYBRID
+};
+
+/**
+ * How nodes are shared between threads when more than one is used.
+ */
+enum ParallelMode
+{
+	/** nodes are solved in rounds of one per thread, and the results are
+		processed in the order the nodes were selected, so that the search
+		and its solution do not depend on the timing of the threads. */
+	PARALLEL_DETERMINISTIC,
+
+	/** each thread keeps its own queue of nodes and takes nodes from the
+		others when it runs out, so that no thread waits for another.  The
+		optimal value is the same, but the node count and, among equally
+		good solutions, the one returned may vary from run to run. */
+	PARALLEL_OPPORTUNISTIC
+};
+
+/**
+ * Branch and bound for models whose variables are restricted to integer
+ * values.  The LP relaxation of each node is solved by the wrapped
+ * algorithm, and a node whose solution has fractional values is split in
+ * two by rounding the bound of one variable down in one child and up in
+ * the other.  Each child starts from the optimal basis of its parent, so
+ * with an algorithm that warm starts, such as DualSimplex, a node solve
+ * takes only a few pivots.
+ *
+ * The variable to branch on is chosen by pseudo-costs, the average
+ * objective degradation per unit of change observed when branching on it
+ * before; variables not branched on yet get the average of the others.
+ * Nodes whose bound is not better than the incumbent by at least the
+ * smallest possible improvement are cut off, which is one when all cost
+ * coefficients are integers.
+ *
+ * The nodes can be solved by several threads at once, which needs one
+ * instance of the node algorithm per thread.  The engine is then created
+ * with a factory rather than a single algorithm, e.g. a
+ * DefaultAlgorithmFactory of DualSimplex or LpSolve.  The incumbent and
+ * the pseudo-costs are shared by all threads.
+ *
+ * Before the search, the relaxation at the root is tightened with rounds
+ * of Gomory, MIR and cover cuts (see CutGenerator), which raise its bound
+ * and so let more nodes be cut off.  The cuts stay in the model of all
+ * nodes.
+ *
+ * Primal heuristics (see PrimalHeuristics) look for good incumbents early
+ * on: rounding, diving, the feasibility pump and RINS at the root, then
+ * rounding at every node and RINS every few nodes.  Each run is limited
+ * by the work limits of the heuristics, and in the opportunistic search
+ * also by a time budget.
+ *
+ * The solve control (see SolveControl) is passed on to the algorithms of
+ * all threads, so its iteration limit applies to each node.  The search
+ * also checks it between nodes, and stops like at the node limit when the
+ * time is up or the solve is cancelled.
+ *
+ * A model without integer restriction is solved as a plain LP.  It throws
+ * ModelInfeasible when the model has no integer solution, and
+ * MaxIterationReached when the node limit is reached before any integer
+ * solution has been found, or IterationTimedOut or SolveCancelled when the
+ * search is stopped before then.
+ */
+class BranchAndBound : public BaseAlgorithm
+{
+public:
+	/**
+	 * @param pAlgorithm algorithm that solves the node relaxations.  The
+	 *                   wrapper takes ownership of it.
+	 */
+	BranchAndBound( ::std::auto_ptr<BaseAlgorithm> pAlgorithm );
+
+	/**
+	 * @param pFactory factory that creates the algorithm of each thread.
+	 *                 The engine takes ownership of it.
+	 */
+	BranchAndBound( ::std::auto_ptr<AlgorithmFactory> pFactory );
+	virtual ~BranchAndBound() throw();
+
+	virtual void solve();
+
+	/**
+	 * @return BaseAlgorithm* algorithm that solves the nodes of the first
+	 *         thread.
+	 */
+	BaseAlgorithm* getAlgorithm() const;
+
+	void setNodeSelection( NodeSelection eSelection );
+	NodeSelection getNodeSelection() const;
+
+	/**
+	 * Set the maximum number of nodes to solve.  When the limit is reached,
+	 * the best integer solution found so far is returned.  The default of
+	 * zero means no limit.
+	 */
+	void setNodeLimit( size_t nLimit );
+
+	/**
+	 * Set the number of threads solving nodes.  Zero means one per
+	 * processor.  An engine created with a single algorithm always uses
+	 * one thread.  The default is one.
+	 */
+	void setThreadCount( size_t nCount );
+	size_t getThreadCount() const;
+
+	void setParallelMode( ParallelMode eMode );
+	ParallelMode getParallelMode() const;
+
+	/**
+	 * Set the maximum number of rounds of cuts at the root.  Zero turns
+	 * cuts off.  The default is ten.
+	 */
+	void setCutRounds( size_t nRounds );
+	size_t getCutRounds() const;
+
+	/**
+	 * @return size_t number of cuts in the model of the nodes during the
+	 *         last solve.
+	 */
+	size_t getCutCount() const;
+
+	/**
+	 * Set the time budget of each heuristic run, in seconds.  Zero turns
+	 * the heuristics off.  The default is two seconds.  The budget only
+	 * applies to the opportunistic search; the deterministic one bounds
+	 * the runs by their work limits alone, so that it stays reproducible.
+	 */
+	void setHeuristicTimeLimit( double fSeconds );
+	double getHeuristicTimeLimit() const;
+
+	/**
+	 * @return size_t number of nodes solved by the last solve, including
+	 *         the root.
+	 */
+	size_t getNodeCount() const;
+
+	/**
+	 * @return bool true if the last solve proved its solution optimal,
+	 *         false if it stopped at the node limit, the time limit or on
+	 *         cancellation.
+	 */
+	virtual bool isOptimal() const;
+
+private:
+	::std::auto_ptr<BranchAndBoundImpl> m_pImpl;
+};
+
+}}}
+
+#endif
@@ -0,0 +1,180 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef _SCSOLVER_LPCUTS_HXX_
+#define _SCSOLVER_LPCUTS_HXX_
+
+#include "lpbase.hxx"
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+namespace scsolver { namespace numeric {
+
+class Matrix;
+
+namespace lp {
+
+class Model;
+class CutGeneratorImpl;
+class CutPoolImpl;
+
+/**
+ * Families of cutting planes.
+ */
+enum CutType
+{
+	/** Gomory mixed-integer cuts, read off the rows of the optimal simplex
+		tableau whose basic variable is fractional. */
+	CUT_GOMORY,
+
+	/** mixed-integer rounding cuts from single constraint rows, after
+		shifting each variable to its nearer bound. */
+	CUT_MIR,
+
+	/** cover cuts from constraint rows of binary variables: not all
+		variables of a cover, whose coefficients add up to more than the
+		right hand side, can be one. */
+	CUT_COVER
+};
+
+/**
+ * Linear inequality a x <= b on the decision variables.
+ */
+class Cut
+{
+public:
+	Cut();
+	Cut( const ::std::vector<double>& aCoef, double fRhs );
+	~Cut() throw();
+
+	const ::std::vector<double>& getCoefficients() const;
+	double getRhs() const;
+
+	/**
+	 * @return double a x - b, positive when the point violates the cut.
+	 */
+	double getViolation( const Matrix& mxX ) const;
+
+	/**
+	 * @return double violation divided by the norm of a, which is the
+	 *         distance of the point from the hyperplane of the cut.
+	 */
+	double getEfficacy( const Matrix& mxX ) const;
+
+	/**
+	 * @return double cosine of the angle between the normals of the two
+	 *         cuts.
+	 */
+	double getParallelism( const Cut& rOther ) const;
+
+private:
+	::std::vector<double> m_aCoef;
+	double m_fRhs;
+	double m_fNorm;
+};
+
+/**
+ * Derives cuts that separate a fractional vertex of the LP relaxation of
+ * an integer model from all of its integer solutions.  All cuts are valid
+ * for the integer model, i.e. no integer solution violates them, so they
+ * can be added to the model to tighten its relaxation.
+ */
+class CutGenerator
+{
+public:
+	CutGenerator();
+	~CutGenerator() throw();
+
+	/**
+	 * Enable or disable a family of cuts.  All are enabled by default.
+	 */
+	void setEnabled( CutType eType, bool bEnabled );
+	bool isEnabled( CutType eType ) const;
+
+	/**
+	 * Generate the cuts violated by a vertex of the relaxation.
+	 *
+	 * @param aModel integer model
+	 * @param mxSolution optimal vertex of its relaxation
+	 * @param aBasis optimal basis, as set by the algorithm.  Gomory cuts
+	 *               are only derived from a complete basis.
+	 * @param rCuts (reference) the violated cuts are appended to it
+	 */
+	void generate( const Model& aModel, const Matrix& mxSolution, const Basis& aBasis,
+				   ::std::vector<Cut>& rCuts ) const;
+
+private:
+	::std::auto_ptr<CutGeneratorImpl> m_pImpl;
+};
+
+/**
+ * Store of the cuts found so far, out of which a few are active, i.e.
+ * part of the LP.  Each round of separation adds the most efficacious
+ * violated cuts to the active set, skipping those nearly parallel to a cut
+ * added before them.  An active cut that stays slack for several rounds
+ * is made inactive again, so that the LP does not keep growing; it stays
+ * in the pool and can be activated again later.
+ */
+class CutPool
+{
+public:
+	CutPool();
+	~CutPool() throw();
+
+	/**
+	 * Add a cut to the pool, unless it holds a nearly parallel cut that is
+	 * at least as tight already.
+	 *
+	 * @return bool true if the cut has been added
+	 */
+	bool add( const Cut& aCut );
+
+	/**
+	 * Activate the inactive cuts violated by the point, at most nMax of
+	 * them.
+	 *
+	 * @return size_t number of cuts activated
+	 */
+	size_t separate( const Matrix& mxX, size_t nMax );
+
+	/**
+	 * Age the active cuts that are slack at the point, and deactivate those
+	 * slack for too long.  The caller must make sure the point is the
+	 * solution of the current LP, in which a slack cut row is basic, so
+	 * that removing it keeps the rest of the basis valid.
+	 */
+	void update( const Matrix& mxX );
+
+	/**
+	 * @param rIds (reference) identifiers of the active cuts, in the order
+	 *             they were activated.  An identifier stays the same as
+	 *             long as the cut is in the pool.
+	 */
+	void getActive( ::std::vector<size_t>& rIds ) const;
+
+	const Cut& getCut( size_t nId ) const;
+	size_t size() const;
+	void clear();
+
+private:
+	::std::auto_ptr<CutPoolImpl> m_pImpl;
+};
+
+}}}
+
+#endif
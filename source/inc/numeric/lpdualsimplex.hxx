@@ -0,0 +1,65 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef _SCSOLVER_LPDUALSIMPLEX_HXX_
+#define _SCSOLVER_LPDUALSIMPLEX_HXX_
+
+#include "lpbase.hxx"
+#include <memory>
+#include <cstddef>
+
+namespace scsolver { namespace numeric { namespace lp {
+
+class DualSimplexImpl;
+
+/**
+ * Dual simplex method with bounded variables.  Variable bounds and
+ * constraint rows are handled directly, without being converted into
+ * additional constraints, and free variables are supported.
+ *
+ * The dual simplex keeps the basis dual feasible (optimal) while it works
+ * towards primal feasibility, so a basis that was optimal before the right
+ * hand side or the variable bounds changed is a good starting point.  Pass
+ * the basis of a previous solve to setStartBasis() to re-optimize from it.
+ * A start basis that does not fit the model or whose basis matrix is
+ * singular is ignored in favor of the slack basis.  Rows added to the
+ * model since the basis was saved start out basic.  When the starting
+ * basis is not dual feasible, a dual phase 1 is run first.
+ *
+ * It throws ModelInfeasible when the model has no feasible solution or is
+ * unbounded.
+ */
+class DualSimplex : public BaseAlgorithm
+{
+public:
+	DualSimplex();
+	virtual ~DualSimplex() throw();
+
+	virtual void solve();
+
+	/**
+	 * @return size_t number of pivots performed by the last solve.
+	 */
+	size_t getIterationCount() const;
+
+private:
+	::std::auto_ptr<DualSimplexImpl> m_pImpl;
+};
+
+}}}
+
+#endif
@@ -0,0 +1,115 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef _SCSOLVER_LPHEURISTIC_HXX_
+#define _SCSOLVER_LPHEURISTIC_HXX_
+
+#include "lpbase.hxx"
+#include <memory>
+#include <cstddef>
+
+namespace scsolver { namespace numeric {
+
+class Matrix;
+
+namespace lp {
+
+class Model;
+class PrimalHeuristicsImpl;
+
+/**
+ * Primal heuristics, which look for good integer solutions without
+ * proving anything about them.
+ */
+enum HeuristicType
+{
+	/** round each fractional variable of the relaxed solution in a
+		direction that keeps all constraints satisfied. */
+	HEURISTIC_ROUNDING,
+
+	/** repeatedly round the bound of the least fractional variable and
+		solve the relaxation again, backtracking once when it becomes
+		infeasible. */
+	HEURISTIC_DIVING,
+
+	/** alternate between rounding the relaxed solution and solving an LP
+		for the relaxed solution closest to the rounded point, until the
+		two meet. */
+	HEURISTIC_FEASIBILITY_PUMP,
+
+	/** fix the variables on which the incumbent and the relaxed solution
+		agree, and search the remaining sub-model with a small branch and
+		bound for a better solution. */
+	HEURISTIC_RINS
+};
+
+/**
+ * Runs primal heuristics on an integer model.  Each run is limited by its
+ * amount of work, i.e. the depth of a dive, the iterations of the pump and
+ * the nodes of the RINS sub-search, and by a time budget.  It returns only
+ * solutions that satisfy all constraints and are better than the
+ * incumbent given to it.
+ */
+class PrimalHeuristics
+{
+public:
+	PrimalHeuristics();
+	~PrimalHeuristics() throw();
+
+	/**
+	 * Enable or disable a heuristic.  All are enabled by default.
+	 */
+	void setEnabled( HeuristicType eType, bool bEnabled );
+	bool isEnabled( HeuristicType eType ) const;
+
+	/**
+	 * Set the time budget of each run, in seconds.  Zero means no budget,
+	 * so that only the work limits apply and the result does not depend on
+	 * the speed of the machine.  The default is two seconds.
+	 */
+	void setTimeLimit( double fSeconds );
+	double getTimeLimit() const;
+
+	/**
+	 * Run a heuristic.
+	 *
+	 * @param eType heuristic to run
+	 * @param rAlgorithm algorithm that solves the LPs of the heuristic
+	 * @param aModel integer model
+	 * @param mxRelaxed optimal solution of the relaxation of the model
+	 * @param aBasis optimal basis of the relaxation, or an empty basis
+	 * @param mxIncumbent best integer solution known so far, or an empty
+	 *                    matrix.  RINS needs one.
+	 *
+	 * @return bool true if the heuristic found a solution better than the
+	 *         incumbent.
+	 */
+	bool run( HeuristicType eType, BaseAlgorithm& rAlgorithm, const Model& aModel,
+			  const Matrix& mxRelaxed, const Basis& aBasis, const Matrix& mxIncumbent );
+
+	/**
+	 * @return Matrix solution found by the last successful run.
+	 */
+	const Matrix getSolution() const;
+
+private:
+	::std::auto_ptr<PrimalHeuristicsImpl> m_pImpl;
+};
+
+}}}
+
+#endif
@@ -0,0 +1,95 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef _SCSOLVER_LPINTERIORPOINT_HXX_
+#define _SCSOLVER_LPINTERIORPOINT_HXX_
+
+#include "lpbase.hxx"
+#include <memory>
+#include <cstddef>
+
+namespace scsolver { namespace numeric { namespace lp {
+
+class InteriorPointImpl;
+
+/**
+ * Primal-dual interior point method with Mehrotra's predictor-corrector
+ * steps.  The model is brought into the form
+ *
+ *     min c x  subject to  A x = b,  0 <= x <= u
+ *
+ * with slack variables for the inequality rows, and with the variables
+ * shifted onto their lower bounds (or mirrored onto their upper bounds, or
+ * split in two when they are free).  A is stored as a sparse matrix, and
+ * each iteration solves the normal equations A D A^T with a sparse
+ * Cholesky factorization, whose ordering and pattern are computed once.
+ * The work per iteration thus depends on the number of non-zero elements
+ * rather than on the size of the model, and the number of iterations
+ * grows only slowly with the size of the model, which makes this the
+ * method of choice for large sparse models.
+ *
+ * The iterates approach the optimum from the interior, so the solution is
+ * in general not a vertex when the optimum is not unique, and its entries
+ * are only accurate up to the convergence tolerance.  With crossover
+ * enabled (the default), a basis is guessed from the interior solution
+ * and handed to the dual simplex method, which finishes with a few pivots
+ * and returns the basic solution and its basis that a simplex method would
+ * have returned.  Crossover inverts the dense basis matrix of the dual
+ * simplex, whose cost grows with the cube of the number of constraints,
+ * so it is skipped for models with more than 1000 constraints unless the
+ * row limit is raised with setCrossoverRowLimit().  Such models get the
+ * interior solution and an empty basis.
+ *
+ * It throws ModelInfeasible when the model has no feasible solution or is
+ * unbounded, and MaxIterationReached when the iterations fail to converge.
+ */
+class InteriorPoint : public BaseAlgorithm
+{
+public:
+	InteriorPoint();
+	virtual ~InteriorPoint() throw();
+
+	virtual void solve();
+
+	void setCrossover( bool b );
+	bool getCrossover() const;
+
+	/**
+	 * Set the largest number of constraints for which crossover runs.
+	 * The default is 1000, and zero removes the limit.
+	 */
+	void setCrossoverRowLimit( size_t n );
+	size_t getCrossoverRowLimit() const;
+
+	/**
+	 * @return size_t number of interior point iterations of the last solve.
+	 */
+	size_t getIterationCount() const;
+
+	/**
+	 * @return size_t number of simplex pivots performed by the crossover
+	 *         of the last solve.
+	 */
+	size_t getCrossoverIterationCount() const;
+
+private:
+	::std::auto_ptr<InteriorPointImpl> m_pImpl;
+};
+
+}}}
+
+#endif
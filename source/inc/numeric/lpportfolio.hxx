@@ -0,0 +1,89 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef _SCSOLVER_LPPORTFOLIO_HXX_
+#define _SCSOLVER_LPPORTFOLIO_HXX_
+
+#include "lpbase.hxx"
+#include <memory>
+#include <cstddef>
+
+namespace scsolver { namespace numeric { namespace lp {
+
+class PortfolioImpl;
+
+/**
+ * Portfolio of algorithms that race each other on the same model.  Each
+ * algorithm solves a copy of the model in a thread of its own, and the
+ * first one to come up with a proven optimal solution (see
+ * BaseAlgorithm::isOptimal), or to prove the model infeasible, decides the
+ * outcome; the others are cancelled right away.  A solution without such
+ * a proof, e.g. from a search stopped by its time limit, does not end the
+ * race; the best of those is only used when no algorithm decides it.
+ *
+ * Since no single engine is the fastest on all models, this gives the
+ * time of the best engine on each model, at the cost of keeping one
+ * processor busy per engine.
+ *
+ * Each algorithm runs under a solve control of its own, linked to the one
+ * of the portfolio (see SolveControl::setParent), with the same limits.
+ * Its progress is passed on to the listener of the portfolio until the
+ * race is decided.  The algorithms are kept for the next solve, so those
+ * that keep state between solves, such as LpSolve, can make use of it.
+ *
+ * An algorithm that fails, e.g. by reaching the iteration limit, drops out
+ * of the race.  When all of them fail, the error of the first one added
+ * is thrown, or SolveCancelled or IterationTimedOut when the portfolio
+ * itself was cancelled or ran out of time.
+ */
+class Portfolio : public BaseAlgorithm
+{
+public:
+	Portfolio();
+	virtual ~Portfolio() throw();
+
+	virtual void solve();
+
+	/**
+	 * Add an algorithm to the race.
+	 *
+	 * @param pAlgorithm algorithm to add.  The portfolio takes ownership
+	 *                   of it.
+	 */
+	void addAlgorithm( ::std::auto_ptr<BaseAlgorithm> pAlgorithm );
+
+	size_t getAlgorithmCount() const;
+	BaseAlgorithm* getAlgorithm( size_t nIndex ) const;
+
+	/**
+	 * @return size_t index of the algorithm that decided the last solve.
+	 */
+	size_t getWinner() const;
+
+	/**
+	 * @return bool true if the solution of the last solve was proven
+	 *         optimal by the algorithm that returned it.
+	 */
+	virtual bool isOptimal() const;
+
+private:
+	::std::auto_ptr<PortfolioImpl> m_pImpl;
+};
+
+}}}
+
+#endif
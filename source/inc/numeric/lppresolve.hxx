@@ -0,0 +1,115 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef _SCSOLVER_LPPRESOLVE_HXX_
+#define _SCSOLVER_LPPRESOLVE_HXX_
+
+#include <memory>
+#include <cstddef>
+
+namespace scsolver { namespace numeric {
+
+class Matrix;
+
+namespace lp {
+
+class Model;
+class Basis;
+class PresolverImpl;
+
+/**
+ * Presolve reduces an LP model before it is passed to an algorithm, and
+ * postsolve maps the solution of the reduced model back to the variables
+ * of the original model.  The following reductions are applied repeatedly
+ * until none of them applies any more:
+ *
+ * - empty rows are dropped, and singleton rows become variable bounds,
+ * - empty and fixed columns are removed,
+ * - rows that are a multiple of another row are merged into it,
+ * - forcing rows fix all their variables at a bound, and rows that can
+ *   never be violated are dropped,
+ * - dominated columns are fixed at the bound favored by the objective,
+ * - continuous column singletons are folded into their row, either as a
+ *   slack or, in an equality row, by substitution.
+ *
+ * The reductions that depend on the objective are skipped when the goal
+ * is to reach a value, and the column singleton reductions are skipped for
+ * integer models.
+ */
+class Presolver
+{
+public:
+	Presolver();
+	~Presolver() throw();
+
+	/**
+	 * Reduce the given model.
+	 *
+	 * It throws ModelInfeasible when the reductions show that the model
+	 * is infeasible or unbounded.
+	 *
+	 * @param aModel model to reduce
+	 */
+	void presolve( const Model& aModel );
+
+	/**
+	 * @return Model reduced model.  It may have no variable left when
+	 *         presolve has determined the whole solution.
+	 */
+	const Model getReducedModel() const;
+
+	/**
+	 * Map a solution of the reduced model back to the original model.
+	 *
+	 * @param mxSolution column vector with one element per variable of
+	 *                   the reduced model
+	 * @return Matrix column vector with one element per variable of the
+	 *         original model
+	 */
+	const Matrix postsolve( const Matrix& mxSolution ) const;
+
+	/**
+	 * Map a basis of the reduced model back to the original model, so that
+	 * it can start the next solve without presolve.  Removed rows are
+	 * basic, and removed columns are non-basic at their lower bound.  The
+	 * result is only a start; the algorithms check it before using it.
+	 *
+	 * @param aBasis basis of the reduced model
+	 * @return Basis basis of the original model, or an empty one when the
+	 *         given basis does not fit the reduced model
+	 */
+	const Basis postsolveBasis( const Basis& aBasis ) const;
+
+	/**
+	 * @return size_t number of constraint rows of the original model that
+	 *         presolve has removed.
+	 */
+	size_t getRemovedRowCount() const;
+
+	/**
+	 * @return size_t number of decision variables of the original model
+	 *         that presolve has removed.
+	 */
+	size_t getRemovedColCount() const;
+
+private:
+	::std::auto_ptr<PresolverImpl> m_pImpl;
+};
+
+}}}
+
+#endif
@@ -0,0 +1,111 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef _SCSOLVER_LPSCALING_HXX_
+#define _SCSOLVER_LPSCALING_HXX_
+
+#include "lpbase.hxx"
+#include <memory>
+#include <cstddef>
+
+namespace scsolver { namespace numeric {
+
+class Matrix;
+
+namespace lp {
+
+class Model;
+class ScalerImpl;
+
+/**
+ * Scaling of an LP model.  The constraint matrix is replaced by R A S,
+ * where R and S are diagonal matrices of row and column scale factors, so
+ * that its non-zero entries are all close to one in magnitude.  A scaled
+ * variable x' relates to the original one by x = S x', so the right hand
+ * side is scaled by R, and the cost vector and the variable bounds by S.
+ * The objective value stays the same.
+ *
+ * The factors are computed by geometric mean scaling, repeated while it
+ * keeps reducing the ratio between the largest and the smallest entry,
+ * followed by one pass of equilibration which brings the largest entry of
+ * each row and column to one.  All factors are rounded to powers of two,
+ * so that scaling introduces no rounding error.  The variables of an
+ * integer model are not scaled, as that would not preserve integrality.
+ */
+class Scaler
+{
+public:
+	Scaler();
+	~Scaler() throw();
+
+	/**
+	 * Compute the scale factors of the given model.
+	 *
+	 * @param aModel model to scale
+	 */
+	void scale( const Model& aModel );
+
+	/**
+	 * @return Model scaled model.
+	 */
+	const Model getScaledModel() const;
+
+	/**
+	 * Map a solution of the scaled model back to the original model.
+	 *
+	 * @param mxSolution column vector of scaled variables
+	 * @return Matrix column vector of original variables
+	 */
+	const Matrix unscale( const Matrix& mxSolution ) const;
+
+	double getRowScale( size_t nRow ) const;
+	double getColScale( size_t nCol ) const;
+
+private:
+	::std::auto_ptr<ScalerImpl> m_pImpl;
+};
+
+/**
+ * Wrapper that solves the model of an algorithm in scaled form.  It
+ * scales the model, lets the wrapped algorithm solve the scaled model,
+ * and unscales the solution, so that any algorithm can make use of scaling
+ * without knowing about it.  The start basis is passed on to the wrapped
+ * algorithm and its final basis is passed back, since scaling does not
+ * change which variables are basic.
+ */
+class ScaledAlgorithm : public BaseAlgorithm
+{
+public:
+	/**
+	 * @param pAlgorithm algorithm that solves the scaled model.  The
+	 *                   wrapper takes ownership of it.
+	 */
+	ScaledAlgorithm( ::std::auto_ptr<BaseAlgorithm> pAlgorithm );
+	virtual ~ScaledAlgorithm() throw();
+
+	virtual void solve();
+	virtual bool isOptimal() const;
+
+	BaseAlgorithm* getAlgorithm() const;
+
+private:
+	::std::auto_ptr<BaseAlgorithm> m_pAlgorithm;
+};
+
+}}}
+
+#endif
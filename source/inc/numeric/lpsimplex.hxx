@@ -20,6 +20,7 @@
 
 #include "lpbase.hxx"
 #include <memory>
+#include <cstddef>
 
 namespace scsolver { namespace numeric { namespace lp {
 
@@ -27,6 +28,38 @@ class Model;
 class RevisedSimplexImpl;
 class BoundedRevisedSimplexImpl;
 
+/**
+ * Strategy used to select the entering variable at each simplex iteration.
+ */
+enum PricingType
+{
+	/** Price every non-basic column and pick the one with the most
+		attractive reduced cost (Dantzig's rule). */
+	PRICING_DANTZIG,
+
+	/** Price the non-basic columns one block at a time, starting where the
+		previous iteration left off, and stop at the first block that
+		contains an attractive column. */
+	PRICING_PARTIAL,
+
+	/** Keep a short list of the most attractive columns from a full
+		pricing pass, and re-price only those until none of them is
+		attractive any more. */
+	PRICING_MULTIPLE,
+
+	/** Price every non-basic column, scaling each reduced cost by an
+		approximate norm of its edge direction relative to a reference
+		framework (Devex).  The approximation is updated cheaply at each
+		pivot and reset when it drifts too far. */
+	PRICING_DEVEX,
+
+	/** Price every non-basic column, scaling each reduced cost by the exact
+		norm of its edge direction, ||(-B^-1 A_j, e_j)||.  The norms are
+		updated at each pivot by the Goldfarb-Reid recurrence, which costs
+		about one extra pricing pass per iteration. */
+	PRICING_STEEPEST_EDGE
+};
+
 class RevisedSimplex : public BaseAlgorithm
 {
 public:
@@ -37,6 +70,67 @@ public:
 
 	void setEnableTwoPhaseSearch( bool );
 
+	/**
+	 * Set the pricing strategy.  The default is PRICING_DANTZIG.
+	 */
+	void setPricing( PricingType );
+	PricingType getPricing() const;
+
+	/**
+	 * Set the number of columns priced per block with PRICING_PARTIAL, or
+	 * the maximum length of the candidate list with PRICING_MULTIPLE.  When
+	 * 0 (default), the size is determined from the number of non-basic
+	 * variables.
+	 */
+	void setPricingBlockSize( size_t );
+	size_t getPricingBlockSize() const;
+
+	/**
+	 * Enable or disable the crash basis of the two-phase search.  When
+	 * enabled (default), phase one starts from a triangular basis that
+	 * replaces as many artificial variables as possible by structural
+	 * columns, instead of the all-artificial basis.
+	 */
+	void setCrash( bool );
+	bool getCrash() const;
+
+	/**
+	 * Set the primal feasibility tolerance, by which the Harris ratio test
+	 * lets a basic variable violate its bound in favour of a larger pivot.
+	 * The default is 1e-9.
+	 */
+	void setPrimalTolerance( double );
+	double getPrimalTolerance() const;
+
+	/**
+	 * Set the dual feasibility tolerance.  A non-basic variable only enters
+	 * the basis if its reduced cost exceeds it in magnitude.  The default is
+	 * 1e-9.
+	 */
+	void setDualTolerance( double );
+	double getDualTolerance() const;
+
+	/**
+	 * Enable or disable perturbation.  When enabled (default), the basic
+	 * variables are moved off their bounds by small random amounts after a
+	 * run of degenerate iterations, and the perturbation is removed once
+	 * the perturbed model is solved.
+	 */
+	void setPerturbation( bool );
+	bool getPerturbation() const;
+
+	/**
+	 * @return size_t number of iterations of the last solve, not counting
+	 *         those of the two-phase search.
+	 */
+	size_t getIterationCount() const;
+
+	/**
+	 * @return size_t number of iterations spent in phase one of the
+	 *         two-phase search by the last solve.
+	 */
+	size_t getPhaseOneIterationCount() const;
+
 private:
 	std::auto_ptr<RevisedSimplexImpl> m_pImpl;
 };
@@ -50,6 +144,61 @@ public:
 
 	virtual void solve();
 
+	/**
+	 * Set the pricing strategy.  The default is PRICING_DANTZIG.
+	 * PRICING_PARTIAL and PRICING_MULTIPLE are not supported by this
+	 * algorithm, and fall back to PRICING_DANTZIG.
+	 */
+	void setPricing( PricingType );
+	PricingType getPricing() const;
+
+	/**
+	 * Enable or disable the long-step ratio test of phase one.  When
+	 * enabled (default), a step may carry an artificial variable through
+	 * zero as long as the sum of infeasibilities keeps decreasing, and
+	 * the artificial variable stays basic with its sign reversed instead
+	 * of leaving the basis.
+	 */
+	void setLongStep( bool );
+	bool getLongStep() const;
+
+	/**
+	 * Set the primal feasibility tolerance, by which the Harris ratio test
+	 * lets a basic variable violate its bound in favour of a larger pivot.
+	 * The default is 1e-9.
+	 */
+	void setPrimalTolerance( double );
+	double getPrimalTolerance() const;
+
+	/**
+	 * Set the dual feasibility tolerance.  A non-basic variable only enters
+	 * the basis if its reduced cost exceeds it in magnitude.  The default is
+	 * 1e-9.
+	 */
+	void setDualTolerance( double );
+	double getDualTolerance() const;
+
+	/**
+	 * Enable or disable perturbation.  When enabled (default), the basic
+	 * variables are moved off their bounds by small random amounts after a
+	 * run of degenerate iterations, and the perturbation is removed once
+	 * the perturbed model is solved.
+	 */
+	void setPerturbation( bool );
+	bool getPerturbation() const;
+
+	/**
+	 * @return size_t number of iterations of the last solve, not counting
+	 *         those of phase one.
+	 */
+	size_t getIterationCount() const;
+
+	/**
+	 * @return size_t number of iterations spent in phase one by the last
+	 *         solve.
+	 */
+	size_t getPhaseOneIterationCount() const;
+
 private:
 	std::auto_ptr<BoundedRevisedSimplexImpl> m_pImpl;
 };
@@ -29,6 +29,17 @@ class LpSolveImpl;
 
 /**
  * This class is a front-end for the lp_solve MILP library.
+ *
+ * The lp_solve instance is kept from one solve to the next.  When the
+ * model has the same number of rows and variables as the last one, only
+ * the values that changed are passed on, and lp_solve starts from its
+ * last basis, so repeated solves of a model whose data was edited take a
+ * fraction of the time of the first.  A valid start basis still takes
+ * precedence over the last one.
+ *
+ * The time limit and the cancel flag of the solve control are passed on to
+ * lp_solve, with the time limit rounded up to whole seconds.  lp_solve has
+ * no iteration limit, so that of the solve control is ignored.
  */
 class LpSolve : public BaseAlgorithm
 {
@@ -38,6 +49,19 @@ public:
 
 	virtual void solve();
 
+	/**
+	 * @return bool false when lp_solve stopped an integer model early and
+	 *         returned its best solution so far (SUBOPTIMAL).
+	 */
+	virtual bool isOptimal() const;
+
+	/**
+	 * Write the model as loaded into lp_solve to the standard output
+	 * before each solve, in LP format.  Off by default.
+	 */
+	void setDumpModel( bool bDump );
+	bool getDumpModel() const;
+
 private:
 	std::auto_ptr<LpSolveImpl> m_pImpl;
 };
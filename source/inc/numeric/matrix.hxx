@@ -66,12 +66,19 @@ public:
     virtual const char* what() const throw();
 };
 
+class MatrixNotPositiveDefinite : public ::std::exception
+{
+public:
+    virtual const char* what() const throw();
+};
+
 class Matrix
 {
 public:
     typedef ::boost::numeric::ublas::matrix<double, ::boost::numeric::ublas::row_major, ::std::vector<double> > 
         NumericMatrixType;
     typedef ::boost::numeric::ublas::matrix< ::std::string > StringMatrixType;
+    typedef ::boost::numeric::ublas::matrix_range<const NumericMatrixType> ConstRangeType;
 
     Matrix();
     Matrix(size_t row, size_t col, bool identity_matrix = false);
@@ -119,8 +126,27 @@ public:
     const Matrix inverse() const;
     const Matrix trans() const;
     double minors( size_t, size_t ) const;
+
+    /**
+     * Change the logical size of the matrix.  The underlying storage is
+     * re-allocated only when the new size exceeds the current capacity;
+     * elements that become newly visible are always zero.
+     *
+     * @param row new row size
+     * @param col new column size
+     */
     void resize(size_t row, size_t col);
 
+    /**
+     * Pre-allocate storage for at least the specified number of rows and
+     * columns without changing the logical size of the matrix.  Call this
+     * before filling a matrix element by element to avoid re-allocation.
+     *
+     * @param row row capacity
+     * @param col column capacity
+     */
+    void reserve(size_t row, size_t col);
+
     /**
      * @return size_t current row size
      */
@@ -130,6 +156,18 @@ public:
      * @return size_t current column size
      */
     size_t cols() const;
+
+    /**
+     * @return size_t number of rows that can be stored without
+     *         re-allocation
+     */
+    size_t rowCapacity() const;
+
+    /**
+     * @return size_t number of columns that can be stored without
+     *         re-allocation
+     */
+    size_t colCapacity() const;
     
     bool empty() const;
     bool isRowEmpty( size_t ) const;
@@ -161,10 +199,23 @@ private:
     const Matrix adj() const;
     double cofactor( size_t, size_t ) const;
     void maybeExpand(size_t row, size_t col);
+    void reallocate(size_t row, size_t col);
     void throwIfEmpty() const;
+    void throwIfOutOfBound(size_t row, size_t col) const;
+
+    /**
+     * @return range object representing the logical portion of the
+     *         storage array.
+     */
+    ConstRangeType getRange() const;
 
     bool m_bResizable;
+
+    /** storage array whose dimensions are the current capacity, which may
+        be larger than the logical size. */
     NumericMatrixType m_aArray;
+    size_t m_nRows;
+    size_t m_nCols;
 };
 
 const Matrix operator+(const Matrix& mx, double scalar);
@@ -0,0 +1,115 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef _SCSOLVER_NUMERIC_MULTISTART_HXX_
+#define _SCSOLVER_NUMERIC_MULTISTART_HXX_
+
+#include "numeric/nlpbase.hxx"
+#include <memory>
+#include <cstddef>
+
+namespace scsolver { namespace numeric { namespace nlp {
+
+class MultiStartImpl;
+
+/**
+ * Global search that runs a local algorithm from many start points and
+ * keeps the best result.  The algorithms of this package are all local,
+ * so on a non-convex model they end in the optimum nearest to the start,
+ * which need not be the global one.
+ *
+ * The first start is the current point of the model; the others form a
+ * Latin hypercube sample of the box given by the variable bounds, so that
+ * each variable has one start in each of as many equal slices of its
+ * range as there are starts.  A variable without a bound on a side is
+ * sampled up to max(1, |x|) beyond its current value x on that side.
+ *
+ * The starts are shared out to a pool of threads, each of which has its
+ * own instance of the local algorithm, made by a factory, its own copy of
+ * the model, and its own clone of the function object (see
+ * BaseFuncObj::clone).  A function object that cannot be cloned, e.g. one
+ * that works on cells, makes the starts run one after another in the
+ * calling thread.
+ *
+ * Each local optimum found is kept as a basin.  A start is skipped when a
+ * known optimum lies within the basin radius of it and is at least as
+ * good as the start itself, since the local algorithm would most likely
+ * end there again.  Distances are measured relative to the sampled range
+ * of each variable.  With several threads, which starts get skipped
+ * depends on the order in which they finish.
+ *
+ * Each local run gets a solve control of its own, linked to the one of
+ * the search (see SolveControl::setParent), with the same iteration and
+ * evaluation limits; the time limit applies to the search as a whole.  A
+ * local run that fails is left out.  When the search is cancelled or runs
+ * out of time, it ends with the best result found so far, and only throws
+ * SolveCancelled or IterationTimedOut when there is none yet.  When all
+ * runs fail, the error of the first failing one is thrown.
+ */
+class MultiStart : public BaseAlgorithm
+{
+    friend class MultiStartImpl;
+
+public:
+    /**
+     * @param pFactory factory that creates the local algorithm of each
+     *                 thread.  The search takes ownership of it.
+     */
+    explicit MultiStart( ::std::auto_ptr<AlgorithmFactory> pFactory );
+    virtual ~MultiStart() throw();
+
+    virtual void solve();
+
+    /** Set the number of start points, including the current point.  The
+        default is 20. */
+    void setStartCount( size_t nCount );
+    size_t getStartCount() const;
+
+    /**
+     * Set the number of threads running the local algorithm.  Zero means
+     * one per processor.  The default is one.
+     */
+    void setThreadCount( size_t nCount );
+    size_t getThreadCount() const;
+
+    /** Set the seed of the sample of start points. */
+    void setSeed( unsigned long nSeed );
+
+    /**
+     * Set the radius around a known optimum within which starts are
+     * skipped, as a fraction of the sampled range of each variable.  Zero
+     * runs every start.  The default is 0.1.
+     */
+    void setBasinRadius( double fRadius );
+
+    /** @return size_t number of distinct local optima of the last solve. */
+    size_t getBasinCount() const;
+
+    /** @return size_t number of starts the last solve ran the local
+        algorithm from. */
+    size_t getSolvedCount() const;
+
+    /** @return size_t number of starts the last solve skipped. */
+    size_t getSkippedCount() const;
+
+private:
+    ::std::auto_ptr<MultiStartImpl> m_pImpl;
+};
+
+}}}
+
+#endif
@@ -23,6 +23,9 @@
 
 namespace scsolver { namespace numeric {
 
+class BaseFuncObj;
+class SolveControl;
+
 namespace nlp {
 
 class Model;
@@ -60,7 +63,47 @@ public:
 
     bool isDebug() const;
 
+    /**
+     * Set the limits and the cancel flag the algorithm honors.  The caller
+     * keeps ownership, and must start() the control before each solve that
+     * has a time limit.  NULL (default) means an own control without any
+     * limit, which leaves each algorithm to its own default limits.
+     *
+     * @param p pointer to solve control.
+     */
+    void setSolveControl(SolveControl* p);
+
+    SolveControl* getSolveControl() const;
+
 protected:
+    /**
+     * Counts the evaluations of the objective function while in scope, and
+     * checks the solve control at each of them, so that the evaluation
+     * limit applies, and a cancelled or timed out solve stops even in the
+     * middle of a line search.  It temporarily replaces the function object
+     * of the model with one that forwards to it.
+     */
+    class EvaluationGuard
+    {
+    public:
+        explicit EvaluationGuard(BaseAlgorithm& rAlgorithm);
+        ~EvaluationGuard() throw();
+
+        /**
+         * Throw again if the solve has to stop, for algorithms that carry
+         * on when a line search fails.
+         */
+        void check() const;
+
+    private:
+        EvaluationGuard(const EvaluationGuard&); // disabled
+        EvaluationGuard& operator=(const EvaluationGuard&); // disabled
+
+        Model* m_pModel;
+        BaseFuncObj* m_pFuncObj;
+        ::std::auto_ptr<BaseFuncObj> m_pCounter;
+    };
+
     /**
      * Get current NLP model.
      * 
@@ -72,6 +115,31 @@ private:
 	::std::auto_ptr<BaseAlgorithmImpl> m_pImpl;
 };
 
+/**
+ * Creates new instances of an algorithm, for drivers that solve several
+ * models at the same time and need an instance per thread.
+ */
+class AlgorithmFactory
+{
+public:
+    virtual ~AlgorithmFactory() throw() {}
+
+    virtual ::std::auto_ptr<BaseAlgorithm> create() const = 0;
+};
+
+/**
+ * Factory for an algorithm class that is default constructible.
+ */
+template<typename AlgorithmType>
+class DefaultAlgorithmFactory : public AlgorithmFactory
+{
+public:
+    virtual ::std::auto_ptr<BaseAlgorithm> create() const
+    {
+        return ::std::auto_ptr<BaseAlgorithm>( new AlgorithmType );
+    }
+};
+
 }}}
 
 
@@ -136,6 +136,14 @@ public:
      */
     void getVars( ::std::vector<double>& vars ) const;
 
+    /**
+     * Set the values of all variables, e.g. to solve the model again from
+     * another start point.  The bounds of the variables stay as they are.
+     *
+     * @param vars variable values, one per variable.
+     */
+    void setVars( const ::std::vector<double>& vars );
+
     /**
      * Get the boundary value of a variable specified by the index.  Note 
      * especially that the caller needs to ensure that the bounardy specified is
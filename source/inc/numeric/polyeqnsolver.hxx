@@ -18,6 +18,8 @@
 #ifndef _SCSOLVER_NUMERIC_POLYEQNSOLVER_HXX_
 #define _SCSOLVER_NUMERIC_POLYEQNSOLVER_HXX
 
+#include "numeric/fixedmatrix.hxx"
+
 #include <list>
 #include <exception>
 
@@ -55,6 +57,30 @@ public:
 
     void addDataPoint(double x, double y);
     const Matrix solve();
+
+    /**
+     * Solve a quadratic equation from exactly three data points.  This is
+     * equivalent of solve() but works entirely on the stack.  It throws 
+     * NotEnoughDataPoints if the number of data points is not three.
+     *
+     * @param coef (reference) coefficients (C, B, A) as in f(x) = Ax^2 + Bx
+     *             + C.
+     */
+    void solveQuadratic(FixedMatrix<3, 1>& coef) const;
+
+    /**
+     * Fit a polynomial of the specified degree to the data points in the
+     * least squares sense, via Householder QR factorization of the
+     * Vandermonde matrix.  The number of data points must be greater than
+     * the degree; if it is exactly one greater, the polynomial interpolates
+     * all data points as with solve().
+     *
+     * @param degree degree of the polynomial
+     *
+     * @return coefficients from the lowest order to highest, as a column
+     *         matrix.
+     */
+    const Matrix solveLeastSquares(size_t degree) const;
     void clear();
 
     /** 
@@ -82,6 +108,7 @@ private:
  *             the coefficients are from the x^0 term toward x^2.
  */
 void getQuadraticPeak(double& x, double& y, const Matrix& coef);
+void getQuadraticPeak(double& x, double& y, const FixedMatrix<3, 1>& coef);
 
 }}
 
@@ -0,0 +1,199 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef _SCSOLVER_SOLVECONTROL_HXX_
+#define _SCSOLVER_SOLVECONTROL_HXX_
+
+#include <memory>
+#include <cstddef>
+
+namespace scsolver {
+
+class Timer;
+
+namespace numeric {
+
+/**
+ * State of a running solve, as passed to a SolveProgressListener.
+ */
+struct SolveProgress
+{
+	SolveProgress();
+
+	/** iterations of the LP or NLP run that reports. */
+	size_t Iteration;
+
+	/** nodes solved so far by a branch and bound, zero otherwise. */
+	size_t Node;
+
+	/** objective value of the current point, or of the incumbent. */
+	double Objective;
+	bool HasObjective;
+
+	/**
+	 * relative gap between the objective and the best bound, i.e.
+	 * |objective - bound|/(1 + |objective|), when the algorithm knows one.
+	 */
+	double Gap;
+	bool HasGap;
+};
+
+/**
+ * Receives the progress of a solve.  It is called on the thread running
+ * the solve, or on one of the worker threads of a parallel search, one
+ * call at a time, so it must neither block nor touch anything that
+ * belongs to another thread.
+ */
+class SolveProgressListener
+{
+public:
+	virtual ~SolveProgressListener() throw() {}
+
+	virtual void progress( const SolveProgress& rProgress ) = 0;
+};
+
+/**
+ * Limits of a solve, and a flag to stop it early, shared by the LP and
+ * the NLP algorithms (see lp::BaseAlgorithm::setSolveControl and
+ * nlp::BaseAlgorithm::setSolveControl).  The algorithms check it once
+ * per iteration, or function evaluation, and stop by throwing
+ * IterationTimedOut, MaxIterationReached or SolveCancelled; an engine
+ * that can return a partial result, like branch and bound with an
+ * incumbent, returns that instead.
+ *
+ * A limit of zero leaves the algorithm to its own default, e.g. 500
+ * iterations and 20 seconds for QuasiNewton; most algorithms have no
+ * default time limit.  The iteration limit applies to each LP or NLP
+ * run, so to each node relaxation of a branch and bound, while the time
+ * limit runs from the last start() for all of them.  The evaluation
+ * limit applies to the objective function of an NLP model.
+ *
+ * The algorithms also report their progress through it, once per
+ * iteration or node, to the listener set with setProgressListener().
+ *
+ * cancel() may be called from any thread while a solve runs.
+ */
+class SolveControl
+{
+public:
+	SolveControl();
+	~SolveControl() throw();
+
+	/**
+	 * Start the clock of the time limit, and clear the cancel flag.  The
+	 * clock also starts when the object is created.
+	 */
+	void start();
+
+	/** Set the time limit in seconds.  The default is none. */
+	void setTimeLimit( double fSeconds );
+	double getTimeLimit() const;
+
+	/** Set the maximum number of iterations.  The default is none. */
+	void setIterationLimit( size_t nLimit );
+	size_t getIterationLimit() const;
+
+	/** Set the maximum number of function evaluations.  The default is none. */
+	void setEvaluationLimit( size_t nLimit );
+	size_t getEvaluationLimit() const;
+
+	/** Ask the running solve to stop as soon as it can. */
+	void cancel();
+
+	/**
+	 * @return bool true if this control, or its parent, has been cancelled.
+	 */
+	bool isCancelled() const;
+
+	/**
+	 * Let the control also count as cancelled when the given one is.  A
+	 * solver that runs parts of its work under controls of its own, so as
+	 * to stop them one by one, keeps them linked to its caller's control
+	 * this way.  The default is none.
+	 */
+	void setParent( const SolveControl* pParent );
+
+	/**
+	 * @return double seconds since the last start().
+	 */
+	double getElapsedTime() const;
+
+	/**
+	 * @param fDefaultLimit limit of the algorithm, used when none is set.
+	 *                      Zero means none.
+	 * @return bool true if the time limit has passed.
+	 */
+	bool isTimedOut( double fDefaultLimit = 0.0 ) const;
+
+	/**
+	 * @param fDefaultLimit limit of the algorithm, used when none is set
+	 * @return double seconds left before the time limit, never negative,
+	 *         or the default when no limit is set.
+	 */
+	double getRemainingTime( double fDefaultLimit ) const;
+
+	/**
+	 * Throw SolveCancelled if the solve was cancelled, or
+	 * IterationTimedOut if the time limit has passed.
+	 */
+	void check( double fDefaultTimeLimit = 0.0 ) const;
+
+	/**
+	 * check(), and throw MaxIterationReached if the given number of
+	 * iterations has reached the iteration limit.
+	 *
+	 * @param nIteration number of iterations done so far
+	 * @param nDefaultLimit limit of the algorithm, used when none is set.
+	 *                      Zero means none.
+	 */
+	void checkIteration( size_t nIteration, size_t nDefaultLimit = 0 ) const;
+
+	/**
+	 * check(), and throw MaxIterationReached if the given number of
+	 * function evaluations has passed the evaluation limit.
+	 */
+	void checkEvaluation( size_t nEvaluation ) const;
+
+	/**
+	 * Set the listener that receives the progress of the solve.  The
+	 * default is none.  The caller keeps ownership of it.
+	 */
+	void setProgressListener( SolveProgressListener* pListener );
+	SolveProgressListener* getProgressListener() const;
+
+	/** Pass the progress on to the listener, if there is one. */
+	void reportProgress( const SolveProgress& rProgress ) const;
+
+	/** Report a progress that consists of the iteration count only. */
+	void reportIteration( size_t nIteration ) const;
+
+private:
+	SolveControl( const SolveControl& ); // disabled
+	SolveControl& operator=( const SolveControl& ); // disabled
+
+	::std::auto_ptr<Timer> m_pTimer;
+	double m_fTimeLimit;
+	size_t m_nIterationLimit;
+	size_t m_nEvaluationLimit;
+	volatile long m_nCancelled;
+	SolveProgressListener* m_pListener;
+	const SolveControl* m_pParent;
+};
+
+}}
+
+#endif
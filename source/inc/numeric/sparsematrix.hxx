@@ -0,0 +1,333 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef _SCSOLVER_NUMERIC_SPARSEMATRIX_HXX_
+#define _SCSOLVER_NUMERIC_SPARSEMATRIX_HXX_
+
+#include <vector>
+#include <cstddef>
+
+namespace scsolver { namespace numeric {
+
+class Matrix;
+
+/**
+ * Sparse matrix in compressed sparse column (CSC) format.  Elements are
+ * added with insert() in any order; they are sorted into the compressed
+ * storage, with duplicates summed, the next time the matrix is queried.
+ *
+ * Column access and A^T x are natural in this format.  A compressed sparse
+ * row (CSR) copy can optionally be kept alongside, via setRowMirror(true),
+ * for callers that need row access or row-oriented A x.  The mirror is
+ * rebuilt lazily after the matrix changes.
+ */
+class SparseMatrix
+{
+public:
+    SparseMatrix();
+    SparseMatrix(size_t rows, size_t cols);
+
+    /**
+     * Construct from a dense matrix, skipping elements whose absolute value
+     * does not exceed the drop tolerance.
+     */
+    explicit SparseMatrix(const Matrix& mx, double fDropTol = 0.0);
+    ~SparseMatrix() throw();
+
+    void swap(SparseMatrix& r) throw();
+
+    /**
+     * Remove all elements and set a new size.
+     */
+    void clear(size_t rows, size_t cols);
+
+    /**
+     * Add a value to an element.  Adding to the same element more than once
+     * accumulates the values.  It throws BadIndex if the element is outside
+     * the matrix.
+     */
+    void insert(size_t row, size_t col, double val);
+
+    /**
+     * Pre-allocate storage for the specified number of non-zero elements.
+     */
+    void reserve(size_t nNonZeros);
+
+    size_t rows() const;
+    size_t cols() const;
+
+    /**
+     * @return size_t number of stored elements
+     */
+    size_t nonZeros() const;
+
+    /**
+     * Query an element.  This takes O(log k) time where k is the number of
+     * stored elements in the column.
+     */
+    double getValue(size_t row, size_t col) const;
+
+    /**
+     * Keep a row-major copy of the matrix in addition to the column-major
+     * storage.  This doubles the memory footprint.
+     */
+    void setRowMirror(bool b);
+    bool hasRowMirror() const;
+
+    /**
+     * y = A x.  This uses the row mirror when it is enabled.
+     *
+     * @param x vector of size cols()
+     * @param y (reference) result vector of size rows()
+     */
+    void multiply(const ::std::vector<double>& x, ::std::vector<double>& y) const;
+
+    /**
+     * y = A^T x
+     *
+     * @param x vector of size rows()
+     * @param y (reference) result vector of size cols()
+     */
+    void multiplyTrans(const ::std::vector<double>& x, ::std::vector<double>& y) const;
+
+    /**
+     * Extract a column into a dense vector.
+     */
+    void getColumn(size_t col, ::std::vector<double>& dense) const;
+
+    /**
+     * Extract the stored elements of a column.
+     *
+     * @param col column index
+     * @param rowIds (reference) row indices in ascending order
+     * @param vals (reference) values corresponding to the row indices
+     */
+    void getColumn(size_t col, ::std::vector<size_t>& rowIds, ::std::vector<double>& vals) const;
+
+    /**
+     * Extract the stored elements of a row.  This is fast only when the row
+     * mirror is enabled; otherwise every column is searched.
+     */
+    void getRow(size_t row, ::std::vector<size_t>& colIds, ::std::vector<double>& vals) const;
+
+    const SparseMatrix trans() const;
+    const Matrix toMatrix() const;
+
+    void print(size_t prec = 2, size_t colspace = 1) const;
+
+private:
+    struct Triplet
+    {
+        size_t Row;
+        size_t Col;
+        double Value;
+
+        Triplet(size_t row, size_t col, double val);
+        bool operator<(const Triplet& r) const;
+    };
+
+    void compress() const;
+    void buildRowMirror() const;
+
+    size_t m_nRows;
+    size_t m_nCols;
+
+    // Elements inserted since the last compression.  Compression and the
+    // row mirror are caches of the logical content, hence mutable.
+    mutable ::std::vector<Triplet> m_aPending;
+
+    // CSC storage
+    mutable ::std::vector<size_t> m_aColPtr;
+    mutable ::std::vector<size_t> m_aRowIds;
+    mutable ::std::vector<double> m_aValues;
+
+    // optional CSR mirror
+    bool m_bRowMirror;
+    mutable bool m_bRowMirrorValid;
+    mutable ::std::vector<size_t> m_aRowPtr;
+    mutable ::std::vector<size_t> m_aColIds;
+    mutable ::std::vector<double> m_aRowValues;
+};
+
+// ----------------------------------------------------------------------------
+
+/**
+ * LU factorization of a square sparse matrix, P A Q = L U, with pivots
+ * chosen by the Markowitz criterion to limit fill-in.  Each pivot minimizes
+ * (r - 1)(c - 1), where r and c are the numbers of elements in its row and
+ * column of the active submatrix, among the candidates in the few sparsest
+ * columns whose magnitude is at least a given fraction of the largest
+ * element in their column (threshold pivoting).
+ */
+class SparseLU
+{
+public:
+    SparseLU();
+
+    /**
+     * Factorize a matrix upon construction.  See factorize().
+     */
+    explicit SparseLU(const SparseMatrix& mxA);
+    ~SparseLU() throw();
+
+    /**
+     * Set the pivot threshold u in (0, 1].  A candidate pivot a_ij must
+     * satisfy |a_ij| >= u max_k |a_kj|.  Smaller values favor sparsity,
+     * larger ones numerical stability.  The default is 0.1.
+     */
+    void setPivotThreshold(double u);
+
+    /**
+     * Factorize a square matrix.  It throws NonSquareMatrix if the matrix
+     * is not square, and SingularMatrix if the matrix is structurally or
+     * numerically singular.
+     */
+    void factorize(const SparseMatrix& mxA);
+
+    /**
+     * Solve A x = b, overwriting b with x.
+     */
+    void solve(::std::vector<double>& b) const;
+
+    /**
+     * Solve A^T x = b, overwriting b with x.
+     */
+    void solveTrans(::std::vector<double>& b) const;
+
+    size_t size() const;
+
+    /**
+     * @return size_t number of elements in L and U combined, including the
+     *         diagonal of U.
+     */
+    size_t nonZeros() const;
+
+private:
+    struct Entry
+    {
+        size_t Index;
+        double Value;
+
+        Entry(size_t index, double val);
+    };
+
+    typedef ::std::vector<Entry> EntryList;
+
+    size_t m_nSize;
+    double m_fThreshold;
+
+    /** row and column eliminated at each step. */
+    ::std::vector<size_t> m_aPivotRows;
+    ::std::vector<size_t> m_aPivotCols;
+    ::std::vector<double> m_aPivots;
+
+    /** multipliers of each step, indexed by original row. */
+    ::std::vector<EntryList> m_aLCols;
+
+    /** off-diagonal part of each pivot row, indexed by original column. */
+    ::std::vector<EntryList> m_aURows;
+};
+
+// ----------------------------------------------------------------------------
+
+/**
+ * Cholesky factorization P A P^T = L L^T of a symmetric positive definite
+ * sparse matrix, where P is a minimum degree ordering that limits fill-in.
+ * Only the elements on and below the diagonal of A are read.
+ *
+ * The ordering and the pattern of L depend only on the pattern of A.  They
+ * are computed by analyze(), after which factorize() can be called for any
+ * number of matrices with the same pattern but different values, which is
+ * what interior point methods need.
+ */
+class SparseCholesky
+{
+public:
+    SparseCholesky();
+    ~SparseCholesky() throw();
+
+    /**
+     * Set the tolerance for small pivots.  A pivot that does not exceed the
+     * tolerance times the largest diagonal element of A is replaced by a
+     * huge value, which effectively drops the corresponding row and column,
+     * and makes the corresponding solution component zero.  This is how
+     * interior point methods cope with normal equations that become
+     * singular near the optimum.  With the default tolerance of zero, a
+     * pivot that is not positive throws SingularMatrix.
+     */
+    void setPivotTolerance(double fTol);
+
+    /**
+     * Compute the ordering and the pattern of L.  It throws NonSquareMatrix
+     * if the matrix is not square.
+     */
+    void analyze(const SparseMatrix& mxA);
+
+    /**
+     * Factorize a matrix.  The matrix is analyzed first unless it has the
+     * same pattern as the last analyzed one.
+     */
+    void factorize(const SparseMatrix& mxA);
+
+    /**
+     * Solve A x = b, overwriting b with x.
+     */
+    void solve(::std::vector<double>& b) const;
+
+    size_t size() const;
+
+    /**
+     * @return size_t number of elements in L, including the diagonal.
+     */
+    size_t nonZeros() const;
+
+    /**
+     * @return size_t number of pivots replaced during the last
+     *         factorization.
+     */
+    size_t getSmallPivotCount() const;
+
+private:
+    void buildUpper(const SparseMatrix& mxA, ::std::vector<size_t>& rColPtr,
+                    ::std::vector<size_t>& rRowIds, ::std::vector<double>& rValues) const;
+    size_t reach(const ::std::vector<size_t>& rColPtr, const ::std::vector<size_t>& rRowIds,
+                 size_t k, ::std::vector<size_t>& rStack, ::std::vector<size_t>& rMark) const;
+
+    size_t m_nSize;
+    double m_fPivotTol;
+    size_t m_nSmallPivots;
+
+    /** m_aPerm[k] is the row of A that becomes row k of P A P^T. */
+    ::std::vector<size_t> m_aPerm;
+    ::std::vector<size_t> m_aPermInv;
+
+    /** pattern of the upper triangle of P A P^T of the analyzed matrix. */
+    ::std::vector<size_t> m_aUpperColPtr;
+    ::std::vector<size_t> m_aUpperRowIds;
+
+    /** elimination tree of P A P^T; the root's parent is m_nSize. */
+    ::std::vector<size_t> m_aParent;
+
+    // L in CSC format, with the diagonal element first in each column.
+    ::std::vector<size_t> m_aColPtr;
+    ::std::vector<size_t> m_aRowIds;
+    ::std::vector<double> m_aValues;
+};
+
+}}
+
+#endif
@@ -28,6 +28,14 @@ enum OptModelType
 	OPTMODELTYPE_NLP
 };
 
+enum OptLpAlgorithm
+{
+	OPTLPALGORITHM_SIMPLEX,
+	/** interior point, or the in-tree branch and bound for integer models. */
+	OPTLPALGORITHM_BUILTIN,
+	OPTLPALGORITHM_PORTFOLIO
+};
+
 struct OptionDataImpl;
 
 class OptionData
@@ -45,6 +53,9 @@ public:
 	void setModelType( OptModelType type );
 	OptModelType getModelType() const;
 
+	void setLpAlgorithm( OptLpAlgorithm algorithm );
+	OptLpAlgorithm getLpAlgorithm() const;
+
 private:
 	::std::auto_ptr<OptionDataImpl> m_pImpl;
 };
@@ -61,6 +61,9 @@ public:
     bool isVarInteger() const;
     void setVarInteger(bool b);
 
+    OptLpAlgorithm getLpAlgorithm() const;
+    void setLpAlgorithm( OptLpAlgorithm algorithm );
+
 private:
 	void initialize();
     void initOptionData();
@@ -63,6 +63,7 @@ namespace scsolver {
 
 class CalcInterface;
 class OptionData;
+class SolveModel;
 class SolverDialog;
 class StringResMgr;
 
@@ -159,6 +160,9 @@ private:
     ::std::auto_ptr<CalcInterface>  m_pCalc;
     ::std::auto_ptr<OptionData>     m_pOption;
     ::std::auto_ptr<StringResMgr>   m_pStringResMgr;
+
+    /** kept between solves, so that the LP engine can reuse its state. */
+    ::std::auto_ptr<SolveModel>     m_pSolveModel;
 };
 
 
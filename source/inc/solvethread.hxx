@@ -0,0 +1,144 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef _SCSOLVER_SOLVETHREAD_HXX_
+#define _SCSOLVER_SOLVETHREAD_HXX_
+
+#include <rtl/ref.hxx>
+#include <memory>
+
+namespace scsolver {
+
+namespace numeric {
+	class SolveControl;
+	struct SolveProgress;
+}
+
+class CalcInterface;
+class SolveThreadImpl;
+
+/**
+ * Function that a job has to run on the main thread, e.g. because it
+ * reads or writes cells.
+ */
+class MainThreadCall
+{
+public:
+	virtual ~MainThreadCall() throw() {}
+	virtual void execute() = 0;
+};
+
+/**
+ * Runs a MainThreadCall on the main thread on behalf of a job.
+ */
+class MainThreadCaller
+{
+public:
+	virtual ~MainThreadCaller() throw() {}
+
+	/**
+	 * Run the call on the main thread, and wait until it has returned.
+	 * It throws SolveCancelled if the call cannot be made because the
+	 * thread is being destroyed, or RuntimeError if the call has thrown.
+	 */
+	virtual void call( MainThreadCall& rCall ) = 0;
+};
+
+/**
+ * Numeric phase of a solve, which SolveThread runs on a worker thread.
+ * It must not touch the document or the dialogs other than through the
+ * MainThreadCaller.
+ */
+class SolveJob
+{
+public:
+	virtual ~SolveJob() throw() {}
+
+	/**
+	 * Solve the model.  Exceptions that escape are swallowed by the
+	 * thread, so the job records the outcome itself.
+	 *
+	 * @param rControl control of the solve, which the job passes on to
+	 *                 its algorithm
+	 * @param rCaller runs calls on the main thread
+	 */
+	virtual void run( numeric::SolveControl& rControl, MainThreadCaller& rCaller ) = 0;
+};
+
+/**
+ * Receives the events of a SolveThread, always on the main thread.
+ */
+class SolveThreadListener
+{
+public:
+	virtual ~SolveThreadListener() throw() {}
+
+	/** Latest progress of the running job. */
+	virtual void progress( const numeric::SolveProgress& rProgress ) = 0;
+
+	/** The job has ended, and is handed back. */
+	virtual void finished( ::std::auto_ptr<SolveJob> pJob ) = 0;
+};
+
+/**
+ * Runs a SolveJob on a worker thread, so that the office keeps handling
+ * its events while a model is solved.  The progress of the job, at most a
+ * few times per second, and its end are posted back to the main thread
+ * through the com.sun.star.awt.AsyncCallback service.  Without that
+ * service, the job runs on the main thread as before.
+ *
+ * The main thread never waits for the worker, since the worker itself may
+ * be waiting for the main thread, to post an event or to run a call.  If
+ * the object is destroyed while a job runs, the job is cancelled, the
+ * listener is not called any more, and the job is deleted once it has
+ * ended.
+ */
+class SolveThread
+{
+public:
+	SolveThread( CalcInterface* pCalc, SolveThreadListener* pListener );
+	~SolveThread() throw();
+
+	/**
+	 * Start a job.  Only one job runs at a time.
+	 *
+	 * @param pJob job to run, owned by the thread until it is handed back
+	 *             through SolveThreadListener::finished().
+	 */
+	void start( ::std::auto_ptr<SolveJob> pJob );
+
+	bool isRunning() const;
+
+	/** Ask the running job to stop. */
+	void cancel();
+
+	/**
+	 * @return SolveControl control passed to the jobs, on which to set
+	 *         their limits.
+	 */
+	numeric::SolveControl& getSolveControl() const;
+
+private:
+	SolveThread( const SolveThread& ); // disabled
+	SolveThread& operator=( const SolveThread& ); // disabled
+
+	::rtl::Reference<SolveThreadImpl> m_pImpl;
+};
+
+}
+
+#endif
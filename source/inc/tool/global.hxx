@@ -29,6 +29,9 @@
 
 #if !defined(SCSOLVER_UNITTEST)
 #include <osl/diagnose.h>
+#else
+#include <cassert>
+#define OSL_ASSERT(c) assert(c)
 #endif
 
 namespace scsolver { namespace numeric {
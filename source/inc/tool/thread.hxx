@@ -0,0 +1,136 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ * 
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef _SCSOLVER_THREAD_HXX_
+#define _SCSOLVER_THREAD_HXX_
+
+#include <memory>
+#include <cstddef>
+
+namespace scsolver {
+
+class MutexImpl;
+class ConditionImpl;
+class ThreadImpl;
+
+/**
+ * Lock protecting data that is shared between threads.
+ */
+class Mutex
+{
+public:
+	Mutex();
+	~Mutex() throw();
+
+	void acquire();
+	void release();
+
+private:
+	Mutex( const Mutex& ); // disabled
+	Mutex& operator=( const Mutex& ); // disabled
+
+	::std::auto_ptr<MutexImpl> m_pImpl;
+
+	friend class ConditionImpl;
+};
+
+/**
+ * Holds a mutex for the lifetime of the guard.
+ */
+class MutexGuard
+{
+public:
+	explicit MutexGuard( Mutex& rMutex );
+	~MutexGuard() throw();
+
+private:
+	MutexGuard( const MutexGuard& ); // disabled
+	MutexGuard& operator=( const MutexGuard& ); // disabled
+
+	Mutex& m_rMutex;
+};
+
+/**
+ * Condition variable, which lets a thread sleep until another thread
+ * changes the data protected by a mutex.
+ */
+class Condition
+{
+public:
+	Condition();
+	~Condition() throw();
+
+	/**
+	 * Release the mutex, which the caller must hold, wait until notified,
+	 * and acquire it again.  The wait may also end spuriously, so the
+	 * caller has to check its condition in a loop.
+	 */
+	void wait( Mutex& rMutex );
+
+	/** Wake up all threads waiting on the condition. */
+	void notifyAll();
+
+private:
+	Condition( const Condition& ); // disabled
+	Condition& operator=( const Condition& ); // disabled
+
+	::std::auto_ptr<ConditionImpl> m_pImpl;
+};
+
+/**
+ * Thread of execution running the run() method of a derived class.  A
+ * thread that has been started must be joined before it is destroyed.
+ * Exceptions must not escape from run().
+ */
+class Thread
+{
+public:
+	Thread();
+	virtual ~Thread() throw();
+
+	/**
+	 * Run run() in a new thread.
+	 *
+	 * @return bool false if no thread could be created, in which case
+	 *         run() has not been called.  The caller then has to do the
+	 *         work itself, and join() does nothing.
+	 */
+	bool start();
+
+	/** Wait until run() has returned. */
+	void join();
+
+	/**
+	 * @return size_t number of processors available, at least one.
+	 */
+	static size_t getProcessorCount();
+
+protected:
+	virtual void run() = 0;
+
+private:
+	Thread( const Thread& ); // disabled
+	Thread& operator=( const Thread& ); // disabled
+
+	::std::auto_ptr<ThreadImpl> m_pImpl;
+
+	friend class ThreadImpl;
+};
+
+}
+
+#endif
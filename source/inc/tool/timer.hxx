@@ -30,6 +30,11 @@ public:
 	void init();
 	bool isTimedOut() const;
 
+	/**
+	 * @return double seconds since the last call to init().
+	 */
+	double getElapsedTime() const;
+
 private:
 	Timer(); // disabled
 
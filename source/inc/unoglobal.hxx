@@ -37,6 +37,7 @@ struct Global
 {
 	static const rtl::OUString STRING_SEPARATOR;
 	static const rtl::OUString MODEL_METADATA_NAME;
+	static const rtl::OUString MODEL_BASIS_NAME;
 };
 
 
@@ -20,6 +20,7 @@
 #include "numeric/nlpmodel.hxx"
 #include "numeric/funcobj.hxx"
 #include "numeric/quadfitlinesearch.hxx"
+#include "numeric/solvecontrol.hxx"
 #include "numeric/type.hxx"
 
 #include <cmath>
@@ -75,6 +76,8 @@ void CyclicCoordinate::solve()
 
     Model& model = *getModel();
     model.print();
+    EvaluationGuard guard(*this);
+    const SolveControl& control = *getSolveControl();
     BaseFuncObj& F = *model.getFuncObject();
 
     vector<double> vars;
@@ -90,8 +93,10 @@ void CyclicCoordinate::solve()
     size_t varCount = vars.size();
     double dist = 0.0;
     vector<double> deltas(varCount);
-    for (size_t i = 0; i < m_maxIteration; ++i)
+    for (size_t i = 0; ; ++i)
     {
+        control.checkIteration(i, m_maxIteration);
+        control.reportIteration(i);
         if (m_debug)
             printf("ITERATION %d\n", i);
 
@@ -120,8 +125,6 @@ void CyclicCoordinate::solve()
 
         deltas = tmpVars;
     }
-
-    throw ModelInfeasible();
 }
 
 }}}
@@ -0,0 +1,468 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/decomposition.hxx"
+#include "numeric/matrix.hxx"
+
+#include <algorithm>
+#include <cmath>
+
+using ::std::vector;
+
+namespace scsolver { namespace numeric {
+
+const size_t CholeskyDecomposition::BLOCK_SIZE;
+
+CholeskyDecomposition::CholeskyDecomposition() :
+    m_nSize(0)
+{
+}
+
+CholeskyDecomposition::CholeskyDecomposition(const Matrix& mxA) :
+    m_nSize(0)
+{
+    factorize(mxA);
+}
+
+CholeskyDecomposition::~CholeskyDecomposition() throw()
+{
+}
+
+void CholeskyDecomposition::factorize(const Matrix& mxA)
+{
+    if (!mxA.isSquare())
+        throw NonSquareMatrix();
+
+    size_t n = mxA.rows();
+    m_nSize = n;
+    m_aData.assign(n*n, 0.0);
+    for (size_t j = 0; j < n; ++j)
+        for (size_t i = j; i < n; ++i)
+            at(i, j) = mxA(i, j);
+
+    // Right-looking blocked factorization.  Each panel is factorized
+    // left-looking within itself, then its outer product is subtracted from
+    // the trailing submatrix.
+    for (size_t k = 0; k < n; k += BLOCK_SIZE)
+    {
+        size_t nEnd = ::std::min(k + BLOCK_SIZE, n);
+        factorizePanel(k, nEnd);
+        updateTrailing(k, nEnd);
+    }
+}
+
+void CholeskyDecomposition::factorizePanel(size_t nColStart, size_t nColEnd)
+{
+    size_t n = m_nSize;
+    for (size_t j = nColStart; j < nColEnd; ++j)
+    {
+        double* pColJ = &m_aData[j*n];
+        for (size_t p = nColStart; p < j; ++p)
+        {
+            const double* pColP = &m_aData[p*n];
+            double fLjp = pColP[j];
+            for (size_t i = j; i < n; ++i)
+                pColJ[i] -= pColP[i]*fLjp;
+        }
+
+        double fDiag = pColJ[j];
+        if (fDiag <= 0.0)
+            throw MatrixNotPositiveDefinite();
+
+        fDiag = ::std::sqrt(fDiag);
+        pColJ[j] = fDiag;
+        for (size_t i = j + 1; i < n; ++i)
+            pColJ[i] /= fDiag;
+    }
+}
+
+void CholeskyDecomposition::updateTrailing(size_t nColStart, size_t nColEnd)
+{
+    size_t n = m_nSize;
+    for (size_t j = nColEnd; j < n; ++j)
+    {
+        double* pColJ = &m_aData[j*n];
+        for (size_t p = nColStart; p < nColEnd; ++p)
+        {
+            const double* pColP = &m_aData[p*n];
+            double fLjp = pColP[j];
+            if (fLjp == 0.0)
+                continue;
+            for (size_t i = j; i < n; ++i)
+                pColJ[i] -= pColP[i]*fLjp;
+        }
+    }
+}
+
+void CholeskyDecomposition::solveInPlace(Matrix& mxB) const
+{
+    size_t n = m_nSize;
+    if (mxB.rows() != n)
+        throw MatrixSizeMismatch();
+
+    vector<double> aCol(n);
+    for (size_t nRhs = 0; nRhs < mxB.cols(); ++nRhs)
+    {
+        for (size_t i = 0; i < n; ++i)
+            aCol[i] = mxB(i, nRhs);
+
+        // L y = b
+        for (size_t j = 0; j < n; ++j)
+        {
+            const double* pColJ = &m_aData[j*n];
+            double fY = aCol[j] / pColJ[j];
+            aCol[j] = fY;
+            for (size_t i = j + 1; i < n; ++i)
+                aCol[i] -= pColJ[i]*fY;
+        }
+
+        // L^T x = y
+        for (size_t j = n; j-- > 0; )
+        {
+            const double* pColJ = &m_aData[j*n];
+            double fSum = aCol[j];
+            for (size_t i = j + 1; i < n; ++i)
+                fSum -= pColJ[i]*aCol[i];
+            aCol[j] = fSum / pColJ[j];
+        }
+
+        for (size_t i = 0; i < n; ++i)
+            mxB(i, nRhs) = aCol[i];
+    }
+}
+
+const Matrix CholeskyDecomposition::solve(const Matrix& mxB) const
+{
+    Matrix mxX(mxB);
+    solveInPlace(mxX);
+    return mxX;
+}
+
+double CholeskyDecomposition::det() const
+{
+    double fDet = 1.0;
+    for (size_t i = 0; i < m_nSize; ++i)
+        fDet *= at(i, i);
+    return fDet*fDet;
+}
+
+const Matrix CholeskyDecomposition::getL() const
+{
+    Matrix mxL(m_nSize, m_nSize);
+    for (size_t j = 0; j < m_nSize; ++j)
+        for (size_t i = j; i < m_nSize; ++i)
+            mxL(i, j) = at(i, j);
+    return mxL;
+}
+
+size_t CholeskyDecomposition::size() const
+{
+    return m_nSize;
+}
+
+// ----------------------------------------------------------------------------
+
+const size_t QRDecomposition::BLOCK_SIZE;
+
+QRDecomposition::QRDecomposition() :
+    m_nRows(0), m_nCols(0)
+{
+}
+
+QRDecomposition::QRDecomposition(const Matrix& mxA) :
+    m_nRows(0), m_nCols(0)
+{
+    factorize(mxA);
+}
+
+QRDecomposition::~QRDecomposition() throw()
+{
+}
+
+void QRDecomposition::factorize(const Matrix& mxA)
+{
+    size_t m = mxA.rows(), n = mxA.cols();
+    if (m < n)
+        throw MatrixSizeMismatch();
+
+    m_nRows = m;
+    m_nCols = n;
+    m_aData.resize(m*n);
+    m_aTau.assign(n, 0.0);
+    for (size_t j = 0; j < n; ++j)
+        for (size_t i = 0; i < m; ++i)
+            at(i, j) = mxA(i, j);
+
+    // Each panel is factorized column by column.  Its reflectors are then
+    // accumulated into the compact WY form H_k ... H_{e-1} = I - V T V^T,
+    // and the trailing columns are updated with the block reflector.
+    vector<double> aT(BLOCK_SIZE*BLOCK_SIZE), aWork(BLOCK_SIZE);
+    for (size_t k = 0; k < n; k += BLOCK_SIZE)
+    {
+        size_t nEnd = ::std::min(k + BLOCK_SIZE, n);
+
+        // Factorize the panel, bringing each column up to date with the
+        // reflectors generated earlier in the same panel.
+        for (size_t j = k; j < nEnd; ++j)
+        {
+            double* pCol = &m_aData[j*m];
+            for (size_t p = k; p < j; ++p)
+                applyReflector(p, pCol);
+            makeReflector(j);
+        }
+
+        if (nEnd == n)
+            break;
+
+        makeBlockFactor(k, nEnd, aT);
+        for (size_t j = nEnd; j < n; ++j)
+            applyBlockReflector(k, nEnd, aT, &m_aData[j*m], aWork);
+    }
+}
+
+void QRDecomposition::makeReflector(size_t nCol)
+{
+    size_t m = m_nRows;
+    double* pCol = &m_aData[nCol*m];
+
+    // Scale by the largest element to avoid overflow in the norm.
+    double fMax = 0.0;
+    for (size_t i = nCol; i < m; ++i)
+        fMax = ::std::max(fMax, ::std::fabs(pCol[i]));
+
+    if (fMax == 0.0)
+    {
+        m_aTau[nCol] = 0.0;
+        return;
+    }
+
+    double fNorm = 0.0;
+    for (size_t i = nCol; i < m; ++i)
+    {
+        double f = pCol[i] / fMax;
+        fNorm += f*f;
+    }
+    fNorm = fMax*::std::sqrt(fNorm);
+
+    double fAlpha = pCol[nCol];
+    double fBeta = fAlpha >= 0.0 ? -fNorm : fNorm;
+
+    // H = I - tau v v^T with v(0) = 1 maps the column onto beta e_1.
+    double fScale = 1.0 / (fAlpha - fBeta);
+    for (size_t i = nCol + 1; i < m; ++i)
+        pCol[i] *= fScale;
+    pCol[nCol] = fBeta;
+    m_aTau[nCol] = (fBeta - fAlpha) / fBeta;
+}
+
+void QRDecomposition::applyReflector(size_t nRefl, double* pCol) const
+{
+    double fTau = m_aTau[nRefl];
+    if (fTau == 0.0)
+        return;
+
+    size_t m = m_nRows;
+    const double* pV = &m_aData[nRefl*m];
+    double fSum = pCol[nRefl];
+    for (size_t i = nRefl + 1; i < m; ++i)
+        fSum += pV[i]*pCol[i];
+
+    fSum *= fTau;
+    pCol[nRefl] -= fSum;
+    for (size_t i = nRefl + 1; i < m; ++i)
+        pCol[i] -= fSum*pV[i];
+}
+
+void QRDecomposition::makeBlockFactor(size_t nColStart, size_t nColEnd, vector<double>& aT) const
+{
+    // Column i of T is T(0:i, i) = -tau_i T(0:i, 0:i) V(:, 0:i)^T v_i, and
+    // T(i, i) = tau_i.  T is stored column-major with BLOCK_SIZE rows.
+    size_t m = m_nRows, nb = nColEnd - nColStart;
+    for (size_t i = 0; i < nb; ++i)
+    {
+        size_t nRefl = nColStart + i;
+        double fTau = m_aTau[nRefl];
+        double* pTi = &aT[i*BLOCK_SIZE];
+        const double* pVi = &m_aData[nRefl*m];
+
+        // v_j^T v_i, where v_i has an implicit 1 at row nRefl and zeros
+        // above it.
+        for (size_t j = 0; j < i; ++j)
+        {
+            const double* pVj = &m_aData[(nColStart + j)*m];
+            double fSum = pVj[nRefl];
+            for (size_t r = nRefl + 1; r < m; ++r)
+                fSum += pVj[r]*pVi[r];
+            pTi[j] = -fTau*fSum;
+        }
+
+        // Multiply by the upper triangular T(0:i, 0:i) in place, top down.
+        for (size_t j = 0; j < i; ++j)
+        {
+            double fSum = 0.0;
+            for (size_t p = j; p < i; ++p)
+                fSum += aT[p*BLOCK_SIZE + j]*pTi[p];
+            pTi[j] = fSum;
+        }
+        pTi[i] = fTau;
+    }
+}
+
+void QRDecomposition::applyBlockReflector(
+    size_t nColStart, size_t nColEnd, const vector<double>& aT, double* pCol,
+    vector<double>& aWork) const
+{
+    // (I - V T V^T)^T c = c - V (T^T (V^T c))
+    size_t m = m_nRows, nb = nColEnd - nColStart;
+    for (size_t p = 0; p < nb; ++p)
+    {
+        size_t nRefl = nColStart + p;
+        const double* pV = &m_aData[nRefl*m];
+        double fSum = pCol[nRefl];
+        for (size_t i = nRefl + 1; i < m; ++i)
+            fSum += pV[i]*pCol[i];
+        aWork[p] = fSum;
+    }
+
+    // T^T is lower triangular; go bottom up so that w can be overwritten.
+    for (size_t p = nb; p-- > 0; )
+    {
+        const double* pTp = &aT[p*BLOCK_SIZE];
+        double fSum = 0.0;
+        for (size_t q = 0; q <= p; ++q)
+            fSum += pTp[q]*aWork[q];
+        aWork[p] = fSum;
+    }
+
+    for (size_t p = 0; p < nb; ++p)
+    {
+        double fW = aWork[p];
+        if (fW == 0.0)
+            continue;
+        size_t nRefl = nColStart + p;
+        const double* pV = &m_aData[nRefl*m];
+        pCol[nRefl] -= fW;
+        for (size_t i = nRefl + 1; i < m; ++i)
+            pCol[i] -= fW*pV[i];
+    }
+}
+
+void QRDecomposition::applyQTrans(Matrix& mxB) const
+{
+    size_t m = m_nRows;
+    if (mxB.rows() != m)
+        throw MatrixSizeMismatch();
+
+    if (m == 0)
+        return;
+
+    vector<double> aCol(m);
+    for (size_t nRhs = 0; nRhs < mxB.cols(); ++nRhs)
+    {
+        for (size_t i = 0; i < m; ++i)
+            aCol[i] = mxB(i, nRhs);
+
+        for (size_t p = 0; p < m_nCols; ++p)
+            applyReflector(p, &aCol[0]);
+
+        for (size_t i = 0; i < m; ++i)
+            mxB(i, nRhs) = aCol[i];
+    }
+}
+
+const Matrix QRDecomposition::solve(const Matrix& mxB) const
+{
+    size_t m = m_nRows, n = m_nCols;
+    if (mxB.rows() != m)
+        throw MatrixSizeMismatch();
+
+    for (size_t j = 0; j < n; ++j)
+        if (at(j, j) == 0.0)
+            throw SingularMatrix();
+
+    Matrix mxX(n, mxB.cols());
+    if (m == 0)
+        return mxX;
+
+    vector<double> aCol(m);
+    for (size_t nRhs = 0; nRhs < mxB.cols(); ++nRhs)
+    {
+        for (size_t i = 0; i < m; ++i)
+            aCol[i] = mxB(i, nRhs);
+
+        for (size_t p = 0; p < n; ++p)
+            applyReflector(p, &aCol[0]);
+
+        // R x = (Q^T b)[0:n], column-oriented back substitution.
+        for (size_t j = n; j-- > 0; )
+        {
+            const double* pColJ = &m_aData[j*m];
+            double fX = aCol[j] / pColJ[j];
+            aCol[j] = fX;
+            for (size_t i = 0; i < j; ++i)
+                aCol[i] -= pColJ[i]*fX;
+        }
+
+        for (size_t i = 0; i < n; ++i)
+            mxX(i, nRhs) = aCol[i];
+    }
+    return mxX;
+}
+
+const Matrix QRDecomposition::getQ() const
+{
+    size_t m = m_nRows, n = m_nCols;
+    Matrix mxQ(m, n);
+    if (m == 0)
+        return mxQ;
+
+    vector<double> aCol(m);
+    for (size_t j = 0; j < n; ++j)
+    {
+        ::std::fill(aCol.begin(), aCol.end(), 0.0);
+        aCol[j] = 1.0;
+
+        // Q e_j = H_0 H_1 ... H_{n-1} e_j
+        for (size_t p = n; p-- > 0; )
+            applyReflector(p, &aCol[0]);
+
+        for (size_t i = 0; i < m; ++i)
+            mxQ(i, j) = aCol[i];
+    }
+    return mxQ;
+}
+
+const Matrix QRDecomposition::getR() const
+{
+    Matrix mxR(m_nCols, m_nCols);
+    for (size_t j = 0; j < m_nCols; ++j)
+        for (size_t i = 0; i <= j; ++i)
+            mxR(i, j) = at(i, j);
+    return mxR;
+}
+
+size_t QRDecomposition::rows() const
+{
+    return m_nRows;
+}
+
+size_t QRDecomposition::cols() const
+{
+    return m_nCols;
+}
+
+}}
@@ -0,0 +1,240 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/decomposition.hxx"
+#include "numeric/matrix.hxx"
+
+#include <cmath>
+#include <stdio.h>
+
+using namespace ::scsolver::numeric;
+
+class TestFailed {};
+
+namespace {
+
+/** Deterministic pseudo-random values in [-1, 1]. */
+double nextValue(unsigned long& seed)
+{
+    seed = (seed*1103515245UL + 12345UL) & 0x7fffffffUL;
+    return static_cast<double>(seed) / 0x3fffffff - 1.0;
+}
+
+double maxAbsDiff(const Matrix& mxA, const Matrix& mxB)
+{
+    if (mxA.rows() != mxB.rows() || mxA.cols() != mxB.cols())
+        throw TestFailed();
+
+    double fMax = 0.0;
+    for (size_t i = 0; i < mxA.rows(); ++i)
+        for (size_t j = 0; j < mxA.cols(); ++j)
+            fMax = ::std::max(fMax, ::std::fabs(mxA(i, j) - mxB(i, j)));
+    return fMax;
+}
+
+void check(bool bCond, const char* msg)
+{
+    if (!bCond)
+    {
+        printf("%s: failed\n", msg);
+        throw TestFailed();
+    }
+    printf("%s: passed\n", msg);
+}
+
+/**
+ * Build a symmetric positive definite matrix as B^T B + n I.
+ */
+const Matrix makeSPD(size_t n, unsigned long seed)
+{
+    Matrix mxB(n, n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+            mxB(i, j) = nextValue(seed);
+
+    Matrix mxA = mxB.trans() * mxB;
+    for (size_t i = 0; i < n; ++i)
+        mxA(i, i) += static_cast<double>(n);
+    return mxA;
+}
+
+void cholesky()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("Cholesky decomposition\n");
+
+    Matrix mxA(3, 3);
+    mxA(0, 0) =   4; mxA(0, 1) =  12; mxA(0, 2) = -16;
+    mxA(1, 0) =  12; mxA(1, 1) =  37; mxA(1, 2) = -43;
+    mxA(2, 0) = -16; mxA(2, 1) = -43; mxA(2, 2) =  98;
+
+    CholeskyDecomposition chol(mxA);
+    Matrix mxL = chol.getL();
+    mxL.print();
+    check(mxL(0, 0) == 2.0 && mxL(1, 0) == 6.0 && mxL(2, 0) == -8.0 &&
+          mxL(1, 1) == 1.0 && mxL(2, 1) == 5.0 && mxL(2, 2) == 3.0, "known factor");
+    check(::std::fabs(chol.det() - 36.0) < 1e-10, "determinant");
+
+    // Sizes straddling the block size exercise the trailing update.
+    size_t aSizes[] = { 1, 5, 31, 32, 33, 70 };
+    for (size_t k = 0; k < sizeof(aSizes)/sizeof(aSizes[0]); ++k)
+    {
+        size_t n = aSizes[k];
+        Matrix mxSPD = makeSPD(n, 17 + n);
+        chol.factorize(mxSPD);
+        Matrix mxLL = chol.getL() * chol.getL().trans();
+        printf("n = %lu  ", static_cast<unsigned long>(n));
+        check(maxAbsDiff(mxLL, mxSPD) < 1e-10*n, "L L^T = A");
+
+        Matrix mxX(n, 2);
+        unsigned long seed = n;
+        for (size_t i = 0; i < n; ++i)
+        {
+            mxX(i, 0) = nextValue(seed);
+            mxX(i, 1) = nextValue(seed);
+        }
+        Matrix mxB = mxSPD * mxX;
+        printf("n = %lu  ", static_cast<unsigned long>(n));
+        check(maxAbsDiff(chol.solve(mxB), mxX) < 1e-10, "solve");
+    }
+
+    Matrix mxIndef(2, 2);
+    mxIndef(0, 0) = 1; mxIndef(0, 1) = 2;
+    mxIndef(1, 0) = 2; mxIndef(1, 1) = 1;
+    bool bThrown = false;
+    try
+    {
+        chol.factorize(mxIndef);
+    }
+    catch (const MatrixNotPositiveDefinite&)
+    {
+        bThrown = true;
+    }
+    check(bThrown, "indefinite matrix rejected");
+
+    bThrown = false;
+    try
+    {
+        chol.factorize(Matrix(2, 3));
+    }
+    catch (const NonSquareMatrix&)
+    {
+        bThrown = true;
+    }
+    check(bThrown, "non-square matrix rejected");
+}
+
+void qr()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("QR decomposition\n");
+
+    size_t aRows[] = { 1, 4, 40, 75, 130 };
+    size_t aCols[] = { 1, 4, 33, 50, 100 };
+    for (size_t k = 0; k < sizeof(aRows)/sizeof(aRows[0]); ++k)
+    {
+        size_t m = aRows[k], n = aCols[k];
+        Matrix mxA(m, n);
+        unsigned long seed = 3 + m;
+        for (size_t i = 0; i < m; ++i)
+            for (size_t j = 0; j < n; ++j)
+                mxA(i, j) = nextValue(seed);
+
+        QRDecomposition qr(mxA);
+        Matrix mxQ = qr.getQ(), mxR = qr.getR();
+        printf("%lu x %lu  ", static_cast<unsigned long>(m), static_cast<unsigned long>(n));
+        check(maxAbsDiff(mxQ * mxR, mxA) < 1e-10, "Q R = A");
+        printf("%lu x %lu  ", static_cast<unsigned long>(m), static_cast<unsigned long>(n));
+        check(maxAbsDiff(mxQ.trans() * mxQ, Matrix(n, n, true)) < 1e-10, "Q^T Q = I");
+
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < i; ++j)
+                if (mxR(i, j) != 0.0)
+                    throw TestFailed();
+
+        // For a consistent system the least squares solution is exact.
+        Matrix mxX(n, 1);
+        for (size_t i = 0; i < n; ++i)
+            mxX(i, 0) = nextValue(seed);
+        printf("%lu x %lu  ", static_cast<unsigned long>(m), static_cast<unsigned long>(n));
+        check(maxAbsDiff(qr.solve(mxA * mxX), mxX) < 1e-9, "solve");
+    }
+
+    // Least squares line through (0, 1), (1, 2), (2, 2), (3, 4): the normal
+    // equations give y = 0.9 + 0.9 x.
+    Matrix mxA(4, 2), mxB(4, 1);
+    double aY[] = { 1, 2, 2, 4 };
+    for (size_t i = 0; i < 4; ++i)
+    {
+        mxA(i, 0) = 1.0;
+        mxA(i, 1) = static_cast<double>(i);
+        mxB(i, 0) = aY[i];
+    }
+    Matrix mxX = QRDecomposition(mxA).solve(mxB);
+    mxX.trans().print(5);
+    check(::std::fabs(mxX(0, 0) - 0.9) < 1e-12 && ::std::fabs(mxX(1, 0) - 0.9) < 1e-12,
+          "least squares line");
+
+    // Residual must be orthogonal to the column space.
+    Matrix mxRes = mxA * mxX - mxB;
+    check(maxAbsDiff(mxA.trans() * mxRes, Matrix(2, 1)) < 1e-12, "residual orthogonality");
+
+    Matrix mxRankDef(3, 2);
+    mxRankDef(0, 0) = 1; mxRankDef(1, 0) = 2; mxRankDef(2, 0) = 3;
+    bool bThrown = false;
+    try
+    {
+        QRDecomposition(mxRankDef).solve(Matrix(3, 1));
+    }
+    catch (const SingularMatrix&)
+    {
+        bThrown = true;
+    }
+    check(bThrown, "rank-deficient matrix rejected");
+
+    bThrown = false;
+    try
+    {
+        QRDecomposition qrWide(Matrix(2, 3));
+    }
+    catch (const MatrixSizeMismatch&)
+    {
+        bThrown = true;
+    }
+    check(bThrown, "wide matrix rejected");
+
+    // Empty factorizations only produce empty results.
+    QRDecomposition qrEmpty(Matrix(0, 0));
+    Matrix mxEmpty(0, 2);
+    qrEmpty.applyQTrans(mxEmpty);
+    check(qrEmpty.solve(Matrix(0, 2)).rows() == 0 && qrEmpty.getQ().rows() == 0
+          && mxEmpty.rows() == 0, "empty matrix");
+
+    QRDecomposition qrNoCols(Matrix(5, 0));
+    check(qrNoCols.solve(Matrix(5, 1)).rows() == 0 && qrNoCols.getQ().rows() == 5
+          && qrNoCols.getQ().cols() == 0, "matrix without columns");
+}
+
+}
+
+int main()
+{
+    printf("unit test: decomposition\n");
+    cholesky();
+    qr();
+    printf("Unit test passed!\n");
+}
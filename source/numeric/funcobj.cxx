@@ -215,6 +215,14 @@ double BaseFuncObj::operator()(const vector<double>& vars)
     return eval();
 }
 
+/**
+ * Function objects are not copied unless they say how.
+ */
+::std::auto_ptr<BaseFuncObj> BaseFuncObj::clone() const
+{
+    return ::std::auto_ptr<BaseFuncObj>();
+}
+
 /**
  * This function generates a new single-variable functor for the present
  * multivariable functor, allowing only the variable identified by \a varIndex
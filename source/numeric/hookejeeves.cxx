@@ -20,6 +20,7 @@
 #include "numeric/nlpmodel.hxx"
 #include "numeric/funcobj.hxx"
 #include "numeric/quadfitlinesearch.hxx"
+#include "numeric/solvecontrol.hxx"
 
 #include <cmath>
 #include <stdio.h>
@@ -95,6 +96,8 @@ void HookeJeeves::solve()
     bool debug = isDebug();
     Model& model = *getModel();
     model.print();
+    EvaluationGuard guard(*this);
+    const SolveControl& control = *getSolveControl();
     BaseFuncObj& F = *model.getFuncObject();
 
     vector<double> vars;
@@ -109,8 +112,10 @@ void HookeJeeves::solve()
     // Iterate cyclically along the axes.
     size_t varCount = vars.size();
     vector<double> prevVars(vars);
-    for (size_t i = 0; i < m_maxIteration; ++i)
+    for (size_t i = 0; ; ++i)
     {
+        control.checkIteration(i, m_maxIteration);
+        control.reportIteration(i);
         if (debug)
             printf("ITERATION %d\n", i);
 
@@ -152,8 +157,6 @@ void HookeJeeves::solve()
         
         prevVars = tmpVars2;
     }
-
-    throw ModelInfeasible();
 }
 
 }}}
@@ -18,6 +18,7 @@
 #include "numeric/lpbase.hxx"
 #include "numeric/lpmodel.hxx"
 #include "numeric/matrix.hxx"
+#include "numeric/solvecontrol.hxx"
 #include <list>
 #include <vector>
 #include <cstddef>
@@ -43,9 +44,21 @@ public:
 	Matrix getSolution() const { return m_mxSolution; }
 	void setSolution( const Matrix& );
 
+	const Basis& getStartBasis() const { return m_aStartBasis; }
+	void setStartBasis( const Basis& aBasis ) { m_aStartBasis = aBasis; }
+	const Basis& getBasis() const { return m_aBasis; }
+	void setBasis( const Basis& aBasis ) { m_aBasis = aBasis; }
+
+	SolveControl* getSolveControl() const { return m_pControl ? m_pControl : &m_aDefaultControl; }
+	void setSolveControl( SolveControl* p ) { m_pControl = p; }
+
 private:
 	Model* m_pModel;						// original model
 	Matrix m_mxSolution;
+	Basis m_aStartBasis;
+	Basis m_aBasis;
+	SolveControl* m_pControl;
+	mutable SolveControl m_aDefaultControl;
 
 	struct ConstDecVar
 	{
@@ -60,7 +73,8 @@ private:
 
 BaseAlgorithmImpl::BaseAlgorithmImpl() :
 	m_pModel( NULL ),
-	m_mxSolution( 0, 0 )
+	m_mxSolution( 0, 0 ),
+	m_pControl( NULL )
 {
 }
 
@@ -103,4 +117,91 @@ void BaseAlgorithm::setSolution( const Matrix& mx )
 	m_pImpl->setSolution( mx );
 }
 
+void BaseAlgorithm::setStartBasis( const Basis& aBasis )
+{
+	m_pImpl->setStartBasis( aBasis );
+}
+
+const Basis BaseAlgorithm::getStartBasis() const
+{
+	return m_pImpl->getStartBasis();
+}
+
+const Basis BaseAlgorithm::getBasis() const
+{
+	return m_pImpl->getBasis();
+}
+
+void BaseAlgorithm::setBasis( const Basis& aBasis )
+{
+	m_pImpl->setBasis( aBasis );
+}
+
+bool BaseAlgorithm::isOptimal() const
+{
+	return true;
+}
+
+void BaseAlgorithm::setSolveControl( SolveControl* p )
+{
+	m_pImpl->setSolveControl( p );
+}
+
+SolveControl* BaseAlgorithm::getSolveControl() const
+{
+	return m_pImpl->getSolveControl();
+}
+
+//---------------------------------------------------------------------------
+// Basis
+
+Basis::Basis()
+{
+}
+
+Basis::Basis( size_t nVarCount, size_t nRowCount ) :
+	m_aVarStatus( nVarCount, BASIS_LOWER ),
+	m_aRowStatus( nRowCount, BASIS_BASIC )
+{
+}
+
+Basis::~Basis() throw()
+{
+}
+
+bool Basis::empty() const
+{
+	return m_aVarStatus.empty() && m_aRowStatus.empty();
+}
+
+size_t Basis::getVarCount() const
+{
+	return m_aVarStatus.size();
+}
+
+size_t Basis::getRowCount() const
+{
+	return m_aRowStatus.size();
+}
+
+BasisStatus Basis::getVarStatus( size_t nVar ) const
+{
+	return m_aVarStatus.at( nVar );
+}
+
+void Basis::setVarStatus( size_t nVar, BasisStatus eStatus )
+{
+	m_aVarStatus.at( nVar ) = eStatus;
+}
+
+BasisStatus Basis::getRowStatus( size_t nRow ) const
+{
+	return m_aRowStatus.at( nRow );
+}
+
+void Basis::setRowStatus( size_t nRow, BasisStatus eStatus )
+{
+	m_aRowStatus.at( nRow ) = eStatus;
+}
+
 }}}
@@ -0,0 +1,1288 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/lpbranchbound.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/lpcuts.hxx"
+#include "numeric/lpheuristic.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/exception.hxx"
+#include "numeric/solvecontrol.hxx"
+#include "tool/thread.hxx"
+
+#include <vector>
+#include <list>
+#include <algorithm>
+#include <string>
+#include <limits>
+#include <cmath>
+#include <iostream>
+
+using ::std::vector;
+using ::std::list;
+using ::std::string;
+using ::std::cout;
+using ::std::endl;
+
+namespace scsolver { namespace numeric { namespace lp {
+
+namespace {
+
+const double INF = ::std::numeric_limits<double>::infinity();
+
+const size_t NO_VAR = static_cast<size_t>( -1 );
+
+/** distance from the nearest integer up to which a value is integral. */
+const double INTEGER_TOL = 1e-6;
+
+/** relative tolerance for comparing a bound against the incumbent. */
+const double CUTOFF_TOL = 1e-9;
+
+/** lower limit of each factor of the branching score. */
+const double SCORE_EPS = 1e-6;
+
+/** default number of rounds of cuts at the root. */
+const size_t DEFAULT_CUT_ROUNDS = 10;
+
+/** maximum number of cuts added to the LP per round. */
+const size_t MAX_CUTS_PER_ROUND = 50;
+
+/** relative bound improvement below which a round of cuts stalls. */
+const double CUT_MIN_PROGRESS = 1e-4;
+
+/** number of stalled rounds after which no more cuts are added. */
+const size_t MAX_CUT_STALLS = 3;
+
+/** default time budget of each heuristic run, in seconds. */
+const double DEFAULT_HEURISTIC_TIME = 2.0;
+
+/** number of nodes between two runs of RINS. */
+const size_t RINS_FREQUENCY = 50;
+
+const char* getHeuristicName( HeuristicType eType )
+{
+	switch ( eType )
+	{
+	case HEURISTIC_ROUNDING:
+		return "rounding";
+	case HEURISTIC_DIVING:
+		return "diving";
+	case HEURISTIC_FEASIBILITY_PUMP:
+		return "feasibility pump";
+	case HEURISTIC_RINS:
+		return "RINS";
+	}
+	return "";
+}
+
+/**
+ * Takes the progress listener off a solve control for the lifetime of the
+ * object, and puts it back on destruction.
+ */
+class ProgressListenerSwitch
+{
+public:
+	explicit ProgressListenerSwitch( SolveControl& rControl ) :
+		m_rControl( rControl ), m_pListener( rControl.getProgressListener() )
+	{
+		m_rControl.setProgressListener( NULL );
+	}
+
+	~ProgressListenerSwitch() throw()
+	{
+		m_rControl.setProgressListener( m_pListener );
+	}
+
+	SolveProgressListener* getListener() const { return m_pListener; }
+
+private:
+	ProgressListenerSwitch( const ProgressListenerSwitch& ); // disabled
+	ProgressListenerSwitch& operator=( const ProgressListenerSwitch& ); // disabled
+
+	SolveControl& m_rControl;
+	SolveProgressListener* m_pListener;
+};
+
+}
+
+//---------------------------------------------------------------------------
+// BranchAndBoundImpl
+
+/**
+ * Objective values are kept in the minimization sense throughout, i.e.
+ * negated for a maximization model.
+ *
+ * Worker 0 runs in the calling thread and uses m_pAlgorithm, the other
+ * workers run in threads of their own with algorithms from the factory,
+ * which are kept for the next solve.
+ */
+class BranchAndBoundImpl
+{
+public:
+	BranchAndBoundImpl( BranchAndBound* pSelf, ::std::auto_ptr<BaseAlgorithm> pAlgorithm );
+	BranchAndBoundImpl( BranchAndBound* pSelf, ::std::auto_ptr<AlgorithmFactory> pFactory );
+	~BranchAndBoundImpl() throw();
+
+	void solve();
+
+	/** entry point of each worker, in its own thread. */
+	void runWorker( size_t nWorker );
+
+	BaseAlgorithm* getAlgorithm() const { return m_pAlgorithm.get(); }
+
+	void setNodeSelection( NodeSelection e ) { m_eSelection = e; }
+	NodeSelection getNodeSelection() const { return m_eSelection; }
+	void setNodeLimit( size_t n ) { m_nNodeLimit = n; }
+	size_t getNodeCount() const { return m_nNodeCount; }
+	bool isOptimal() const { return m_bOptimal; }
+	void setThreadCount( size_t n ) { m_nThreadCount = n; }
+	size_t getThreadCount() const { return m_nThreadCount; }
+	void setParallelMode( ParallelMode e ) { m_eParallelMode = e; }
+	ParallelMode getParallelMode() const { return m_eParallelMode; }
+	void setCutRounds( size_t n ) { m_nCutRounds = n; }
+	size_t getCutRounds() const { return m_nCutRounds; }
+	size_t getCutCount() const { return m_nCutCount; }
+	void setHeuristicTimeLimit( double f ) { m_fHeuristicTimeLimit = f; }
+	double getHeuristicTimeLimit() const { return m_fHeuristicTimeLimit; }
+
+private:
+	struct BoundChange
+	{
+		size_t Var;
+		BoundType Type;
+		double Value;
+
+		BoundChange( size_t nVar, BoundType eType, double fValue ) :
+			Var( nVar ), Type( eType ), Value( fValue ) {}
+	};
+
+	/**
+	 * Open node of the search tree, described by the bounds tightened on
+	 * the way from the root.  Its bound is the objective value of its
+	 * parent.  The branching variable and the distance it was moved are
+	 * kept to update the pseudo-costs once the node is solved.
+	 */
+	struct Node
+	{
+		vector<BoundChange> Bounds;
+		Basis StartBasis;
+		double Bound;
+		size_t BranchVar;
+		bool Up;
+		double Distance;
+
+		Node() : Bound( -INF ), BranchVar( NO_VAR ), Up( false ), Distance( 0.0 ) {}
+	};
+
+	enum JobError
+	{
+		JOBERROR_NONE,
+		JOBERROR_MAX_ITERATION,
+		JOBERROR_TIMED_OUT,
+		JOBERROR_CANCELLED,
+		JOBERROR_OTHER
+	};
+
+	/**
+	 * Node being solved by a worker, and the result.  An exception cannot
+	 * leave a worker thread, so it is recorded here and thrown again by
+	 * the calling thread.
+	 */
+	struct Job
+	{
+		Node Input;
+		bool Feasible;
+		Matrix Solution;
+		Basis NodeBasis;
+		double Obj;
+		JobError Error;
+		string Message;
+
+		/** sequence number of the node, starting at one for the root. */
+		size_t Number;
+
+		/** true while a worker of the opportunistic search solves the node. */
+		bool Busy;
+
+		Job() : Feasible( false ), Solution( 0, 0 ), Obj( 0.0 ), Error( JOBERROR_NONE ), Number( 0 ),
+			Busy( false ) {}
+	};
+
+	BranchAndBound* m_pSelf;
+	::std::auto_ptr<BaseAlgorithm> m_pAlgorithm;
+	::std::auto_ptr<AlgorithmFactory> m_pFactory;
+	vector<BaseAlgorithm*> m_aWorkerAlgorithms;
+
+	NodeSelection m_eSelection;
+	size_t m_nNodeLimit;
+	size_t m_nNodeCount;
+	bool m_bOptimal;
+	bool m_bVerbose;
+	bool m_bInteger;
+	size_t m_nThreadCount;
+	ParallelMode m_eParallelMode;
+	size_t m_nCutRounds;
+	size_t m_nCutCount;
+
+	/** why the search stopped early on request of the solve control. */
+	JobError m_eStopReason;
+
+	/**
+	 * listener of the solve control, which only the search reports to
+	 * while it runs, not the node relaxations.
+	 */
+	SolveProgressListener* m_pListener;
+
+	/** model with the cuts added at the root, if any. */
+	::std::auto_ptr<Model> m_pCutModel;
+
+	double m_fHeuristicTimeLimit;
+
+	/** whether the heuristics run with their time budget, which only the
+		opportunistic search does. */
+	bool m_bTimedHeuristics;
+
+	double m_fSign;
+	vector<double> m_aCost;
+	bool m_bIntegralObjective;
+
+	bool m_bHasIncumbent;
+	double m_fIncumbent;
+	Matrix m_mxIncumbent;
+	Basis m_aIncumbentBasis;
+
+	/** pseudo-cost sums and counts, indexed by direction (0 down, 1 up). */
+	vector<double> m_aCostSum[2];
+	vector<size_t> m_aCostCount[2];
+	double m_fTotalSum[2];
+	size_t m_nTotalCount[2];
+
+	/** open nodes of the deterministic search. */
+	list<Node> m_aOpen;
+
+	/** open nodes of each worker in the opportunistic search. */
+	vector< list<Node> > m_aQueues;
+
+	vector<Job> m_aJobs;
+
+	/** protects the shared state while the opportunistic search runs. */
+	Mutex m_aMutex;
+	Condition m_aCondition;
+	size_t m_nBusyCount;
+	bool m_bStop;
+
+	BaseAlgorithm* getWorkerAlgorithm( size_t nWorker ) const;
+	const Model& getNodeModel() const;
+	void initObjective();
+	bool isCutOff( double fBound ) const;
+	bool isDepthFirst() const;
+	list<Node>::iterator selectNode( list<Node>& rOpen ) const;
+	bool takeNode( size_t nWorker, Node& rNode );
+	size_t getOpenCount() const;
+	bool solveNode( BaseAlgorithm& rAlgorithm, const Model& rModel, const Node& rNode,
+					Matrix& rSolution, Basis& rBasis, double& rObj ) const;
+	void solveJob( size_t nWorker );
+	void throwJobError( const Job& rJob ) const;
+	void stopSearch( JobError eReason );
+	bool isStopRequested();
+	void reportProgress() const;
+	double getPseudoCost( size_t nVar, bool bUp ) const;
+	void updatePseudoCost( const Node& rNode, double fObj );
+	size_t selectBranchVar( const Matrix& mxSolution ) const;
+	void branch( const Node& rNode, const Matrix& mxSolution, const Basis& rBasis,
+				 double fObj, size_t nVar, list<Node>& rOpen );
+	void setIncumbent( double fObj, const Matrix& mxSolution, const Basis& rBasis );
+	void runHeuristics( BaseAlgorithm& rAlgorithm, const Job& rJob, bool bUnlock );
+	void processNode( BaseAlgorithm& rAlgorithm, Job& rJob, list<Node>& rOpen, bool bUnlock );
+	void addRootCuts( Basis& rBasis );
+	const Basis getModelBasis( const Basis& rBasis ) const;
+	void runWorkers( size_t nCount );
+	void searchDeterministic( size_t nThreads );
+	void searchOpportunistic( size_t nThreads );
+	void search( size_t nWorker );
+};
+
+/**
+ * Thread running one worker of the search.
+ */
+class BranchAndBoundWorker : public ::scsolver::Thread
+{
+public:
+	BranchAndBoundWorker( BranchAndBoundImpl* pImpl, size_t nWorker ) :
+		m_pImpl( pImpl ), m_nWorker( nWorker )
+	{
+	}
+
+protected:
+	virtual void run()
+	{
+		m_pImpl->runWorker( m_nWorker );
+	}
+
+private:
+	BranchAndBoundImpl* m_pImpl;
+	size_t m_nWorker;
+};
+
+BranchAndBoundImpl::BranchAndBoundImpl( BranchAndBound* pSelf, ::std::auto_ptr<BaseAlgorithm> pAlgorithm ) :
+	m_pSelf( pSelf ), m_pAlgorithm( pAlgorithm ),
+	m_eSelection( NODESEL_HYBRID ), m_nNodeLimit( 0 ), m_nNodeCount( 0 ),
+	m_bOptimal( false ), m_bVerbose( false ), m_bInteger( false ),
+	m_nThreadCount( 1 ), m_eParallelMode( PARALLEL_DETERMINISTIC ),
+	m_nCutRounds( DEFAULT_CUT_ROUNDS ), m_nCutCount( 0 ), m_eStopReason( JOBERROR_NONE ), m_pListener( NULL ),
+	m_fHeuristicTimeLimit( DEFAULT_HEURISTIC_TIME ), m_bTimedHeuristics( false ),
+	m_fSign( 1.0 ), m_bIntegralObjective( false ),
+	m_bHasIncumbent( false ), m_fIncumbent( INF ), m_mxIncumbent( 0, 0 ),
+	m_nBusyCount( 0 ), m_bStop( false )
+{
+}
+
+BranchAndBoundImpl::BranchAndBoundImpl( BranchAndBound* pSelf, ::std::auto_ptr<AlgorithmFactory> pFactory ) :
+	m_pSelf( pSelf ), m_pAlgorithm( pFactory->create() ), m_pFactory( pFactory ),
+	m_eSelection( NODESEL_HYBRID ), m_nNodeLimit( 0 ), m_nNodeCount( 0 ),
+	m_bOptimal( false ), m_bVerbose( false ), m_bInteger( false ),
+	m_nThreadCount( 1 ), m_eParallelMode( PARALLEL_DETERMINISTIC ),
+	m_nCutRounds( DEFAULT_CUT_ROUNDS ), m_nCutCount( 0 ), m_eStopReason( JOBERROR_NONE ), m_pListener( NULL ),
+	m_fHeuristicTimeLimit( DEFAULT_HEURISTIC_TIME ), m_bTimedHeuristics( false ),
+	m_fSign( 1.0 ), m_bIntegralObjective( false ),
+	m_bHasIncumbent( false ), m_fIncumbent( INF ), m_mxIncumbent( 0, 0 ),
+	m_nBusyCount( 0 ), m_bStop( false )
+{
+}
+
+BranchAndBoundImpl::~BranchAndBoundImpl() throw()
+{
+	for ( size_t i = 0; i < m_aWorkerAlgorithms.size(); ++i )
+		delete m_aWorkerAlgorithms[i];
+}
+
+BaseAlgorithm* BranchAndBoundImpl::getWorkerAlgorithm( size_t nWorker ) const
+{
+	return nWorker == 0 ? m_pAlgorithm.get() : m_aWorkerAlgorithms.at( nWorker - 1 );
+}
+
+const Model& BranchAndBoundImpl::getNodeModel() const
+{
+	return m_pCutModel.get() ? *m_pCutModel : *m_pSelf->getModel();
+}
+
+void BranchAndBoundImpl::initObjective()
+{
+	Model* pModel = m_pSelf->getModel();
+	m_fSign = pModel->getGoal() == GOAL_MAXIMIZE ? -1.0 : 1.0;
+
+	Matrix mxC = pModel->getCostVector();
+	m_aCost.assign( mxC.cols(), 0.0 );
+	m_bIntegralObjective = pModel->getVarInteger();
+	for ( size_t j = 0; j < mxC.cols(); ++j )
+	{
+		m_aCost[j] = m_fSign*mxC( 0, j );
+		if ( m_aCost[j] != ::std::floor( m_aCost[j] ) )
+			m_bIntegralObjective = false;
+	}
+}
+
+/**
+ * A node can be discarded when its bound shows that it cannot improve on
+ * the incumbent.  With integer costs on integer variables, the objective
+ * values are integers, so an improvement is at least one.
+ */
+bool BranchAndBoundImpl::isCutOff( double fBound ) const
+{
+	if ( !m_bHasIncumbent )
+		return false;
+
+	double fTol = CUTOFF_TOL*( 1.0 + ::std::fabs( m_fIncumbent ) );
+	double fMinImprovement = m_bIntegralObjective ? 1.0 - fTol : fTol;
+	return fBound > m_fIncumbent - fMinImprovement;
+}
+
+bool BranchAndBoundImpl::isDepthFirst() const
+{
+	return m_eSelection == NODESEL_DEPTH_FIRST ||
+		( m_eSelection == NODESEL_HYBRID && !m_bHasIncumbent );
+}
+
+list<BranchAndBoundImpl::Node>::iterator BranchAndBoundImpl::selectNode( list<Node>& rOpen ) const
+{
+	list<Node>::iterator itrBest = --rOpen.end();
+	if ( isDepthFirst() )
+		return itrBest;
+
+	// Among equal bounds, the most recent node is preferred.
+	list<Node>::iterator itr = rOpen.begin(), itrEnd = rOpen.end();
+	for ( ; itr != itrEnd; ++itr )
+		if ( itr->Bound < itrBest->Bound )
+			itrBest = itr;
+	return itrBest;
+}
+
+/**
+ * Take the next node of a worker in the opportunistic search.  A worker
+ * whose queue is empty steals from the longest queue, taking its oldest
+ * node in depth first search, which is the closest to the root and so
+ * has the most work left below it.
+ *
+ * @return bool false if all queues are empty.
+ */
+bool BranchAndBoundImpl::takeNode( size_t nWorker, Node& rNode )
+{
+	size_t nQueue = nWorker;
+	if ( m_aQueues[nWorker].empty() )
+		for ( size_t i = 0; i < m_aQueues.size(); ++i )
+			if ( m_aQueues[i].size() > m_aQueues[nQueue].size() )
+				nQueue = i;
+
+	list<Node>& rOpen = m_aQueues[nQueue];
+	if ( rOpen.empty() )
+		return false;
+
+	list<Node>::iterator itr = nQueue != nWorker && isDepthFirst() ? rOpen.begin() : selectNode( rOpen );
+	rNode = *itr;
+	rOpen.erase( itr );
+	return true;
+}
+
+size_t BranchAndBoundImpl::getOpenCount() const
+{
+	size_t nCount = m_aOpen.size();
+	for ( size_t i = 0; i < m_aQueues.size(); ++i )
+		nCount += m_aQueues[i].size();
+	return nCount;
+}
+
+/**
+ * Solve the relaxation of a node, starting from the basis of its parent.
+ * The integer flag is cleared on the node copy, since an engine such as
+ * LpSolve would otherwise branch on its own and solve each node as a MIP.
+ * Only reads the shared state, so that workers can call it concurrently.
+ *
+ * @return bool false if the relaxation is infeasible.
+ */
+bool BranchAndBoundImpl::solveNode( BaseAlgorithm& rAlgorithm, const Model& rModel, const Node& rNode,
+									Matrix& rSolution, Basis& rBasis, double& rObj ) const
+{
+	Model aModel( rModel );
+	aModel.setVarInteger( false );
+	vector<BoundChange>::const_iterator itr = rNode.Bounds.begin(), itrEnd = rNode.Bounds.end();
+	for ( ; itr != itrEnd; ++itr )
+		aModel.setVarBound( itr->Var, itr->Type, itr->Value );
+
+	rAlgorithm.setModel( &aModel );
+	rAlgorithm.setStartBasis( rNode.StartBasis );
+	try
+	{
+		rAlgorithm.solve();
+	}
+	catch ( const ModelInfeasible& )
+	{
+		rAlgorithm.setModel( NULL );
+		return false;
+	}
+	catch ( ... )
+	{
+		rAlgorithm.setModel( NULL );
+		throw;
+	}
+	rAlgorithm.setModel( NULL );
+
+	rSolution = rAlgorithm.getSolution();
+	rBasis = rAlgorithm.getBasis();
+	rObj = 0.0;
+	for ( size_t j = 0; j < m_aCost.size() && j < rSolution.rows(); ++j )
+		rObj += m_aCost[j]*rSolution( j, 0 );
+	return true;
+}
+
+void BranchAndBoundImpl::solveJob( size_t nWorker )
+{
+	Job& rJob = m_aJobs[nWorker];
+	rJob.Error = JOBERROR_NONE;
+	try
+	{
+		rJob.Feasible = solveNode( *getWorkerAlgorithm( nWorker ), getNodeModel(), rJob.Input,
+								   rJob.Solution, rJob.NodeBasis, rJob.Obj );
+	}
+	catch ( const MaxIterationReached& )
+	{
+		rJob.Error = JOBERROR_MAX_ITERATION;
+	}
+	catch ( const IterationTimedOut& )
+	{
+		rJob.Error = JOBERROR_TIMED_OUT;
+	}
+	catch ( const SolveCancelled& )
+	{
+		rJob.Error = JOBERROR_CANCELLED;
+	}
+	catch ( const ::std::exception& e )
+	{
+		rJob.Error = JOBERROR_OTHER;
+		rJob.Message = e.what();
+	}
+}
+
+void BranchAndBoundImpl::throwJobError( const Job& rJob ) const
+{
+	if ( rJob.Error == JOBERROR_MAX_ITERATION )
+		throw MaxIterationReached();
+	throw Exception( rJob.Message );
+}
+
+/**
+ * End the search early, the way the node limit does, because the solve
+ * control ran out of time or was cancelled.  The incumbent, if any, is
+ * still returned.
+ */
+void BranchAndBoundImpl::stopSearch( JobError eReason )
+{
+	m_eStopReason = eReason;
+	m_bOptimal = false;
+}
+
+/**
+ * @return bool true if the solve control asks the search to stop.
+ */
+bool BranchAndBoundImpl::isStopRequested()
+{
+	const SolveControl* pControl = m_pSelf->getSolveControl();
+	if ( pControl->isCancelled() )
+		stopSearch( JOBERROR_CANCELLED );
+	else if ( pControl->isTimedOut() )
+		stopSearch( JOBERROR_TIMED_OUT );
+	return m_eStopReason != JOBERROR_NONE;
+}
+
+/**
+ * Report the node count, the incumbent, and its gap to the best bound of
+ * the open nodes and the nodes being solved.  The opportunistic search
+ * calls it with the mutex held.
+ */
+void BranchAndBoundImpl::reportProgress() const
+{
+	if ( !m_pListener )
+		return;
+
+	SolveProgress aProgress;
+	aProgress.Node = m_nNodeCount;
+	if ( m_bHasIncumbent )
+	{
+		double fBound = m_fIncumbent;
+		for ( list<Node>::const_iterator itr = m_aOpen.begin(); itr != m_aOpen.end(); ++itr )
+			fBound = ::std::min( fBound, itr->Bound );
+		for ( size_t i = 0; i < m_aQueues.size(); ++i )
+			for ( list<Node>::const_iterator itr = m_aQueues[i].begin(); itr != m_aQueues[i].end(); ++itr )
+				fBound = ::std::min( fBound, itr->Bound );
+		for ( size_t i = 0; i < m_aJobs.size(); ++i )
+			if ( m_aJobs[i].Busy )
+				fBound = ::std::min( fBound, m_aJobs[i].Input.Bound );
+
+		aProgress.Objective = m_fSign*m_fIncumbent;
+		aProgress.HasObjective = true;
+		aProgress.HasGap = fBound > -INF;
+		if ( aProgress.HasGap )
+			aProgress.Gap = ( m_fIncumbent - fBound )/( 1.0 + ::std::fabs( m_fIncumbent ) );
+	}
+	m_pListener->progress( aProgress );
+}
+
+/**
+ * @return double average degradation per unit in the given direction, or
+ *         the average over all variables if this one has no history yet.
+ */
+double BranchAndBoundImpl::getPseudoCost( size_t nVar, bool bUp ) const
+{
+	size_t nDir = bUp ? 1 : 0;
+	if ( m_aCostCount[nDir][nVar] > 0 )
+		return m_aCostSum[nDir][nVar]/m_aCostCount[nDir][nVar];
+	if ( m_nTotalCount[nDir] > 0 )
+		return m_fTotalSum[nDir]/m_nTotalCount[nDir];
+	return 1.0;
+}
+
+void BranchAndBoundImpl::updatePseudoCost( const Node& rNode, double fObj )
+{
+	if ( rNode.BranchVar == NO_VAR )
+		return;
+
+	size_t nDir = rNode.Up ? 1 : 0;
+	double fCost = ::std::max( fObj - rNode.Bound, 0.0 )/rNode.Distance;
+	m_aCostSum[nDir][rNode.BranchVar] += fCost;
+	++m_aCostCount[nDir][rNode.BranchVar];
+	m_fTotalSum[nDir] += fCost;
+	++m_nTotalCount[nDir];
+}
+
+/**
+ * Pick the fractional variable whose estimated degradation is largest in
+ * both directions, measured by the product of the two estimates.
+ *
+ * @return size_t variable to branch on, or NO_VAR if the solution is
+ *         integral.
+ */
+size_t BranchAndBoundImpl::selectBranchVar( const Matrix& mxSolution ) const
+{
+	size_t nBest = NO_VAR;
+	double fBestScore = 0.0;
+	for ( size_t j = 0; j < mxSolution.rows(); ++j )
+	{
+		double fVal = mxSolution( j, 0 );
+		double fFrac = fVal - ::std::floor( fVal );
+		if ( fFrac <= INTEGER_TOL || fFrac >= 1.0 - INTEGER_TOL )
+			continue;
+
+		double fScore = ::std::max( getPseudoCost( j, false )*fFrac, SCORE_EPS )*
+			::std::max( getPseudoCost( j, true )*( 1.0 - fFrac ), SCORE_EPS );
+		if ( nBest == NO_VAR || fScore > fBestScore )
+		{
+			nBest = j;
+			fBestScore = fScore;
+		}
+	}
+	return nBest;
+}
+
+void BranchAndBoundImpl::branch( const Node& rNode, const Matrix& mxSolution, const Basis& rBasis,
+								 double fObj, size_t nVar, list<Node>& rOpen )
+{
+	double fVal = mxSolution( nVar, 0 ), fFloor = ::std::floor( fVal );
+
+	Node aDown;
+	aDown.Bounds = rNode.Bounds;
+	aDown.Bounds.push_back( BoundChange( nVar, BOUND_UPPER, fFloor ) );
+	aDown.StartBasis = rBasis;
+	aDown.Bound = fObj;
+	aDown.BranchVar = nVar;
+	aDown.Up = false;
+	aDown.Distance = fVal - fFloor;
+
+	Node aUp( aDown );
+	aUp.Bounds.back() = BoundChange( nVar, BOUND_LOWER, fFloor + 1.0 );
+	aUp.Up = true;
+	aUp.Distance = fFloor + 1.0 - fVal;
+
+	// Depth first search continues with the last node, which is the child
+	// in the direction the value would be rounded to.
+	if ( aDown.Distance > 0.5 )
+	{
+		rOpen.push_back( aDown );
+		rOpen.push_back( aUp );
+	}
+	else
+	{
+		rOpen.push_back( aUp );
+		rOpen.push_back( aDown );
+	}
+}
+
+void BranchAndBoundImpl::setIncumbent( double fObj, const Matrix& mxSolution, const Basis& rBasis )
+{
+	m_bHasIncumbent = true;
+	m_fIncumbent = fObj;
+	m_mxIncumbent = mxSolution;
+	m_aIncumbentBasis = rBasis;
+}
+
+/**
+ * Look for a better incumbent around the fractional solution of a node.
+ * All heuristics run at the root, rounding at every node, and RINS every
+ * few nodes once there is an incumbent to start from.  In the
+ * deterministic search, the runs are only bounded by the work limits of
+ * the heuristics, not by their time budget, so that the solutions found
+ * do not depend on the speed of the machine.
+ *
+ * @param bUnlock true if the caller holds the mutex, which is then
+ *                released while the heuristics run, so that the other
+ *                workers are not held up
+ */
+void BranchAndBoundImpl::runHeuristics( BaseAlgorithm& rAlgorithm, const Job& rJob, bool bUnlock )
+{
+	if ( m_fHeuristicTimeLimit <= 0.0 )
+		return;
+
+	vector<HeuristicType> aTypes;
+	if ( rJob.Input.Bounds.empty() )
+	{
+		aTypes.push_back( HEURISTIC_ROUNDING );
+		aTypes.push_back( HEURISTIC_DIVING );
+		aTypes.push_back( HEURISTIC_FEASIBILITY_PUMP );
+		aTypes.push_back( HEURISTIC_RINS );
+	}
+	else
+	{
+		aTypes.push_back( HEURISTIC_ROUNDING );
+		if ( rJob.Number % RINS_FREQUENCY == 0 )
+			aTypes.push_back( HEURISTIC_RINS );
+	}
+
+	PrimalHeuristics aHeuristics;
+	aHeuristics.setTimeLimit( m_bTimedHeuristics ? m_fHeuristicTimeLimit : 0.0 );
+	Matrix mxIncumbent( m_bHasIncumbent ? m_mxIncumbent : Matrix( 0, 0 ) );
+	vector<HeuristicType> aFoundTypes;
+	vector<Matrix> aFound;
+
+	if ( bUnlock )
+		m_aMutex.release();
+	try
+	{
+		for ( size_t k = 0; k < aTypes.size(); ++k )
+		{
+			if ( !aHeuristics.run( aTypes[k], rAlgorithm, getNodeModel(), rJob.Solution,
+								   rJob.NodeBasis, mxIncumbent ) )
+				continue;
+
+			// Each heuristic has to improve on what the previous ones found.
+			mxIncumbent = aHeuristics.getSolution();
+			aFoundTypes.push_back( aTypes[k] );
+			aFound.push_back( mxIncumbent );
+		}
+	}
+	catch ( const IterationTimedOut& )
+	{
+		// The search stops before the next node.
+	}
+	catch ( const SolveCancelled& )
+	{
+	}
+	catch ( ... )
+	{
+		if ( bUnlock )
+			m_aMutex.acquire();
+		throw;
+	}
+	if ( bUnlock )
+		m_aMutex.acquire();
+
+	for ( size_t k = 0; k < aFound.size(); ++k )
+	{
+		const Matrix& mxFound = aFound[k];
+		double fObj = 0.0;
+		for ( size_t j = 0; j < m_aCost.size() && j < mxFound.rows(); ++j )
+			fObj += m_aCost[j]*mxFound( j, 0 );
+		if ( isCutOff( fObj ) )
+			continue;
+
+		// The solution has no basis of its own; the one of the node
+		// relaxation still makes a good start basis for the next solve.
+		setIncumbent( fObj, mxFound, rJob.NodeBasis );
+		if ( m_bVerbose )
+			cout << "heuristic " << getHeuristicName( aFoundTypes[k] ) << " at node " << rJob.Number
+				 << ": incumbent " << m_fSign*fObj << endl;
+	}
+}
+
+/**
+ * Take in the solution of a node: branch on it, or make it the new
+ * incumbent if it is integral.  The heuristics run before branching, as
+ * an incumbent they find may cut off the node itself.
+ */
+void BranchAndBoundImpl::processNode( BaseAlgorithm& rAlgorithm, Job& rJob, list<Node>& rOpen, bool bUnlock )
+{
+	const Node& rNode = rJob.Input;
+	Matrix& mxSolution = rJob.Solution;
+	double fObj = rJob.Obj;
+	updatePseudoCost( rNode, fObj );
+	if ( isCutOff( fObj ) )
+		return;
+
+	size_t nVar = m_bInteger ? selectBranchVar( mxSolution ) : NO_VAR;
+	if ( nVar != NO_VAR )
+	{
+		runHeuristics( rAlgorithm, rJob, bUnlock );
+		if ( !isCutOff( fObj ) )
+			branch( rNode, mxSolution, rJob.NodeBasis, fObj, nVar, rOpen );
+		return;
+	}
+
+	if ( m_bInteger )
+		for ( size_t j = 0; j < mxSolution.rows(); ++j )
+			mxSolution( j, 0 ) = ::std::floor( mxSolution( j, 0 ) + 0.5 );
+	setIncumbent( fObj, mxSolution, rJob.NodeBasis );
+	if ( m_bVerbose )
+		cout << "node " << rJob.Number << ": incumbent " << m_fSign*fObj
+			 << ", " << getOpenCount() << " open node(s)" << endl;
+}
+
+/**
+ * Tighten the relaxation with rounds of cuts before the search starts.
+ * Each round solves the relaxation with the active cuts and activates the
+ * most efficacious of the new cuts it violates.  The rows of the cuts that
+ * stay in the LP keep their basis status, and new rows start basic, so
+ * each round is a warm start.  The rounds end when the relaxation is
+ * integral or infeasible, no violated cut is left, or the bound has
+ * stalled for a few rounds.
+ *
+ * @param rBasis (reference) start basis of the root, for the model with
+ *               the cuts on return
+ */
+void BranchAndBoundImpl::addRootCuts( Basis& rBasis )
+{
+	const Model& rModel = *m_pSelf->getModel();
+	size_t nVarCount = m_aCostSum[0].size(), nRowCount = rModel.getConstraintCount();
+
+	CutGenerator aGenerator;
+	CutPool aPool;
+	::std::auto_ptr<Model> pModel( new Model( rModel ) );
+	vector<size_t> aRowIds;
+	Basis aBasis( rBasis );
+	double fPrevObj = -INF;
+	size_t nStalls = 0;
+	for ( size_t nRound = 0; nRound < m_nCutRounds; ++nRound )
+	{
+		Node aRoot;
+		aRoot.StartBasis = aBasis;
+		Matrix mxSolution( 0, 0 );
+		double fObj;
+		try
+		{
+			if ( !solveNode( *m_pAlgorithm, *pModel, aRoot, mxSolution, aBasis, fObj ) )
+				break;
+		}
+		catch ( const IterationTimedOut& )
+		{
+			// The search stops before the root, so the basis does not matter.
+			break;
+		}
+		catch ( const SolveCancelled& )
+		{
+			break;
+		}
+		if ( selectBranchVar( mxSolution ) == NO_VAR )
+			break;
+
+		if ( fObj - fPrevObj < CUT_MIN_PROGRESS*( 1.0 + ::std::fabs( fObj ) ) )
+		{
+			if ( ++nStalls >= MAX_CUT_STALLS )
+				break;
+		}
+		else
+			nStalls = 0;
+		fPrevObj = fObj;
+
+		vector<Cut> aCuts;
+		aGenerator.generate( *pModel, mxSolution, aBasis, aCuts );
+		for ( size_t k = 0; k < aCuts.size(); ++k )
+			aPool.add( aCuts[k] );
+		aPool.update( mxSolution );
+		if ( aPool.separate( mxSolution, MAX_CUTS_PER_ROUND ) == 0 )
+			break;
+
+		vector<size_t> aActive;
+		aPool.getActive( aActive );
+		::std::auto_ptr<Model> pNext( new Model( rModel ) );
+		bool bWarm = aBasis.getVarCount() == nVarCount && aBasis.getRowCount() == nRowCount + aRowIds.size();
+		Basis aNextBasis( nVarCount, nRowCount + aActive.size() );
+		for ( size_t j = 0; j < nVarCount && bWarm; ++j )
+			aNextBasis.setVarStatus( j, aBasis.getVarStatus( j ) );
+		for ( size_t i = 0; i < nRowCount && bWarm; ++i )
+			aNextBasis.setRowStatus( i, aBasis.getRowStatus( i ) );
+		for ( size_t k = 0; k < aActive.size(); ++k )
+		{
+			const Cut& rCut = aPool.getCut( aActive[k] );
+			vector<double> aCoef( rCut.getCoefficients() );
+			aCoef.resize( nVarCount, 0.0 );
+			pNext->addConstraint( aCoef, LESS_EQUAL, rCut.getRhs() );
+
+			vector<size_t>::iterator itr = ::std::find( aRowIds.begin(), aRowIds.end(), aActive[k] );
+			BasisStatus eStatus = BASIS_BASIC;
+			if ( itr != aRowIds.end() && bWarm )
+				eStatus = aBasis.getRowStatus( nRowCount + ( itr - aRowIds.begin() ) );
+			aNextBasis.setRowStatus( nRowCount + k, eStatus );
+		}
+
+		pModel = pNext;
+		aRowIds.swap( aActive );
+		aBasis = bWarm ? aNextBasis : Basis();
+		if ( m_bVerbose )
+			cout << "cut round " << nRound + 1 << ": bound " << m_fSign*fObj << ", "
+				 << aRowIds.size() << " cut(s) in the LP, " << aPool.size() << " in the pool" << endl;
+	}
+
+	rBasis = aBasis;
+	if ( aRowIds.empty() )
+		return;
+	m_pCutModel = pModel;
+	m_nCutCount = aRowIds.size();
+}
+
+/**
+ * @return const Basis basis of the model being solved, without the rows
+ *         of the cuts.  It is incomplete when a cut row is non-basic, and
+ *         so only serves as a start basis once the algorithm completes it.
+ */
+const Basis BranchAndBoundImpl::getModelBasis( const Basis& rBasis ) const
+{
+	if ( !m_pCutModel.get() || rBasis.empty() )
+		return rBasis;
+
+	size_t nRowCount = m_pSelf->getModel()->getConstraintCount();
+	Basis aBasis( rBasis.getVarCount(), nRowCount );
+	for ( size_t j = 0; j < rBasis.getVarCount(); ++j )
+		aBasis.setVarStatus( j, rBasis.getVarStatus( j ) );
+	for ( size_t i = 0; i < nRowCount; ++i )
+		aBasis.setRowStatus( i, rBasis.getRowStatus( i ) );
+	return aBasis;
+}
+
+/**
+ * Run workers 1 to nCount - 1 in threads of their own and worker 0 in the
+ * calling thread, and wait until all of them are done.
+ */
+void BranchAndBoundImpl::runWorkers( size_t nCount )
+{
+	vector<BranchAndBoundWorker*> aThreads;
+	for ( size_t i = 1; i < nCount; ++i )
+	{
+		aThreads.push_back( new BranchAndBoundWorker( this, i ) );
+		if ( !aThreads.back()->start() )
+			runWorker( i );
+	}
+	if ( nCount > 0 )
+		runWorker( 0 );
+	for ( size_t i = 0; i < aThreads.size(); ++i )
+	{
+		aThreads[i]->join();
+		delete aThreads[i];
+	}
+}
+
+void BranchAndBoundImpl::runWorker( size_t nWorker )
+{
+	if ( m_eParallelMode == PARALLEL_OPPORTUNISTIC )
+		search( nWorker );
+	else
+		solveJob( nWorker );
+}
+
+/**
+ * Solve the nodes in rounds of one per thread.  The nodes of a round are
+ * selected before any of them is solved, and their results are processed
+ * in the same order, so that the search does not depend on which thread
+ * finishes first.  With one thread, this is the plain sequential search.
+ */
+void BranchAndBoundImpl::searchDeterministic( size_t nThreads )
+{
+	while ( !m_aOpen.empty() )
+	{
+		if ( m_nNodeLimit > 0 && m_nNodeCount >= m_nNodeLimit )
+		{
+			m_bOptimal = false;
+			break;
+		}
+		if ( isStopRequested() )
+			break;
+
+		size_t nBatch = 0;
+		while ( nBatch < nThreads && !m_aOpen.empty() &&
+				( m_nNodeLimit == 0 || m_nNodeCount < m_nNodeLimit ) )
+		{
+			list<Node>::iterator itr = selectNode( m_aOpen );
+			Node aNode( *itr );
+			m_aOpen.erase( itr );
+			if ( isCutOff( aNode.Bound ) )
+				continue;
+			Job& rJob = m_aJobs[nBatch++];
+			rJob.Input = aNode;
+			rJob.Number = ++m_nNodeCount;
+		}
+
+		if ( nBatch == 1 )
+		{
+			// A single node is solved right here, so that its errors
+			// propagate as they are.
+			Job& rJob = m_aJobs[0];
+			rJob.Error = JOBERROR_NONE;
+			try
+			{
+				rJob.Feasible = solveNode( *m_pAlgorithm, getNodeModel(), rJob.Input,
+										   rJob.Solution, rJob.NodeBasis, rJob.Obj );
+			}
+			catch ( const IterationTimedOut& )
+			{
+				rJob.Error = JOBERROR_TIMED_OUT;
+			}
+			catch ( const SolveCancelled& )
+			{
+				rJob.Error = JOBERROR_CANCELLED;
+			}
+		}
+		else
+			runWorkers( nBatch );
+
+		for ( size_t i = 0; i < nBatch; ++i )
+		{
+			Job& rJob = m_aJobs[i];
+			if ( rJob.Error == JOBERROR_TIMED_OUT || rJob.Error == JOBERROR_CANCELLED )
+				stopSearch( rJob.Error );
+			else if ( rJob.Error != JOBERROR_NONE )
+				throwJobError( rJob );
+			else if ( rJob.Feasible )
+				processNode( *m_pAlgorithm, rJob, m_aOpen, false );
+		}
+		reportProgress();
+		if ( m_eStopReason != JOBERROR_NONE )
+			break;
+	}
+}
+
+/**
+ * Search loop of one worker in the opportunistic search.  The shared
+ * state is only touched with the mutex held, which is released while the
+ * node relaxation is solved and while the heuristics run.  The search ends when all queues are empty
+ * and no worker is solving a node that could add more.
+ */
+void BranchAndBoundImpl::search( size_t nWorker )
+{
+	Job& rJob = m_aJobs[nWorker];
+	MutexGuard aGuard( m_aMutex );
+	while ( !m_bStop )
+	{
+		if ( !takeNode( nWorker, rJob.Input ) )
+		{
+			if ( m_nBusyCount == 0 )
+			{
+				m_bStop = true;
+				m_aCondition.notifyAll();
+			}
+			else
+				m_aCondition.wait( m_aMutex );
+			continue;
+		}
+
+		if ( isCutOff( rJob.Input.Bound ) )
+			continue;
+
+		if ( ( m_nNodeLimit > 0 && m_nNodeCount >= m_nNodeLimit ) || isStopRequested() )
+		{
+			m_bOptimal = false;
+			m_bStop = true;
+			m_aCondition.notifyAll();
+			break;
+		}
+
+		rJob.Number = ++m_nNodeCount;
+		++m_nBusyCount;
+		rJob.Busy = true;
+		m_aMutex.release();
+		solveJob( nWorker );
+		m_aMutex.acquire();
+
+		// The worker stays busy while the heuristics of the node run
+		// without the mutex, as they may still add an incumbent.
+		if ( rJob.Error == JOBERROR_TIMED_OUT || rJob.Error == JOBERROR_CANCELLED )
+		{
+			stopSearch( rJob.Error );
+			m_bStop = true;
+		}
+		else if ( rJob.Error != JOBERROR_NONE )
+			m_bStop = true;
+		else if ( rJob.Feasible )
+			processNode( *getWorkerAlgorithm( nWorker ), rJob, m_aQueues[nWorker], true );
+		rJob.Busy = false;
+		--m_nBusyCount;
+		reportProgress();
+		m_aCondition.notifyAll();
+	}
+}
+
+void BranchAndBoundImpl::searchOpportunistic( size_t nThreads )
+{
+	m_aQueues.assign( nThreads, list<Node>() );
+	m_aQueues[0].swap( m_aOpen );
+	m_nBusyCount = 0;
+	m_bStop = false;
+
+	runWorkers( nThreads );
+	m_aQueues.clear();
+
+	for ( size_t i = 0; i < nThreads; ++i )
+		if ( m_aJobs[i].Error != JOBERROR_NONE && m_aJobs[i].Error != JOBERROR_TIMED_OUT &&
+			 m_aJobs[i].Error != JOBERROR_CANCELLED )
+			throwJobError( m_aJobs[i] );
+}
+
+void BranchAndBoundImpl::solve()
+{
+	Model* pModel = m_pSelf->getModel();
+	m_bVerbose = pModel->getVerbose();
+	m_bInteger = pModel->getVarInteger();
+	m_nNodeCount = 0;
+	m_bOptimal = true;
+	m_bHasIncumbent = false;
+	m_fIncumbent = INF;
+	m_eStopReason = JOBERROR_NONE;
+	initObjective();
+
+	size_t nVarCount = ::std::max( pModel->getConstraintMatrix().cols(), m_aCost.size() );
+	for ( size_t nDir = 0; nDir < 2; ++nDir )
+	{
+		m_aCostSum[nDir].assign( nVarCount, 0.0 );
+		m_aCostCount[nDir].assign( nVarCount, 0 );
+		m_fTotalSum[nDir] = 0.0;
+		m_nTotalCount[nDir] = 0;
+	}
+
+	size_t nThreads = 1;
+	if ( m_pFactory.get() && m_bInteger )
+		nThreads = m_nThreadCount > 0 ? m_nThreadCount : Thread::getProcessorCount();
+	while ( m_aWorkerAlgorithms.size() + 1 < nThreads )
+		m_aWorkerAlgorithms.push_back( m_pFactory->create().release() );
+	SolveControl* pControl = m_pSelf->getSolveControl();
+	ProgressListenerSwitch aListenerSwitch( *pControl );
+	m_pListener = aListenerSwitch.getListener();
+	m_pAlgorithm->setSolveControl( pControl );
+	for ( size_t i = 0; i < m_aWorkerAlgorithms.size(); ++i )
+		m_aWorkerAlgorithms[i]->setSolveControl( pControl );
+	m_aJobs.assign( nThreads, Job() );
+
+	Basis aRootBasis( m_pSelf->getStartBasis() );
+	m_pCutModel.reset();
+	m_nCutCount = 0;
+	if ( m_bInteger && m_nCutRounds > 0 )
+		addRootCuts( aRootBasis );
+
+	m_aOpen.clear();
+	Node aRoot;
+	aRoot.StartBasis = aRootBasis;
+	m_aOpen.push_back( aRoot );
+
+	// Only the opportunistic search depends on the timing anyway.
+	m_bTimedHeuristics = nThreads > 1 && m_eParallelMode == PARALLEL_OPPORTUNISTIC;
+	if ( nThreads > 1 && m_eParallelMode == PARALLEL_OPPORTUNISTIC )
+		searchOpportunistic( nThreads );
+	else
+		searchDeterministic( nThreads );
+	m_aOpen.clear();
+	m_aJobs.clear();
+
+	if ( m_bVerbose )
+		cout << "branch and bound: " << m_nNodeCount << " node(s) solved with "
+			 << nThreads << " thread(s)" << endl;
+
+	if ( !m_bHasIncumbent )
+	{
+		if ( m_eStopReason == JOBERROR_CANCELLED )
+			throw SolveCancelled();
+		if ( m_eStopReason == JOBERROR_TIMED_OUT )
+			throw IterationTimedOut();
+		if ( !m_bOptimal )
+			throw MaxIterationReached();
+		throw ModelInfeasible();
+	}
+
+	m_pSelf->setSolution( m_mxIncumbent );
+	m_pSelf->setBasis( getModelBasis( m_aIncumbentBasis ) );
+}
+
+//---------------------------------------------------------------------------
+// BranchAndBound
+
+BranchAndBound::BranchAndBound( ::std::auto_ptr<BaseAlgorithm> pAlgorithm ) :
+	BaseAlgorithm(), m_pImpl( new BranchAndBoundImpl( this, pAlgorithm ) )
+{
+}
+
+BranchAndBound::BranchAndBound( ::std::auto_ptr<AlgorithmFactory> pFactory ) :
+	BaseAlgorithm(), m_pImpl( new BranchAndBoundImpl( this, pFactory ) )
+{
+}
+
+BranchAndBound::~BranchAndBound() throw()
+{
+}
+
+void BranchAndBound::solve()
+{
+	m_pImpl->solve();
+}
+
+BaseAlgorithm* BranchAndBound::getAlgorithm() const
+{
+	return m_pImpl->getAlgorithm();
+}
+
+void BranchAndBound::setNodeSelection( NodeSelection eSelection )
+{
+	m_pImpl->setNodeSelection( eSelection );
+}
+
+NodeSelection BranchAndBound::getNodeSelection() const
+{
+	return m_pImpl->getNodeSelection();
+}
+
+void BranchAndBound::setNodeLimit( size_t nLimit )
+{
+	m_pImpl->setNodeLimit( nLimit );
+}
+
+size_t BranchAndBound::getNodeCount() const
+{
+	return m_pImpl->getNodeCount();
+}
+
+bool BranchAndBound::isOptimal() const
+{
+	return m_pImpl->isOptimal();
+}
+
+void BranchAndBound::setThreadCount( size_t nCount )
+{
+	m_pImpl->setThreadCount( nCount );
+}
+
+size_t BranchAndBound::getThreadCount() const
+{
+	return m_pImpl->getThreadCount();
+}
+
+void BranchAndBound::setParallelMode( ParallelMode eMode )
+{
+	m_pImpl->setParallelMode( eMode );
+}
+
+ParallelMode BranchAndBound::getParallelMode() const
+{
+	return m_pImpl->getParallelMode();
+}
+
+void BranchAndBound::setCutRounds( size_t nRounds )
+{
+	m_pImpl->setCutRounds( nRounds );
+}
+
+size_t BranchAndBound::getCutRounds() const
+{
+	return m_pImpl->getCutRounds();
+}
+
+size_t BranchAndBound::getCutCount() const
+{
+	return m_pImpl->getCutCount();
+}
+
+void BranchAndBound::setHeuristicTimeLimit( double fSeconds )
+{
+	m_pImpl->setHeuristicTimeLimit( fSeconds );
+}
+
+double BranchAndBound::getHeuristicTimeLimit() const
+{
+	return m_pImpl->getHeuristicTimeLimit();
+}
+
+}}}
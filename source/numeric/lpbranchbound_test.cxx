@@ -0,0 +1,437 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/lpbranchbound.hxx"
+#include "numeric/lpdualsimplex.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/exception.hxx"
+#include "tool/thread.hxx"
+#include "lptestutil.hxx"
+
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <stdio.h>
+
+using namespace ::scsolver::numeric;
+using namespace ::scsolver::numeric::lp;
+using namespace ::scsolver::numeric::lp::test;
+using ::std::vector;
+using ::std::auto_ptr;
+
+namespace {
+
+/**
+ * Knapsack model (see buildKnapsackModel) small enough that its optimum
+ * is found by enumerating all 5^n points.
+ *
+ * @return double optimal objective value.
+ */
+double buildSmallKnapsackModel(Model& model, size_t nRows, size_t nCols, unsigned long seed)
+{
+    buildKnapsackModel(model, nRows, nCols, seed);
+    Matrix A = model.getConstraintMatrix();
+    Matrix cost = model.getCostVector();
+
+    double fBest = 0.0;
+    vector<size_t> x(nCols, 0);
+    while (true)
+    {
+        bool bFeasible = true;
+        for (size_t i = 0; i < nRows && bFeasible; ++i)
+        {
+            double lhs = 0.0;
+            for (size_t j = 0; j < nCols; ++j)
+                lhs += A(i, j)*x[j];
+            bFeasible = lhs <= model.getRhsValue(i);
+        }
+        if (bFeasible)
+        {
+            double f = 0.0;
+            for (size_t j = 0; j < nCols; ++j)
+                f += cost(0, j)*x[j];
+            fBest = ::std::max(fBest, f);
+        }
+
+        size_t j = 0;
+        while (j < nCols && x[j] == 4)
+            x[j++] = 0;
+        if (j == nCols)
+            break;
+        ++x[j];
+    }
+    return fBest;
+}
+
+/**
+ * 4x4 sudoku as a binary model: x(r, c, v) = 1 when cell (r, c) holds
+ * value v, with one value per cell and each value once per row, column
+ * and 2x2 box.
+ */
+void buildSudokuModel(Model& model, const int givens[4][4])
+{
+    const size_t n = 4, nVarCount = n*n*n;
+    model.setCostVector(vector<double>(nVarCount, 0.0));
+    model.setGoal(GOAL_MINIMIZE);
+    model.setVarPositive(true);
+    model.setVarInteger(true);
+    for (size_t j = 0; j < nVarCount; ++j)
+        model.setVarBound(j, BOUND_UPPER, 1);
+
+    for (size_t a = 0; a < n; ++a)
+        for (size_t b = 0; b < n; ++b)
+        {
+            vector<double> cell(nVarCount, 0.0), row(nVarCount, 0.0), col(nVarCount, 0.0), box(nVarCount, 0.0);
+            for (size_t k = 0; k < n; ++k)
+            {
+                cell[(a*n + b)*n + k] = 1.0;          // cell (a, b)
+                row[(a*n + k)*n + b] = 1.0;           // value b in row a
+                col[(k*n + a)*n + b] = 1.0;           // value b in column a
+                size_t r = (a/2)*2 + k/2, c = (a%2)*2 + k%2;
+                box[(r*n + c)*n + b] = 1.0;           // value b in box a
+            }
+            model.addConstraint(cell, EQUAL, 1);
+            model.addConstraint(row, EQUAL, 1);
+            model.addConstraint(col, EQUAL, 1);
+            model.addConstraint(box, EQUAL, 1);
+        }
+
+    for (size_t r = 0; r < n; ++r)
+        for (size_t c = 0; c < n; ++c)
+            if (givens[r][c] > 0)
+                model.setVarBound((r*n + c)*n + givens[r][c] - 1, BOUND_LOWER, 1);
+}
+
+void knapsack()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("knapsack models\n");
+
+    // Cuts are turned off, as they solve these models at the root.
+    const NodeSelection selections[] = { NODESEL_BEST_BOUND, NODESEL_DEPTH_FIRST, NODESEL_HYBRID };
+    const char* names[] = { "best bound", "depth first", "hybrid" };
+    for (unsigned long seed = 1; seed <= 5; ++seed)
+    {
+        Model model;
+        double fBest = buildSmallKnapsackModel(model, 3, 5, seed);
+        for (size_t k = 0; k < 3; ++k)
+        {
+            auto_ptr<BaseAlgorithm> p(new DualSimplex);
+            BranchAndBound algorithm(p);
+            algorithm.setModel(&model);
+            algorithm.setCutRounds(0);
+            algorithm.setNodeSelection(selections[k]);
+            algorithm.solve();
+            Matrix sol = algorithm.getSolution();
+            printf("seed %lu, %s: objective %g (enumerated %g), %lu nodes  ", seed, names[k],
+                   getObjective(model, sol), fBest, static_cast<unsigned long>(algorithm.getNodeCount()));
+            check(isIntegral(sol) && isFeasible(model, sol) && getObjective(model, sol) == fBest &&
+                  algorithm.isOptimal(), "optimal integer solution");
+        }
+    }
+
+    // Without heuristics, a node limit of one leaves no integer solution
+    // to return.
+    Model model;
+    buildKnapsackModel(model, 3, 5, 1);
+    auto_ptr<BaseAlgorithm> p(new DualSimplex);
+    BranchAndBound algorithm(p);
+    algorithm.setModel(&model);
+    algorithm.setCutRounds(0);
+    algorithm.setHeuristicTimeLimit(0.0);
+    algorithm.setNodeLimit(1);
+    bool bThrown = false;
+    try
+    {
+        algorithm.solve();
+    }
+    catch (const MaxIterationReached&)
+    {
+        bThrown = true;
+    }
+    check(bThrown && algorithm.getNodeCount() == 1, "node limit");
+
+    // The heuristics at the root find one.
+    algorithm.setHeuristicTimeLimit(1.0);
+    algorithm.solve();
+    Matrix sol = algorithm.getSolution();
+    printf("objective %g at the node limit  ", getObjective(model, sol));
+    check(isIntegral(sol) && isFeasible(model, sol) && algorithm.getNodeCount() == 1,
+          "heuristic solution at the node limit");
+}
+
+void sudoku()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("sudoku\n");
+
+    const int givens[4][4] = {
+        { 1, 0, 0, 0 },
+        { 0, 0, 3, 0 },
+        { 0, 4, 0, 0 },
+        { 0, 0, 0, 2 }
+    };
+    Model model;
+    buildSudokuModel(model, givens);
+
+    auto_ptr<BaseAlgorithm> p(new DualSimplex);
+    BranchAndBound algorithm(p);
+    algorithm.setModel(&model);
+    algorithm.solve();
+    Matrix sol = algorithm.getSolution();
+
+    int grid[4][4];
+    for (size_t r = 0; r < 4; ++r)
+    {
+        for (size_t c = 0; c < 4; ++c)
+        {
+            grid[r][c] = 0;
+            for (size_t v = 0; v < 4; ++v)
+                if (sol((r*4 + c)*4 + v, 0) == 1.0)
+                    grid[r][c] = v + 1;
+            printf("%d ", grid[r][c]);
+        }
+        printf("\n");
+    }
+    printf("%lu nodes\n", static_cast<unsigned long>(algorithm.getNodeCount()));
+    check(isIntegral(sol) && isFeasible(model, sol) && grid[0][0] == 1 && grid[1][2] == 3 &&
+          grid[2][1] == 4 && grid[3][3] == 2, "sudoku solved");
+}
+
+bool isSameSolution(const Matrix& a, const Matrix& b)
+{
+    if (a.rows() != b.rows())
+        return false;
+    for (size_t j = 0; j < a.rows(); ++j)
+        if (a(j, 0) != b(j, 0))
+            return false;
+    return true;
+}
+
+void parallel()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("parallel search\n");
+
+    for (unsigned long seed = 1; seed <= 3; ++seed)
+    {
+        Model model;
+        double fBest = buildSmallKnapsackModel(model, 4, 8, seed);
+
+        // The deterministic search gives the same result on every run.
+        Matrix first;
+        size_t nFirstCount = 0;
+        for (size_t nRun = 0; nRun < 2; ++nRun)
+        {
+            auto_ptr<AlgorithmFactory> p(new DefaultAlgorithmFactory<DualSimplex>);
+            BranchAndBound algorithm(p);
+            algorithm.setModel(&model);
+            algorithm.setCutRounds(0);
+            algorithm.setThreadCount(4);
+            algorithm.setParallelMode(PARALLEL_DETERMINISTIC);
+            algorithm.solve();
+            Matrix sol = algorithm.getSolution();
+            printf("seed %lu, deterministic run %lu: objective %g (enumerated %g), %lu nodes  ", seed,
+                   static_cast<unsigned long>(nRun + 1), getObjective(model, sol), fBest,
+                   static_cast<unsigned long>(algorithm.getNodeCount()));
+            check(isIntegral(sol) && isFeasible(model, sol) && getObjective(model, sol) == fBest &&
+                  algorithm.isOptimal(), "optimal integer solution");
+            if (nRun == 0)
+            {
+                first = sol;
+                nFirstCount = algorithm.getNodeCount();
+            }
+            else
+                check(isSameSolution(first, sol) && nFirstCount == algorithm.getNodeCount(),
+                      "same solution and node count");
+        }
+
+        // One thread per processor.
+        auto_ptr<AlgorithmFactory> p(new DefaultAlgorithmFactory<DualSimplex>);
+        BranchAndBound algorithm(p);
+        algorithm.setModel(&model);
+        algorithm.setCutRounds(0);
+        algorithm.setThreadCount(0);
+        algorithm.setParallelMode(PARALLEL_OPPORTUNISTIC);
+        for (size_t k = 0; k < 3; ++k)
+        {
+            const NodeSelection selections[] = { NODESEL_BEST_BOUND, NODESEL_DEPTH_FIRST, NODESEL_HYBRID };
+            algorithm.setNodeSelection(selections[k]);
+            algorithm.solve();
+            Matrix sol = algorithm.getSolution();
+            printf("seed %lu, opportunistic: objective %g (enumerated %g), %lu nodes  ", seed,
+                   getObjective(model, sol), fBest, static_cast<unsigned long>(algorithm.getNodeCount()));
+            check(isIntegral(sol) && isFeasible(model, sol) && getObjective(model, sol) == fBest &&
+                  algorithm.isOptimal(), "optimal integer solution");
+        }
+    }
+
+    // The node limit holds across threads.
+    Model model;
+    buildKnapsackModel(model, 4, 8, 1);
+    auto_ptr<AlgorithmFactory> p(new DefaultAlgorithmFactory<DualSimplex>);
+    BranchAndBound algorithm(p);
+    algorithm.setModel(&model);
+    algorithm.setCutRounds(0);
+    algorithm.setThreadCount(4);
+    algorithm.setParallelMode(PARALLEL_OPPORTUNISTIC);
+    algorithm.setNodeSelection(NODESEL_DEPTH_FIRST);
+    algorithm.setNodeLimit(5);
+    try
+    {
+        algorithm.solve();
+    }
+    catch (const MaxIterationReached&)
+    {
+    }
+    check(algorithm.getNodeCount() == 5 && !algorithm.isOptimal(), "node limit");
+}
+
+/**
+ * Engine that counts the models handed to it with the integer flag set.
+ * LpSolve passes the flag on to lp_solve, which would then solve every
+ * node as a full MIP.
+ */
+class RelaxationOnly : public DualSimplex
+{
+public:
+    virtual void solve()
+    {
+        if (getModel()->getVarInteger())
+        {
+            ::scsolver::MutexGuard aGuard(smMutex);
+            ++snIntegerModels;
+        }
+        DualSimplex::solve();
+    }
+
+    static ::scsolver::Mutex smMutex;
+    static size_t snIntegerModels;
+};
+
+::scsolver::Mutex RelaxationOnly::smMutex;
+size_t RelaxationOnly::snIntegerModels = 0;
+
+void relaxations()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("node relaxations\n");
+
+    Model model;
+    double fBest = buildSmallKnapsackModel(model, 4, 8, 2);
+    for (size_t nThreads = 1; nThreads <= 4; nThreads += 3)
+    {
+        auto_ptr<AlgorithmFactory> p(new DefaultAlgorithmFactory<RelaxationOnly>);
+        BranchAndBound algorithm(p);
+        algorithm.setModel(&model);
+        algorithm.setCutRounds(nThreads == 1 ? 10 : 0);
+        algorithm.setThreadCount(nThreads);
+        algorithm.solve();
+        Matrix sol = algorithm.getSolution();
+        printf("%lu thread(s): objective %g (enumerated %g), %lu nodes  ",
+               static_cast<unsigned long>(nThreads), getObjective(model, sol), fBest,
+               static_cast<unsigned long>(algorithm.getNodeCount()));
+        check(isIntegral(sol) && getObjective(model, sol) == fBest && algorithm.isOptimal(),
+              "optimal integer solution");
+    }
+    check(RelaxationOnly::snIntegerModels == 0, "nodes solved as LPs");
+    check(model.getVarInteger(), "integer flag of the model kept");
+}
+
+void cuts()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("cuts\n");
+
+    size_t nNodes = 0, nCutNodes = 0;
+    for (unsigned long seed = 1; seed <= 5; ++seed)
+    {
+        Model model;
+        double fBest = buildSmallKnapsackModel(model, 4, 8, seed);
+
+        auto_ptr<BaseAlgorithm> p(new DualSimplex);
+        BranchAndBound algorithm(p);
+        algorithm.setModel(&model);
+        algorithm.setCutRounds(0);
+        algorithm.solve();
+        nNodes += algorithm.getNodeCount();
+
+        algorithm.setCutRounds(10);
+        algorithm.solve();
+        Matrix sol = algorithm.getSolution();
+        nCutNodes += algorithm.getNodeCount();
+        printf("seed %lu: objective %g (enumerated %g), %lu cut(s)  ", seed,
+               getObjective(model, sol), fBest, static_cast<unsigned long>(algorithm.getCutCount()));
+        check(isIntegral(sol) && isFeasible(model, sol) && getObjective(model, sol) == fBest &&
+              algorithm.isOptimal(), "optimal integer solution");
+        check(algorithm.getBasis().getRowCount() == model.getConstraintCount(), "basis without cut rows");
+    }
+    printf("%lu node(s) without cuts, %lu with cuts\n", static_cast<unsigned long>(nNodes),
+           static_cast<unsigned long>(nCutNodes));
+    check(nCutNodes*4 < nNodes, "fewer nodes with cuts");
+}
+
+void infeasible()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("infeasible model\n");
+
+    // 2x + 2y = 3 has no integer solution, though its relaxation has.
+    Model model;
+    vector<double> cost(2, 1.0);
+    model.setCostVector(cost);
+    model.setGoal(GOAL_MINIMIZE);
+    model.setVarPositive(true);
+    model.setVarInteger(true);
+    vector<double> row(2, 2.0);
+    model.addConstraint(row, EQUAL, 3);
+
+    auto_ptr<BaseAlgorithm> p(new DualSimplex);
+    BranchAndBound algorithm(p);
+    algorithm.setModel(&model);
+    bool bThrown = false;
+    try
+    {
+        algorithm.solve();
+    }
+    catch (const ModelInfeasible&)
+    {
+        bThrown = true;
+    }
+    check(bThrown, "no integer solution");
+
+    // Without the integer restriction, the relaxation is the answer.
+    model.setVarInteger(false);
+    algorithm.solve();
+    check(getObjective(model, algorithm.getSolution()) == 1.5 && algorithm.getNodeCount() == 1,
+          "continuous model solved at the root");
+}
+
+}
+
+int main()
+{
+    printf("unit test: branch and bound\n");
+    knapsack();
+    sudoku();
+    parallel();
+    relaxations();
+    cuts();
+    infeasible();
+    printf("Unit test passed!\n");
+}
@@ -0,0 +1,929 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/lpcuts.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/decomposition.hxx"
+
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+using ::std::vector;
+using ::std::map;
+using ::std::pair;
+
+namespace scsolver { namespace numeric { namespace lp {
+
+namespace {
+
+const double INF = ::std::numeric_limits<double>::infinity();
+
+/** distance from the nearest integer up to which a value is integral. */
+const double INTEGER_TOL = 1e-6;
+
+/** smallest fractional part of the value a cut is derived from.  Below
+	it, the cut is too weak to be worth the rounding errors. */
+const double MIN_FRACTION = 0.005;
+
+/** smallest distance between a point and the cuts that separate it. */
+const double MIN_EFFICACY = 1e-4;
+
+/** largest ratio between the absolute values of two coefficients of a
+	cut.  Cuts with a larger range are numerically unsafe. */
+const double MAX_DYNAMISM = 1e6;
+
+/** magnitude below which a tableau entry is taken as zero. */
+const double ZERO_TOL = 1e-11;
+
+/** maximum number of tableau rows to derive Gomory cuts from. */
+const size_t MAX_GOMORY_ROWS = 100;
+
+/** maximum number of divisors tried for each MIR cut. */
+const size_t MAX_MIR_DIVISORS = 8;
+
+/** cuts more parallel than this are duplicates when added to the pool. */
+const double DUPLICATE_PARALLELISM = 0.9999;
+
+/** two cuts more parallel than this are not activated in the same round. */
+const double SELECT_PARALLELISM = 0.98;
+
+/** maximum number of cuts in the pool. */
+const size_t MAX_POOL_SIZE = 1000;
+
+/** number of rounds an active cut may stay slack before it is removed
+	from the LP. */
+const size_t MAX_AGE = 3;
+
+bool isIntegral( double fVal )
+{
+	return ::std::fabs( fVal - ::std::floor( fVal + 0.5 ) ) <= INTEGER_TOL;
+}
+
+double getFraction( double fVal )
+{
+	return fVal - ::std::floor( fVal );
+}
+
+/**
+ * @return double coefficient of the MIR cut for a row coefficient q, after
+ *         division, when the right hand side has fractional part f.
+ */
+double getMirCoefficient( double fQ, double f )
+{
+	return ::std::floor( fQ ) + ::std::max( 0.0, getFraction( fQ ) - f )/( 1.0 - f );
+}
+
+/**
+ * @return double efficacy of the MIR cut from sum_k c_k y_k <= d divided
+ *         by the given divisor, at the point y, or zero if the right hand
+ *         side is too close to an integer.
+ */
+double getMirEfficacy( const vector<double>& aC, const vector<double>& aY, double fD, double fDiv )
+{
+	double f = getFraction( fD/fDiv );
+	if ( f < MIN_FRACTION || f > 1.0 - MIN_FRACTION )
+		return 0.0;
+
+	double fLhs = 0.0, fNorm = 0.0;
+	for ( size_t k = 0; k < aC.size(); ++k )
+	{
+		double fCoef = getMirCoefficient( aC[k]/fDiv, f );
+		fLhs += fCoef*aY[k];
+		fNorm += fCoef*fCoef;
+	}
+	return fNorm > 0.0 ? ( fLhs - ::std::floor( fD/fDiv ) )/::std::sqrt( fNorm ) : 0.0;
+}
+
+struct EfficacyGreater
+{
+	bool operator()( const pair<double, size_t>& r1, const pair<double, size_t>& r2 ) const
+	{
+		return r1.first > r2.first;
+	}
+};
+
+}
+
+//---------------------------------------------------------------------------
+// Cut
+
+Cut::Cut() : m_fRhs( 0.0 ), m_fNorm( 0.0 )
+{
+}
+
+Cut::Cut( const vector<double>& aCoef, double fRhs ) :
+	m_aCoef( aCoef ), m_fRhs( fRhs ), m_fNorm( 0.0 )
+{
+	for ( size_t j = 0; j < m_aCoef.size(); ++j )
+		m_fNorm += m_aCoef[j]*m_aCoef[j];
+	m_fNorm = ::std::sqrt( m_fNorm );
+}
+
+Cut::~Cut() throw()
+{
+}
+
+const vector<double>& Cut::getCoefficients() const
+{
+	return m_aCoef;
+}
+
+double Cut::getRhs() const
+{
+	return m_fRhs;
+}
+
+double Cut::getViolation( const Matrix& mxX ) const
+{
+	double fLhs = 0.0;
+	for ( size_t j = 0; j < m_aCoef.size() && j < mxX.rows(); ++j )
+		fLhs += m_aCoef[j]*mxX( j, 0 );
+	return fLhs - m_fRhs;
+}
+
+double Cut::getEfficacy( const Matrix& mxX ) const
+{
+	return m_fNorm > 0.0 ? getViolation( mxX )/m_fNorm : 0.0;
+}
+
+double Cut::getParallelism( const Cut& rOther ) const
+{
+	if ( m_fNorm == 0.0 || rOther.m_fNorm == 0.0 )
+		return 0.0;
+	double fDot = 0.0;
+	size_t nSize = ::std::min( m_aCoef.size(), rOther.m_aCoef.size() );
+	for ( size_t j = 0; j < nSize; ++j )
+		fDot += m_aCoef[j]*rOther.m_aCoef[j];
+	return fDot/( m_fNorm*rOther.m_fNorm );
+}
+
+//---------------------------------------------------------------------------
+// Separator
+
+/**
+ * Model data needed to separate one point.  The row activities a_i x are
+ * treated as additional variables, as in the simplex basis, indexed after
+ * the decision variables.  The bounds of integer variables are rounded
+ * inwards.
+ */
+class Separator
+{
+public:
+	Separator( const Model& aModel, const Matrix& mxSolution );
+
+	void gomory( const Basis& aBasis, vector<Cut>& rCuts ) const;
+	void mir( vector<Cut>& rCuts ) const;
+	void cover( vector<Cut>& rCuts ) const;
+
+private:
+	size_t m_nVarCount;
+	size_t m_nRowCount;
+	Matrix m_mxA;
+	Matrix m_mxX;
+	vector<double> m_aLower;
+	vector<double> m_aUpper;
+	vector<bool> m_aInteger;
+	vector<double> m_aValue;
+
+	/** constraint rows in the form a x <= b. */
+	vector< vector<double> > m_aLeRows;
+	vector<double> m_aLeRhs;
+
+	bool addCut( vector<double>& aCoef, double fRhs, vector<Cut>& rCuts ) const;
+	void mirRow( const vector<double>& aRow, double fRhs, vector<Cut>& rCuts ) const;
+	void coverRow( const vector<double>& aRow, double fRhs, vector<Cut>& rCuts ) const;
+};
+
+Separator::Separator( const Model& aModel, const Matrix& mxSolution ) :
+	m_mxA( aModel.getConstraintMatrix() ), m_mxX( mxSolution )
+{
+	m_nRowCount = m_mxA.rows();
+	m_nVarCount = ::std::max( m_mxA.cols(), aModel.getCostVector().cols() );
+	if ( m_mxA.cols() < m_nVarCount )
+		m_mxA.resize( m_nRowCount, m_nVarCount );
+	if ( m_mxX.rows() < m_nVarCount )
+		m_mxX.resize( m_nVarCount, 1 );
+
+	size_t nTotal = m_nVarCount + m_nRowCount;
+	m_aLower.assign( nTotal, -INF );
+	m_aUpper.assign( nTotal, INF );
+	m_aInteger.assign( nTotal, aModel.getVarInteger() );
+	m_aValue.assign( nTotal, 0.0 );
+	for ( size_t j = 0; j < m_nVarCount; ++j )
+	{
+		if ( aModel.getVarPositive() )
+			m_aLower[j] = 0.0;
+		if ( aModel.isVarBounded( j, BOUND_LOWER ) )
+			m_aLower[j] = ::std::max( m_aLower[j], aModel.getVarBound( j, BOUND_LOWER ) );
+		if ( aModel.isVarBounded( j, BOUND_UPPER ) )
+			m_aUpper[j] = aModel.getVarBound( j, BOUND_UPPER );
+		if ( m_aInteger[j] )
+		{
+			m_aLower[j] = ::std::ceil( m_aLower[j] - INTEGER_TOL );
+			m_aUpper[j] = ::std::floor( m_aUpper[j] + INTEGER_TOL );
+		}
+		m_aValue[j] = m_mxX( j, 0 );
+	}
+
+	for ( size_t i = 0; i < m_nRowCount; ++i )
+	{
+		size_t k = m_nVarCount + i;
+		vector<double> aRow( m_nVarCount );
+		for ( size_t j = 0; j < m_nVarCount; ++j )
+		{
+			aRow[j] = m_mxA( i, j );
+			m_aValue[k] += aRow[j]*m_aValue[j];
+			if ( aRow[j] != 0.0 && ( !m_aInteger[j] || aRow[j] != ::std::floor( aRow[j] ) ) )
+				m_aInteger[k] = false;
+		}
+
+		double fRhs = aModel.getRhsValue( i );
+		EqualityType eEq = aModel.getEquality( i );
+		if ( eEq != GREATER_EQUAL )
+		{
+			m_aUpper[k] = fRhs;
+			m_aLeRows.push_back( aRow );
+			m_aLeRhs.push_back( fRhs );
+		}
+		if ( eEq != LESS_EQUAL )
+		{
+			m_aLower[k] = fRhs;
+			for ( size_t j = 0; j < m_nVarCount; ++j )
+				aRow[j] = -aRow[j];
+			m_aLeRows.push_back( aRow );
+			m_aLeRhs.push_back( -fRhs );
+		}
+	}
+}
+
+/**
+ * Clean up a cut and append it if it is violated enough.  Tiny
+ * coefficients are removed by moving their term to the right hand side at
+ * its worst value within the bounds, which keeps the cut valid, and the
+ * cut is scaled so that its largest coefficient is one.
+ *
+ * @return bool true if the cut has been appended.
+ */
+bool Separator::addCut( vector<double>& aCoef, double fRhs, vector<Cut>& rCuts ) const
+{
+	double fMax = 0.0;
+	for ( size_t j = 0; j < aCoef.size(); ++j )
+		fMax = ::std::max( fMax, ::std::fabs( aCoef[j] ) );
+	if ( fMax == 0.0 )
+		return false;
+
+	for ( size_t j = 0; j < aCoef.size(); ++j )
+	{
+		if ( aCoef[j] == 0.0 || ::std::fabs( aCoef[j] ) >= fMax/MAX_DYNAMISM )
+			continue;
+		double fBound = aCoef[j] > 0.0 ? m_aLower[j] : m_aUpper[j];
+		if ( fBound == -INF || fBound == INF )
+			return false;
+		fRhs -= aCoef[j]*fBound;
+		aCoef[j] = 0.0;
+	}
+
+	for ( size_t j = 0; j < aCoef.size(); ++j )
+		aCoef[j] /= fMax;
+	Cut aCut( aCoef, fRhs/fMax );
+	if ( aCut.getEfficacy( m_mxX ) < MIN_EFFICACY )
+		return false;
+	rCuts.push_back( aCut );
+	return true;
+}
+
+/**
+ * Gomory mixed-integer cuts.  The tableau row of a basic variable x_k
+ * expresses it in terms of the non-basic variables, each measured by its
+ * distance t_j >= 0 from the bound it is at:
+ *
+ *   x_k + sum_j g_j t_j = v_k.
+ *
+ * When x_k is integer and v_k is fractional with fractional part f, every
+ * integer solution satisfies sum_j h_j t_j >= 1, where h_j is
+ * frac(g_j)/f or (1 - frac(g_j))/(1 - f), whichever is smaller, for an
+ * integer t_j, and g_j/f or -g_j/(1 - f), whichever is positive, for a
+ * continuous one.  Substituting t_j gives a cut on the decision
+ * variables.
+ */
+void Separator::gomory( const Basis& aBasis, vector<Cut>& rCuts ) const
+{
+	if ( aBasis.getVarCount() != m_nVarCount || aBasis.getRowCount() != m_nRowCount || m_nRowCount == 0 )
+		return;
+
+	size_t nTotal = m_nVarCount + m_nRowCount;
+	vector<BasisStatus> aStatus( nTotal );
+	vector<size_t> aBasic;
+	for ( size_t j = 0; j < nTotal; ++j )
+	{
+		aStatus[j] = j < m_nVarCount ? aBasis.getVarStatus( j ) : aBasis.getRowStatus( j - m_nVarCount );
+		if ( aStatus[j] == BASIS_BASIC )
+			aBasic.push_back( j );
+	}
+	if ( aBasic.size() != m_nRowCount )
+		return;
+
+	// Rows whose basic variable is the most fractional come first.
+	vector< pair<double, size_t> > aCandidates;
+	for ( size_t k = 0; k < m_nRowCount; ++k )
+	{
+		size_t j = aBasic[k];
+		double fFrac = getFraction( m_aValue[j] );
+		if ( m_aInteger[j] && fFrac >= MIN_FRACTION && fFrac <= 1.0 - MIN_FRACTION )
+			aCandidates.push_back( pair<double, size_t>( ::std::fabs( fFrac - 0.5 ), k ) );
+	}
+	if ( aCandidates.empty() )
+		return;
+	::std::sort( aCandidates.begin(), aCandidates.end() );
+	if ( aCandidates.size() > MAX_GOMORY_ROWS )
+		aCandidates.resize( MAX_GOMORY_ROWS );
+
+	// Row k of the inverse of the basis matrix B = [A | -I]_basic solves
+	// B^T y = e_k.
+	Matrix mxBT( m_nRowCount, m_nRowCount ), mxE( m_nRowCount, aCandidates.size() );
+	for ( size_t k = 0; k < m_nRowCount; ++k )
+	{
+		size_t j = aBasic[k];
+		if ( j < m_nVarCount )
+			for ( size_t i = 0; i < m_nRowCount; ++i )
+				mxBT( k, i ) = m_mxA( i, j );
+		else
+			mxBT( k, j - m_nVarCount ) = -1.0;
+	}
+	for ( size_t r = 0; r < aCandidates.size(); ++r )
+		mxE( aCandidates[r].second, r ) = 1.0;
+
+	Matrix mxY( 0, 0 );
+	try
+	{
+		QRDecomposition aQR( mxBT );
+		Matrix mxR = aQR.getR();
+		double fMaxDiag = 0.0;
+		for ( size_t i = 0; i < m_nRowCount; ++i )
+			fMaxDiag = ::std::max( fMaxDiag, ::std::fabs( mxR( i, i ) ) );
+		for ( size_t i = 0; i < m_nRowCount; ++i )
+			if ( ::std::fabs( mxR( i, i ) ) <= 1e-10*fMaxDiag )
+				return;
+		mxY = aQR.solve( mxE );
+	}
+	catch ( const SingularMatrix& )
+	{
+		return;
+	}
+
+	for ( size_t r = 0; r < aCandidates.size(); ++r )
+	{
+		double f0 = getFraction( m_aValue[aBasic[aCandidates[r].second]] );
+		vector<double> aCoef( m_nVarCount, 0.0 );
+		double fConst = 0.0;
+		bool bValid = true;
+		for ( size_t j = 0; j < nTotal && bValid; ++j )
+		{
+			if ( aStatus[j] == BASIS_BASIC || m_aLower[j] == m_aUpper[j] )
+				continue;
+
+			double fEntry;
+			if ( j < m_nVarCount )
+			{
+				fEntry = 0.0;
+				for ( size_t i = 0; i < m_nRowCount; ++i )
+					fEntry += mxY( i, r )*m_mxA( i, j );
+			}
+			else
+				fEntry = -mxY( j - m_nVarCount, r );
+			if ( ::std::fabs( fEntry ) <= ZERO_TOL )
+				continue;
+
+			bool bUpper = aStatus[j] == BASIS_UPPER;
+			double fBound = bUpper ? m_aUpper[j] : m_aLower[j];
+			if ( fBound == -INF || fBound == INF )
+			{
+				// A free non-basic variable cannot be bounded.
+				bValid = false;
+				break;
+			}
+
+			double g = bUpper ? -fEntry : fEntry, h;
+			if ( m_aInteger[j] && isIntegral( fBound ) )
+			{
+				double fj = getFraction( g );
+				h = fj <= f0 ? fj/f0 : ( 1.0 - fj )/( 1.0 - f0 );
+			}
+			else
+				h = g >= 0.0 ? g/f0 : -g/( 1.0 - f0 );
+			if ( h == 0.0 )
+				continue;
+
+			// h t_j, with t_j = x_j - l_j or u_j - x_j
+			double fSign = bUpper ? -1.0 : 1.0;
+			fConst -= fSign*h*fBound;
+			if ( j < m_nVarCount )
+				aCoef[j] += fSign*h;
+			else
+				for ( size_t i = 0; i < m_nVarCount; ++i )
+					aCoef[i] += fSign*h*m_mxA( j - m_nVarCount, i );
+		}
+		if ( !bValid )
+			continue;
+
+		// a x + c >= 1, i.e. -a x <= c - 1
+		for ( size_t j = 0; j < m_nVarCount; ++j )
+			aCoef[j] = -aCoef[j];
+		addCut( aCoef, fConst - 1.0, rCuts );
+	}
+}
+
+/**
+ * Mixed-integer rounding cut from a row a x <= b of integer variables.
+ * Each variable is replaced by its distance y_j >= 0 from the nearer
+ * bound, giving sum_j c_j y_j <= d.  Dividing by some s > 0 and rounding
+ * yields the valid inequality
+ *
+ *   sum_j ( floor(c_j/s) + max(0, frac(c_j/s) - f)/(1 - f) ) y_j <= floor(d/s)
+ *
+ * where f is the fractional part of d/s.
+ * The divisors tried are the coefficients of the variables away from
+ * their bound, and halves of the best of them.
+ */
+void Separator::mirRow( const vector<double>& aRow, double fRhs, vector<Cut>& rCuts ) const
+{
+	vector<size_t> aVars;
+	vector<bool> aComplement;
+	vector<double> aC, aY;
+	double fD = fRhs;
+	for ( size_t j = 0; j < m_nVarCount; ++j )
+	{
+		if ( aRow[j] == 0.0 )
+			continue;
+		if ( !m_aInteger[j] )
+			return;
+
+		double fLower = m_aLower[j], fUpper = m_aUpper[j];
+		bool bComplement;
+		if ( fLower == -INF && fUpper == INF )
+			return;
+		else if ( fLower == -INF )
+			bComplement = true;
+		else if ( fUpper == INF )
+			bComplement = false;
+		else
+			bComplement = m_aValue[j] > 0.5*( fLower + fUpper );
+
+		aVars.push_back( j );
+		aComplement.push_back( bComplement );
+		if ( bComplement )
+		{
+			aC.push_back( -aRow[j] );
+			aY.push_back( fUpper - m_aValue[j] );
+			fD -= aRow[j]*fUpper;
+		}
+		else
+		{
+			aC.push_back( aRow[j] );
+			aY.push_back( m_aValue[j] - fLower );
+			fD -= aRow[j]*fLower;
+		}
+	}
+
+	vector<double> aDivisors;
+	for ( size_t k = 0; k < aVars.size() && aDivisors.size() < MAX_MIR_DIVISORS; ++k )
+	{
+		size_t j = aVars[k];
+		double fDiv = ::std::fabs( aC[k] );
+		if ( aY[k] > INTEGER_TOL && m_aValue[j] < m_aUpper[j] - INTEGER_TOL &&
+			 ::std::find( aDivisors.begin(), aDivisors.end(), fDiv ) == aDivisors.end() )
+			aDivisors.push_back( fDiv );
+	}
+
+	double fBestEfficacy = MIN_EFFICACY, fBestDiv = 0.0;
+	for ( size_t n = 0; n < aDivisors.size(); ++n )
+	{
+		double fEfficacy = getMirEfficacy( aC, aY, fD, aDivisors[n] );
+		if ( fEfficacy > fBestEfficacy )
+		{
+			fBestEfficacy = fEfficacy;
+			fBestDiv = aDivisors[n];
+		}
+	}
+	if ( fBestDiv == 0.0 )
+		return;
+
+	double fDiv = fBestDiv;
+	for ( size_t n = 1; n <= 3; ++n )
+	{
+		double fTry = fBestDiv/static_cast<double>( 1 << n );
+		double fEfficacy = getMirEfficacy( aC, aY, fD, fTry );
+		if ( fEfficacy > fBestEfficacy )
+		{
+			fBestEfficacy = fEfficacy;
+			fDiv = fTry;
+		}
+	}
+
+	double f = getFraction( fD/fDiv ), fCutRhs = ::std::floor( fD/fDiv );
+	vector<double> aCoef( m_nVarCount, 0.0 );
+	for ( size_t k = 0; k < aC.size(); ++k )
+	{
+		double fCoef = getMirCoefficient( aC[k]/fDiv, f );
+		size_t j = aVars[k];
+		if ( aComplement[k] )
+		{
+			// y_j = u_j - x_j
+			aCoef[j] = -fCoef;
+			fCutRhs -= fCoef*m_aUpper[j];
+		}
+		else
+		{
+			// y_j = x_j - l_j
+			aCoef[j] = fCoef;
+			fCutRhs += fCoef*m_aLower[j];
+		}
+	}
+	addCut( aCoef, fCutRhs, rCuts );
+}
+
+void Separator::mir( vector<Cut>& rCuts ) const
+{
+	for ( size_t i = 0; i < m_aLeRows.size(); ++i )
+		mirRow( m_aLeRows[i], m_aLeRhs[i], rCuts );
+}
+
+/**
+ * Cover cut from a row a x <= b of binary variables.  Variables with a
+ * negative coefficient are complemented, z_j = 1 - x_j, so that all
+ * coefficients are positive.  A cover C is a set of variables whose
+ * coefficients add up to more than the right hand side, so at most
+ * |C| - 1 of them can be one.  The cover is chosen greedily to include
+ * the variables closest to one, and is extended by all other variables
+ * with a coefficient at least as large as any in the cover.
+ */
+void Separator::coverRow( const vector<double>& aRow, double fRhs, vector<Cut>& rCuts ) const
+{
+	vector<size_t> aVars;
+	vector<double> aA, aZ;
+	vector<bool> aComplement;
+	double fB = fRhs, fSum = 0.0;
+	for ( size_t j = 0; j < m_nVarCount; ++j )
+	{
+		if ( aRow[j] == 0.0 )
+			continue;
+		if ( !m_aInteger[j] || m_aLower[j] != 0.0 || m_aUpper[j] != 1.0 )
+			return;
+
+		bool bComplement = aRow[j] < 0.0;
+		aVars.push_back( j );
+		aComplement.push_back( bComplement );
+		aA.push_back( ::std::fabs( aRow[j] ) );
+		aZ.push_back( bComplement ? 1.0 - m_aValue[j] : m_aValue[j] );
+		if ( bComplement )
+			fB -= aRow[j];
+		fSum += aA.back();
+	}
+
+	double fTol = 1e-9*( 1.0 + ::std::fabs( fB ) );
+	if ( aVars.size() < 2 || fSum <= fB + fTol || fB < 0.0 )
+		return;
+
+	// Add variables by increasing (1 - z_j)/a_j until the sum exceeds b.
+	vector< pair<double, size_t> > aOrder;
+	for ( size_t k = 0; k < aVars.size(); ++k )
+		aOrder.push_back( pair<double, size_t>( ( 1.0 - aZ[k] )/aA[k], k ) );
+	::std::sort( aOrder.begin(), aOrder.end() );
+
+	vector<bool> aInCover( aVars.size(), false );
+	double fCoverSum = 0.0;
+	for ( size_t n = 0; n < aOrder.size() && fCoverSum <= fB + fTol; ++n )
+	{
+		aInCover[aOrder[n].second] = true;
+		fCoverSum += aA[aOrder[n].second];
+	}
+
+	// Dropping a variable with z_j < 1 makes the cut more violated, as
+	// long as what remains is still a cover.
+	vector< pair<double, size_t> > aDrop;
+	for ( size_t k = 0; k < aVars.size(); ++k )
+		if ( aInCover[k] )
+			aDrop.push_back( pair<double, size_t>( aZ[k], k ) );
+	::std::sort( aDrop.begin(), aDrop.end() );
+	for ( size_t n = 0; n < aDrop.size(); ++n )
+	{
+		size_t k = aDrop[n].second;
+		if ( aZ[k] < 1.0 - INTEGER_TOL && fCoverSum - aA[k] > fB + fTol )
+		{
+			aInCover[k] = false;
+			fCoverSum -= aA[k];
+		}
+	}
+
+	size_t nCoverSize = 0;
+	double fMaxA = 0.0;
+	for ( size_t k = 0; k < aVars.size(); ++k )
+		if ( aInCover[k] )
+		{
+			++nCoverSize;
+			fMaxA = ::std::max( fMaxA, aA[k] );
+		}
+
+	vector<double> aCoef( m_nVarCount, 0.0 );
+	double fCutRhs = static_cast<double>( nCoverSize ) - 1.0;
+	for ( size_t k = 0; k < aVars.size(); ++k )
+	{
+		if ( !aInCover[k] && aA[k] < fMaxA )
+			continue;
+		if ( aComplement[k] )
+		{
+			aCoef[aVars[k]] = -1.0;
+			fCutRhs -= 1.0;
+		}
+		else
+			aCoef[aVars[k]] = 1.0;
+	}
+	addCut( aCoef, fCutRhs, rCuts );
+}
+
+void Separator::cover( vector<Cut>& rCuts ) const
+{
+	for ( size_t i = 0; i < m_aLeRows.size(); ++i )
+		coverRow( m_aLeRows[i], m_aLeRhs[i], rCuts );
+}
+
+//---------------------------------------------------------------------------
+// CutGeneratorImpl
+
+class CutGeneratorImpl
+{
+public:
+	CutGeneratorImpl()
+	{
+		for ( size_t i = 0; i < 3; ++i )
+			m_bEnabled[i] = true;
+	}
+
+	~CutGeneratorImpl() throw()
+	{
+	}
+
+	void setEnabled( CutType eType, bool bEnabled ) { m_bEnabled[eType] = bEnabled; }
+	bool isEnabled( CutType eType ) const { return m_bEnabled[eType]; }
+
+	void generate( const Model& aModel, const Matrix& mxSolution, const Basis& aBasis,
+				   vector<Cut>& rCuts ) const
+	{
+		if ( !aModel.getVarInteger() )
+			return;
+
+		Separator aSeparator( aModel, mxSolution );
+		if ( m_bEnabled[CUT_GOMORY] )
+			aSeparator.gomory( aBasis, rCuts );
+		if ( m_bEnabled[CUT_MIR] )
+			aSeparator.mir( rCuts );
+		if ( m_bEnabled[CUT_COVER] )
+			aSeparator.cover( rCuts );
+	}
+
+private:
+	bool m_bEnabled[3];
+};
+
+//---------------------------------------------------------------------------
+// CutPoolImpl
+
+class CutPoolImpl
+{
+public:
+	CutPoolImpl() : m_nNextId( 0 )
+	{
+	}
+
+	~CutPoolImpl() throw()
+	{
+	}
+
+	bool add( const Cut& aCut );
+	size_t separate( const Matrix& mxX, size_t nMax );
+	void update( const Matrix& mxX );
+	void getActive( vector<size_t>& rIds ) const { rIds = m_aActive; }
+	const Cut& getCut( size_t nId ) const;
+	size_t size() const { return m_aEntries.size(); }
+
+	void clear()
+	{
+		m_aEntries.clear();
+		m_aActive.clear();
+	}
+
+private:
+	struct Entry
+	{
+		Cut PoolCut;
+		bool Active;
+		size_t Age;
+
+		Entry() : Active( false ), Age( 0 ) {}
+	};
+
+	/** ordered by identifier, i.e. from the oldest cut to the newest. */
+	map<size_t, Entry> m_aEntries;
+	vector<size_t> m_aActive;
+	size_t m_nNextId;
+};
+
+bool CutPoolImpl::add( const Cut& aCut )
+{
+	double fNorm = 0.0;
+	const vector<double>& rCoef = aCut.getCoefficients();
+	for ( size_t j = 0; j < rCoef.size(); ++j )
+		fNorm += rCoef[j]*rCoef[j];
+	fNorm = ::std::sqrt( fNorm );
+	if ( fNorm == 0.0 )
+		return false;
+
+	map<size_t, Entry>::iterator itr = m_aEntries.begin(), itrEnd = m_aEntries.end();
+	map<size_t, Entry>::iterator itrInactive = itrEnd;
+	for ( ; itr != itrEnd; ++itr )
+	{
+		const Cut& rOther = itr->second.PoolCut;
+		if ( itrInactive == itrEnd && !itr->second.Active )
+			itrInactive = itr;
+		if ( aCut.getParallelism( rOther ) < DUPLICATE_PARALLELISM )
+			continue;
+
+		// Same direction: compare the right hand sides at unit norm.
+		double fOtherNorm = 0.0;
+		const vector<double>& rOtherCoef = rOther.getCoefficients();
+		for ( size_t j = 0; j < rOtherCoef.size(); ++j )
+			fOtherNorm += rOtherCoef[j]*rOtherCoef[j];
+		fOtherNorm = ::std::sqrt( fOtherNorm );
+		if ( rOther.getRhs()/fOtherNorm <= aCut.getRhs()/fNorm + 1e-9 )
+			return false;
+	}
+
+	if ( m_aEntries.size() >= MAX_POOL_SIZE )
+	{
+		// Make room by dropping the oldest inactive cut.
+		if ( itrInactive == itrEnd )
+			return false;
+		m_aEntries.erase( itrInactive );
+	}
+
+	Entry aEntry;
+	aEntry.PoolCut = aCut;
+	m_aEntries.insert( pair<size_t, Entry>( m_nNextId++, aEntry ) );
+	return true;
+}
+
+size_t CutPoolImpl::separate( const Matrix& mxX, size_t nMax )
+{
+	vector< pair<double, size_t> > aCandidates;
+	map<size_t, Entry>::const_iterator itr = m_aEntries.begin(), itrEnd = m_aEntries.end();
+	for ( ; itr != itrEnd; ++itr )
+	{
+		if ( itr->second.Active )
+			continue;
+		double fEfficacy = itr->second.PoolCut.getEfficacy( mxX );
+		if ( fEfficacy >= MIN_EFFICACY )
+			aCandidates.push_back( pair<double, size_t>( fEfficacy, itr->first ) );
+	}
+	::std::stable_sort( aCandidates.begin(), aCandidates.end(), EfficacyGreater() );
+
+	vector<size_t> aSelected;
+	for ( size_t n = 0; n < aCandidates.size() && aSelected.size() < nMax; ++n )
+	{
+		const Cut& rCut = m_aEntries[aCandidates[n].second].PoolCut;
+		bool bParallel = false;
+		for ( size_t k = 0; k < aSelected.size() && !bParallel; ++k )
+			bParallel = rCut.getParallelism( m_aEntries[aSelected[k]].PoolCut ) > SELECT_PARALLELISM;
+		if ( !bParallel )
+			aSelected.push_back( aCandidates[n].second );
+	}
+
+	for ( size_t k = 0; k < aSelected.size(); ++k )
+	{
+		Entry& rEntry = m_aEntries[aSelected[k]];
+		rEntry.Active = true;
+		rEntry.Age = 0;
+		m_aActive.push_back( aSelected[k] );
+	}
+	return aSelected.size();
+}
+
+void CutPoolImpl::update( const Matrix& mxX )
+{
+	vector<size_t> aActive;
+	for ( size_t k = 0; k < m_aActive.size(); ++k )
+	{
+		Entry& rEntry = m_aEntries[m_aActive[k]];
+		double fSlack = -rEntry.PoolCut.getViolation( mxX );
+		if ( fSlack > 1e-6*( 1.0 + ::std::fabs( rEntry.PoolCut.getRhs() ) ) )
+			++rEntry.Age;
+		else
+			rEntry.Age = 0;
+
+		if ( rEntry.Age > MAX_AGE )
+			rEntry.Active = false;
+		else
+			aActive.push_back( m_aActive[k] );
+	}
+	m_aActive.swap( aActive );
+}
+
+const Cut& CutPoolImpl::getCut( size_t nId ) const
+{
+	map<size_t, Entry>::const_iterator itr = m_aEntries.find( nId );
+	if ( itr == m_aEntries.end() )
+		throw BadIndex();
+	return itr->second.PoolCut;
+}
+
+//---------------------------------------------------------------------------
+// CutGenerator
+
+CutGenerator::CutGenerator() : m_pImpl( new CutGeneratorImpl )
+{
+}
+
+CutGenerator::~CutGenerator() throw()
+{
+}
+
+void CutGenerator::setEnabled( CutType eType, bool bEnabled )
+{
+	m_pImpl->setEnabled( eType, bEnabled );
+}
+
+bool CutGenerator::isEnabled( CutType eType ) const
+{
+	return m_pImpl->isEnabled( eType );
+}
+
+void CutGenerator::generate( const Model& aModel, const Matrix& mxSolution, const Basis& aBasis,
+							 vector<Cut>& rCuts ) const
+{
+	m_pImpl->generate( aModel, mxSolution, aBasis, rCuts );
+}
+
+//---------------------------------------------------------------------------
+// CutPool
+
+CutPool::CutPool() : m_pImpl( new CutPoolImpl )
+{
+}
+
+CutPool::~CutPool() throw()
+{
+}
+
+bool CutPool::add( const Cut& aCut )
+{
+	return m_pImpl->add( aCut );
+}
+
+size_t CutPool::separate( const Matrix& mxX, size_t nMax )
+{
+	return m_pImpl->separate( mxX, nMax );
+}
+
+void CutPool::update( const Matrix& mxX )
+{
+	m_pImpl->update( mxX );
+}
+
+void CutPool::getActive( vector<size_t>& rIds ) const
+{
+	m_pImpl->getActive( rIds );
+}
+
+const Cut& CutPool::getCut( size_t nId ) const
+{
+	return m_pImpl->getCut( nId );
+}
+
+size_t CutPool::size() const
+{
+	return m_pImpl->size();
+}
+
+void CutPool::clear()
+{
+	m_pImpl->clear();
+}
+
+}}}
@@ -0,0 +1,212 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/lpcuts.hxx"
+#include "numeric/lpdualsimplex.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/exception.hxx"
+#include "lptestutil.hxx"
+
+#include <vector>
+#include <cmath>
+#include <stdio.h>
+
+using namespace ::scsolver::numeric;
+using namespace ::scsolver::numeric::lp;
+using namespace ::scsolver::numeric::lp::test;
+using ::std::vector;
+
+namespace {
+
+/**
+ * Integer model max c x with rows of mixed sign and sense, and
+ * 0 <= x <= nUpper, small enough to enumerate all integer points.
+ */
+void buildModel(Model& model, size_t nRows, size_t nCols, int nUpper, unsigned long seed)
+{
+    vector<double> cost(nCols);
+    for (size_t j = 0; j < nCols; ++j)
+        cost[j] = 1.0 + ::std::floor(9.0*nextValue(seed));
+    model.setCostVector(cost);
+    model.setGoal(GOAL_MAXIMIZE);
+    model.setVarPositive(true);
+    model.setVarInteger(true);
+    for (size_t j = 0; j < nCols; ++j)
+        model.setVarBound(j, BOUND_UPPER, nUpper);
+
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        vector<double> row(nCols);
+        for (size_t j = 0; j < nCols; ++j)
+            row[j] = ::std::floor(1.0 + 9.0*nextValue(seed));
+        if (i % 3 == 2)
+        {
+            // x_a - x_b >= -k, with a negative coefficient
+            row.assign(nCols, 0.0);
+            row[i % nCols] = 1.0;
+            row[(i + 1) % nCols] = -1.0;
+            model.addConstraint(row, GREATER_EQUAL, -::std::floor(nUpper*nextValue(seed)));
+        }
+        else
+            model.addConstraint(row, LESS_EQUAL, ::std::floor(5.0 + 15.0*nUpper*nextValue(seed)));
+    }
+}
+
+/**
+ * @return size_t number of integer feasible points that violate any of
+ *         the cuts.
+ */
+size_t countCutOff(const Model& model, int nUpper, const vector<Cut>& cuts)
+{
+    size_t n = model.getDecisionVarSize(), nCutOff = 0;
+    Matrix x(n, 1);
+    vector<int> v(n, 0);
+    while (true)
+    {
+        for (size_t j = 0; j < n; ++j)
+            x(j, 0) = v[j];
+        if (isFeasible(model, x))
+            for (size_t k = 0; k < cuts.size(); ++k)
+                if (cuts[k].getViolation(x) > 1e-7)
+                {
+                    ++nCutOff;
+                    break;
+                }
+
+        size_t j = 0;
+        while (j < n && v[j] == nUpper)
+            v[j++] = 0;
+        if (j == n)
+            break;
+        ++v[j];
+    }
+    return nCutOff;
+}
+
+void validity()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("validity of cuts\n");
+
+    const CutType types[] = { CUT_GOMORY, CUT_MIR, CUT_COVER };
+    const char* names[] = { "gomory", "mir", "cover" };
+    size_t nTotal[3] = { 0, 0, 0 }, nCutOff = 0;
+    for (unsigned long seed = 1; seed <= 20; ++seed)
+    {
+        int nUpper = seed % 2 ? 1 : 3;
+        Model model;
+        buildModel(model, 4, 6, nUpper, seed);
+
+        DualSimplex algorithm;
+        algorithm.setModel(&model);
+        try
+        {
+            algorithm.solve();
+        }
+        catch (const ModelInfeasible&)
+        {
+            continue;
+        }
+        Matrix sol = algorithm.getSolution();
+
+        for (size_t t = 0; t < 3; ++t)
+        {
+            CutGenerator generator;
+            for (size_t u = 0; u < 3; ++u)
+                generator.setEnabled(types[u], u == t);
+            vector<Cut> cuts;
+            generator.generate(model, sol, algorithm.getBasis(), cuts);
+
+            bool bViolated = true;
+            for (size_t k = 0; k < cuts.size(); ++k)
+                bViolated = bViolated && cuts[k].getEfficacy(sol) > 0.0;
+            check(bViolated, "cuts separate the relaxed optimum");
+            nTotal[t] += cuts.size();
+            nCutOff += countCutOff(model, nUpper, cuts);
+        }
+    }
+    for (size_t t = 0; t < 3; ++t)
+        printf("%s: %lu cut(s)\n", names[t], static_cast<unsigned long>(nTotal[t]));
+    check(nTotal[0] > 0 && nTotal[1] > 0 && nTotal[2] > 0, "all families found cuts");
+    check(nCutOff == 0, "no integer solution cut off");
+
+    // A continuous model has no cuts.
+    Model model;
+    buildModel(model, 4, 6, 3, 1);
+    model.setVarInteger(false);
+    DualSimplex algorithm;
+    algorithm.setModel(&model);
+    algorithm.solve();
+    CutGenerator generator;
+    vector<Cut> cuts;
+    generator.generate(model, algorithm.getSolution(), algorithm.getBasis(), cuts);
+    check(cuts.empty(), "no cuts for a continuous model");
+}
+
+void pool()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("cut pool\n");
+
+    // x0 + x1 <= 1, its multiple, a weaker copy, and x0 - x1 <= 0
+    vector<double> a(2, 1.0);
+    Cut cut(a, 1.0);
+    vector<double> b(2, 2.0);
+    vector<double> c(2);
+    c[0] = 1.0;
+    c[1] = -1.0;
+
+    CutPool pool;
+    check(pool.add(cut), "cut added");
+    check(!pool.add(Cut(b, 2.0)), "multiple rejected");
+    check(!pool.add(Cut(a, 1.5)), "weaker cut rejected");
+    check(pool.add(Cut(c, 0.0)), "other cut added");
+    check(pool.size() == 2, "pool size");
+
+    // (0.6, 0.6) violates only the first cut.
+    Matrix x(2, 1);
+    x(0, 0) = 0.6;
+    x(1, 0) = 0.6;
+    check(pool.separate(x, 10) == 1, "violated cut activated");
+    vector<size_t> ids;
+    pool.getActive(ids);
+    check(ids.size() == 1 && pool.getCut(ids[0]).getRhs() == 1.0, "active cut");
+    check(pool.separate(x, 10) == 0, "active cut not activated twice");
+
+    // The cut is deactivated after staying slack for a few rounds.
+    x(0, 0) = 0.2;
+    x(1, 0) = 0.2;
+    size_t nRounds = 0;
+    for (; nRounds < 10 && !ids.empty(); ++nRounds)
+    {
+        pool.update(x);
+        pool.getActive(ids);
+    }
+    printf("deactivated after %lu round(s)\n", static_cast<unsigned long>(nRounds));
+    check(ids.empty() && nRounds > 1 && pool.size() == 2, "slack cut deactivated");
+}
+
+}
+
+int main()
+{
+    printf("unit test: cuts\n");
+    validity();
+    pool();
+    printf("Unit test passed!\n");
+}
@@ -0,0 +1,636 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/lpdualsimplex.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/exception.hxx"
+#include "numeric/solvecontrol.hxx"
+#include "tool/global.hxx"
+
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <iostream>
+
+using ::std::vector;
+using ::std::cout;
+using ::std::endl;
+
+namespace scsolver { namespace numeric { namespace lp {
+
+namespace {
+
+const double INF = ::std::numeric_limits<double>::infinity();
+
+/** absolute tolerance for bound violation, relative for large bounds. */
+const double PRIMAL_TOL = 1e-9;
+
+/** tolerance for the sign of a reduced cost. */
+const double DUAL_TOL = 1e-9;
+
+/** smallest acceptable pivot element. */
+const double PIVOT_TOL = 1e-9;
+
+/** number of pivots between re-inversions of the basis matrix. */
+const size_t REFACTOR_INTERVAL = 50;
+
+}
+
+//---------------------------------------------------------------------------
+// DualSimplexImpl
+
+/**
+ * The model is stored in the computational form
+ *
+ *     min c x  subject to  [A -I] (x, r) = 0,  l <= (x, r) <= u
+ *
+ * where r holds the row activities, bounded by the right hand side.  The
+ * first m_nVarCount variables are the decision variables, the remaining
+ * m_nRowCount variables the rows.  With a zero right hand side, changing
+ * the right hand side of the model only changes the bounds, which leaves
+ * a dual feasible basis dual feasible.
+ */
+class DualSimplexImpl
+{
+public:
+	DualSimplexImpl( DualSimplex* p );
+	~DualSimplexImpl() throw();
+
+	void solve();
+
+	size_t getIterationCount() const { return m_nIter; }
+
+private:
+	DualSimplex* m_pSelf;
+
+	Basis m_aStartBasis;
+	size_t m_nIter;
+	bool m_bVerbose;
+
+	size_t m_nVarCount;
+	size_t m_nRowCount;
+
+	Matrix m_mxA;
+	vector<double> m_aCost;
+	vector<double> m_aLower;
+	vector<double> m_aUpper;
+
+	vector<BasisStatus> m_aStatus;
+	vector<size_t> m_aBasicVarId;
+	Matrix m_mxBasicInv;
+	vector<double> m_aX;
+	vector<double> m_aReducedCost;
+
+	size_t getTotalCount() const { return m_nVarCount + m_nRowCount; }
+
+	void buildProblem();
+	void initSlackBasis();
+	bool initStartBasis();
+	void factorize();
+
+	void normalizeStatus( const vector<double>& rLower, const vector<double>& rUpper );
+	void computeReducedCosts();
+	void flipBoxedVars( const vector<double>& rLower, const vector<double>& rUpper );
+	bool isDualFeasible( const vector<double>& rLower, const vector<double>& rUpper ) const;
+	void computePrimal( const vector<double>& rLower, const vector<double>& rUpper );
+
+	bool selectLeavingRow( const vector<double>& rLower, const vector<double>& rUpper,
+						   size_t& rRow, double& rDelta ) const;
+	bool selectEnteringVar( const vector<double>& rLower, const vector<double>& rUpper,
+							size_t nRow, double fDelta, size_t& rEnterVarId ) const;
+	void pivot( size_t nRow, size_t nEnterVarId, BasisStatus eLeaveStatus );
+
+	void runDualSimplex( const vector<double>& rLower, const vector<double>& rUpper );
+};
+
+DualSimplexImpl::DualSimplexImpl( DualSimplex* p ) :
+	m_pSelf( p ), m_nIter( 0 ), m_bVerbose( false ),
+	m_nVarCount( 0 ), m_nRowCount( 0 ), m_mxA( 0, 0 ), m_mxBasicInv( 0, 0 )
+{
+}
+
+DualSimplexImpl::~DualSimplexImpl() throw()
+{
+}
+
+void DualSimplexImpl::buildProblem()
+{
+	Model* pModel = m_pSelf->getModel();
+	Matrix mxA = pModel->getConstraintMatrix();
+	Matrix mxC = pModel->getCostVector();
+
+	m_nRowCount = mxA.rows();
+	m_nVarCount = ::std::max( mxA.cols(), mxC.cols() );
+	size_t nTotal = getTotalCount();
+
+	Matrix mxFull( m_nRowCount, nTotal );
+	for ( size_t i = 0; i < m_nRowCount; ++i )
+	{
+		for ( size_t j = 0; j < mxA.cols(); ++j )
+			mxFull( i, j ) = mxA( i, j );
+		mxFull( i, m_nVarCount + i ) = -1.0;
+	}
+	m_mxA.swap( mxFull );
+
+	double fSign = pModel->getGoal() == GOAL_MAXIMIZE ? -1.0 : 1.0;
+	m_aCost.assign( nTotal, 0.0 );
+	for ( size_t j = 0; j < mxC.cols(); ++j )
+		m_aCost[j] = fSign*mxC( 0, j );
+
+	m_aLower.assign( nTotal, -INF );
+	m_aUpper.assign( nTotal, INF );
+	for ( size_t j = 0; j < m_nVarCount; ++j )
+	{
+		if ( pModel->getVarPositive() )
+			m_aLower[j] = 0.0;
+		if ( pModel->isVarBounded( j, BOUND_LOWER ) )
+			m_aLower[j] = ::std::max( m_aLower[j], pModel->getVarBound( j, BOUND_LOWER ) );
+		if ( pModel->isVarBounded( j, BOUND_UPPER ) )
+			m_aUpper[j] = pModel->getVarBound( j, BOUND_UPPER );
+		if ( m_aLower[j] > m_aUpper[j] )
+			throw ModelInfeasible();
+	}
+
+	for ( size_t i = 0; i < m_nRowCount; ++i )
+	{
+		size_t j = m_nVarCount + i;
+		double fRhs = pModel->getRhsValue( i );
+		switch ( pModel->getEquality( i ) )
+		{
+		case LESS_EQUAL:
+			m_aUpper[j] = fRhs;
+			break;
+		case GREATER_EQUAL:
+			m_aLower[j] = fRhs;
+			break;
+		case EQUAL:
+			m_aLower[j] = m_aUpper[j] = fRhs;
+			break;
+		}
+	}
+}
+
+/**
+ * All rows basic, and all decision variables non-basic.
+ */
+void DualSimplexImpl::initSlackBasis()
+{
+	m_aStatus.assign( getTotalCount(), BASIS_LOWER );
+	m_aBasicVarId.clear();
+	for ( size_t i = 0; i < m_nRowCount; ++i )
+	{
+		m_aStatus[m_nVarCount + i] = BASIS_BASIC;
+		m_aBasicVarId.push_back( m_nVarCount + i );
+	}
+	factorize();
+}
+
+/**
+ * Take the statuses from the start basis.  Rows added since the basis was
+ * saved are made basic.
+ *
+ * @return bool true if the start basis fits the model, false otherwise.
+ */
+bool DualSimplexImpl::initStartBasis()
+{
+	if ( m_aStartBasis.empty() || m_aStartBasis.getVarCount() != m_nVarCount ||
+		 m_aStartBasis.getRowCount() > m_nRowCount )
+		return false;
+
+	m_aStatus.assign( getTotalCount(), BASIS_BASIC );
+	for ( size_t j = 0; j < m_nVarCount; ++j )
+		m_aStatus[j] = m_aStartBasis.getVarStatus( j );
+	for ( size_t i = 0; i < m_aStartBasis.getRowCount(); ++i )
+		m_aStatus[m_nVarCount + i] = m_aStartBasis.getRowStatus( i );
+
+	m_aBasicVarId.clear();
+	for ( size_t j = 0; j < getTotalCount(); ++j )
+		if ( m_aStatus[j] == BASIS_BASIC )
+			m_aBasicVarId.push_back( j );
+
+	if ( m_aBasicVarId.size() != m_nRowCount )
+		return false;
+
+	try
+	{
+		factorize();
+	}
+	catch ( const SingularMatrix& )
+	{
+		return false;
+	}
+	return true;
+}
+
+void DualSimplexImpl::factorize()
+{
+	if ( m_nRowCount == 0 )
+	{
+		m_mxBasicInv.resize( 0, 0 );
+		return;
+	}
+
+	Matrix mxB( m_nRowCount, m_nRowCount );
+	for ( size_t k = 0; k < m_nRowCount; ++k )
+	{
+		size_t nId = m_aBasicVarId[k];
+		for ( size_t i = 0; i < m_nRowCount; ++i )
+			mxB( i, k ) = m_mxA( i, nId );
+	}
+	m_mxBasicInv = mxB.inverse();
+}
+
+/**
+ * Make the status of each non-basic variable consistent with its bounds:
+ * a variable can only be at a finite bound.
+ */
+void DualSimplexImpl::normalizeStatus( const vector<double>& rLower, const vector<double>& rUpper )
+{
+	for ( size_t j = 0; j < getTotalCount(); ++j )
+	{
+		if ( m_aStatus[j] == BASIS_UPPER && rUpper[j] == INF )
+			m_aStatus[j] = BASIS_LOWER;
+		else if ( m_aStatus[j] == BASIS_LOWER && rLower[j] == -INF && rUpper[j] != INF )
+			m_aStatus[j] = BASIS_UPPER;
+	}
+}
+
+/**
+ * d_j = c_j - y a_j with y = c_B B^-1.  Basic variables get zero.
+ */
+void DualSimplexImpl::computeReducedCosts()
+{
+	vector<double> aY( m_nRowCount, 0.0 );
+	for ( size_t k = 0; k < m_nRowCount; ++k )
+	{
+		double fCost = m_aCost[m_aBasicVarId[k]];
+		if ( fCost == 0.0 )
+			continue;
+		for ( size_t i = 0; i < m_nRowCount; ++i )
+			aY[i] += fCost*m_mxBasicInv( k, i );
+	}
+
+	m_aReducedCost.assign( getTotalCount(), 0.0 );
+	for ( size_t j = 0; j < getTotalCount(); ++j )
+	{
+		if ( m_aStatus[j] == BASIS_BASIC )
+			continue;
+		double fD = m_aCost[j];
+		for ( size_t i = 0; i < m_nRowCount; ++i )
+			fD -= aY[i]*m_mxA( i, j );
+		m_aReducedCost[j] = fD;
+	}
+}
+
+/**
+ * Move each non-basic variable with two finite bounds to the bound at
+ * which its reduced cost has the dual feasible sign.
+ */
+void DualSimplexImpl::flipBoxedVars( const vector<double>& rLower, const vector<double>& rUpper )
+{
+	for ( size_t j = 0; j < getTotalCount(); ++j )
+	{
+		if ( m_aStatus[j] == BASIS_BASIC || rLower[j] == -INF || rUpper[j] == INF )
+			continue;
+
+		if ( m_aReducedCost[j] > DUAL_TOL )
+			m_aStatus[j] = BASIS_LOWER;
+		else if ( m_aReducedCost[j] < -DUAL_TOL )
+			m_aStatus[j] = BASIS_UPPER;
+	}
+}
+
+bool DualSimplexImpl::isDualFeasible( const vector<double>& rLower, const vector<double>& rUpper ) const
+{
+	for ( size_t j = 0; j < getTotalCount(); ++j )
+	{
+		if ( m_aStatus[j] == BASIS_BASIC )
+			continue;
+
+		bool bHasLower = rLower[j] != -INF, bHasUpper = rUpper[j] != INF;
+		if ( bHasLower && bHasUpper )
+			continue;
+
+		double fD = m_aReducedCost[j];
+		if ( !bHasLower && !bHasUpper && ::std::fabs( fD ) > DUAL_TOL )
+			return false;
+		if ( bHasLower && !bHasUpper && fD < -DUAL_TOL )
+			return false;
+		if ( !bHasLower && bHasUpper && fD > DUAL_TOL )
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Set the non-basic variables to their bounds and solve for the basic
+ * variables, x_B = -B^-1 N x_N.
+ */
+void DualSimplexImpl::computePrimal( const vector<double>& rLower, const vector<double>& rUpper )
+{
+	m_aX.assign( getTotalCount(), 0.0 );
+	vector<double> aRhs( m_nRowCount, 0.0 );
+	for ( size_t j = 0; j < getTotalCount(); ++j )
+	{
+		switch ( m_aStatus[j] )
+		{
+		case BASIS_BASIC:
+			continue;
+		case BASIS_LOWER:
+			m_aX[j] = rLower[j] != -INF ? rLower[j] : 0.0;
+			break;
+		case BASIS_UPPER:
+			m_aX[j] = rUpper[j];
+			break;
+		}
+
+		double fX = m_aX[j];
+		if ( fX == 0.0 )
+			continue;
+		for ( size_t i = 0; i < m_nRowCount; ++i )
+			aRhs[i] -= m_mxA( i, j )*fX;
+	}
+
+	for ( size_t k = 0; k < m_nRowCount; ++k )
+	{
+		double fX = 0.0;
+		for ( size_t i = 0; i < m_nRowCount; ++i )
+			fX += m_mxBasicInv( k, i )*aRhs[i];
+		m_aX[m_aBasicVarId[k]] = fX;
+	}
+}
+
+/**
+ * Pick the basic variable with the largest bound violation.
+ *
+ * @param rDelta (reference) x_B - l_B when below the lower bound (negative),
+ *               or x_B - u_B when above the upper bound (positive).
+ * @return bool false if the basis is primal feasible i.e. optimal.
+ */
+bool DualSimplexImpl::selectLeavingRow( const vector<double>& rLower, const vector<double>& rUpper,
+										size_t& rRow, double& rDelta ) const
+{
+	double fMaxViolation = 0.0;
+	bool bFound = false;
+	for ( size_t k = 0; k < m_nRowCount; ++k )
+	{
+		size_t nId = m_aBasicVarId[k];
+		double fX = m_aX[nId];
+		double fDelta = 0.0;
+		if ( fX < rLower[nId] - PRIMAL_TOL*( 1.0 + ::std::fabs( rLower[nId] ) ) )
+			fDelta = fX - rLower[nId];
+		else if ( fX > rUpper[nId] + PRIMAL_TOL*( 1.0 + ::std::fabs( rUpper[nId] ) ) )
+			fDelta = fX - rUpper[nId];
+		else
+			continue;
+
+		if ( ::std::fabs( fDelta ) > fMaxViolation )
+		{
+			fMaxViolation = ::std::fabs( fDelta );
+			rRow = k;
+			rDelta = fDelta;
+			bFound = true;
+		}
+	}
+	return bFound;
+}
+
+/**
+ * Dual ratio test on the pivot row alpha_r = e_r B^-1 N.  Among the
+ * non-basic variables that can move the leaving variable towards its
+ * violated bound, pick the one whose reduced cost reaches zero first, so
+ * that the basis stays dual feasible.  Ties go to the larger pivot.
+ *
+ * @return bool false if there is no such variable, meaning that the model
+ *         is primal infeasible.
+ */
+bool DualSimplexImpl::selectEnteringVar( const vector<double>& rLower, const vector<double>& rUpper,
+										 size_t nRow, double fDelta, size_t& rEnterVarId ) const
+{
+	double fSign = fDelta < 0.0 ? -1.0 : 1.0;
+	double fMinRatio = INF, fBestPivot = 0.0;
+	bool bFound = false;
+	for ( size_t j = 0; j < getTotalCount(); ++j )
+	{
+		if ( m_aStatus[j] == BASIS_BASIC || rLower[j] == rUpper[j] )
+			continue;
+
+		double fAlpha = 0.0;
+		for ( size_t i = 0; i < m_nRowCount; ++i )
+			fAlpha += m_mxBasicInv( nRow, i )*m_mxA( i, j );
+		fAlpha *= fSign;
+		if ( ::std::fabs( fAlpha ) < PIVOT_TOL )
+			continue;
+
+		bool bFree = rLower[j] == -INF && rUpper[j] == INF;
+		if ( !bFree && !( m_aStatus[j] == BASIS_LOWER && fAlpha > 0.0 ) &&
+			 !( m_aStatus[j] == BASIS_UPPER && fAlpha < 0.0 ) )
+			continue;
+
+		double fRatio = ::std::fabs( m_aReducedCost[j] ) / ::std::fabs( fAlpha );
+		if ( fRatio < fMinRatio - DUAL_TOL ||
+			 ( fRatio <= fMinRatio + DUAL_TOL && ::std::fabs( fAlpha ) > fBestPivot ) )
+		{
+			fMinRatio = fRatio;
+			fBestPivot = ::std::fabs( fAlpha );
+			rEnterVarId = j;
+			bFound = true;
+		}
+	}
+	return bFound;
+}
+
+/**
+ * Replace the basic variable of a row with the entering variable, and
+ * update the basis inverse.
+ */
+void DualSimplexImpl::pivot( size_t nRow, size_t nEnterVarId, BasisStatus eLeaveStatus )
+{
+	size_t nLeaveVarId = m_aBasicVarId[nRow];
+	m_aStatus[nLeaveVarId] = eLeaveStatus;
+	m_aStatus[nEnterVarId] = BASIS_BASIC;
+	m_aBasicVarId[nRow] = nEnterVarId;
+	++m_nIter;
+
+	if ( m_nIter % REFACTOR_INTERVAL == 0 )
+	{
+		factorize();
+		return;
+	}
+
+	vector<double> aAlpha( m_nRowCount, 0.0 );
+	for ( size_t i = 0; i < m_nRowCount; ++i )
+	{
+		double fA = m_mxA( i, nEnterVarId );
+		if ( fA == 0.0 )
+			continue;
+		for ( size_t k = 0; k < m_nRowCount; ++k )
+			aAlpha[k] += m_mxBasicInv( k, i )*fA;
+	}
+
+	double fPivot = aAlpha[nRow];
+	if ( ::std::fabs( fPivot ) < PIVOT_TOL )
+	{
+		factorize();
+		return;
+	}
+
+	for ( size_t i = 0; i < m_nRowCount; ++i )
+		m_mxBasicInv( nRow, i ) /= fPivot;
+
+	for ( size_t k = 0; k < m_nRowCount; ++k )
+	{
+		if ( k == nRow || aAlpha[k] == 0.0 )
+			continue;
+		double fFactor = aAlpha[k];
+		for ( size_t i = 0; i < m_nRowCount; ++i )
+			m_mxBasicInv( k, i ) -= fFactor*m_mxBasicInv( nRow, i );
+	}
+}
+
+/**
+ * Iterate until the basis is primal feasible.  The basis must be dual
+ * feasible for the given bounds on entry, apart from variables with two
+ * finite bounds, which are moved to the proper bound.
+ */
+void DualSimplexImpl::runDualSimplex( const vector<double>& rLower, const vector<double>& rUpper )
+{
+	const size_t nMaxIter = 50*getTotalCount() + 1000;
+	normalizeStatus( rLower, rUpper );
+	while ( true )
+	{
+		computeReducedCosts();
+		flipBoxedVars( rLower, rUpper );
+		computePrimal( rLower, rUpper );
+
+		size_t nRow = 0;
+		double fDelta = 0.0;
+		if ( !selectLeavingRow( rLower, rUpper, nRow, fDelta ) )
+			return;
+
+		size_t nEnterVarId = 0;
+		if ( !selectEnteringVar( rLower, rUpper, nRow, fDelta, nEnterVarId ) )
+		{
+			if ( m_bVerbose )
+				cout << "dual unbounded: model infeasible" << endl;
+			throw ModelInfeasible();
+		}
+
+		if ( m_bVerbose )
+			cout << "iteration " << m_nIter << ": x" << nEnterVarId << " enters and x"
+				 << m_aBasicVarId[nRow] << " leaves (violation " << fDelta << ")" << endl;
+
+		pivot( nRow, nEnterVarId, fDelta < 0.0 ? BASIS_LOWER : BASIS_UPPER );
+		const SolveControl* pControl = m_pSelf->getSolveControl();
+		pControl->checkIteration( m_nIter, nMaxIter );
+		pControl->reportIteration( m_nIter );
+	}
+}
+
+void DualSimplexImpl::solve()
+{
+	m_bVerbose = m_pSelf->getModel()->getVerbose();
+	m_aStartBasis = m_pSelf->getStartBasis();
+	m_nIter = 0;
+	buildProblem();
+
+	if ( !initStartBasis() )
+	{
+		if ( m_bVerbose && !m_aStartBasis.empty() )
+			cout << "start basis does not fit the model; using the slack basis" << endl;
+		initSlackBasis();
+	}
+
+	normalizeStatus( m_aLower, m_aUpper );
+	computeReducedCosts();
+	flipBoxedVars( m_aLower, m_aUpper );
+	if ( !isDualFeasible( m_aLower, m_aUpper ) )
+	{
+		// Dual phase 1: solve the auxiliary problem in which every variable
+		// is boxed, so that any basis is dual feasible.  Its optimal basis is
+		// dual feasible for the original problem, unless the original problem
+		// is dual infeasible.
+		if ( m_bVerbose )
+			cout << "dual phase 1" << endl;
+
+		size_t nTotal = getTotalCount();
+		vector<double> aLower( nTotal ), aUpper( nTotal );
+		for ( size_t j = 0; j < nTotal; ++j )
+		{
+			bool bHasLower = m_aLower[j] != -INF, bHasUpper = m_aUpper[j] != INF;
+			aLower[j] = bHasLower ? 0.0 : -1.0;
+			aUpper[j] = bHasUpper ? 0.0 : 1.0;
+		}
+		runDualSimplex( aLower, aUpper );
+
+		normalizeStatus( m_aLower, m_aUpper );
+		computeReducedCosts();
+		flipBoxedVars( m_aLower, m_aUpper );
+		if ( !isDualFeasible( m_aLower, m_aUpper ) )
+		{
+			if ( m_bVerbose )
+				cout << "dual infeasible: model unbounded or infeasible" << endl;
+			throw ModelInfeasible();
+		}
+	}
+
+	runDualSimplex( m_aLower, m_aUpper );
+
+	Matrix mxSolution( m_nVarCount, 1 );
+	for ( size_t j = 0; j < m_nVarCount; ++j )
+		mxSolution( j, 0 ) = m_aX[j];
+	m_pSelf->setSolution( mxSolution );
+
+	Basis aBasis( m_nVarCount, m_nRowCount );
+	for ( size_t j = 0; j < m_nVarCount; ++j )
+		aBasis.setVarStatus( j, m_aStatus[j] );
+	for ( size_t i = 0; i < m_nRowCount; ++i )
+		aBasis.setRowStatus( i, m_aStatus[m_nVarCount + i] );
+	m_pSelf->setBasis( aBasis );
+
+	if ( m_bVerbose )
+	{
+		cout << "optimum reached after " << m_nIter << " iteration(s)" << endl;
+		cout << "x = ";
+		mxSolution.trans().print();
+	}
+}
+
+//---------------------------------------------------------------------------
+// DualSimplex
+
+DualSimplex::DualSimplex() : BaseAlgorithm(),
+	m_pImpl( new DualSimplexImpl( this ) )
+{
+}
+
+DualSimplex::~DualSimplex() throw()
+{
+}
+
+void DualSimplex::solve()
+{
+	m_pImpl->solve();
+}
+
+size_t DualSimplex::getIterationCount() const
+{
+	return m_pImpl->getIterationCount();
+}
+
+}}}
@@ -0,0 +1,227 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/lpdualsimplex.hxx"
+#include "numeric/lpsimplex.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/exception.hxx"
+#include "lptestutil.hxx"
+
+#include <vector>
+#include <cmath>
+#include <stdio.h>
+
+using namespace ::scsolver::numeric;
+using namespace ::scsolver::numeric::lp;
+using namespace ::scsolver::numeric::lp::test;
+using ::std::vector;
+
+namespace {
+
+bool solveThrows(Model& model)
+{
+    DualSimplex algorithm;
+    algorithm.setModel(&model);
+    try
+    {
+        algorithm.solve();
+    }
+    catch (const ModelInfeasible&)
+    {
+        return true;
+    }
+    return false;
+}
+
+void smallModels()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("small models\n");
+
+    {
+        // max 3x + 5y, x <= 4, 2y <= 12, 3x + 2y <= 18  ->  (2, 6)
+        Model model;
+        setCost(model, 3, 5, GOAL_MAXIMIZE);
+        model.setVarPositive(true);
+        addConstraint(model, 1, 0, LESS_EQUAL, 4);
+        addConstraint(model, 0, 2, LESS_EQUAL, 12);
+        addConstraint(model, 3, 2, LESS_EQUAL, 18);
+
+        DualSimplex algorithm;
+        algorithm.setModel(&model);
+        algorithm.solve();
+        Matrix sol = algorithm.getSolution();
+        sol.trans().print();
+        check(isNear(sol(0, 0), 2.0) && isNear(sol(1, 0), 6.0), "maximize (dual phase 1)");
+    }
+
+    {
+        // min 2x + 3y, x + y >= 4, x + 3y >= 6  ->  (3, 1).  The slack basis
+        // is dual feasible.
+        Model model;
+        setCost(model, 2, 3, GOAL_MINIMIZE);
+        model.setVarPositive(true);
+        addConstraint(model, 1, 1, GREATER_EQUAL, 4);
+        addConstraint(model, 1, 3, GREATER_EQUAL, 6);
+
+        DualSimplex algorithm;
+        algorithm.setModel(&model);
+        algorithm.solve();
+        Matrix sol = algorithm.getSolution();
+        sol.trans().print();
+        check(isNear(sol(0, 0), 3.0) && isNear(sol(1, 0), 1.0), "minimize");
+        check(algorithm.getIterationCount() == 2, "two pivots from the slack basis");
+    }
+
+    {
+        // min x + y, x - y = 1, x + y >= 3, x <= 5 with free variables
+        //   ->  (2, 1)
+        Model model;
+        setCost(model, 1, 1, GOAL_MINIMIZE);
+        model.setVarPositive(false);
+        model.setVarBound(0, BOUND_UPPER, 5);
+        addConstraint(model, 1, -1, EQUAL, 1);
+        addConstraint(model, 1, 1, GREATER_EQUAL, 3);
+
+        DualSimplex algorithm;
+        algorithm.setModel(&model);
+        algorithm.solve();
+        Matrix sol = algorithm.getSolution();
+        sol.trans().print();
+        check(isNear(sol(0, 0), 2.0) && isNear(sol(1, 0), 1.0), "free variables and equality");
+    }
+
+    {
+        // max 3x + 5y, 0 <= x <= 4, 0 <= y <= 6, 3x + 2y <= 18, x + y <= 7
+        //   ->  (1, 6)
+        Model model;
+        setCost(model, 3, 5, GOAL_MAXIMIZE);
+        model.setVarPositive(true);
+        model.setVarBound(0, BOUND_UPPER, 4);
+        model.setVarBound(1, BOUND_UPPER, 6);
+        addConstraint(model, 3, 2, LESS_EQUAL, 18);
+        addConstraint(model, 1, 1, LESS_EQUAL, 7);
+
+        DualSimplex algorithm;
+        algorithm.setModel(&model);
+        algorithm.solve();
+        Matrix sol = algorithm.getSolution();
+        sol.trans().print();
+        check(isNear(sol(0, 0), 1.0) && isNear(sol(1, 0), 6.0), "bounded variables");
+    }
+
+    {
+        Model model;
+        setCost(model, 1, 1, GOAL_MINIMIZE);
+        model.setVarPositive(true);
+        addConstraint(model, 1, 1, LESS_EQUAL, 1);
+        addConstraint(model, 1, 1, GREATER_EQUAL, 2);
+        check(solveThrows(model), "infeasible model rejected");
+    }
+
+    {
+        Model model;
+        setCost(model, 1, 0, GOAL_MAXIMIZE);
+        model.setVarPositive(true);
+        addConstraint(model, 1, -1, LESS_EQUAL, 1);
+        check(solveThrows(model), "unbounded model rejected");
+    }
+}
+
+void warmStart()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("warm start\n");
+
+    Model model;
+    buildWideModel(model, 15, 80, 42);
+
+    RevisedSimplex reference;
+    reference.setModel(&model);
+    reference.solve();
+    double fRefObj = getObjective(model, reference.getSolution());
+
+    DualSimplex algorithm;
+    algorithm.setModel(&model);
+    algorithm.solve();
+    double fObj = getObjective(model, algorithm.getSolution());
+    size_t nColdIter = algorithm.getIterationCount();
+    printf("cold start: objective = %.10g, %lu iterations\n", fObj, static_cast<unsigned long>(nColdIter));
+    check(isNear(fObj, fRefObj), "same optimum as primal simplex");
+
+    // Re-solving from the optimal basis takes no pivot.
+    algorithm.setStartBasis(algorithm.getBasis());
+    algorithm.solve();
+    check(algorithm.getIterationCount() == 0, "no pivot from the optimal basis");
+
+    // Tighten the right hand side of a few rows.
+    for (size_t i = 0; i < 15; i += 4)
+        model.setRhsValue(i, model.getRhsValue(i)*0.8);
+
+    DualSimplex cold;
+    cold.setModel(&model);
+    cold.solve();
+    fRefObj = getObjective(model, cold.getSolution());
+
+    algorithm.setStartBasis(algorithm.getBasis());
+    algorithm.solve();
+    fObj = getObjective(model, algorithm.getSolution());
+    printf("rhs changed: objective = %.10g, %lu iterations (cold: %lu)\n",
+           fObj, static_cast<unsigned long>(algorithm.getIterationCount()),
+           static_cast<unsigned long>(cold.getIterationCount()));
+    check(isNear(fObj, fRefObj), "same optimum after rhs change");
+    check(algorithm.getIterationCount() < cold.getIterationCount(), "fewer pivots after rhs change");
+
+    // Add a constraint cutting off the current optimum.
+    Matrix sol = algorithm.getSolution();
+    vector<double> row(80, 0.0);
+    double fLhs = 0.0;
+    for (size_t j = 0; j < 80; j += 5)
+    {
+        row[j] = 1.0;
+        fLhs += sol(j, 0);
+    }
+    model.addConstraint(row, LESS_EQUAL, fLhs*0.5);
+
+    cold.solve();
+    fRefObj = getObjective(model, cold.getSolution());
+
+    algorithm.setStartBasis(algorithm.getBasis());
+    algorithm.solve();
+    fObj = getObjective(model, algorithm.getSolution());
+    printf("row added: objective = %.10g, %lu iterations (cold: %lu)\n",
+           fObj, static_cast<unsigned long>(algorithm.getIterationCount()),
+           static_cast<unsigned long>(cold.getIterationCount()));
+    check(isNear(fObj, fRefObj), "same optimum after adding a row");
+    check(algorithm.getIterationCount() < cold.getIterationCount(), "fewer pivots after adding a row");
+
+    // A basis of the wrong size is ignored.
+    algorithm.setStartBasis(Basis(3, 2));
+    algorithm.solve();
+    check(isNear(getObjective(model, algorithm.getSolution()), fRefObj), "mismatching basis ignored");
+}
+
+}
+
+int main()
+{
+    printf("unit test: dual simplex\n");
+    smallModels();
+    warmStart();
+    printf("Unit test passed!\n");
+}
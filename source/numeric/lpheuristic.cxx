@@ -0,0 +1,746 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/lpheuristic.hxx"
+#include "numeric/lpbranchbound.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/exception.hxx"
+#include "tool/timer.hxx"
+
+#include <vector>
+#include <list>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+using ::std::vector;
+using ::std::list;
+using ::std::pair;
+
+namespace scsolver { namespace numeric { namespace lp {
+
+namespace {
+
+const double INF = ::std::numeric_limits<double>::infinity();
+
+/** distance from the nearest integer up to which a value is integral. */
+const double INTEGER_TOL = 1e-6;
+
+/** relative violation up to which a constraint is satisfied. */
+const double FEASIBILITY_TOL = 1e-6;
+
+const double DEFAULT_TIME_LIMIT = 2.0;
+
+/** maximum number of bounds rounded by one dive. */
+const size_t MAX_DIVE_DEPTH = 1000;
+
+const size_t MAX_PUMP_ITERATIONS = 200;
+
+/** number of variables flipped when the pump repeats its last point. */
+const size_t PUMP_FLIPS = 10;
+
+/** number of previous points checked for longer cycles of the pump. */
+const size_t PUMP_HISTORY = 3;
+
+/** factor by which the weight of the objective in the pump decreases. */
+const double PUMP_ALPHA_DECAY = 0.9;
+
+/** smallest share of integer variables RINS must be able to fix. */
+const double RINS_MIN_FIXING = 0.3;
+
+const size_t RINS_NODE_LIMIT = 500;
+
+bool isIntegral( double fVal )
+{
+	return ::std::fabs( fVal - ::std::floor( fVal + 0.5 ) ) <= INTEGER_TOL;
+}
+
+double nextRandom( unsigned long& nSeed )
+{
+	nSeed = ( nSeed*1103515245UL + 12345UL ) & 0x7fffffffUL;
+	return static_cast<double>( nSeed )/0x7fffffff;
+}
+
+/**
+ * Algorithm that passes its model on to one it does not own, so that a
+ * sub-search can use the algorithm of the caller.  It stops the sub-search
+ * once the time budget is used up.
+ */
+class AlgorithmRef : public BaseAlgorithm
+{
+public:
+	AlgorithmRef( BaseAlgorithm& rAlgorithm, const Timer& rTimer ) :
+		BaseAlgorithm(), m_rAlgorithm( rAlgorithm ), m_rTimer( rTimer )
+	{
+	}
+
+	virtual ~AlgorithmRef() throw()
+	{
+	}
+
+	virtual void solve()
+	{
+		if ( m_rTimer.isTimedOut() )
+			throw MaxIterationReached();
+
+		m_rAlgorithm.setModel( getModel() );
+		m_rAlgorithm.setStartBasis( getStartBasis() );
+		try
+		{
+			m_rAlgorithm.solve();
+		}
+		catch ( ... )
+		{
+			m_rAlgorithm.setModel( NULL );
+			throw;
+		}
+		m_rAlgorithm.setModel( NULL );
+		setSolution( m_rAlgorithm.getSolution() );
+		setBasis( m_rAlgorithm.getBasis() );
+	}
+
+	virtual bool isOptimal() const
+	{
+		return m_rAlgorithm.isOptimal();
+	}
+
+private:
+	BaseAlgorithm& m_rAlgorithm;
+	const Timer& m_rTimer;
+};
+
+struct DiveBound
+{
+	size_t Var;
+	BoundType Type;
+	double Value;
+
+	DiveBound( size_t nVar, BoundType eType, double fValue ) :
+		Var( nVar ), Type( eType ), Value( fValue ) {}
+};
+
+}
+
+//---------------------------------------------------------------------------
+// PrimalHeuristicsImpl
+
+/**
+ * Objective values are kept in the minimization sense, as in the branch
+ * and bound.  The model data is set up at the start of each run.
+ */
+class PrimalHeuristicsImpl
+{
+public:
+	PrimalHeuristicsImpl();
+	~PrimalHeuristicsImpl() throw();
+
+	void setEnabled( HeuristicType e, bool b ) { m_bEnabled[e] = b; }
+	bool isEnabled( HeuristicType e ) const { return m_bEnabled[e]; }
+	void setTimeLimit( double f ) { m_fTimeLimit = f; }
+	double getTimeLimit() const { return m_fTimeLimit; }
+	const Matrix getSolution() const { return m_mxSolution; }
+
+	bool run( HeuristicType eType, BaseAlgorithm& rAlgorithm, const Model& aModel,
+			  const Matrix& mxRelaxed, const Basis& aBasis, const Matrix& mxIncumbent );
+
+private:
+	bool m_bEnabled[4];
+	double m_fTimeLimit;
+	Matrix m_mxSolution;
+
+	const Model* m_pModel;
+	BaseAlgorithm* m_pAlgorithm;
+	::std::auto_ptr<Timer> m_pTimer;
+	size_t m_nVarCount;
+	size_t m_nRowCount;
+	Matrix m_mxA;
+	vector<double> m_aLower;
+	vector<double> m_aUpper;
+	vector<double> m_aRowLower;
+	vector<double> m_aRowUpper;
+	vector<double> m_aCost;
+	bool m_bIntegralObjective;
+	bool m_bHasIncumbent;
+	double m_fIncumbent;
+
+	void init( const Model& aModel, const Matrix& mxIncumbent );
+	void toVector( const Matrix& mxX, vector<double>& rX ) const;
+	double getObjective( const vector<double>& aX ) const;
+	bool isBetter( double fObj ) const;
+	bool isFeasible( const vector<double>& aX ) const;
+	bool isRowFeasible( size_t nRow, double fActivity ) const;
+	bool accept( const vector<double>& aX );
+	bool solveLp( const Model& aModel, const Basis& aStart, vector<double>& rX, Basis& rBasis, double& rObj );
+	bool round( const vector<double>& aX, vector<double>& rRounded ) const;
+
+	bool rounding( const vector<double>& aRelaxed );
+	bool diving( const vector<double>& aRelaxed, const Basis& aBasis );
+	bool feasibilityPump( const vector<double>& aRelaxed );
+	bool rins( const vector<double>& aRelaxed, const vector<double>& aIncumbent );
+};
+
+PrimalHeuristicsImpl::PrimalHeuristicsImpl() :
+	m_fTimeLimit( DEFAULT_TIME_LIMIT ), m_mxSolution( 0, 0 ), m_pModel( NULL ), m_pAlgorithm( NULL ),
+	m_nVarCount( 0 ), m_nRowCount( 0 ), m_mxA( 0, 0 ), m_bIntegralObjective( false ),
+	m_bHasIncumbent( false ), m_fIncumbent( INF )
+{
+	for ( size_t i = 0; i < 4; ++i )
+		m_bEnabled[i] = true;
+}
+
+PrimalHeuristicsImpl::~PrimalHeuristicsImpl() throw()
+{
+}
+
+void PrimalHeuristicsImpl::init( const Model& aModel, const Matrix& mxIncumbent )
+{
+	m_pModel = &aModel;
+	m_mxA = aModel.getConstraintMatrix();
+	m_nRowCount = m_mxA.rows();
+	Matrix mxC = aModel.getCostVector();
+	m_nVarCount = ::std::max( m_mxA.cols(), mxC.cols() );
+	if ( m_mxA.cols() < m_nVarCount )
+		m_mxA.resize( m_nRowCount, m_nVarCount );
+
+	double fSign = aModel.getGoal() == GOAL_MAXIMIZE ? -1.0 : 1.0;
+	m_aCost.assign( m_nVarCount, 0.0 );
+	m_bIntegralObjective = true;
+	for ( size_t j = 0; j < mxC.cols(); ++j )
+	{
+		m_aCost[j] = fSign*mxC( 0, j );
+		if ( m_aCost[j] != ::std::floor( m_aCost[j] ) )
+			m_bIntegralObjective = false;
+	}
+
+	m_aLower.assign( m_nVarCount, -INF );
+	m_aUpper.assign( m_nVarCount, INF );
+	for ( size_t j = 0; j < m_nVarCount; ++j )
+	{
+		if ( aModel.getVarPositive() )
+			m_aLower[j] = 0.0;
+		if ( aModel.isVarBounded( j, BOUND_LOWER ) )
+			m_aLower[j] = ::std::max( m_aLower[j], aModel.getVarBound( j, BOUND_LOWER ) );
+		if ( aModel.isVarBounded( j, BOUND_UPPER ) )
+			m_aUpper[j] = aModel.getVarBound( j, BOUND_UPPER );
+		m_aLower[j] = ::std::ceil( m_aLower[j] - INTEGER_TOL );
+		m_aUpper[j] = ::std::floor( m_aUpper[j] + INTEGER_TOL );
+	}
+
+	m_aRowLower.assign( m_nRowCount, -INF );
+	m_aRowUpper.assign( m_nRowCount, INF );
+	for ( size_t i = 0; i < m_nRowCount; ++i )
+	{
+		double fRhs = aModel.getRhsValue( i );
+		EqualityType eEq = aModel.getEquality( i );
+		if ( eEq != GREATER_EQUAL )
+			m_aRowUpper[i] = fRhs;
+		if ( eEq != LESS_EQUAL )
+			m_aRowLower[i] = fRhs;
+	}
+
+	m_bHasIncumbent = mxIncumbent.rows() > 0;
+	m_fIncumbent = INF;
+	if ( m_bHasIncumbent )
+	{
+		vector<double> aIncumbent;
+		toVector( mxIncumbent, aIncumbent );
+		m_fIncumbent = getObjective( aIncumbent );
+	}
+}
+
+void PrimalHeuristicsImpl::toVector( const Matrix& mxX, vector<double>& rX ) const
+{
+	rX.assign( m_nVarCount, 0.0 );
+	for ( size_t j = 0; j < m_nVarCount && j < mxX.rows(); ++j )
+		rX[j] = mxX( j, 0 );
+}
+
+double PrimalHeuristicsImpl::getObjective( const vector<double>& aX ) const
+{
+	double fObj = 0.0;
+	for ( size_t j = 0; j < m_nVarCount; ++j )
+		fObj += m_aCost[j]*aX[j];
+	return fObj;
+}
+
+/**
+ * With integer costs on integer variables, a better solution is better by
+ * at least one.
+ */
+bool PrimalHeuristicsImpl::isBetter( double fObj ) const
+{
+	if ( !m_bHasIncumbent )
+		return true;
+	double fTol = FEASIBILITY_TOL*( 1.0 + ::std::fabs( m_fIncumbent ) );
+	return fObj < m_fIncumbent - ( m_bIntegralObjective ? 1.0 - fTol : fTol );
+}
+
+bool PrimalHeuristicsImpl::isRowFeasible( size_t nRow, double fActivity ) const
+{
+	double fLower = m_aRowLower[nRow], fUpper = m_aRowUpper[nRow];
+	return ( fLower == -INF || fActivity >= fLower - FEASIBILITY_TOL*( 1.0 + ::std::fabs( fLower ) ) ) &&
+		( fUpper == INF || fActivity <= fUpper + FEASIBILITY_TOL*( 1.0 + ::std::fabs( fUpper ) ) );
+}
+
+bool PrimalHeuristicsImpl::isFeasible( const vector<double>& aX ) const
+{
+	for ( size_t j = 0; j < m_nVarCount; ++j )
+		if ( !isIntegral( aX[j] ) || aX[j] < m_aLower[j] - INTEGER_TOL || aX[j] > m_aUpper[j] + INTEGER_TOL )
+			return false;
+
+	for ( size_t i = 0; i < m_nRowCount; ++i )
+	{
+		double fActivity = 0.0;
+		for ( size_t j = 0; j < m_nVarCount; ++j )
+			fActivity += m_mxA( i, j )*aX[j];
+		if ( !isRowFeasible( i, fActivity ) )
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Take a point as the solution if it is feasible and better than the
+ * incumbent.  Its values are rounded to the nearest integers.
+ */
+bool PrimalHeuristicsImpl::accept( const vector<double>& aX )
+{
+	vector<double> aRounded( aX );
+	for ( size_t j = 0; j < m_nVarCount; ++j )
+		aRounded[j] = ::std::floor( aX[j] + 0.5 );
+	if ( !isFeasible( aRounded ) || !isBetter( getObjective( aRounded ) ) )
+		return false;
+
+	Matrix mxX( m_nVarCount, 1 );
+	for ( size_t j = 0; j < m_nVarCount; ++j )
+		mxX( j, 0 ) = aRounded[j];
+	m_mxSolution = mxX;
+	return true;
+}
+
+/**
+ * Solve the relaxation of the given model, without its integer flag.
+ *
+ * @return bool false if the LP is infeasible or could not be solved.
+ */
+bool PrimalHeuristicsImpl::solveLp( const Model& aModel, const Basis& aStart, vector<double>& rX,
+									Basis& rBasis, double& rObj )
+{
+	Model aLp( aModel );
+	aLp.setVarInteger( false );
+	m_pAlgorithm->setModel( &aLp );
+	m_pAlgorithm->setStartBasis( aStart );
+	try
+	{
+		m_pAlgorithm->solve();
+	}
+	catch ( const ModelInfeasible& )
+	{
+		m_pAlgorithm->setModel( NULL );
+		return false;
+	}
+	catch ( const MaxIterationReached& )
+	{
+		m_pAlgorithm->setModel( NULL );
+		return false;
+	}
+	m_pAlgorithm->setModel( NULL );
+
+	toVector( m_pAlgorithm->getSolution(), rX );
+	rBasis = m_pAlgorithm->getBasis();
+	rObj = getObjective( rX );
+	return true;
+}
+
+/**
+ * Round each fractional value in a direction that keeps all rows within
+ * their bounds, trying first the one that improves the objective.
+ *
+ * @return bool false if some value can be rounded in neither direction.
+ */
+bool PrimalHeuristicsImpl::round( const vector<double>& aX, vector<double>& rRounded ) const
+{
+	rRounded = aX;
+	vector<double> aActivity( m_nRowCount, 0.0 );
+	for ( size_t i = 0; i < m_nRowCount; ++i )
+		for ( size_t j = 0; j < m_nVarCount; ++j )
+			aActivity[i] += m_mxA( i, j )*aX[j];
+
+	for ( size_t j = 0; j < m_nVarCount; ++j )
+	{
+		double fVal = aX[j];
+		double aTry[2];
+		if ( isIntegral( fVal ) )
+			aTry[0] = aTry[1] = ::std::floor( fVal + 0.5 );
+		else if ( m_aCost[j] > 0.0 )
+		{
+			aTry[0] = ::std::floor( fVal );
+			aTry[1] = aTry[0] + 1.0;
+		}
+		else
+		{
+			aTry[0] = ::std::ceil( fVal );
+			aTry[1] = aTry[0] - 1.0;
+		}
+
+		bool bDone = false;
+		for ( size_t n = 0; n < 2 && !bDone; ++n )
+		{
+			double fDelta = aTry[n] - fVal;
+			if ( aTry[n] < m_aLower[j] || aTry[n] > m_aUpper[j] )
+				continue;
+			bool bFeasible = true;
+			for ( size_t i = 0; i < m_nRowCount && bFeasible; ++i )
+				if ( m_mxA( i, j ) != 0.0 )
+					bFeasible = isRowFeasible( i, aActivity[i] + m_mxA( i, j )*fDelta );
+			if ( !bFeasible )
+				continue;
+
+			for ( size_t i = 0; i < m_nRowCount; ++i )
+				aActivity[i] += m_mxA( i, j )*fDelta;
+			rRounded[j] = aTry[n];
+			bDone = true;
+		}
+		if ( !bDone )
+			return false;
+	}
+	return true;
+}
+
+bool PrimalHeuristicsImpl::rounding( const vector<double>& aRelaxed )
+{
+	vector<double> aRounded;
+	return round( aRelaxed, aRounded ) && accept( aRounded );
+}
+
+/**
+ * Fractional diving.  At each step the variable closest to an integer is
+ * rounded by tightening its bound, and the relaxation is solved again from
+ * the previous basis.  When that is infeasible, or no better than the
+ * incumbent, the other direction is tried; when both fail, the dive is
+ * given up.  Each relaxed solution is also tried with simple rounding.
+ */
+bool PrimalHeuristicsImpl::diving( const vector<double>& aRelaxed, const Basis& aBasis )
+{
+	vector<double> aX( aRelaxed );
+	Basis aDiveBasis( aBasis );
+	vector<DiveBound> aBounds;
+	for ( size_t nDepth = 0; nDepth < MAX_DIVE_DEPTH && !m_pTimer->isTimedOut(); ++nDepth )
+	{
+		vector<double> aRounded;
+		if ( round( aX, aRounded ) && accept( aRounded ) )
+			return true;
+
+		size_t nVar = m_nVarCount;
+		double fBestFrac = 1.0;
+		for ( size_t j = 0; j < m_nVarCount; ++j )
+		{
+			if ( isIntegral( aX[j] ) )
+				continue;
+			double fFrac = aX[j] - ::std::floor( aX[j] );
+			if ( ::std::min( fFrac, 1.0 - fFrac ) < fBestFrac )
+			{
+				fBestFrac = ::std::min( fFrac, 1.0 - fFrac );
+				nVar = j;
+			}
+		}
+		if ( nVar == m_nVarCount )
+			return accept( aX );
+
+		bool bUp = aX[nVar] - ::std::floor( aX[nVar] ) >= 0.5, bSolved = false;
+		for ( size_t nTry = 0; nTry < 2 && !bSolved; ++nTry, bUp = !bUp )
+		{
+			Model aDive( *m_pModel );
+			vector<DiveBound>::const_iterator itr = aBounds.begin(), itrEnd = aBounds.end();
+			for ( ; itr != itrEnd; ++itr )
+				aDive.setVarBound( itr->Var, itr->Type, itr->Value );
+			DiveBound aBound( nVar, bUp ? BOUND_LOWER : BOUND_UPPER,
+							  bUp ? ::std::ceil( aX[nVar] ) : ::std::floor( aX[nVar] ) );
+			aDive.setVarBound( aBound.Var, aBound.Type, aBound.Value );
+
+			vector<double> aNewX;
+			Basis aNewBasis;
+			double fObj;
+			if ( solveLp( aDive, aDiveBasis, aNewX, aNewBasis, fObj ) && isBetter( fObj ) )
+			{
+				aBounds.push_back( aBound );
+				aX.swap( aNewX );
+				aDiveBasis = aNewBasis;
+				bSolved = true;
+			}
+		}
+		if ( !bSolved )
+			return false;
+	}
+	return false;
+}
+
+/**
+ * Objective feasibility pump.  The distance LP minimizes the L1 distance
+ * to the rounded point: x - l or u - x for a variable rounded to one of
+ * its bounds, and an auxiliary variable d >= |x - x~| otherwise, blended
+ * with the objective by a weight that decreases each iteration.  When the
+ * rounding repeats the last point, the variables farthest from their
+ * rounded value are flipped; when it repeats an older point, all values
+ * are perturbed at random.
+ */
+bool PrimalHeuristicsImpl::feasibilityPump( const vector<double>& aRelaxed )
+{
+	double fCostNorm = 0.0;
+	for ( size_t j = 0; j < m_nVarCount; ++j )
+		fCostNorm += m_aCost[j]*m_aCost[j];
+	fCostNorm = ::std::sqrt( fCostNorm );
+	double fCostScale = fCostNorm > 0.0 ? ::std::sqrt( static_cast<double>( m_nVarCount ) )/fCostNorm : 0.0;
+
+	vector<double> aX( aRelaxed ), aRounded( m_nVarCount );
+	list< vector<double> > aHistory;
+	double fAlpha = 1.0;
+	unsigned long nSeed = 1;
+	for ( size_t nIter = 0; nIter < MAX_PUMP_ITERATIONS && !m_pTimer->isTimedOut(); ++nIter )
+	{
+		for ( size_t j = 0; j < m_nVarCount; ++j )
+			aRounded[j] = ::std::max( m_aLower[j], ::std::min( m_aUpper[j], ::std::floor( aX[j] + 0.5 ) ) );
+
+		if ( !aHistory.empty() && aRounded == aHistory.front() )
+		{
+			vector< pair<double, size_t> > aScores;
+			for ( size_t j = 0; j < m_nVarCount; ++j )
+				if ( ::std::fabs( aX[j] - aRounded[j] ) > INTEGER_TOL )
+					aScores.push_back( pair<double, size_t>( -::std::fabs( aX[j] - aRounded[j] ), j ) );
+			::std::sort( aScores.begin(), aScores.end() );
+			for ( size_t n = 0; n < aScores.size() && n < PUMP_FLIPS; ++n )
+			{
+				size_t j = aScores[n].second;
+				aRounded[j] += aX[j] > aRounded[j] ? 1.0 : -1.0;
+			}
+		}
+		else if ( ::std::find( aHistory.begin(), aHistory.end(), aRounded ) != aHistory.end() )
+		{
+			for ( size_t j = 0; j < m_nVarCount; ++j )
+			{
+				double fRho = nextRandom( nSeed ) - 0.3;
+				if ( ::std::fabs( aX[j] - aRounded[j] ) + ::std::max( fRho, 0.0 ) <= 0.5 )
+					continue;
+				double fFlip = aX[j] > aRounded[j] || ( aX[j] == aRounded[j] && nextRandom( nSeed ) < 0.5 ) ? 1.0 : -1.0;
+				aRounded[j] = ::std::max( m_aLower[j], ::std::min( m_aUpper[j], aRounded[j] + fFlip ) );
+			}
+		}
+
+		if ( isFeasible( aRounded ) )
+			return accept( aRounded );
+
+		aHistory.push_front( aRounded );
+		if ( aHistory.size() > PUMP_HISTORY )
+			aHistory.pop_back();
+
+		Model aPump( *m_pModel );
+		aPump.setVarInteger( false );
+		aPump.setGoal( GOAL_MINIMIZE );
+		vector<double> aCost( m_nVarCount, 0.0 );
+		vector< pair<size_t, size_t> > aAux;
+		for ( size_t j = 0; j < m_nVarCount; ++j )
+		{
+			if ( aRounded[j] <= m_aLower[j] )
+				aCost[j] = 1.0;
+			else if ( aRounded[j] >= m_aUpper[j] )
+				aCost[j] = -1.0;
+			else
+				aAux.push_back( pair<size_t, size_t>( j, m_nVarCount + aAux.size() ) );
+		}
+		aCost.resize( m_nVarCount + aAux.size(), 1.0 );
+		for ( size_t k = 0; k < aCost.size(); ++k )
+		{
+			aCost[k] *= 1.0 - fAlpha;
+			if ( k < m_nVarCount )
+				aCost[k] += fAlpha*fCostScale*m_aCost[k];
+		}
+		aPump.setCostVector( aCost );
+		for ( size_t k = 0; k < aAux.size(); ++k )
+		{
+			size_t j = aAux[k].first, nAux = aAux[k].second;
+			aPump.setVarBound( nAux, BOUND_LOWER, 0.0 );
+			vector<double> aRow( nAux + 1, 0.0 );
+			aRow[nAux] = 1.0;
+			aRow[j] = -1.0;
+			aPump.addConstraint( aRow, GREATER_EQUAL, -aRounded[j] );
+			aRow[j] = 1.0;
+			aPump.addConstraint( aRow, GREATER_EQUAL, aRounded[j] );
+		}
+
+		vector<double> aNewX;
+		Basis aBasis;
+		double fObj;
+		if ( !solveLp( aPump, Basis(), aNewX, aBasis, fObj ) )
+			return false;
+		aX.swap( aNewX );
+		aX.resize( m_nVarCount );
+		fAlpha *= PUMP_ALPHA_DECAY;
+
+		bool bIntegral = true;
+		for ( size_t j = 0; j < m_nVarCount && bIntegral; ++j )
+			bIntegral = isIntegral( aX[j] );
+		if ( bIntegral && accept( aX ) )
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Relaxation induced neighborhood search.  The variables whose value is
+ * the same in the incumbent and the relaxed solution are fixed, an
+ * objective cutoff asks for a better solution, and the rest is searched
+ * by a branch and bound with a node limit.  A sub-search cut short by the
+ * time budget finds nothing.
+ */
+bool PrimalHeuristicsImpl::rins( const vector<double>& aRelaxed, const vector<double>& aIncumbent )
+{
+	if ( !m_bHasIncumbent )
+		return false;
+
+	Model aSub( *m_pModel );
+	size_t nFixed = 0;
+	for ( size_t j = 0; j < m_nVarCount; ++j )
+	{
+		if ( ::std::fabs( aRelaxed[j] - aIncumbent[j] ) > INTEGER_TOL )
+			continue;
+		aSub.setVarBound( j, BOUND_LOWER, aIncumbent[j] );
+		aSub.setVarBound( j, BOUND_UPPER, aIncumbent[j] );
+		++nFixed;
+	}
+	if ( nFixed == m_nVarCount || nFixed < RINS_MIN_FIXING*m_nVarCount )
+		return false;
+
+	double fTol = FEASIBILITY_TOL*( 1.0 + ::std::fabs( m_fIncumbent ) );
+	double fCutoff = m_fIncumbent - ( m_bIntegralObjective ? 1.0 : fTol );
+	if ( m_pModel->getGoal() == GOAL_MAXIMIZE )
+	{
+		vector<double> aRow( m_nVarCount );
+		for ( size_t j = 0; j < m_nVarCount; ++j )
+			aRow[j] = -m_aCost[j];
+		aSub.addConstraint( aRow, GREATER_EQUAL, -fCutoff );
+	}
+	else
+		aSub.addConstraint( m_aCost, LESS_EQUAL, fCutoff );
+
+	::std::auto_ptr<BaseAlgorithm> p( new AlgorithmRef( *m_pAlgorithm, *m_pTimer ) );
+	BranchAndBound aSearch( p );
+	aSearch.setNodeLimit( RINS_NODE_LIMIT );
+	aSearch.setCutRounds( 0 );
+	aSearch.setHeuristicTimeLimit( 0.0 );
+	aSearch.setModel( &aSub );
+	try
+	{
+		aSearch.solve();
+	}
+	catch ( const ModelInfeasible& )
+	{
+		return false;
+	}
+	catch ( const MaxIterationReached& )
+	{
+		return false;
+	}
+
+	vector<double> aX;
+	toVector( aSearch.getSolution(), aX );
+	return accept( aX );
+}
+
+bool PrimalHeuristicsImpl::run( HeuristicType eType, BaseAlgorithm& rAlgorithm, const Model& aModel,
+								const Matrix& mxRelaxed, const Basis& aBasis, const Matrix& mxIncumbent )
+{
+	if ( !m_bEnabled[eType] || !aModel.getVarInteger() )
+		return false;
+
+	::std::auto_ptr<Timer> pTimer( new Timer( m_fTimeLimit > 0.0 ? m_fTimeLimit : INF ) );
+	m_pTimer = pTimer;
+	m_pTimer->init();
+	m_pAlgorithm = &rAlgorithm;
+	init( aModel, mxIncumbent );
+
+	vector<double> aRelaxed;
+	toVector( mxRelaxed, aRelaxed );
+	bool bFound = false;
+	switch ( eType )
+	{
+	case HEURISTIC_ROUNDING:
+		bFound = rounding( aRelaxed );
+		break;
+	case HEURISTIC_DIVING:
+		bFound = diving( aRelaxed, aBasis );
+		break;
+	case HEURISTIC_FEASIBILITY_PUMP:
+		bFound = feasibilityPump( aRelaxed );
+		break;
+	case HEURISTIC_RINS:
+	{
+		vector<double> aIncumbent;
+		toVector( mxIncumbent, aIncumbent );
+		bFound = rins( aRelaxed, aIncumbent );
+		break;
+	}
+	}
+
+	m_pModel = NULL;
+	m_pAlgorithm = NULL;
+	return bFound;
+}
+
+//---------------------------------------------------------------------------
+// PrimalHeuristics
+
+PrimalHeuristics::PrimalHeuristics() : m_pImpl( new PrimalHeuristicsImpl )
+{
+}
+
+PrimalHeuristics::~PrimalHeuristics() throw()
+{
+}
+
+void PrimalHeuristics::setEnabled( HeuristicType eType, bool bEnabled )
+{
+	m_pImpl->setEnabled( eType, bEnabled );
+}
+
+bool PrimalHeuristics::isEnabled( HeuristicType eType ) const
+{
+	return m_pImpl->isEnabled( eType );
+}
+
+void PrimalHeuristics::setTimeLimit( double fSeconds )
+{
+	m_pImpl->setTimeLimit( fSeconds );
+}
+
+double PrimalHeuristics::getTimeLimit() const
+{
+	return m_pImpl->getTimeLimit();
+}
+
+bool PrimalHeuristics::run( HeuristicType eType, BaseAlgorithm& rAlgorithm, const Model& aModel,
+							const Matrix& mxRelaxed, const Basis& aBasis, const Matrix& mxIncumbent )
+{
+	return m_pImpl->run( eType, rAlgorithm, aModel, mxRelaxed, aBasis, mxIncumbent );
+}
+
+const Matrix PrimalHeuristics::getSolution() const
+{
+	return m_pImpl->getSolution();
+}
+
+}}}
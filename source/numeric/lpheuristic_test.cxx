@@ -0,0 +1,202 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/lpheuristic.hxx"
+#include "numeric/lpdualsimplex.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/exception.hxx"
+#include "lptestutil.hxx"
+
+#include <vector>
+#include <cmath>
+#include <stdio.h>
+
+using namespace ::scsolver::numeric;
+using namespace ::scsolver::numeric::lp;
+using namespace ::scsolver::numeric::lp::test;
+using ::std::vector;
+
+namespace {
+
+/**
+ * min c x, A x = b, 0 <= x <= 4 integer, with integer A, where b is the
+ * image of a random integer point so that the model is feasible.  Simple
+ * rounding rarely satisfies the equality rows.
+ */
+void buildEqualityModel(Model& model, size_t nRows, size_t nCols, unsigned long seed)
+{
+    vector<double> cost(nCols), point(nCols);
+    for (size_t j = 0; j < nCols; ++j)
+    {
+        cost[j] = 1.0 + ::std::floor(9.0*nextValue(seed));
+        point[j] = ::std::floor(5.0*nextValue(seed));
+    }
+    model.setCostVector(cost);
+    model.setGoal(GOAL_MINIMIZE);
+    model.setVarPositive(true);
+    model.setVarInteger(true);
+    for (size_t j = 0; j < nCols; ++j)
+        model.setVarBound(j, BOUND_UPPER, 4);
+
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        vector<double> row(nCols);
+        double rhs = 0.0;
+        for (size_t j = 0; j < nCols; ++j)
+        {
+            row[j] = ::std::floor(6.0*nextValue(seed));
+            rhs += row[j]*point[j];
+        }
+        model.addConstraint(row, EQUAL, rhs);
+    }
+}
+
+void solveRelaxation(const Model& model, Matrix& sol, Basis& basis)
+{
+    Model relaxed(model);
+    relaxed.setVarInteger(false);
+    DualSimplex algorithm;
+    algorithm.setModel(&relaxed);
+    algorithm.solve();
+    sol = algorithm.getSolution();
+    basis = algorithm.getBasis();
+}
+
+void knapsack()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("knapsack models\n");
+
+    const HeuristicType types[] = { HEURISTIC_ROUNDING, HEURISTIC_DIVING, HEURISTIC_FEASIBILITY_PUMP };
+    const char* names[] = { "rounding", "diving", "feasibility pump" };
+    for (unsigned long seed = 1; seed <= 5; ++seed)
+    {
+        Model model;
+        buildKnapsackModel(model, 4, 8, seed);
+        Matrix relaxed(0, 0);
+        Basis basis;
+        solveRelaxation(model, relaxed, basis);
+
+        for (size_t k = 0; k < 3; ++k)
+        {
+            DualSimplex algorithm;
+            PrimalHeuristics heuristics;
+            bool bFound = heuristics.run(types[k], algorithm, model, relaxed, basis, Matrix(0, 0));
+            Matrix sol = heuristics.getSolution();
+            printf("seed %lu, %s: objective %g (relaxation %g)  ", seed, names[k],
+                   bFound ? getObjective(model, sol) : 0.0, getObjective(model, relaxed));
+            check(bFound && isIntegral(sol) && isFeasible(model, sol), "feasible integer solution");
+        }
+    }
+}
+
+void equalities()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("equality models\n");
+
+    size_t nRounding = 0, nDiving = 0, nPump = 0;
+    for (unsigned long seed = 1; seed <= 10; ++seed)
+    {
+        Model model;
+        buildEqualityModel(model, 2, 10, seed);
+        Matrix relaxed(0, 0);
+        Basis basis;
+        solveRelaxation(model, relaxed, basis);
+
+        DualSimplex algorithm;
+        PrimalHeuristics heuristics;
+        if (heuristics.run(HEURISTIC_ROUNDING, algorithm, model, relaxed, basis, Matrix(0, 0)))
+            ++nRounding;
+        if (heuristics.run(HEURISTIC_DIVING, algorithm, model, relaxed, basis, Matrix(0, 0)))
+        {
+            check(isIntegral(heuristics.getSolution()) && isFeasible(model, heuristics.getSolution()),
+                  "diving solution feasible");
+            ++nDiving;
+        }
+        if (heuristics.run(HEURISTIC_FEASIBILITY_PUMP, algorithm, model, relaxed, basis, Matrix(0, 0)))
+        {
+            check(isIntegral(heuristics.getSolution()) && isFeasible(model, heuristics.getSolution()),
+                  "pump solution feasible");
+            ++nPump;
+        }
+    }
+    printf("solutions found: rounding %lu, diving %lu, feasibility pump %lu (of 10)\n",
+           static_cast<unsigned long>(nRounding), static_cast<unsigned long>(nDiving),
+           static_cast<unsigned long>(nPump));
+    check(nPump > nRounding && nDiving > nRounding, "pump and diving beat rounding");
+}
+
+void rins()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("RINS\n");
+
+    size_t nImproved = 0;
+    for (unsigned long seed = 1; seed <= 5; ++seed)
+    {
+        Model model;
+        buildKnapsackModel(model, 4, 8, seed);
+        Matrix relaxed(0, 0);
+        Basis basis;
+        solveRelaxation(model, relaxed, basis);
+
+        // Rounding the relaxed solution down gives a feasible incumbent
+        // that agrees with it on all integral values.
+        Matrix incumbent(relaxed.rows(), 1);
+        for (size_t j = 0; j < relaxed.rows(); ++j)
+            incumbent(j, 0) = ::std::floor(relaxed(j, 0) + 1e-9);
+
+        DualSimplex algorithm;
+        PrimalHeuristics heuristics;
+        if (!heuristics.run(HEURISTIC_RINS, algorithm, model, relaxed, basis, incumbent))
+            continue;
+        Matrix sol = heuristics.getSolution();
+        printf("seed %lu: objective %g (incumbent %g)  ", seed, getObjective(model, sol),
+               getObjective(model, incumbent));
+        check(isIntegral(sol) && isFeasible(model, sol) &&
+              getObjective(model, sol) > getObjective(model, incumbent), "better solution");
+        ++nImproved;
+    }
+    check(nImproved > 0, "incumbent improved");
+
+    // Nothing runs without an incumbent, or when disabled.
+    Model model;
+    buildKnapsackModel(model, 4, 8, 1);
+    Matrix relaxed(0, 0);
+    Basis basis;
+    solveRelaxation(model, relaxed, basis);
+    DualSimplex algorithm;
+    PrimalHeuristics heuristics;
+    check(!heuristics.run(HEURISTIC_RINS, algorithm, model, relaxed, basis, Matrix(0, 0)),
+          "no incumbent");
+    heuristics.setEnabled(HEURISTIC_ROUNDING, false);
+    check(!heuristics.run(HEURISTIC_ROUNDING, algorithm, model, relaxed, basis, Matrix(0, 0)),
+          "disabled");
+}
+
+}
+
+int main()
+{
+    printf("unit test: primal heuristics\n");
+    knapsack();
+    equalities();
+    rins();
+    printf("Unit test passed!\n");
+}
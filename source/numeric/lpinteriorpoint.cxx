@@ -0,0 +1,756 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/lpinteriorpoint.hxx"
+#include "numeric/lpdualsimplex.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/sparsematrix.hxx"
+#include "numeric/exception.hxx"
+#include "numeric/solvecontrol.hxx"
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <cmath>
+#include <iostream>
+
+using ::std::vector;
+using ::std::cout;
+using ::std::endl;
+
+namespace scsolver { namespace numeric { namespace lp {
+
+namespace {
+
+const double INF = ::std::numeric_limits<double>::infinity();
+
+const size_t NO_COLUMN = static_cast<size_t>( -1 );
+
+/** relative tolerance for the residuals and the duality gap. */
+const double CONVERGENCE_TOL = 1e-8;
+
+/** fraction of the distance to the boundary covered by a step. */
+const double STEP_FACTOR = 0.9995;
+
+const size_t MAX_ITERATIONS = 200;
+
+/**
+ * Default of the largest number of constraints for which crossover runs.
+ * Each refactorization of the dual simplex inverts a dense basis matrix,
+ * which takes about a second at this size.
+ */
+const size_t CROSSOVER_ROW_LIMIT = 1000;
+
+/**
+ * Iterates growing beyond this multiple of the largest data entry show
+ * that the model is infeasible or unbounded.
+ */
+const double DIVERGENCE_FACTOR = 1e12;
+
+/**
+ * Pivots of the normal equations below this fraction of their largest
+ * diagonal element are dropped, which takes care of dependent rows and of
+ * the ill-conditioning near the optimum.
+ */
+const double NORMAL_PIVOT_TOL = 1e-13;
+
+double getMaxAbs( const vector<double>& r )
+{
+	double fMax = 0.0;
+	for ( size_t i = 0; i < r.size(); ++i )
+		if ( r[i] != INF )
+			fMax = ::std::max( fMax, ::std::fabs( r[i] ) );
+	return fMax;
+}
+
+/**
+ * @return double largest step up to fStep for which x + step dx remains
+ *         non-negative.
+ */
+double getMaxStep( const vector<double>& rX, const vector<double>& rDX, double fStep )
+{
+	for ( size_t j = 0; j < rX.size(); ++j )
+		if ( rDX[j] < 0.0 )
+			fStep = ::std::min( fStep, -rX[j]/rDX[j] );
+	return fStep;
+}
+
+}
+
+//---------------------------------------------------------------------------
+// InteriorPointImpl
+
+/**
+ * In addition to the primal variables x, the method keeps the variables w
+ * = u - x of the upper bounds, the dual variables y of the rows, and the
+ * dual variables z and v of the lower and upper bounds, all but y strictly
+ * positive.  The optimality conditions are
+ *
+ *     A x = b,  x + w = u,  A^T y + z - v = c,  X Z e = 0,  W V e = 0
+ *
+ * and each iteration takes a Newton step towards the point where the last
+ * two hold with mu e on their right hand side.  Columns without an upper
+ * bound have w = v = 0 throughout.
+ */
+class InteriorPointImpl
+{
+public:
+	InteriorPointImpl( InteriorPoint* p );
+	~InteriorPointImpl() throw();
+
+	void solve();
+
+	void setCrossover( bool b ) { m_bCrossover = b; }
+	bool getCrossover() const { return m_bCrossover; }
+	void setCrossoverRowLimit( size_t n ) { m_nCrossoverRowLimit = n; }
+	size_t getCrossoverRowLimit() const { return m_nCrossoverRowLimit; }
+	size_t getIterationCount() const { return m_nIter; }
+	size_t getCrossoverIterationCount() const { return m_nCrossoverIter; }
+
+private:
+	/**
+	 * Mapping of a decision variable onto the standard form columns, as in
+	 * x_j = Shift + Sign x[Col] - x[NegCol].  A fixed variable has no
+	 * column, and only a free variable has a negative part.
+	 */
+	struct VarMap
+	{
+		size_t Col;
+		size_t NegCol;
+		double Sign;
+		double Shift;
+
+		VarMap() : Col( NO_COLUMN ), NegCol( NO_COLUMN ), Sign( 1.0 ), Shift( 0.0 ) {}
+	};
+
+	struct Direction
+	{
+		vector<double> X;
+		vector<double> Y;
+		vector<double> Z;
+		vector<double> W;
+		vector<double> V;
+	};
+
+	InteriorPoint* m_pSelf;
+
+	bool m_bCrossover;
+	size_t m_nCrossoverRowLimit;
+	size_t m_nIter;
+	size_t m_nCrossoverIter;
+	bool m_bVerbose;
+
+	size_t m_nRowCount;
+	size_t m_nColCount;
+	SparseMatrix m_mxA;
+	vector<double> m_aB;
+	vector<double> m_aC;
+	vector<double> m_aU;
+	vector<VarMap> m_aVarMap;
+	vector<size_t> m_aRowSlack;
+
+	/** column-wise copy of A, used to form the normal equations. */
+	vector< vector<size_t> > m_aColRows;
+	vector< vector<double> > m_aColVals;
+
+	vector<double> m_aX;
+	vector<double> m_aY;
+	vector<double> m_aZ;
+	vector<double> m_aW;
+	vector<double> m_aV;
+
+	SparseCholesky m_aNormal;
+
+	bool isBounded( size_t j ) const { return m_aU[j] != INF; }
+
+	void buildProblem();
+	void factorizeNormal( const vector<double>& rD );
+	void initPoint();
+	void solveNewton( const vector<double>& rD, const vector<double>& rRb,
+					  const vector<double>& rRc, const vector<double>& rRu,
+					  const vector<double>& rRxz, const vector<double>& rRwv,
+					  Direction& rDir );
+	void iterate();
+
+	const Matrix getSolution() const;
+	double getColumnScore( size_t k, bool& rAtUpper ) const;
+	const Basis guessBasis() const;
+};
+
+InteriorPointImpl::InteriorPointImpl( InteriorPoint* p ) :
+	m_pSelf( p ), m_bCrossover( true ),
+	m_nCrossoverRowLimit( CROSSOVER_ROW_LIMIT ), m_nIter( 0 ), m_nCrossoverIter( 0 ),
+	m_bVerbose( false ), m_nRowCount( 0 ), m_nColCount( 0 )
+{
+	m_aNormal.setPivotTolerance( NORMAL_PIVOT_TOL );
+}
+
+InteriorPointImpl::~InteriorPointImpl() throw()
+{
+}
+
+void InteriorPointImpl::buildProblem()
+{
+	Model* pModel = m_pSelf->getModel();
+	Matrix mxA = pModel->getConstraintMatrix();
+	Matrix mxC = pModel->getCostVector();
+
+	m_nRowCount = mxA.rows();
+	size_t nVarCount = ::std::max( mxA.cols(), mxC.cols() );
+	double fSign = pModel->getGoal() == GOAL_MAXIMIZE ? -1.0 : 1.0;
+
+	m_aVarMap.assign( nVarCount, VarMap() );
+	m_aC.clear();
+	m_aU.clear();
+	for ( size_t j = 0; j < nVarCount; ++j )
+	{
+		double fLower = pModel->getVarPositive() ? 0.0 : -INF;
+		if ( pModel->isVarBounded( j, BOUND_LOWER ) )
+			fLower = ::std::max( fLower, pModel->getVarBound( j, BOUND_LOWER ) );
+		double fUpper = INF;
+		if ( pModel->isVarBounded( j, BOUND_UPPER ) )
+			fUpper = pModel->getVarBound( j, BOUND_UPPER );
+		if ( fLower > fUpper )
+			throw ModelInfeasible();
+
+		double fCost = j < mxC.cols() ? fSign*mxC( 0, j ) : 0.0;
+		VarMap& rMap = m_aVarMap[j];
+		if ( fLower == fUpper )
+			rMap.Shift = fLower;
+		else if ( fLower != -INF )
+		{
+			rMap.Col = m_aC.size();
+			rMap.Shift = fLower;
+			m_aC.push_back( fCost );
+			m_aU.push_back( fUpper - fLower );
+		}
+		else if ( fUpper != INF )
+		{
+			rMap.Col = m_aC.size();
+			rMap.Sign = -1.0;
+			rMap.Shift = fUpper;
+			m_aC.push_back( -fCost );
+			m_aU.push_back( INF );
+		}
+		else
+		{
+			rMap.Col = m_aC.size();
+			rMap.NegCol = rMap.Col + 1;
+			m_aC.push_back( fCost );
+			m_aC.push_back( -fCost );
+			m_aU.push_back( INF );
+			m_aU.push_back( INF );
+		}
+	}
+
+	m_aRowSlack.assign( m_nRowCount, NO_COLUMN );
+	for ( size_t i = 0; i < m_nRowCount; ++i )
+	{
+		if ( pModel->getEquality( i ) == EQUAL )
+			continue;
+		m_aRowSlack[i] = m_aC.size();
+		m_aC.push_back( 0.0 );
+		m_aU.push_back( INF );
+	}
+	m_nColCount = m_aC.size();
+
+	m_mxA.clear( m_nRowCount, m_nColCount );
+	m_aB.assign( m_nRowCount, 0.0 );
+	for ( size_t i = 0; i < m_nRowCount; ++i )
+	{
+		m_aB[i] = pModel->getRhsValue( i );
+		for ( size_t j = 0; j < mxA.cols(); ++j )
+		{
+			double fVal = mxA( i, j );
+			if ( fVal == 0.0 )
+				continue;
+			const VarMap& rMap = m_aVarMap[j];
+			m_aB[i] -= fVal*rMap.Shift;
+			if ( rMap.Col != NO_COLUMN )
+				m_mxA.insert( i, rMap.Col, rMap.Sign*fVal );
+			if ( rMap.NegCol != NO_COLUMN )
+				m_mxA.insert( i, rMap.NegCol, -fVal );
+		}
+		if ( m_aRowSlack[i] != NO_COLUMN )
+			m_mxA.insert( i, m_aRowSlack[i], pModel->getEquality( i ) == LESS_EQUAL ? 1.0 : -1.0 );
+	}
+
+	m_aColRows.resize( m_nColCount );
+	m_aColVals.resize( m_nColCount );
+	for ( size_t j = 0; j < m_nColCount; ++j )
+		m_mxA.getColumn( j, m_aColRows[j], m_aColVals[j] );
+}
+
+/**
+ * Form and factorize the normal equations matrix A D A^T.  Only its lower
+ * triangle is needed.
+ */
+void InteriorPointImpl::factorizeNormal( const vector<double>& rD )
+{
+	SparseMatrix mxM( m_nRowCount, m_nRowCount );
+	for ( size_t i = 0; i < m_nRowCount; ++i )
+		mxM.insert( i, i, 0.0 );
+	for ( size_t j = 0; j < m_nColCount; ++j )
+	{
+		const vector<size_t>& rRows = m_aColRows[j];
+		const vector<double>& rVals = m_aColVals[j];
+		for ( size_t p = 0; p < rRows.size(); ++p )
+			for ( size_t q = 0; q <= p; ++q )
+				mxM.insert( rRows[p], rRows[q], rD[j]*rVals[p]*rVals[q] );
+	}
+	m_aNormal.factorize( mxM );
+}
+
+/**
+ * Mehrotra's starting point: the least squares solutions of A x = b and
+ * A^T y + z = c, shifted to be sufficiently positive and well centered.
+ */
+void InteriorPointImpl::initPoint()
+{
+	size_t n = m_nColCount;
+	factorizeNormal( vector<double>( n, 1.0 ) );
+
+	vector<double> aT( m_aB ), aATy;
+	m_aNormal.solve( aT );
+	m_mxA.multiplyTrans( aT, m_aX );
+
+	m_mxA.multiply( m_aC, m_aY );
+	m_aNormal.solve( m_aY );
+	m_mxA.multiplyTrans( m_aY, aATy );
+
+	// The bound duals split c - A^T y between them.
+	m_aZ.assign( n, 0.0 );
+	m_aW.assign( n, 0.0 );
+	m_aV.assign( n, 0.0 );
+	double fMinPrimal = INF, fMinDual = INF;
+	for ( size_t j = 0; j < n; ++j )
+	{
+		double fReduced = m_aC[j] - aATy[j];
+		if ( isBounded( j ) )
+		{
+			m_aW[j] = m_aU[j] - m_aX[j];
+			m_aZ[j] = 0.5*fReduced;
+			m_aV[j] = -0.5*fReduced;
+			fMinPrimal = ::std::min( fMinPrimal, m_aW[j] );
+			fMinDual = ::std::min( fMinDual, m_aV[j] );
+		}
+		else
+			m_aZ[j] = fReduced;
+		fMinPrimal = ::std::min( fMinPrimal, m_aX[j] );
+		fMinDual = ::std::min( fMinDual, m_aZ[j] );
+	}
+
+	double fShiftPrimal = ::std::max( -1.5*fMinPrimal, 0.0 );
+	double fShiftDual = ::std::max( -1.5*fMinDual, 0.0 );
+	double fGap = 0.0, fSumPrimal = 0.0, fSumDual = 0.0;
+	for ( size_t j = 0; j < n; ++j )
+	{
+		m_aX[j] += fShiftPrimal;
+		m_aZ[j] += fShiftDual;
+		fGap += m_aX[j]*m_aZ[j];
+		fSumPrimal += m_aX[j];
+		fSumDual += m_aZ[j];
+		if ( isBounded( j ) )
+		{
+			m_aW[j] += fShiftPrimal;
+			m_aV[j] += fShiftDual;
+			fGap += m_aW[j]*m_aV[j];
+			fSumPrimal += m_aW[j];
+			fSumDual += m_aV[j];
+		}
+	}
+
+	double fStepPrimal = fSumDual > 0.0 ? 0.5*fGap/fSumDual : 0.0;
+	double fStepDual = fSumPrimal > 0.0 ? 0.5*fGap/fSumPrimal : 0.0;
+	for ( size_t j = 0; j < n; ++j )
+	{
+		// A zero gap leaves everything at zero, so fall back to one.
+		m_aX[j] = ::std::max( m_aX[j] + fStepPrimal, 1.0e-2 );
+		m_aZ[j] = ::std::max( m_aZ[j] + fStepDual, 1.0e-2 );
+		if ( isBounded( j ) )
+		{
+			m_aW[j] = ::std::max( m_aW[j] + fStepPrimal, 1.0e-2 );
+			m_aV[j] = ::std::max( m_aV[j] + fStepDual, 1.0e-2 );
+		}
+	}
+}
+
+/**
+ * Solve the Newton system
+ *
+ *     A dx = rb,  dx + dw = ru,  A^T dy + dz - dv = rc,
+ *     Z dx + X dz = rxz,  V dw + W dv = rwv
+ *
+ * by eliminating all but dy, which leaves the normal equations
+ * A D A^T dy = rb + A D r with D = (X^-1 Z + W^-1 V)^-1.
+ */
+void InteriorPointImpl::solveNewton( const vector<double>& rD, const vector<double>& rRb,
+									 const vector<double>& rRc, const vector<double>& rRu,
+									 const vector<double>& rRxz, const vector<double>& rRwv,
+									 Direction& rDir )
+{
+	size_t n = m_nColCount;
+	vector<double> aR( n ), aDR( n );
+	for ( size_t j = 0; j < n; ++j )
+	{
+		aR[j] = rRc[j] - rRxz[j]/m_aX[j];
+		if ( isBounded( j ) )
+			aR[j] += ( rRwv[j] - m_aV[j]*rRu[j] )/m_aW[j];
+		aDR[j] = rD[j]*aR[j];
+	}
+
+	m_mxA.multiply( aDR, rDir.Y );
+	for ( size_t i = 0; i < m_nRowCount; ++i )
+		rDir.Y[i] += rRb[i];
+	m_aNormal.solve( rDir.Y );
+
+	vector<double> aATdy;
+	m_mxA.multiplyTrans( rDir.Y, aATdy );
+	rDir.X.resize( n );
+	rDir.Z.resize( n );
+	rDir.W.assign( n, 0.0 );
+	rDir.V.assign( n, 0.0 );
+	for ( size_t j = 0; j < n; ++j )
+	{
+		rDir.X[j] = rD[j]*( aATdy[j] - aR[j] );
+		rDir.Z[j] = ( rRxz[j] - m_aZ[j]*rDir.X[j] )/m_aX[j];
+		if ( isBounded( j ) )
+		{
+			rDir.W[j] = rRu[j] - rDir.X[j];
+			rDir.V[j] = ( rRwv[j] - m_aV[j]*rDir.W[j] )/m_aW[j];
+		}
+	}
+}
+
+void InteriorPointImpl::iterate()
+{
+	size_t n = m_nColCount, m = m_nRowCount;
+	size_t nPairCount = n;
+	for ( size_t j = 0; j < n; ++j )
+		if ( isBounded( j ) )
+			++nPairCount;
+
+	const double fNormB = getMaxAbs( m_aB ), fNormC = getMaxAbs( m_aC ), fNormU = getMaxAbs( m_aU );
+	const double fDivergence = DIVERGENCE_FACTOR*( 1.0 + ::std::max( fNormB, ::std::max( fNormC, fNormU ) ) );
+
+	vector<double> aRb( m ), aRc( n ), aRu( n, 0.0 ), aRxz( n ), aRwv( n, 0.0 ), aD( n ), aT;
+	Direction aAff, aDir;
+	for ( m_nIter = 0; ; ++m_nIter )
+	{
+		// residuals and duality gap
+		m_mxA.multiply( m_aX, aT );
+		for ( size_t i = 0; i < m; ++i )
+			aRb[i] = m_aB[i] - aT[i];
+		m_mxA.multiplyTrans( m_aY, aT );
+		double fPrimalObj = 0.0, fDualObj = 0.0, fGap = 0.0;
+		for ( size_t j = 0; j < n; ++j )
+		{
+			aRc[j] = m_aC[j] - aT[j] - m_aZ[j] + m_aV[j];
+			fPrimalObj += m_aC[j]*m_aX[j];
+			fGap += m_aX[j]*m_aZ[j];
+			if ( isBounded( j ) )
+			{
+				aRu[j] = m_aU[j] - m_aX[j] - m_aW[j];
+				fDualObj -= m_aU[j]*m_aV[j];
+				fGap += m_aW[j]*m_aV[j];
+			}
+		}
+		for ( size_t i = 0; i < m; ++i )
+			fDualObj += m_aB[i]*m_aY[i];
+		double fMu = fGap/nPairCount;
+
+		double fPrimalRes = ::std::max( getMaxAbs( aRb )/( 1.0 + fNormB ), getMaxAbs( aRu )/( 1.0 + fNormU ) );
+		double fDualRes = getMaxAbs( aRc )/( 1.0 + fNormC );
+		double fRelGap = ::std::fabs( fPrimalObj - fDualObj )/( 1.0 + ::std::fabs( fPrimalObj ) );
+		if ( m_bVerbose )
+			cout << "iteration " << m_nIter << ": primal " << fPrimalObj << " dual " << fDualObj
+				 << " residuals " << fPrimalRes << " " << fDualRes << " mu " << fMu << endl;
+
+		if ( fPrimalRes <= CONVERGENCE_TOL && fDualRes <= CONVERGENCE_TOL && fRelGap <= CONVERGENCE_TOL )
+			break;
+
+		if ( getMaxAbs( m_aX ) > fDivergence || getMaxAbs( m_aY ) > fDivergence ||
+			 getMaxAbs( m_aZ ) > fDivergence || getMaxAbs( m_aV ) > fDivergence )
+		{
+			if ( m_bVerbose )
+				cout << "iterates diverge: model infeasible or unbounded" << endl;
+			throw ModelInfeasible();
+		}
+
+		const SolveControl* pControl = m_pSelf->getSolveControl();
+		pControl->checkIteration( m_nIter, MAX_ITERATIONS );
+		SolveProgress aProgress;
+		aProgress.Iteration = m_nIter;
+		aProgress.Gap = fRelGap;
+		aProgress.HasGap = true;
+		pControl->reportProgress( aProgress );
+
+		for ( size_t j = 0; j < n; ++j )
+		{
+			double fInv = m_aZ[j]/m_aX[j];
+			if ( isBounded( j ) )
+				fInv += m_aV[j]/m_aW[j];
+			aD[j] = 1.0/fInv;
+		}
+		factorizeNormal( aD );
+
+		// Predictor: the affine scaling direction, which aims at mu = 0.
+		for ( size_t j = 0; j < n; ++j )
+		{
+			aRxz[j] = -m_aX[j]*m_aZ[j];
+			if ( isBounded( j ) )
+				aRwv[j] = -m_aW[j]*m_aV[j];
+		}
+		solveNewton( aD, aRb, aRc, aRu, aRxz, aRwv, aAff );
+		double fStepPrimal = getMaxStep( m_aW, aAff.W, getMaxStep( m_aX, aAff.X, 1.0 ) );
+		double fStepDual = getMaxStep( m_aV, aAff.V, getMaxStep( m_aZ, aAff.Z, 1.0 ) );
+
+		double fGapAff = 0.0;
+		for ( size_t j = 0; j < n; ++j )
+		{
+			fGapAff += ( m_aX[j] + fStepPrimal*aAff.X[j] )*( m_aZ[j] + fStepDual*aAff.Z[j] );
+			if ( isBounded( j ) )
+				fGapAff += ( m_aW[j] + fStepPrimal*aAff.W[j] )*( m_aV[j] + fStepDual*aAff.V[j] );
+		}
+		double fSigma = ::std::pow( fGapAff/fGap, 3 );
+
+		// Corrector: aim at sigma mu, and compensate for the second order
+		// term that the predictor neglected.
+		for ( size_t j = 0; j < n; ++j )
+		{
+			aRxz[j] = fSigma*fMu - m_aX[j]*m_aZ[j] - aAff.X[j]*aAff.Z[j];
+			if ( isBounded( j ) )
+				aRwv[j] = fSigma*fMu - m_aW[j]*m_aV[j] - aAff.W[j]*aAff.V[j];
+		}
+		solveNewton( aD, aRb, aRc, aRu, aRxz, aRwv, aDir );
+		fStepPrimal = ::std::min( 1.0, STEP_FACTOR*getMaxStep( m_aW, aDir.W, getMaxStep( m_aX, aDir.X, INF ) ) );
+		fStepDual = ::std::min( 1.0, STEP_FACTOR*getMaxStep( m_aV, aDir.V, getMaxStep( m_aZ, aDir.Z, INF ) ) );
+
+		for ( size_t j = 0; j < n; ++j )
+		{
+			m_aX[j] += fStepPrimal*aDir.X[j];
+			m_aZ[j] += fStepDual*aDir.Z[j];
+			if ( isBounded( j ) )
+			{
+				m_aW[j] += fStepPrimal*aDir.W[j];
+				m_aV[j] += fStepDual*aDir.V[j];
+			}
+		}
+		for ( size_t i = 0; i < m; ++i )
+			m_aY[i] += fStepDual*aDir.Y[i];
+	}
+}
+
+const Matrix InteriorPointImpl::getSolution() const
+{
+	Matrix mxX( m_aVarMap.size(), 1 );
+	for ( size_t j = 0; j < m_aVarMap.size(); ++j )
+	{
+		const VarMap& rMap = m_aVarMap[j];
+		double fVal = rMap.Shift;
+		if ( rMap.Col != NO_COLUMN )
+			fVal += rMap.Sign*m_aX[rMap.Col];
+		if ( rMap.NegCol != NO_COLUMN )
+			fVal -= m_aX[rMap.NegCol];
+		mxX( j, 0 ) = fVal;
+	}
+	return mxX;
+}
+
+/**
+ * The ratio between a primal variable and its dual variable tends to
+ * infinity for a basic variable, and to zero for a non-basic one.
+ *
+ * @param k standard form column
+ * @param rAtUpper (reference) whether the column is closer to its upper
+ *                 bound than to zero
+ * @return double the smaller of the ratios at its two bounds.
+ */
+double InteriorPointImpl::getColumnScore( size_t k, bool& rAtUpper ) const
+{
+	double fLower = m_aX[k]/m_aZ[k];
+	double fUpper = isBounded( k ) ? m_aW[k]/m_aV[k] : INF;
+	rAtUpper = fUpper < fLower;
+	return ::std::min( fLower, fUpper );
+}
+
+/**
+ * Guess the optimal basis from the interior solution: the variables and
+ * rows with the highest scores are made basic, and the rest non-basic at
+ * the bound they are closest to.  Fixed variables and equality rows are
+ * only made basic when nothing else is left.
+ */
+const Basis InteriorPointImpl::guessBasis() const
+{
+	typedef ::std::pair<double, size_t> ScoreId;
+
+	size_t nVarCount = m_aVarMap.size();
+	Basis aBasis( nVarCount, m_nRowCount );
+	vector<ScoreId> aCandidates;
+	for ( size_t j = 0; j < nVarCount; ++j )
+	{
+		const VarMap& rMap = m_aVarMap[j];
+		if ( rMap.Col == NO_COLUMN )
+		{
+			aCandidates.push_back( ScoreId( -1.0, j ) );
+			aBasis.setVarStatus( j, BASIS_LOWER );
+		}
+		else if ( rMap.NegCol != NO_COLUMN )
+		{
+			// free variables are normally basic
+			aCandidates.push_back( ScoreId( INF, j ) );
+			aBasis.setVarStatus( j, BASIS_LOWER );
+		}
+		else
+		{
+			bool bAtUpper;
+			aCandidates.push_back( ScoreId( getColumnScore( rMap.Col, bAtUpper ), j ) );
+			aBasis.setVarStatus( j, bAtUpper != ( rMap.Sign < 0.0 ) ? BASIS_UPPER : BASIS_LOWER );
+		}
+	}
+
+	Model* pModel = m_pSelf->getModel();
+	for ( size_t i = 0; i < m_nRowCount; ++i )
+	{
+		size_t nSlack = m_aRowSlack[i];
+		if ( nSlack == NO_COLUMN )
+		{
+			aCandidates.push_back( ScoreId( -1.0, nVarCount + i ) );
+			aBasis.setRowStatus( i, BASIS_LOWER );
+		}
+		else
+		{
+			bool bAtUpper;
+			aCandidates.push_back( ScoreId( getColumnScore( nSlack, bAtUpper ), nVarCount + i ) );
+			aBasis.setRowStatus( i, pModel->getEquality( i ) == LESS_EQUAL ? BASIS_UPPER : BASIS_LOWER );
+		}
+	}
+
+	::std::sort( aCandidates.begin(), aCandidates.end(), ::std::greater<ScoreId>() );
+	for ( size_t k = 0; k < m_nRowCount && k < aCandidates.size(); ++k )
+	{
+		size_t nId = aCandidates[k].second;
+		if ( nId < nVarCount )
+			aBasis.setVarStatus( nId, BASIS_BASIC );
+		else
+			aBasis.setRowStatus( nId - nVarCount, BASIS_BASIC );
+	}
+	return aBasis;
+}
+
+void InteriorPointImpl::solve()
+{
+	Model* pModel = m_pSelf->getModel();
+	m_bVerbose = pModel->getVerbose();
+	m_nIter = 0;
+	m_nCrossoverIter = 0;
+	buildProblem();
+
+	if ( m_nColCount == 0 )
+	{
+		// Every variable is fixed, and so is every row activity.
+		if ( getMaxAbs( m_aB ) > CONVERGENCE_TOL )
+			throw ModelInfeasible();
+		m_aX.clear();
+	}
+	else
+	{
+		initPoint();
+		iterate();
+		if ( m_bVerbose )
+			cout << "interior point converged after " << m_nIter << " iteration(s)" << endl;
+	}
+
+	bool bCrossover = m_bCrossover;
+	if ( bCrossover && m_nCrossoverRowLimit > 0 &&
+		 pModel->getConstraintCount() > m_nCrossoverRowLimit )
+	{
+		if ( m_bVerbose )
+			cout << "crossover skipped for " << pModel->getConstraintCount() << " constraints" << endl;
+		bCrossover = false;
+	}
+
+	if ( !bCrossover )
+	{
+		m_pSelf->setSolution( getSolution() );
+		m_pSelf->setBasis( Basis() );
+		return;
+	}
+
+	DualSimplex aSimplex;
+	aSimplex.setModel( pModel );
+	aSimplex.setStartBasis( guessBasis() );
+	aSimplex.setSolveControl( m_pSelf->getSolveControl() );
+	aSimplex.solve();
+	m_nCrossoverIter = aSimplex.getIterationCount();
+	if ( m_bVerbose )
+		cout << "crossover finished after " << m_nCrossoverIter << " pivot(s)" << endl;
+
+	m_pSelf->setSolution( aSimplex.getSolution() );
+	m_pSelf->setBasis( aSimplex.getBasis() );
+}
+
+//---------------------------------------------------------------------------
+// InteriorPoint
+
+InteriorPoint::InteriorPoint() : BaseAlgorithm(),
+	m_pImpl( new InteriorPointImpl( this ) )
+{
+}
+
+InteriorPoint::~InteriorPoint() throw()
+{
+}
+
+void InteriorPoint::solve()
+{
+	m_pImpl->solve();
+}
+
+void InteriorPoint::setCrossover( bool b )
+{
+	m_pImpl->setCrossover( b );
+}
+
+bool InteriorPoint::getCrossover() const
+{
+	return m_pImpl->getCrossover();
+}
+
+void InteriorPoint::setCrossoverRowLimit( size_t n )
+{
+	m_pImpl->setCrossoverRowLimit( n );
+}
+
+size_t InteriorPoint::getCrossoverRowLimit() const
+{
+	return m_pImpl->getCrossoverRowLimit();
+}
+
+size_t InteriorPoint::getIterationCount() const
+{
+	return m_pImpl->getIterationCount();
+}
+
+size_t InteriorPoint::getCrossoverIterationCount() const
+{
+	return m_pImpl->getCrossoverIterationCount();
+}
+
+}}}
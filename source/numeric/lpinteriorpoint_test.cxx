@@ -0,0 +1,242 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/lpinteriorpoint.hxx"
+#include "numeric/lpdualsimplex.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/exception.hxx"
+#include "lptestutil.hxx"
+
+#include <vector>
+#include <cmath>
+#include <stdio.h>
+
+using namespace ::scsolver::numeric;
+using namespace ::scsolver::numeric::lp;
+using namespace ::scsolver::numeric::lp::test;
+using ::std::vector;
+
+namespace {
+
+/**
+ * Solve a model with and without crossover, and check that both find the
+ * expected solution: exactly with crossover, up to the convergence
+ * tolerance without.
+ */
+void checkSolution(Model& model, double x0, double x1, const char* msg)
+{
+    InteriorPoint algorithm;
+    algorithm.setModel(&model);
+    algorithm.setCrossover(false);
+    algorithm.solve();
+    Matrix sol = algorithm.getSolution();
+    sol.trans().print();
+    printf("%lu iterations  ", static_cast<unsigned long>(algorithm.getIterationCount()));
+    check(isNear(sol(0, 0), x0, 1e-6) && isNear(sol(1, 0), x1, 1e-6), msg);
+
+    algorithm.setCrossover(true);
+    algorithm.solve();
+    sol = algorithm.getSolution();
+    printf("crossover: %lu pivots  ", static_cast<unsigned long>(algorithm.getCrossoverIterationCount()));
+    check(isNear(sol(0, 0), x0) && isNear(sol(1, 0), x1) && !algorithm.getBasis().empty(), msg);
+}
+
+bool solveThrows(Model& model)
+{
+    InteriorPoint algorithm;
+    algorithm.setModel(&model);
+    try
+    {
+        algorithm.solve();
+    }
+    catch (const ModelInfeasible&)
+    {
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Transportation problem: min c x, sum_j x_ij = s_i, sum_i x_ij <= d_j,
+ * x >= 0, with twice the supply on offer.  Each column has two non-zero
+ * elements.
+ */
+void buildTransportModel(Model& model, size_t nSources, size_t nSinks, unsigned long seed)
+{
+    size_t nVarCount = nSources*nSinks;
+    vector<double> cost(nVarCount);
+    for (size_t k = 0; k < nVarCount; ++k)
+        cost[k] = 1.0 + 9.0*nextValue(seed);
+    model.setCostVector(cost);
+    model.setGoal(GOAL_MINIMIZE);
+    model.setVarPositive(true);
+
+    for (size_t i = 0; i < nSources; ++i)
+    {
+        vector<double> row(nVarCount, 0.0);
+        for (size_t j = 0; j < nSinks; ++j)
+            row[i*nSinks + j] = 1.0;
+        model.addConstraint(row, EQUAL, 10.0 + 10.0*nextValue(seed));
+    }
+    for (size_t j = 0; j < nSinks; ++j)
+    {
+        vector<double> row(nVarCount, 0.0);
+        for (size_t i = 0; i < nSources; ++i)
+            row[i*nSinks + j] = 1.0;
+        model.addConstraint(row, LESS_EQUAL, 20.0 + 20.0*nextValue(seed));
+    }
+}
+
+void smallModels()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("small models\n");
+
+    {
+        // max 3x + 5y, x <= 4, 2y <= 12, 3x + 2y <= 18  ->  (2, 6)
+        Model model;
+        setCost(model, 3, 5, GOAL_MAXIMIZE);
+        model.setVarPositive(true);
+        addConstraint(model, 1, 0, LESS_EQUAL, 4);
+        addConstraint(model, 0, 2, LESS_EQUAL, 12);
+        addConstraint(model, 3, 2, LESS_EQUAL, 18);
+        checkSolution(model, 2, 6, "maximize");
+    }
+
+    {
+        // min 2x + 3y, x + y >= 4, x + 3y >= 6  ->  (3, 1)
+        Model model;
+        setCost(model, 2, 3, GOAL_MINIMIZE);
+        model.setVarPositive(true);
+        addConstraint(model, 1, 1, GREATER_EQUAL, 4);
+        addConstraint(model, 1, 3, GREATER_EQUAL, 6);
+        checkSolution(model, 3, 1, "minimize");
+    }
+
+    {
+        // min x + y, x - y = 1, x + y >= 3, x <= 5 with free variables
+        //   ->  (2, 1)
+        Model model;
+        setCost(model, 1, 1, GOAL_MINIMIZE);
+        model.setVarPositive(false);
+        model.setVarBound(0, BOUND_UPPER, 5);
+        addConstraint(model, 1, -1, EQUAL, 1);
+        addConstraint(model, 1, 1, GREATER_EQUAL, 3);
+        checkSolution(model, 2, 1, "free variables and equality");
+    }
+
+    {
+        // max 3x + 5y, 0 <= x <= 4, 0 <= y <= 6, 3x + 2y <= 18, x + y <= 7
+        //   ->  (1, 6)
+        Model model;
+        setCost(model, 3, 5, GOAL_MAXIMIZE);
+        model.setVarPositive(true);
+        model.setVarBound(0, BOUND_UPPER, 4);
+        model.setVarBound(1, BOUND_UPPER, 6);
+        addConstraint(model, 3, 2, LESS_EQUAL, 18);
+        addConstraint(model, 1, 1, LESS_EQUAL, 7);
+        checkSolution(model, 1, 6, "bounded variables");
+    }
+
+    {
+        // max x + 2y, x <= 3, y = 2 (fixed), x + y >= 0  ->  (3, 2)
+        Model model;
+        setCost(model, 1, 2, GOAL_MAXIMIZE);
+        model.setVarPositive(false);
+        model.setVarBound(0, BOUND_UPPER, 3);
+        model.setVarBound(1, BOUND_LOWER, 2);
+        model.setVarBound(1, BOUND_UPPER, 2);
+        addConstraint(model, 1, 1, GREATER_EQUAL, 0);
+        checkSolution(model, 3, 2, "upper bound only and fixed variable");
+    }
+
+    {
+        Model model;
+        setCost(model, 1, 1, GOAL_MINIMIZE);
+        model.setVarPositive(true);
+        addConstraint(model, 1, 1, LESS_EQUAL, 1);
+        addConstraint(model, 1, 1, GREATER_EQUAL, 2);
+        check(solveThrows(model), "infeasible model rejected");
+    }
+
+    {
+        Model model;
+        setCost(model, 1, 0, GOAL_MAXIMIZE);
+        model.setVarPositive(true);
+        addConstraint(model, 1, -1, LESS_EQUAL, 1);
+        check(solveThrows(model), "unbounded model rejected");
+    }
+}
+
+void transportModel()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("transportation model\n");
+
+    Model model;
+    buildTransportModel(model, 40, 40, 5);
+
+    DualSimplex reference;
+    reference.setModel(&model);
+    reference.solve();
+    double fRefObj = getObjective(model, reference.getSolution());
+
+    InteriorPoint algorithm;
+    algorithm.setModel(&model);
+    algorithm.setCrossover(false);
+    algorithm.solve();
+    Matrix sol = algorithm.getSolution();
+    printf("interior point: objective = %.10g after %lu iterations (dual simplex: %.10g after %lu pivots)\n",
+           getObjective(model, sol), static_cast<unsigned long>(algorithm.getIterationCount()),
+           fRefObj, static_cast<unsigned long>(reference.getIterationCount()));
+    check(isNear(getObjective(model, sol), fRefObj, 1e-7), "same optimum as dual simplex");
+    check(algorithm.getIterationCount() < 40, "few iterations");
+
+    algorithm.setCrossover(true);
+    algorithm.solve();
+    sol = algorithm.getSolution();
+    Basis basis = algorithm.getBasis();
+    size_t nBasic = 0;
+    for (size_t j = 0; j < basis.getVarCount(); ++j)
+        if (basis.getVarStatus(j) == BASIS_BASIC)
+            ++nBasic;
+    for (size_t i = 0; i < basis.getRowCount(); ++i)
+        if (basis.getRowStatus(i) == BASIS_BASIC)
+            ++nBasic;
+    printf("crossover: %lu pivots\n", static_cast<unsigned long>(algorithm.getCrossoverIterationCount()));
+    check(isNear(getObjective(model, sol), fRefObj) && nBasic == 80, "crossover to an optimal basis");
+    check(algorithm.getCrossoverIterationCount() < reference.getIterationCount(), "crossover needs fewer pivots");
+
+    // Above the row limit, crossover is skipped.
+    check(algorithm.getCrossoverRowLimit() == 1000, "default crossover row limit");
+    algorithm.setCrossoverRowLimit(model.getConstraintCount() - 1);
+    algorithm.solve();
+    sol = algorithm.getSolution();
+    check(isNear(getObjective(model, sol), fRefObj, 1e-7) && algorithm.getCrossoverIterationCount() == 0 &&
+          algorithm.getBasis().getVarCount() == 0, "crossover skipped above the row limit");
+}
+
+}
+
+int main()
+{
+    printf("unit test: interior point\n");
+    smallModels();
+    transportModel();
+    printf("Unit test passed!\n");
+}
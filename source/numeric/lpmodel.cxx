@@ -257,13 +257,11 @@ double ModelImpl::getVarBound( size_t i, BoundType e ) const
 void ModelImpl::setVarBound( size_t nVarId, BoundType e, double fBound )
 {
     size_t nSize = m_cnVarRanges.size();
-    cout << "size is " << nSize << " and request is " << nVarId << endl;
     if ( nVarId >= nSize )
     {
         // Fill the container as necessary
         for ( size_t i = 0; i < nVarId + 1 - nSize; ++i )
         {
-            cout << "inserting new VarBounds at " << i << endl;
             VarBounds vb;
             vb.Lower.Enabled = false;
             vb.Lower.Value = 0.0;
@@ -0,0 +1,414 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/lpportfolio.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/exception.hxx"
+#include "numeric/solvecontrol.hxx"
+#include "tool/thread.hxx"
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <iostream>
+
+using ::std::vector;
+using ::std::string;
+using ::std::cout;
+using ::std::endl;
+
+namespace scsolver { namespace numeric { namespace lp {
+
+namespace {
+
+/** time limit given to the algorithms when the portfolio has almost none
+	left, since a limit of zero would mean none. */
+const double MIN_TIME_LIMIT = 1e-3;
+
+/**
+ * How an algorithm of the race has ended.
+ */
+enum EngineResult
+{
+	ENGINE_RUNNING,
+	ENGINE_OPTIMAL,
+
+	/** solution found without a proof of optimality, e.g. the incumbent
+		of a search stopped by its time limit. */
+	ENGINE_FEASIBLE,
+	ENGINE_INFEASIBLE,
+	ENGINE_MAX_ITERATION,
+	ENGINE_TIMED_OUT,
+	ENGINE_CANCELLED,
+	ENGINE_FAILED
+};
+
+}
+
+class PortfolioImpl;
+
+/**
+ * One algorithm of a race, with its copy of the model and its solve
+ * control.  The first engine runs in the calling thread, the others in
+ * threads of their own.  It passes the progress of its algorithm on to
+ * the portfolio.
+ */
+class PortfolioEngine : public ::scsolver::Thread, public SolveProgressListener
+{
+public:
+	PortfolioEngine( PortfolioImpl* pImpl, size_t nIndex, const Model& aModel ) :
+		m_pImpl( pImpl ), m_nIndex( nIndex ), m_aModel( aModel ), m_eResult( ENGINE_RUNNING )
+	{
+	}
+
+	virtual ~PortfolioEngine() throw() {}
+
+	void solveModel();
+
+	virtual void progress( const SolveProgress& rProgress );
+
+	size_t getIndex() const { return m_nIndex; }
+	Model& getModel() { return m_aModel; }
+	SolveControl& getControl() { return m_aControl; }
+	EngineResult getResult() const { return m_eResult; }
+	const string& getMessage() const { return m_sMessage; }
+
+protected:
+	virtual void run()
+	{
+		solveModel();
+	}
+
+private:
+	PortfolioImpl* m_pImpl;
+	size_t m_nIndex;
+	Model m_aModel;
+	SolveControl m_aControl;
+	EngineResult m_eResult;
+	string m_sMessage;
+};
+
+//---------------------------------------------------------------------------
+// PortfolioImpl
+
+/**
+ * The mutex protects the outcome of the race, which the engines decide
+ * as they end, and the calls to the progress listener.
+ */
+class PortfolioImpl
+{
+public:
+	PortfolioImpl( Portfolio* pSelf );
+	~PortfolioImpl() throw();
+
+	void solve();
+
+	void addAlgorithm( ::std::auto_ptr<BaseAlgorithm> pAlgorithm );
+	size_t getAlgorithmCount() const { return m_aAlgorithms.size(); }
+	BaseAlgorithm* getAlgorithm( size_t nIndex ) const { return m_aAlgorithms.at( nIndex ); }
+	size_t getWinner() const { return m_nWinner; }
+	bool isOptimal() const { return m_bOptimal; }
+
+	/** Record the end of an engine; called in its thread. */
+	void endEngine( const PortfolioEngine& rEngine );
+
+	void forwardProgress( const SolveProgress& rProgress );
+
+private:
+	void race();
+	bool pickFeasible();
+	void clearEngines();
+	void throwResult( EngineResult eResult, const string& rMessage ) const;
+
+	Portfolio* m_pSelf;
+	vector<BaseAlgorithm*> m_aAlgorithms;
+	vector<PortfolioEngine*> m_aEngines;
+
+	Mutex m_aMutex;
+	bool m_bDecided;
+	size_t m_nWinner;
+	bool m_bOptimal;
+	SolveProgressListener* m_pListener;
+};
+
+void PortfolioEngine::solveModel()
+{
+	try
+	{
+		BaseAlgorithm* pAlgorithm = m_pImpl->getAlgorithm( m_nIndex );
+		pAlgorithm->solve();
+		m_eResult = pAlgorithm->isOptimal() ? ENGINE_OPTIMAL : ENGINE_FEASIBLE;
+	}
+	catch ( const ModelInfeasible& )
+	{
+		m_eResult = ENGINE_INFEASIBLE;
+	}
+	catch ( const MaxIterationReached& )
+	{
+		m_eResult = ENGINE_MAX_ITERATION;
+	}
+	catch ( const IterationTimedOut& )
+	{
+		m_eResult = ENGINE_TIMED_OUT;
+	}
+	catch ( const SolveCancelled& )
+	{
+		m_eResult = ENGINE_CANCELLED;
+	}
+	catch ( const ::std::exception& e )
+	{
+		m_eResult = ENGINE_FAILED;
+		m_sMessage = e.what();
+	}
+	m_pImpl->endEngine( *this );
+}
+
+void PortfolioEngine::progress( const SolveProgress& rProgress )
+{
+	m_pImpl->forwardProgress( rProgress );
+}
+
+PortfolioImpl::PortfolioImpl( Portfolio* pSelf ) :
+	m_pSelf( pSelf ), m_bDecided( false ), m_nWinner( 0 ), m_bOptimal( false ), m_pListener( NULL )
+{
+}
+
+PortfolioImpl::~PortfolioImpl() throw()
+{
+	for ( size_t i = 0; i < m_aAlgorithms.size(); ++i )
+		delete m_aAlgorithms[i];
+}
+
+void PortfolioImpl::addAlgorithm( ::std::auto_ptr<BaseAlgorithm> pAlgorithm )
+{
+	m_aAlgorithms.reserve( m_aAlgorithms.size() + 1 );
+	m_aAlgorithms.push_back( pAlgorithm.release() );
+}
+
+/**
+ * The first proven optimal solution or proof of infeasibility decides the
+ * race, and the other engines are asked to stop.  A solution without a
+ * proof leaves the others running, since one of them may still prove a
+ * better one optimal.
+ */
+void PortfolioImpl::endEngine( const PortfolioEngine& rEngine )
+{
+	MutexGuard aGuard( m_aMutex );
+	if ( m_bDecided )
+		return;
+	if ( rEngine.getResult() != ENGINE_OPTIMAL && rEngine.getResult() != ENGINE_INFEASIBLE )
+		return;
+
+	m_bDecided = true;
+	m_nWinner = rEngine.getIndex();
+	for ( size_t i = 0; i < m_aEngines.size(); ++i )
+		if ( i != m_nWinner )
+			m_aEngines[i]->getControl().cancel();
+}
+
+void PortfolioImpl::forwardProgress( const SolveProgress& rProgress )
+{
+	MutexGuard aGuard( m_aMutex );
+	if ( !m_bDecided && m_pListener )
+		m_pListener->progress( rProgress );
+}
+
+/**
+ * Run the first engine in the calling thread and the others in threads
+ * of their own, and wait until all of them have ended.
+ */
+void PortfolioImpl::race()
+{
+	for ( size_t i = 1; i < m_aEngines.size(); ++i )
+		if ( !m_aEngines[i]->start() )
+			m_aEngines[i]->solveModel();
+	m_aEngines[0]->solveModel();
+	for ( size_t i = 1; i < m_aEngines.size(); ++i )
+		m_aEngines[i]->join();
+}
+
+/**
+ * When no engine has decided the race, take the best of the solutions
+ * found without a proof of optimality, if any.
+ */
+bool PortfolioImpl::pickFeasible()
+{
+	const Model& rModel = *m_pSelf->getModel();
+	Matrix mxCost = rModel.getCostVector();
+	bool bFound = false;
+	double fBest = 0.0;
+	for ( size_t i = 0; i < m_aEngines.size(); ++i )
+	{
+		if ( m_aEngines[i]->getResult() != ENGINE_FEASIBLE )
+			continue;
+
+		Matrix mxSolution = m_aAlgorithms[i]->getSolution();
+		double fValue = 0.0;
+		for ( size_t j = 0; j < mxCost.cols() && j < mxSolution.rows(); ++j )
+			fValue += mxCost( 0, j )*mxSolution( j, 0 );
+		bool bBetter = rModel.getGoal() == GOAL_MAXIMIZE ? fValue > fBest : fValue < fBest;
+		if ( !bFound || ( rModel.getGoal() != GOAL_TOVALUE && bBetter ) )
+		{
+			bFound = true;
+			fBest = fValue;
+			m_nWinner = i;
+		}
+	}
+	return bFound;
+}
+
+void PortfolioImpl::clearEngines()
+{
+	for ( size_t i = 0; i < m_aEngines.size(); ++i )
+	{
+		m_aAlgorithms[i]->setModel( NULL );
+		m_aAlgorithms[i]->setSolveControl( NULL );
+		delete m_aEngines[i];
+	}
+	m_aEngines.clear();
+}
+
+void PortfolioImpl::throwResult( EngineResult eResult, const string& rMessage ) const
+{
+	switch ( eResult )
+	{
+	case ENGINE_MAX_ITERATION:
+		throw MaxIterationReached();
+	case ENGINE_TIMED_OUT:
+		throw IterationTimedOut();
+	case ENGINE_CANCELLED:
+		throw SolveCancelled();
+	default:
+		throw Exception( rMessage );
+	}
+}
+
+void PortfolioImpl::solve()
+{
+	if ( m_aAlgorithms.empty() )
+		throw Exception( "portfolio has no algorithm" );
+
+	Model* pModel = m_pSelf->getModel();
+	SolveControl* pControl = m_pSelf->getSolveControl();
+	pControl->check();
+
+	m_bDecided = false;
+	m_nWinner = 0;
+	m_bOptimal = false;
+	m_pListener = pControl->getProgressListener();
+	const Basis aStartBasis = m_pSelf->getStartBasis();
+
+	// Each engine solves a copy of the model, so that no state is shared
+	// between the threads.  Only the first one prints its progress.
+	m_aEngines.reserve( m_aAlgorithms.size() );
+	for ( size_t i = 0; i < m_aAlgorithms.size(); ++i )
+	{
+		m_aEngines.push_back( new PortfolioEngine( this, i, *pModel ) );
+		PortfolioEngine& rEngine = *m_aEngines.back();
+		rEngine.getModel().setVerbose( i == 0 && pModel->getVerbose() );
+
+		SolveControl& rControl = rEngine.getControl();
+		rControl.setParent( pControl );
+		if ( pControl->getTimeLimit() > 0.0 )
+			rControl.setTimeLimit( ::std::max( pControl->getRemainingTime( 0.0 ), MIN_TIME_LIMIT ) );
+		rControl.setIterationLimit( pControl->getIterationLimit() );
+		rControl.setEvaluationLimit( pControl->getEvaluationLimit() );
+		rControl.setProgressListener( &rEngine );
+
+		BaseAlgorithm* pAlgorithm = m_aAlgorithms[i];
+		pAlgorithm->setModel( &rEngine.getModel() );
+		pAlgorithm->setStartBasis( aStartBasis );
+		pAlgorithm->setSolveControl( &rControl );
+	}
+
+	race();
+
+	if ( !m_bDecided && !pickFeasible() )
+	{
+		// All engines have failed.
+		EngineResult eResult = m_aEngines[0]->getResult();
+		string sMessage = m_aEngines[0]->getMessage();
+		clearEngines();
+		if ( pControl->isCancelled() )
+			throw SolveCancelled();
+		if ( pControl->isTimedOut() )
+			throw IterationTimedOut();
+		throwResult( eResult, sMessage );
+	}
+
+	if ( pModel->getVerbose() )
+		cout << "portfolio: algorithm " << m_nWinner << " of " << m_aAlgorithms.size()
+			 << " decided the solve" << endl;
+
+	const PortfolioEngine& rWinner = *m_aEngines[m_nWinner];
+	bool bInfeasible = rWinner.getResult() == ENGINE_INFEASIBLE;
+	m_bOptimal = rWinner.getResult() == ENGINE_OPTIMAL;
+	if ( !bInfeasible )
+	{
+		BaseAlgorithm* pAlgorithm = m_aAlgorithms[m_nWinner];
+		m_pSelf->setSolution( pAlgorithm->getSolution() );
+		m_pSelf->setBasis( pAlgorithm->getBasis() );
+	}
+	clearEngines();
+	if ( bInfeasible )
+		throw ModelInfeasible();
+}
+
+//---------------------------------------------------------------------------
+// Portfolio
+
+Portfolio::Portfolio() :
+	BaseAlgorithm(), m_pImpl( new PortfolioImpl( this ) )
+{
+}
+
+Portfolio::~Portfolio() throw()
+{
+}
+
+void Portfolio::solve()
+{
+	m_pImpl->solve();
+}
+
+void Portfolio::addAlgorithm( ::std::auto_ptr<BaseAlgorithm> pAlgorithm )
+{
+	m_pImpl->addAlgorithm( pAlgorithm );
+}
+
+size_t Portfolio::getAlgorithmCount() const
+{
+	return m_pImpl->getAlgorithmCount();
+}
+
+BaseAlgorithm* Portfolio::getAlgorithm( size_t nIndex ) const
+{
+	return m_pImpl->getAlgorithm( nIndex );
+}
+
+size_t Portfolio::getWinner() const
+{
+	return m_pImpl->getWinner();
+}
+
+bool Portfolio::isOptimal() const
+{
+	return m_pImpl->isOptimal();
+}
+
+}}}
@@ -0,0 +1,291 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/lpportfolio.hxx"
+#include "numeric/lpdualsimplex.hxx"
+#include "numeric/lpsimplex.hxx"
+#include "numeric/lpinteriorpoint.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/exception.hxx"
+#include "numeric/solvecontrol.hxx"
+#include "lptestutil.hxx"
+
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <stdio.h>
+
+using namespace ::scsolver::numeric;
+using namespace ::scsolver::numeric::lp;
+using namespace ::scsolver::numeric::lp::test;
+using ::std::vector;
+using ::std::auto_ptr;
+
+namespace {
+
+/**
+ * Algorithm that never finishes on its own, and cancels the given control
+ * after a while if there is one.
+ */
+class StallingAlgorithm : public BaseAlgorithm
+{
+public:
+    explicit StallingAlgorithm(SolveControl* pCancel = NULL) :
+        m_pCancel(pCancel), m_bCancelled(false) {}
+    virtual ~StallingAlgorithm() {}
+
+    virtual void solve()
+    {
+        m_bCancelled = false;
+        try
+        {
+            for (size_t i = 0; ; ++i)
+            {
+                if (m_pCancel && i == 1000)
+                    m_pCancel->cancel();
+                getSolveControl()->check();
+            }
+        }
+        catch (const SolveCancelled&)
+        {
+            m_bCancelled = true;
+            throw;
+        }
+    }
+
+    bool isCancelled() const { return m_bCancelled; }
+
+private:
+    SolveControl* m_pCancel;
+    bool m_bCancelled;
+};
+
+/**
+ * Algorithm that stops right away as if its time limit had run out, with
+ * the feasible but poor solution x = 0 and no proof of optimality.
+ */
+class TimeLimitedAlgorithm : public BaseAlgorithm
+{
+public:
+    virtual ~TimeLimitedAlgorithm() {}
+
+    virtual void solve()
+    {
+        setSolution(Matrix(getModel()->getCostVector().cols(), 1));
+    }
+
+    virtual bool isOptimal() const { return false; }
+};
+
+class FailingAlgorithm : public BaseAlgorithm
+{
+public:
+    virtual ~FailingAlgorithm() {}
+    virtual void solve() { throw MaxIterationReached(); }
+};
+
+class ProgressCounter : public SolveProgressListener
+{
+public:
+    ProgressCounter() : m_nCount(0) {}
+    virtual ~ProgressCounter() throw() {}
+    virtual void progress(const SolveProgress&) { ++m_nCount; }
+    size_t getCount() const { return m_nCount; }
+
+private:
+    size_t m_nCount;
+};
+
+void addEngines(Portfolio& portfolio)
+{
+    auto_ptr<BaseAlgorithm> pDual(new DualSimplex);
+    portfolio.addAlgorithm(pDual);
+    auto_ptr<BaseAlgorithm> pPrimal(new RevisedSimplex);
+    portfolio.addAlgorithm(pPrimal);
+    auto_ptr<BaseAlgorithm> pInterior(new InteriorPoint);
+    portfolio.addAlgorithm(pInterior);
+}
+
+void randomModels()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("random models\n");
+
+    Portfolio portfolio;
+    addEngines(portfolio);
+    for (unsigned long seed = 1; seed <= 5; ++seed)
+    {
+        Model model;
+        buildWideModel(model, 20, 40, seed);
+
+        DualSimplex reference;
+        reference.setModel(&model);
+        reference.solve();
+        double fRefObj = getObjective(model, reference.getSolution());
+
+        portfolio.setModel(&model);
+        portfolio.solve();
+        Matrix sol = portfolio.getSolution();
+        printf("seed %lu: objective %.10g (reference %.10g), won by algorithm %lu  ",
+               seed, getObjective(model, sol), fRefObj,
+               static_cast<unsigned long>(portfolio.getWinner()));
+        check(sol.rows() == 40 && isNear(getObjective(model, sol), fRefObj, 1e-6), "same optimum");
+    }
+    check(portfolio.getAlgorithm(0)->getModel() == NULL, "algorithms released the model");
+}
+
+void infeasibleModel()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("infeasible model\n");
+
+    // x + y <= 1, x + y >= 3
+    Model model;
+    vector<double> cost(2, 1.0);
+    model.setCostVector(cost);
+    model.setGoal(GOAL_MAXIMIZE);
+    model.setVarPositive(true);
+    vector<double> row(2, 1.0);
+    model.addConstraint(row, LESS_EQUAL, 1.0);
+    model.addConstraint(row, GREATER_EQUAL, 3.0);
+
+    Portfolio portfolio;
+    addEngines(portfolio);
+    portfolio.setModel(&model);
+    bool bThrown = false;
+    try
+    {
+        portfolio.solve();
+    }
+    catch (const ModelInfeasible&)
+    {
+        bThrown = true;
+    }
+    check(bThrown, "infeasibility proven");
+}
+
+void cancellation()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("cancellation\n");
+
+    Model model;
+    buildWideModel(model, 20, 40, 11);
+
+    // The stalling algorithm only ends when the race is decided.
+    {
+        Portfolio portfolio;
+        StallingAlgorithm* pStalling = new StallingAlgorithm;
+        auto_ptr<BaseAlgorithm> p(pStalling);
+        portfolio.addAlgorithm(p);
+        auto_ptr<BaseAlgorithm> pDual(new DualSimplex);
+        portfolio.addAlgorithm(pDual);
+
+        ProgressCounter counter;
+        SolveControl control;
+        control.setProgressListener(&counter);
+        portfolio.setSolveControl(&control);
+        portfolio.setModel(&model);
+        portfolio.solve();
+        check(portfolio.getWinner() == 1, "dual simplex wins");
+        check(pStalling->isCancelled(), "other algorithm cancelled");
+        check(!control.isCancelled(), "control of the portfolio not cancelled");
+        printf("%lu progress reports\n", static_cast<unsigned long>(counter.getCount()));
+        check(counter.getCount() > 0, "progress passed on");
+    }
+
+    // A solution without a proof of optimality does not decide the race.
+    {
+        DualSimplex reference;
+        reference.setModel(&model);
+        reference.solve();
+        double fRefObj = getObjective(model, reference.getSolution());
+
+        Portfolio portfolio;
+        auto_ptr<BaseAlgorithm> pLimited(new TimeLimitedAlgorithm);
+        portfolio.addAlgorithm(pLimited);
+        auto_ptr<BaseAlgorithm> pDual(new DualSimplex);
+        portfolio.addAlgorithm(pDual);
+        portfolio.setModel(&model);
+        portfolio.solve();
+        check(portfolio.getWinner() == 1 && portfolio.isOptimal() &&
+              isNear(getObjective(model, portfolio.getSolution()), fRefObj, 1e-6),
+              "stopped algorithm does not win");
+
+        // It is still used when nothing better comes up.
+        Portfolio fallback;
+        auto_ptr<BaseAlgorithm> p1(new FailingAlgorithm), p2(new TimeLimitedAlgorithm);
+        fallback.addAlgorithm(p1);
+        fallback.addAlgorithm(p2);
+        fallback.setModel(&model);
+        fallback.solve();
+        check(fallback.getWinner() == 1 && !fallback.isOptimal() &&
+              getObjective(model, fallback.getSolution()) == 0.0, "solution without proof used");
+    }
+
+    // When all algorithms fail, the error of the first one is thrown.
+    {
+        Portfolio portfolio;
+        auto_ptr<BaseAlgorithm> p1(new FailingAlgorithm), p2(new FailingAlgorithm);
+        portfolio.addAlgorithm(p1);
+        portfolio.addAlgorithm(p2);
+        portfolio.setModel(&model);
+        bool bThrown = false;
+        try
+        {
+            portfolio.solve();
+        }
+        catch (const MaxIterationReached&)
+        {
+            bThrown = true;
+        }
+        check(bThrown, "all algorithms failed");
+    }
+
+    // Cancelling the portfolio stops all of its algorithms.
+    {
+        SolveControl control;
+        Portfolio portfolio;
+        auto_ptr<BaseAlgorithm> p1(new StallingAlgorithm(&control)), p2(new StallingAlgorithm);
+        portfolio.addAlgorithm(p1);
+        portfolio.addAlgorithm(p2);
+        portfolio.setSolveControl(&control);
+        portfolio.setModel(&model);
+        bool bThrown = false;
+        try
+        {
+            portfolio.solve();
+        }
+        catch (const SolveCancelled&)
+        {
+            bThrown = true;
+        }
+        check(bThrown, "portfolio cancelled");
+    }
+}
+
+}
+
+int main()
+{
+    printf("unit test: portfolio\n");
+    randomModels();
+    infeasibleModel();
+    cancellation();
+    printf("Unit test passed!\n");
+}
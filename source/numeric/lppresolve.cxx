@@ -0,0 +1,828 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/lppresolve.hxx"
+#include "numeric/lpbase.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/exception.hxx"
+
+#include <vector>
+#include <utility>
+#include <limits>
+#include <cmath>
+#include <iostream>
+
+using ::std::vector;
+using ::std::pair;
+using ::std::cout;
+using ::std::endl;
+
+namespace scsolver { namespace numeric { namespace lp {
+
+namespace {
+
+const double INF = ::std::numeric_limits<double>::infinity();
+
+/** absolute tolerance for bound violation, relative for large bounds. */
+const double PRIMAL_TOL = 1e-9;
+
+/** relative tolerance when comparing the coefficients of two rows. */
+const double COEF_TOL = 1e-12;
+
+double getTol( double fVal )
+{
+	return fVal == INF || fVal == -INF ? PRIMAL_TOL : PRIMAL_TOL*( 1.0 + ::std::fabs( fVal ) );
+}
+
+typedef vector< pair<size_t,double> > RowEntries;
+
+enum PostsolveType
+{
+	POSTSOLVE_FIXED,
+	POSTSOLVE_SLACK,
+	POSTSOLVE_SUBSTITUTE
+};
+
+/**
+ * One removed column, recorded in the order of removal.  Postsolve walks
+ * the steps backwards, so the other entries of the row of a column
+ * singleton refer to columns whose values are already known by then.
+ */
+struct PostsolveStep
+{
+	PostsolveType Type;
+	size_t Col;
+
+	/** value of a fixed column. */
+	double Value;
+
+	/** coefficient of a column singleton in its row. */
+	double Coef;
+
+	/** bounds of a column singleton. */
+	double Lower;
+	double Upper;
+
+	/** bounds of the row of a column singleton, without the column. */
+	double RowLower;
+	double RowUpper;
+
+	/** the other entries in the row of a column singleton. */
+	RowEntries Row;
+};
+
+}
+
+//---------------------------------------------------------------------------
+// PresolverImpl
+
+/**
+ * The model is stored as  min c x  subject to  lr <= A x <= ur,
+ * lc <= x <= uc, where an infinite bound means no bound.  Reductions only
+ * mark rows and columns as removed and change the bounds and the cost,
+ * while the constraint matrix stays as it is.
+ */
+class PresolverImpl
+{
+public:
+	PresolverImpl();
+	~PresolverImpl() throw();
+
+	void presolve( const Model& aModel );
+	const Model getReducedModel() const;
+	const Matrix postsolve( const Matrix& mxSolution ) const;
+	const Basis postsolveBasis( const Basis& aBasis ) const;
+
+	size_t getRemovedRowCount() const;
+	size_t getRemovedColCount() const;
+
+private:
+	::std::auto_ptr<Model> m_pModel;
+
+	bool m_bDualReductions;
+	bool m_bInteger;
+
+	Matrix m_mxA;
+	vector<double> m_aCost;
+	vector<double> m_aLower;
+	vector<double> m_aUpper;
+	vector<double> m_aRowLower;
+	vector<double> m_aRowUpper;
+
+	vector<bool> m_aRowAlive;
+	vector<bool> m_aColAlive;
+
+	/** number of non-zero entries in the remaining rows and columns. */
+	vector<size_t> m_aRowCount;
+	vector<size_t> m_aColCount;
+
+	vector<PostsolveStep> m_aSteps;
+
+	void initialize( const Model& aModel );
+
+	void removeRow( size_t i );
+	void removeColumn( size_t j );
+	void fixColumn( size_t j, double fVal );
+	void tightenBounds( size_t j, double fLower, double fUpper );
+	void getActivityRange( size_t i, size_t nSkipCol, double& rMin, double& rMax ) const;
+	void getRowEntries( size_t i, size_t nSkipCol, RowEntries& rEntries ) const;
+
+	bool reduceRows();
+	bool reduceColumns();
+	bool reduceColumnSingleton( size_t j );
+	bool reduceDuplicateRows();
+};
+
+PresolverImpl::PresolverImpl() :
+	m_bDualReductions( true ), m_bInteger( false ), m_mxA( 0, 0 )
+{
+}
+
+PresolverImpl::~PresolverImpl() throw()
+{
+}
+
+void PresolverImpl::initialize( const Model& aModel )
+{
+	::std::auto_ptr<Model> p( new Model( aModel ) );
+	m_pModel = p;
+
+	GoalType eGoal = aModel.getGoal();
+	m_bDualReductions = eGoal == GOAL_MINIMIZE || eGoal == GOAL_MAXIMIZE;
+	m_bInteger = aModel.getVarInteger();
+
+	m_mxA = aModel.getConstraintMatrix();
+	Matrix mxC = aModel.getCostVector();
+	size_t nRowCount = m_mxA.rows();
+	size_t nColCount = ::std::max( m_mxA.cols(), mxC.cols() );
+	if ( m_mxA.cols() < nColCount )
+		m_mxA.resize( nRowCount, nColCount );
+
+	double fSign = eGoal == GOAL_MAXIMIZE ? -1.0 : 1.0;
+	m_aCost.assign( nColCount, 0.0 );
+	for ( size_t j = 0; j < mxC.cols(); ++j )
+		m_aCost[j] = fSign*mxC( 0, j );
+
+	m_aLower.assign( nColCount, aModel.getVarPositive() ? 0.0 : -INF );
+	m_aUpper.assign( nColCount, INF );
+	for ( size_t j = 0; j < nColCount; ++j )
+	{
+		double fLower = aModel.isVarBounded( j, BOUND_LOWER ) ? aModel.getVarBound( j, BOUND_LOWER ) : -INF;
+		double fUpper = aModel.isVarBounded( j, BOUND_UPPER ) ? aModel.getVarBound( j, BOUND_UPPER ) : INF;
+		tightenBounds( j, fLower, fUpper );
+	}
+
+	m_aRowLower.assign( nRowCount, -INF );
+	m_aRowUpper.assign( nRowCount, INF );
+	for ( size_t i = 0; i < nRowCount; ++i )
+	{
+		double fRhs = aModel.getRhsValue( i );
+		switch ( aModel.getEquality( i ) )
+		{
+		case LESS_EQUAL:
+			m_aRowUpper[i] = fRhs;
+			break;
+		case GREATER_EQUAL:
+			m_aRowLower[i] = fRhs;
+			break;
+		case EQUAL:
+			m_aRowLower[i] = m_aRowUpper[i] = fRhs;
+			break;
+		}
+	}
+
+	m_aRowAlive.assign( nRowCount, true );
+	m_aColAlive.assign( nColCount, true );
+	m_aRowCount.assign( nRowCount, 0 );
+	m_aColCount.assign( nColCount, 0 );
+	for ( size_t i = 0; i < nRowCount; ++i )
+		for ( size_t j = 0; j < nColCount; ++j )
+			if ( m_mxA( i, j ) != 0.0 )
+			{
+				++m_aRowCount[i];
+				++m_aColCount[j];
+			}
+
+	m_aSteps.clear();
+}
+
+void PresolverImpl::presolve( const Model& aModel )
+{
+	initialize( aModel );
+
+	bool bChanged = true;
+	while ( bChanged )
+	{
+		bChanged = reduceRows();
+		bChanged = reduceColumns() || bChanged;
+		if ( !bChanged )
+			// Duplicate rows are the most expensive to find, so look for
+			// them only when nothing else is left to do.
+			bChanged = reduceDuplicateRows();
+	}
+
+	if ( aModel.getVerbose() )
+		cout << "presolve: removed " << getRemovedRowCount() << " of " << m_aRowAlive.size()
+			 << " rows and " << getRemovedColCount() << " of " << m_aColAlive.size()
+			 << " columns" << endl;
+}
+
+const Model PresolverImpl::getReducedModel() const
+{
+	Model aModel;
+	aModel.setGoal( m_pModel->getGoal() );
+	aModel.setSolveToValue( m_pModel->getSolveToValue() );
+	aModel.setPrecision( m_pModel->getPrecision() );
+	aModel.setVarPositive( m_pModel->getVarPositive() );
+	aModel.setVarInteger( m_pModel->getVarInteger() );
+	aModel.setVerbose( m_pModel->getVerbose() );
+
+	vector<size_t> aCols;
+	for ( size_t j = 0; j < m_aColAlive.size(); ++j )
+		if ( m_aColAlive[j] )
+			aCols.push_back( j );
+
+	double fSign = m_pModel->getGoal() == GOAL_MAXIMIZE ? -1.0 : 1.0;
+	vector<double> aCost( aCols.size() );
+	for ( size_t k = 0; k < aCols.size(); ++k )
+	{
+		size_t j = aCols[k];
+		aCost[k] = fSign*m_aCost[j];
+
+		// A zero lower bound is implicit when all variables are positive,
+		// unless the original model had it explicitly.
+		double fLower = m_aLower[j];
+		if ( fLower != -INF && ( fLower != 0.0 || !m_pModel->getVarPositive() ||
+								 m_pModel->isVarBounded( j, BOUND_LOWER ) ) )
+			aModel.setVarBound( k, BOUND_LOWER, fLower );
+		if ( m_aUpper[j] != INF )
+			aModel.setVarBound( k, BOUND_UPPER, m_aUpper[j] );
+	}
+	aModel.setCostVector( aCost );
+
+	for ( size_t i = 0; i < m_aRowAlive.size(); ++i )
+	{
+		if ( !m_aRowAlive[i] )
+			continue;
+
+		vector<double> aRow( aCols.size() );
+		for ( size_t k = 0; k < aCols.size(); ++k )
+			aRow[k] = m_mxA( i, aCols[k] );
+
+		double fLower = m_aRowLower[i], fUpper = m_aRowUpper[i];
+		if ( fLower == fUpper )
+			aModel.addConstraint( aRow, EQUAL, fLower );
+		else
+		{
+			if ( fLower != -INF )
+				aModel.addConstraint( aRow, GREATER_EQUAL, fLower );
+			if ( fUpper != INF )
+				aModel.addConstraint( aRow, LESS_EQUAL, fUpper );
+		}
+	}
+
+	return aModel;
+}
+
+const Matrix PresolverImpl::postsolve( const Matrix& mxSolution ) const
+{
+	size_t nColCount = m_aColAlive.size();
+	vector<double> aX( nColCount, 0.0 );
+	size_t k = 0;
+	for ( size_t j = 0; j < nColCount; ++j )
+		if ( m_aColAlive[j] )
+			aX[j] = mxSolution( k++, 0 );
+
+	vector<PostsolveStep>::const_reverse_iterator itr, itrEnd = m_aSteps.rend();
+	for ( itr = m_aSteps.rbegin(); itr != itrEnd; ++itr )
+	{
+		if ( itr->Type == POSTSOLVE_FIXED )
+		{
+			aX[itr->Col] = itr->Value;
+			continue;
+		}
+
+		double fActivity = 0.0;
+		RowEntries::const_iterator itrEntry, itrEntryEnd = itr->Row.end();
+		for ( itrEntry = itr->Row.begin(); itrEntry != itrEntryEnd; ++itrEntry )
+			fActivity += itrEntry->second*aX[itrEntry->first];
+
+		double fCoef = itr->Coef;
+		if ( itr->Type == POSTSOLVE_SUBSTITUTE )
+		{
+			aX[itr->Col] = ( itr->RowLower - fActivity )/fCoef;
+			continue;
+		}
+
+		// Pick the value closest to zero that keeps the row feasible.
+		double fLower = ( itr->RowLower - fActivity )/fCoef;
+		double fUpper = ( itr->RowUpper - fActivity )/fCoef;
+		if ( fCoef < 0.0 )
+			::std::swap( fLower, fUpper );
+		fLower = ::std::max( fLower, itr->Lower );
+		fUpper = ::std::min( fUpper, itr->Upper );
+		aX[itr->Col] = fLower > 0.0 ? fLower : ( fUpper < 0.0 ? fUpper : 0.0 );
+	}
+
+	Matrix mxX( nColCount, 1 );
+	for ( size_t j = 0; j < nColCount; ++j )
+		mxX( j, 0 ) = aX[j];
+	return mxX;
+}
+
+const Basis PresolverImpl::postsolveBasis( const Basis& aBasis ) const
+{
+	size_t nColCount = m_aColAlive.size(), nRowCount = m_aRowAlive.size();
+	Basis aOrigBasis( nColCount, nRowCount );
+
+	size_t k = 0;
+	for ( size_t j = 0; j < nColCount; ++j )
+	{
+		BasisStatus eStatus = BASIS_LOWER;
+		if ( m_aColAlive[j] )
+		{
+			if ( k == aBasis.getVarCount() )
+				return Basis();
+			eStatus = aBasis.getVarStatus( k++ );
+		}
+		aOrigBasis.setVarStatus( j, eStatus );
+	}
+	if ( k != aBasis.getVarCount() )
+		return Basis();
+
+	// The reduced model has one constraint per bound of a row, see
+	// getReducedModel.  A ranged row is non-basic when either of its two
+	// constraints is.
+	k = 0;
+	for ( size_t i = 0; i < nRowCount; ++i )
+	{
+		BasisStatus eStatus = BASIS_BASIC;
+		if ( m_aRowAlive[i] )
+		{
+			double fLower = m_aRowLower[i], fUpper = m_aRowUpper[i];
+			size_t nCount = 1;
+			if ( fLower != fUpper )
+				nCount = ( fLower != -INF ? 1 : 0 ) + ( fUpper != INF ? 1 : 0 );
+			if ( k + nCount > aBasis.getRowCount() )
+				return Basis();
+			for ( ; nCount > 0; --nCount, ++k )
+				if ( aBasis.getRowStatus( k ) != BASIS_BASIC )
+					eStatus = aBasis.getRowStatus( k );
+		}
+		aOrigBasis.setRowStatus( i, eStatus );
+	}
+	if ( k != aBasis.getRowCount() )
+		return Basis();
+
+	return aOrigBasis;
+}
+
+size_t PresolverImpl::getRemovedRowCount() const
+{
+	size_t nCount = 0;
+	for ( size_t i = 0; i < m_aRowAlive.size(); ++i )
+		if ( !m_aRowAlive[i] )
+			++nCount;
+	return nCount;
+}
+
+size_t PresolverImpl::getRemovedColCount() const
+{
+	size_t nCount = 0;
+	for ( size_t j = 0; j < m_aColAlive.size(); ++j )
+		if ( !m_aColAlive[j] )
+			++nCount;
+	return nCount;
+}
+
+void PresolverImpl::removeRow( size_t i )
+{
+	m_aRowAlive[i] = false;
+	for ( size_t j = 0; j < m_aColAlive.size(); ++j )
+		if ( m_aColAlive[j] && m_mxA( i, j ) != 0.0 )
+			--m_aColCount[j];
+}
+
+void PresolverImpl::removeColumn( size_t j )
+{
+	m_aColAlive[j] = false;
+	for ( size_t i = 0; i < m_aRowAlive.size(); ++i )
+		if ( m_aRowAlive[i] && m_mxA( i, j ) != 0.0 )
+			--m_aRowCount[i];
+}
+
+/**
+ * Remove a column at a fixed value, and move its contribution to the row
+ * bounds.
+ */
+void PresolverImpl::fixColumn( size_t j, double fVal )
+{
+	PostsolveStep aStep;
+	aStep.Type = POSTSOLVE_FIXED;
+	aStep.Col = j;
+	aStep.Value = fVal;
+	m_aSteps.push_back( aStep );
+
+	for ( size_t i = 0; i < m_aRowAlive.size(); ++i )
+	{
+		double fCoef = m_mxA( i, j );
+		if ( !m_aRowAlive[i] || fCoef == 0.0 )
+			continue;
+		m_aRowLower[i] -= fCoef*fVal;
+		m_aRowUpper[i] -= fCoef*fVal;
+	}
+	removeColumn( j );
+}
+
+/**
+ * Intersect the bounds of a column with the given ones.  Bounds of integer
+ * variables are rounded inwards.
+ */
+void PresolverImpl::tightenBounds( size_t j, double fLower, double fUpper )
+{
+	if ( m_bInteger )
+	{
+		fLower = ::std::ceil( fLower - getTol( fLower ) );
+		fUpper = ::std::floor( fUpper + getTol( fUpper ) );
+	}
+
+	double& rLower = m_aLower[j];
+	double& rUpper = m_aUpper[j];
+	rLower = ::std::max( rLower, fLower );
+	rUpper = ::std::min( rUpper, fUpper );
+	if ( rLower > rUpper + getTol( rUpper ) )
+		throw ModelInfeasible();
+	if ( rLower > rUpper )
+		rUpper = rLower;
+}
+
+/**
+ * Compute the smallest and the largest activity of a row over the bounds
+ * of its remaining columns, optionally leaving one column out.
+ */
+void PresolverImpl::getActivityRange( size_t i, size_t nSkipCol, double& rMin, double& rMax ) const
+{
+	rMin = rMax = 0.0;
+	for ( size_t j = 0; j < m_aColAlive.size(); ++j )
+	{
+		double fCoef = m_mxA( i, j );
+		if ( !m_aColAlive[j] || fCoef == 0.0 || j == nSkipCol )
+			continue;
+
+		if ( fCoef > 0.0 )
+		{
+			rMin += fCoef*m_aLower[j];
+			rMax += fCoef*m_aUpper[j];
+		}
+		else
+		{
+			rMin += fCoef*m_aUpper[j];
+			rMax += fCoef*m_aLower[j];
+		}
+	}
+}
+
+void PresolverImpl::getRowEntries( size_t i, size_t nSkipCol, RowEntries& rEntries ) const
+{
+	rEntries.clear();
+	for ( size_t j = 0; j < m_aColAlive.size(); ++j )
+	{
+		double fCoef = m_mxA( i, j );
+		if ( m_aColAlive[j] && fCoef != 0.0 && j != nSkipCol )
+			rEntries.push_back( pair<size_t,double>( j, fCoef ) );
+	}
+}
+
+/**
+ * Remove empty rows, turn singleton rows into bounds, and remove forcing
+ * and redundant rows.
+ *
+ * @return bool true if any row has been removed
+ */
+bool PresolverImpl::reduceRows()
+{
+	bool bChanged = false;
+	for ( size_t i = 0; i < m_aRowAlive.size(); ++i )
+	{
+		if ( !m_aRowAlive[i] )
+			continue;
+
+		double fLower = m_aRowLower[i], fUpper = m_aRowUpper[i];
+		if ( m_aRowCount[i] == 0 )
+		{
+			if ( fLower > getTol( fLower ) || fUpper < -getTol( fUpper ) )
+				throw ModelInfeasible();
+			removeRow( i );
+			bChanged = true;
+			continue;
+		}
+
+		if ( m_aRowCount[i] == 1 )
+		{
+			size_t j = 0;
+			while ( !m_aColAlive[j] || m_mxA( i, j ) == 0.0 )
+				++j;
+			double fCoef = m_mxA( i, j );
+			if ( fCoef > 0.0 )
+				tightenBounds( j, fLower/fCoef, fUpper/fCoef );
+			else
+				tightenBounds( j, fUpper/fCoef, fLower/fCoef );
+			removeRow( i );
+			bChanged = true;
+			continue;
+		}
+
+		double fMin, fMax;
+		getActivityRange( i, m_aColAlive.size(), fMin, fMax );
+		if ( fMin > fUpper + getTol( fUpper ) || fMax < fLower - getTol( fLower ) )
+			throw ModelInfeasible();
+
+		bool bForceMin = fUpper != INF && fMin >= fUpper - getTol( fUpper );
+		bool bForceMax = fLower != -INF && fMax <= fLower + getTol( fLower );
+		if ( bForceMin || bForceMax )
+		{
+			// Forcing row: every column has to sit at the bound that
+			// attains the extreme activity.
+			for ( size_t j = 0; j < m_aColAlive.size(); ++j )
+			{
+				double fCoef = m_mxA( i, j );
+				if ( !m_aColAlive[j] || fCoef == 0.0 )
+					continue;
+				bool bLower = ( fCoef > 0.0 ) == bForceMin;
+				fixColumn( j, bLower ? m_aLower[j] : m_aUpper[j] );
+			}
+			removeRow( i );
+			bChanged = true;
+		}
+		else if ( fMin >= fLower - getTol( fLower ) && fMax <= fUpper + getTol( fUpper ) )
+		{
+			// The row can never be violated.
+			removeRow( i );
+			bChanged = true;
+		}
+	}
+	return bChanged;
+}
+
+/**
+ * Remove fixed, empty and dominated columns, and column singletons.
+ *
+ * @return bool true if any column has been removed
+ */
+bool PresolverImpl::reduceColumns()
+{
+	bool bChanged = false;
+	for ( size_t j = 0; j < m_aColAlive.size(); ++j )
+	{
+		if ( !m_aColAlive[j] )
+			continue;
+
+		double fLower = m_aLower[j], fUpper = m_aUpper[j];
+		if ( fLower == fUpper )
+		{
+			fixColumn( j, fLower );
+			bChanged = true;
+			continue;
+		}
+
+		double fCost = m_aCost[j];
+		if ( fCost != 0.0 && !m_bDualReductions )
+			continue;
+
+		// Find out whether moving the column towards either of its bounds
+		// can violate any row.
+		bool bCanDecrease = true, bCanIncrease = true;
+		for ( size_t i = 0; i < m_aRowAlive.size(); ++i )
+		{
+			double fCoef = m_mxA( i, j );
+			if ( !m_aRowAlive[i] || fCoef == 0.0 )
+				continue;
+			bool bHasLower = m_aRowLower[i] != -INF, bHasUpper = m_aRowUpper[i] != INF;
+			if ( ( fCoef > 0.0 && bHasLower ) || ( fCoef < 0.0 && bHasUpper ) )
+				bCanDecrease = false;
+			if ( ( fCoef > 0.0 && bHasUpper ) || ( fCoef < 0.0 && bHasLower ) )
+				bCanIncrease = false;
+		}
+
+		// An empty column is dominated in both directions.
+		if ( fCost > 0.0 && bCanDecrease )
+		{
+			if ( fLower == -INF )
+				throw ModelInfeasible();
+			fixColumn( j, fLower );
+			bChanged = true;
+		}
+		else if ( fCost < 0.0 && bCanIncrease )
+		{
+			if ( fUpper == INF )
+				throw ModelInfeasible();
+			fixColumn( j, fUpper );
+			bChanged = true;
+		}
+		else if ( fCost == 0.0 && ( ( bCanDecrease && fLower != -INF ) || ( bCanIncrease && fUpper != INF ) ) )
+		{
+			fixColumn( j, bCanDecrease && fLower != -INF ? fLower : fUpper );
+			bChanged = true;
+		}
+		else if ( fCost == 0.0 && bCanDecrease && bCanIncrease )
+		{
+			// Empty free column.
+			fixColumn( j, 0.0 );
+			bChanged = true;
+		}
+		else if ( m_aColCount[j] == 1 && !m_bInteger )
+			bChanged = reduceColumnSingleton( j ) || bChanged;
+	}
+	return bChanged;
+}
+
+/**
+ * A continuous column that appears in only one row is folded into the
+ * row.  Without a cost, the column is a slack that widens the bounds of
+ * the row.  Otherwise, when the row is an equality and the bounds of the
+ * column can never be reached, the column is substituted out of the
+ * model together with the row.
+ *
+ * @return bool true if the column has been removed
+ */
+bool PresolverImpl::reduceColumnSingleton( size_t j )
+{
+	size_t i = 0;
+	while ( !m_aRowAlive[i] || m_mxA( i, j ) == 0.0 )
+		++i;
+
+	double fCoef = m_mxA( i, j );
+	double fLower = m_aLower[j], fUpper = m_aUpper[j];
+	double fRowLower = m_aRowLower[i], fRowUpper = m_aRowUpper[i];
+
+	PostsolveStep aStep;
+	aStep.Col = j;
+	aStep.Value = 0.0;
+	aStep.Coef = fCoef;
+	aStep.Lower = fLower;
+	aStep.Upper = fUpper;
+	aStep.RowLower = fRowLower;
+	aStep.RowUpper = fRowUpper;
+
+	if ( m_aCost[j] == 0.0 )
+	{
+		double fMinTerm = fCoef > 0.0 ? fCoef*fLower : fCoef*fUpper;
+		double fMaxTerm = fCoef > 0.0 ? fCoef*fUpper : fCoef*fLower;
+		aStep.Type = POSTSOLVE_SLACK;
+		getRowEntries( i, j, aStep.Row );
+		m_aSteps.push_back( aStep );
+
+		m_aRowLower[i] = fRowLower - fMaxTerm;
+		m_aRowUpper[i] = fRowUpper - fMinTerm;
+		removeColumn( j );
+		return true;
+	}
+
+	if ( fRowLower != fRowUpper )
+		return false;
+
+	// The column is implied free when the rest of the row can never push
+	// it beyond its bounds.
+	double fMin, fMax;
+	getActivityRange( i, j, fMin, fMax );
+	double fImpliedLower = ( fRowLower - ( fCoef > 0.0 ? fMax : fMin ) )/fCoef;
+	double fImpliedUpper = ( fRowLower - ( fCoef > 0.0 ? fMin : fMax ) )/fCoef;
+	if ( fImpliedLower < fLower - getTol( fLower ) || fImpliedUpper > fUpper + getTol( fUpper ) )
+		return false;
+
+	aStep.Type = POSTSOLVE_SUBSTITUTE;
+	getRowEntries( i, j, aStep.Row );
+	m_aSteps.push_back( aStep );
+
+	double fRatio = m_aCost[j]/fCoef;
+	RowEntries::const_iterator itr, itrEnd = aStep.Row.end();
+	for ( itr = aStep.Row.begin(); itr != itrEnd; ++itr )
+		m_aCost[itr->first] -= fRatio*itr->second;
+	m_aCost[j] = 0.0;
+
+	removeColumn( j );
+	removeRow( i );
+	return true;
+}
+
+/**
+ * Merge rows that are a multiple of another row into that row.
+ *
+ * @return bool true if any row has been removed
+ */
+bool PresolverImpl::reduceDuplicateRows()
+{
+	size_t nRowCount = m_aRowAlive.size(), nColCount = m_aColAlive.size();
+
+	// First remaining column of each row, so that only rows with the same
+	// pattern start and size need to be compared.
+	vector<size_t> aFirstCol( nRowCount, nColCount );
+	for ( size_t i = 0; i < nRowCount; ++i )
+		for ( size_t j = 0; m_aRowAlive[i] && j < nColCount; ++j )
+			if ( m_aColAlive[j] && m_mxA( i, j ) != 0.0 )
+			{
+				aFirstCol[i] = j;
+				break;
+			}
+
+	bool bChanged = false;
+	for ( size_t i = 0; i < nRowCount; ++i )
+	{
+		if ( !m_aRowAlive[i] || aFirstCol[i] == nColCount )
+			continue;
+
+		for ( size_t k = i + 1; k < nRowCount; ++k )
+		{
+			if ( !m_aRowAlive[k] || aFirstCol[k] != aFirstCol[i] || m_aRowCount[k] != m_aRowCount[i] )
+				continue;
+
+			double fRatio = m_mxA( k, aFirstCol[i] )/m_mxA( i, aFirstCol[i] );
+			bool bDuplicate = true;
+			for ( size_t j = 0; j < nColCount && bDuplicate; ++j )
+			{
+				if ( !m_aColAlive[j] )
+					continue;
+				double fVal = m_mxA( k, j );
+				if ( ::std::fabs( fVal - fRatio*m_mxA( i, j ) ) > COEF_TOL*( 1.0 + ::std::fabs( fVal ) ) )
+					bDuplicate = false;
+			}
+			if ( !bDuplicate )
+				continue;
+
+			// Row k is row i times the ratio.
+			double fLower = m_aRowLower[k]/fRatio, fUpper = m_aRowUpper[k]/fRatio;
+			if ( fRatio < 0.0 )
+				::std::swap( fLower, fUpper );
+			double& rLower = m_aRowLower[i];
+			double& rUpper = m_aRowUpper[i];
+			rLower = ::std::max( rLower, fLower );
+			rUpper = ::std::min( rUpper, fUpper );
+			if ( rLower > rUpper + getTol( rUpper ) )
+				throw ModelInfeasible();
+			if ( rLower > rUpper )
+				rUpper = rLower;
+
+			removeRow( k );
+			bChanged = true;
+		}
+	}
+	return bChanged;
+}
+
+//---------------------------------------------------------------------------
+// Presolver
+
+Presolver::Presolver() : m_pImpl( new PresolverImpl )
+{
+}
+
+Presolver::~Presolver() throw()
+{
+}
+
+void Presolver::presolve( const Model& aModel )
+{
+	m_pImpl->presolve( aModel );
+}
+
+const Model Presolver::getReducedModel() const
+{
+	return m_pImpl->getReducedModel();
+}
+
+const Matrix Presolver::postsolve( const Matrix& mxSolution ) const
+{
+	return m_pImpl->postsolve( mxSolution );
+}
+
+const Basis Presolver::postsolveBasis( const Basis& aBasis ) const
+{
+	return m_pImpl->postsolveBasis( aBasis );
+}
+
+size_t Presolver::getRemovedRowCount() const
+{
+	return m_pImpl->getRemovedRowCount();
+}
+
+size_t Presolver::getRemovedColCount() const
+{
+	return m_pImpl->getRemovedColCount();
+}
+
+}}}
@@ -0,0 +1,319 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/lppresolve.hxx"
+#include "numeric/lpdualsimplex.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/exception.hxx"
+#include "lptestutil.hxx"
+
+#include <vector>
+#include <cmath>
+#include <stdio.h>
+
+using namespace ::scsolver::numeric;
+using namespace ::scsolver::numeric::lp;
+using namespace ::scsolver::numeric::lp::test;
+using ::std::vector;
+
+namespace {
+
+/**
+ * Presolve the model, solve the reduced model if anything is left of it,
+ * and map the solution back.
+ */
+Matrix solveWithPresolve(const Model& model, Presolver& presolver)
+{
+    presolver.presolve(model);
+    Model reduced = presolver.getReducedModel();
+    Matrix sol(0, 0);
+    if (reduced.getDecisionVarSize() > 0)
+    {
+        DualSimplex algorithm;
+        algorithm.setModel(&reduced);
+        algorithm.solve();
+        sol = algorithm.getSolution();
+    }
+    return presolver.postsolve(sol);
+}
+
+bool presolveThrows(const Model& model)
+{
+    Presolver presolver;
+    try
+    {
+        presolver.presolve(model);
+    }
+    catch (const ModelInfeasible&)
+    {
+        return true;
+    }
+    return false;
+}
+
+void smallModels()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("small models\n");
+
+    {
+        // max 3x + 5y, x <= 4, 2y <= 12, 3x + 2y <= 18  ->  (2, 6).  The
+        // singleton rows become bounds.
+        Model model;
+        setCost(model, 3, 5, GOAL_MAXIMIZE);
+        model.setVarPositive(true);
+        addConstraint(model, 1, 0, LESS_EQUAL, 4);
+        addConstraint(model, 0, 2, LESS_EQUAL, 12);
+        addConstraint(model, 3, 2, LESS_EQUAL, 18);
+
+        Presolver presolver;
+        Matrix sol = solveWithPresolve(model, presolver);
+        sol.trans().print();
+        check(presolver.getRemovedRowCount() == 2, "singleton rows removed");
+        check(isNear(sol(0, 0), 2.0, 1e-8) && isNear(sol(1, 0), 6.0, 1e-8), "singleton rows");
+    }
+
+    {
+        // min 2x + 3y, x + y >= 4, x + 3y >= 6, 2x + 6y >= 9  ->  (3, 1).
+        // The last row is a looser copy of the second.
+        Model model;
+        setCost(model, 2, 3, GOAL_MINIMIZE);
+        model.setVarPositive(true);
+        addConstraint(model, 1, 1, GREATER_EQUAL, 4);
+        addConstraint(model, 1, 3, GREATER_EQUAL, 6);
+        addConstraint(model, 2, 6, GREATER_EQUAL, 9);
+
+        Presolver presolver;
+        Matrix sol = solveWithPresolve(model, presolver);
+        sol.trans().print();
+        check(presolver.getRemovedRowCount() == 1, "duplicate row removed");
+        check(isNear(sol(0, 0), 3.0, 1e-8) && isNear(sol(1, 0), 1.0, 1e-8), "duplicate rows");
+    }
+
+    {
+        // max x + y, x + y <= 0  ->  (0, 0).  The forcing row fixes both
+        // variables, and nothing is left to solve.
+        Model model;
+        setCost(model, 1, 1, GOAL_MAXIMIZE);
+        model.setVarPositive(true);
+        addConstraint(model, 1, 1, LESS_EQUAL, 0);
+
+        Presolver presolver;
+        Matrix sol = solveWithPresolve(model, presolver);
+        check(presolver.getReducedModel().getDecisionVarSize() == 0, "forcing row fixes all columns");
+        check(sol.rows() == 2 && sol(0, 0) == 0.0 && sol(1, 0) == 0.0, "forcing row");
+    }
+
+    {
+        // min x - y, y <= 3, x + y >= 2 with x fixed at 1  ->  (1, 3).
+        // Fixing x turns the second row into a bound, and y is then
+        // dominated.
+        Model model;
+        setCost(model, 1, -1, GOAL_MINIMIZE);
+        model.setVarPositive(true);
+        model.setVarBound(0, BOUND_LOWER, 1);
+        model.setVarBound(0, BOUND_UPPER, 1);
+        addConstraint(model, 0, 1, LESS_EQUAL, 3);
+        addConstraint(model, 1, 1, GREATER_EQUAL, 2);
+
+        Presolver presolver;
+        Matrix sol = solveWithPresolve(model, presolver);
+        sol.trans().print();
+        check(isNear(sol(0, 0), 1.0, 1e-8) && isNear(sol(1, 0), 3.0, 1e-8), "fixed and dominated columns");
+    }
+
+    {
+        // min 2x + y, x + y = 5, y + s = 4  ->  (1, 4, 0).  s is a slack
+        // column singleton, and x becomes an implied free column singleton
+        // once y <= 4 is known.
+        Model model;
+        vector<double> cost(3);
+        cost[0] = 2;
+        cost[1] = 1;
+        model.setCostVector(cost);
+        model.setGoal(GOAL_MINIMIZE);
+        model.setVarPositive(true);
+        vector<double> row(3);
+        row[0] = 1;
+        row[1] = 1;
+        model.addConstraint(row, EQUAL, 5);
+        row[0] = 0;
+        row[2] = 1;
+        model.addConstraint(row, EQUAL, 4);
+
+        Presolver presolver;
+        Matrix sol = solveWithPresolve(model, presolver);
+        sol.trans().print();
+        check(presolver.getReducedModel().getDecisionVarSize() == 0, "column singletons removed");
+        check(isNear(sol(0, 0), 1.0, 1e-8) && isNear(sol(1, 0), 4.0, 1e-8) && isNear(sol(2, 0), 0.0, 1e-8),
+              "column singletons");
+    }
+
+    {
+        Model model;
+        setCost(model, 1, 1, GOAL_MINIMIZE);
+        model.setVarPositive(true);
+        addConstraint(model, 1, 0, GREATER_EQUAL, 5);
+        addConstraint(model, 1, 0, LESS_EQUAL, 3);
+        check(presolveThrows(model), "conflicting bounds rejected");
+    }
+
+    {
+        Model model;
+        setCost(model, 1, 1, GOAL_MINIMIZE);
+        model.setVarPositive(true);
+        addConstraint(model, 1, 1, LESS_EQUAL, -1);
+        check(presolveThrows(model), "infeasible row rejected");
+    }
+
+    {
+        Model model;
+        setCost(model, 1, 0, GOAL_MAXIMIZE);
+        model.setVarPositive(true);
+        addConstraint(model, 0, 1, LESS_EQUAL, 1);
+        check(presolveThrows(model), "unbounded column rejected");
+    }
+}
+
+/**
+ * max c x, A x <= b, x >= 0, padded with the kind of redundancy that a
+ * spreadsheet model typically has: unused variables, variables pinned to a
+ * value, single cell limits, repeated constraints, a forcing constraint,
+ * and helper cells that only appear in one constraint.
+ */
+void buildRedundantModel(Model& model, size_t nRows, size_t nCols, unsigned long seed)
+{
+    size_t nEmpty = nCols/8, nSlack = nRows/3;
+    size_t nTotalCols = nCols + nEmpty + nSlack;
+
+    vector<double> cost(nTotalCols, 0.0);
+    for (size_t j = 0; j < nCols; ++j)
+        cost[j] = 1.0 + nextValue(seed);
+    for (size_t j = nCols; j < nCols + nEmpty; ++j)
+        cost[j] = -nextValue(seed);
+    model.setCostVector(cost);
+    model.setGoal(GOAL_MAXIMIZE);
+    model.setVarPositive(true);
+
+    vector< vector<double> > rows;
+    vector<double> rhs;
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        vector<double> row(nTotalCols, 0.0);
+        for (size_t j = 0; j < nCols; ++j)
+            row[j] = nextValue(seed) < 0.3 ? 1.0 + 9.0*nextValue(seed) : 0.0;
+        if (i < nSlack)
+            row[nCols + nEmpty + i] = 1.0;
+        rows.push_back(row);
+        rhs.push_back(10.0 + 90.0*nextValue(seed));
+    }
+
+    for (size_t i = 0; i < nRows; ++i)
+        model.addConstraint(rows[i], LESS_EQUAL, rhs[i]);
+
+    // Repeated constraints, scaled.
+    for (size_t i = nSlack; i < nRows; i += 2)
+    {
+        vector<double> row(rows[i]);
+        for (size_t j = 0; j < nTotalCols; ++j)
+            row[j] *= 2.0;
+        model.addConstraint(row, LESS_EQUAL, rhs[i]*(i % 4 ? 1.5 : 2.5));
+    }
+
+    // Single cell limits.
+    for (size_t j = 0; j < nCols; j += 4)
+    {
+        vector<double> row(nTotalCols, 0.0);
+        row[j] = 1.0;
+        model.addConstraint(row, LESS_EQUAL, 2.0 + 3.0*nextValue(seed));
+    }
+
+    // Pinned variables.
+    for (size_t j = 1; j < nCols; j += 7)
+    {
+        model.setVarBound(j, BOUND_LOWER, 0.5);
+        model.setVarBound(j, BOUND_UPPER, 0.5);
+    }
+
+    // A forcing constraint.
+    vector<double> row(nTotalCols, 0.0);
+    for (size_t j = 2; j < nCols; j += 9)
+        if (j % 7 != 1)
+            row[j] = 1.0;
+    model.addConstraint(row, LESS_EQUAL, 0.0);
+}
+
+void redundantModel()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("redundant model\n");
+
+    Model model;
+    buildRedundantModel(model, 24, 64, 42);
+    size_t nRowCount = model.getConstraintCount(), nColCount = model.getDecisionVarSize();
+
+    DualSimplex reference;
+    reference.setModel(&model);
+    reference.solve();
+    Matrix refSol = reference.getSolution();
+    double fRefObj = getObjective(model, refSol);
+    check(isFeasible(model, refSol, 1e-8), "reference solution feasible");
+
+    Presolver presolver;
+    Matrix sol = solveWithPresolve(model, presolver);
+    Model reduced = presolver.getReducedModel();
+    size_t nRemoved = presolver.getRemovedRowCount() + presolver.getRemovedColCount();
+    printf("rows: %lu -> %lu, columns: %lu -> %lu\n",
+           static_cast<unsigned long>(nRowCount), static_cast<unsigned long>(reduced.getConstraintCount()),
+           static_cast<unsigned long>(nColCount), static_cast<unsigned long>(reduced.getDecisionVarSize()));
+    printf("objective: %.10g (reference: %.10g)\n", getObjective(model, sol), fRefObj);
+    check(sol.rows() == nColCount, "solution size");
+    check(isFeasible(model, sol, 1e-8), "postsolved solution feasible");
+    check(isNear(getObjective(model, sol), fRefObj, 1e-8), "same optimum");
+    check(nRemoved*10 >= (nRowCount + nColCount)*3, "at least 30% of the model removed");
+
+    // The basis of the reduced model, mapped back, starts a solve of the
+    // original model.
+    DualSimplex algorithm;
+    algorithm.setModel(&reduced);
+    algorithm.solve();
+    Basis basis = presolver.postsolveBasis(algorithm.getBasis());
+    check(basis.getVarCount() == nColCount && basis.getRowCount() == nRowCount, "basis size");
+    check(presolver.postsolveBasis(Basis(nColCount, nRowCount)).empty(), "mismatching basis rejected");
+
+    DualSimplex warm;
+    warm.setModel(&model);
+    warm.setStartBasis(basis);
+    warm.solve();
+    printf("warm start: objective = %.10g, %lu iterations (cold: %lu)\n",
+           getObjective(model, warm.getSolution()),
+           static_cast<unsigned long>(warm.getIterationCount()),
+           static_cast<unsigned long>(reference.getIterationCount()));
+    check(isNear(getObjective(model, warm.getSolution()), fRefObj, 1e-8), "same optimum from the mapped basis");
+    check(warm.getIterationCount() < reference.getIterationCount(), "fewer pivots from the mapped basis");
+}
+
+}
+
+int main()
+{
+    printf("unit test: presolve\n");
+    smallModels();
+    redundantModel();
+    printf("Unit test passed!\n");
+}
@@ -0,0 +1,358 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/lpscaling.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+
+#include <vector>
+#include <cmath>
+#include <iostream>
+
+using ::std::vector;
+using ::std::cout;
+using ::std::endl;
+
+namespace scsolver { namespace numeric { namespace lp {
+
+namespace {
+
+/** maximum number of geometric mean passes. */
+const size_t MAX_GEOMETRIC_PASS = 20;
+
+/** geometric scaling stops when a pass reduces the ratio by less. */
+const double MIN_IMPROVEMENT = 0.9;
+
+/**
+ * Round a positive factor to the nearest power of two.
+ */
+double roundToPowerOfTwo( double fVal )
+{
+	return ::std::pow( 2.0, ::std::floor( ::std::log( fVal )/::std::log( 2.0 ) + 0.5 ) );
+}
+
+}
+
+//---------------------------------------------------------------------------
+// ScalerImpl
+
+class ScalerImpl
+{
+public:
+	ScalerImpl();
+	~ScalerImpl() throw();
+
+	void scale( const Model& aModel );
+	const Model getScaledModel() const;
+	const Matrix unscale( const Matrix& mxSolution ) const;
+
+	double getRowScale( size_t nRow ) const { return m_aRowScale.at( nRow ); }
+	double getColScale( size_t nCol ) const { return m_aColScale.at( nCol ); }
+
+private:
+	::std::auto_ptr<Model> m_pModel;
+	Matrix m_mxA;
+	vector<double> m_aRowScale;
+	vector<double> m_aColScale;
+
+	double getScaled( size_t i, size_t j ) const;
+	double getRatio() const;
+	void scaleGeometric( bool bScaleCols );
+	void equilibrate( bool bScaleCols );
+};
+
+ScalerImpl::ScalerImpl() : m_mxA( 0, 0 )
+{
+}
+
+ScalerImpl::~ScalerImpl() throw()
+{
+}
+
+double ScalerImpl::getScaled( size_t i, size_t j ) const
+{
+	return ::std::fabs( m_aRowScale[i]*m_mxA( i, j )*m_aColScale[j] );
+}
+
+/**
+ * @return double ratio between the largest and the smallest non-zero
+ *         entry of the scaled matrix.
+ */
+double ScalerImpl::getRatio() const
+{
+	double fMin = 0.0, fMax = 0.0;
+	for ( size_t i = 0; i < m_mxA.rows(); ++i )
+		for ( size_t j = 0; j < m_mxA.cols(); ++j )
+		{
+			double fVal = getScaled( i, j );
+			if ( fVal == 0.0 )
+				continue;
+			if ( fMin == 0.0 || fVal < fMin )
+				fMin = fVal;
+			fMax = ::std::max( fMax, fVal );
+		}
+	return fMin == 0.0 ? 1.0 : fMax/fMin;
+}
+
+/**
+ * Divide each row, then each column, by the geometric mean of its largest
+ * and smallest entries.
+ */
+void ScalerImpl::scaleGeometric( bool bScaleCols )
+{
+	size_t nRowCount = m_mxA.rows(), nColCount = m_mxA.cols();
+	for ( size_t i = 0; i < nRowCount; ++i )
+	{
+		double fMin = 0.0, fMax = 0.0;
+		for ( size_t j = 0; j < nColCount; ++j )
+		{
+			double fVal = getScaled( i, j );
+			if ( fVal == 0.0 )
+				continue;
+			if ( fMin == 0.0 || fVal < fMin )
+				fMin = fVal;
+			fMax = ::std::max( fMax, fVal );
+		}
+		if ( fMax > 0.0 )
+			m_aRowScale[i] /= ::std::sqrt( fMin*fMax );
+	}
+
+	if ( !bScaleCols )
+		return;
+
+	for ( size_t j = 0; j < nColCount; ++j )
+	{
+		double fMin = 0.0, fMax = 0.0;
+		for ( size_t i = 0; i < nRowCount; ++i )
+		{
+			double fVal = getScaled( i, j );
+			if ( fVal == 0.0 )
+				continue;
+			if ( fMin == 0.0 || fVal < fMin )
+				fMin = fVal;
+			fMax = ::std::max( fMax, fVal );
+		}
+		if ( fMax > 0.0 )
+			m_aColScale[j] /= ::std::sqrt( fMin*fMax );
+	}
+}
+
+/**
+ * Divide each row, then each column, by its largest entry.
+ */
+void ScalerImpl::equilibrate( bool bScaleCols )
+{
+	size_t nRowCount = m_mxA.rows(), nColCount = m_mxA.cols();
+	for ( size_t i = 0; i < nRowCount; ++i )
+	{
+		double fMax = 0.0;
+		for ( size_t j = 0; j < nColCount; ++j )
+			fMax = ::std::max( fMax, getScaled( i, j ) );
+		if ( fMax > 0.0 )
+			m_aRowScale[i] /= fMax;
+	}
+
+	if ( !bScaleCols )
+		return;
+
+	for ( size_t j = 0; j < nColCount; ++j )
+	{
+		double fMax = 0.0;
+		for ( size_t i = 0; i < nRowCount; ++i )
+			fMax = ::std::max( fMax, getScaled( i, j ) );
+		if ( fMax > 0.0 )
+			m_aColScale[j] /= fMax;
+	}
+}
+
+void ScalerImpl::scale( const Model& aModel )
+{
+	::std::auto_ptr<Model> p( new Model( aModel ) );
+	m_pModel = p;
+
+	m_mxA = aModel.getConstraintMatrix();
+	size_t nColCount = ::std::max( m_mxA.cols(), aModel.getCostVector().cols() );
+	if ( m_mxA.cols() < nColCount )
+		m_mxA.resize( m_mxA.rows(), nColCount );
+
+	m_aRowScale.assign( m_mxA.rows(), 1.0 );
+	m_aColScale.assign( nColCount, 1.0 );
+
+	bool bScaleCols = !aModel.getVarInteger();
+	const double fInitRatio = getRatio();
+	double fRatio = fInitRatio;
+	for ( size_t nPass = 0; nPass < MAX_GEOMETRIC_PASS; ++nPass )
+	{
+		vector<double> aRowScale( m_aRowScale ), aColScale( m_aColScale );
+		scaleGeometric( bScaleCols );
+		double fNewRatio = getRatio();
+		if ( fNewRatio > fRatio )
+		{
+			// Keep the previous factors when a pass makes it worse.
+			m_aRowScale.swap( aRowScale );
+			m_aColScale.swap( aColScale );
+			break;
+		}
+		bool bDone = fNewRatio > MIN_IMPROVEMENT*fRatio;
+		fRatio = fNewRatio;
+		if ( bDone )
+			break;
+	}
+	equilibrate( bScaleCols );
+
+	for ( size_t i = 0; i < m_aRowScale.size(); ++i )
+		m_aRowScale[i] = roundToPowerOfTwo( m_aRowScale[i] );
+	for ( size_t j = 0; j < m_aColScale.size(); ++j )
+		m_aColScale[j] = roundToPowerOfTwo( m_aColScale[j] );
+
+	if ( aModel.getVerbose() )
+		cout << "scaling: coefficient ratio " << fInitRatio << " -> " << getRatio() << endl;
+}
+
+const Model ScalerImpl::getScaledModel() const
+{
+	Model aModel;
+	aModel.setGoal( m_pModel->getGoal() );
+	aModel.setSolveToValue( m_pModel->getSolveToValue() );
+	aModel.setPrecision( m_pModel->getPrecision() );
+	aModel.setVarPositive( m_pModel->getVarPositive() );
+	aModel.setVarInteger( m_pModel->getVarInteger() );
+	aModel.setVerbose( m_pModel->getVerbose() );
+
+	size_t nColCount = m_aColScale.size();
+	Matrix mxC = m_pModel->getCostVector();
+	vector<double> aCost( nColCount, 0.0 );
+	for ( size_t j = 0; j < mxC.cols(); ++j )
+		aCost[j] = mxC( 0, j )*m_aColScale[j];
+	aModel.setCostVector( aCost );
+
+	// x = s x', so a bound l <= x turns into l/s <= x'.
+	for ( size_t j = 0; j < nColCount; ++j )
+	{
+		if ( m_pModel->isVarBounded( j, BOUND_LOWER ) )
+			aModel.setVarBound( j, BOUND_LOWER, m_pModel->getVarBound( j, BOUND_LOWER )/m_aColScale[j] );
+		if ( m_pModel->isVarBounded( j, BOUND_UPPER ) )
+			aModel.setVarBound( j, BOUND_UPPER, m_pModel->getVarBound( j, BOUND_UPPER )/m_aColScale[j] );
+	}
+
+	for ( size_t i = 0; i < m_mxA.rows(); ++i )
+	{
+		vector<double> aRow( nColCount );
+		for ( size_t j = 0; j < nColCount; ++j )
+			aRow[j] = m_aRowScale[i]*m_mxA( i, j )*m_aColScale[j];
+		aModel.addConstraint( aRow, m_pModel->getEquality( i ),
+							  m_aRowScale[i]*m_pModel->getRhsValue( i ) );
+	}
+
+	return aModel;
+}
+
+const Matrix ScalerImpl::unscale( const Matrix& mxSolution ) const
+{
+	// Any entries beyond the decision variables are left as they are.
+	Matrix mxX( mxSolution.rows(), 1 );
+	for ( size_t j = 0; j < mxSolution.rows(); ++j )
+		mxX( j, 0 ) = j < m_aColScale.size() ? mxSolution( j, 0 )*m_aColScale[j] : mxSolution( j, 0 );
+	return mxX;
+}
+
+//---------------------------------------------------------------------------
+// Scaler
+
+Scaler::Scaler() : m_pImpl( new ScalerImpl )
+{
+}
+
+Scaler::~Scaler() throw()
+{
+}
+
+void Scaler::scale( const Model& aModel )
+{
+	m_pImpl->scale( aModel );
+}
+
+const Model Scaler::getScaledModel() const
+{
+	return m_pImpl->getScaledModel();
+}
+
+const Matrix Scaler::unscale( const Matrix& mxSolution ) const
+{
+	return m_pImpl->unscale( mxSolution );
+}
+
+double Scaler::getRowScale( size_t nRow ) const
+{
+	return m_pImpl->getRowScale( nRow );
+}
+
+double Scaler::getColScale( size_t nCol ) const
+{
+	return m_pImpl->getColScale( nCol );
+}
+
+//---------------------------------------------------------------------------
+// ScaledAlgorithm
+
+ScaledAlgorithm::ScaledAlgorithm( ::std::auto_ptr<BaseAlgorithm> pAlgorithm ) :
+	BaseAlgorithm(), m_pAlgorithm( pAlgorithm )
+{
+}
+
+ScaledAlgorithm::~ScaledAlgorithm() throw()
+{
+}
+
+void ScaledAlgorithm::solve()
+{
+	Scaler aScaler;
+	aScaler.scale( *getModel() );
+	Model aScaledModel( aScaler.getScaledModel() );
+
+	m_pAlgorithm->setModel( &aScaledModel );
+	m_pAlgorithm->setStartBasis( getStartBasis() );
+	m_pAlgorithm->setSolveControl( getSolveControl() );
+	try
+	{
+		m_pAlgorithm->solve();
+	}
+	catch ( ... )
+	{
+		// The scaled model is about to go out of scope.
+		m_pAlgorithm->setModel( NULL );
+		m_pAlgorithm->setSolveControl( NULL );
+		throw;
+	}
+	m_pAlgorithm->setModel( NULL );
+	m_pAlgorithm->setSolveControl( NULL );
+
+	setSolution( aScaler.unscale( m_pAlgorithm->getSolution() ) );
+	setBasis( m_pAlgorithm->getBasis() );
+}
+
+bool ScaledAlgorithm::isOptimal() const
+{
+	return m_pAlgorithm->isOptimal();
+}
+
+BaseAlgorithm* ScaledAlgorithm::getAlgorithm() const
+{
+	return m_pAlgorithm.get();
+}
+
+}}}
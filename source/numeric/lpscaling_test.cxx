@@ -0,0 +1,206 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/lpscaling.hxx"
+#include "numeric/lpdualsimplex.hxx"
+#include "numeric/lpsimplex.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/exception.hxx"
+#include "lptestutil.hxx"
+
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <stdio.h>
+
+using namespace ::scsolver::numeric;
+using namespace ::scsolver::numeric::lp;
+using namespace ::scsolver::numeric::lp::test;
+using ::std::vector;
+using ::std::auto_ptr;
+
+namespace {
+
+double getRatio(const Matrix& A)
+{
+    double fMin = 0.0, fMax = 0.0;
+    for (size_t i = 0; i < A.rows(); ++i)
+        for (size_t j = 0; j < A.cols(); ++j)
+        {
+            double fVal = ::std::fabs(A(i, j));
+            if (fVal == 0.0)
+                continue;
+            if (fMin == 0.0 || fVal < fMin)
+                fMin = fVal;
+            if (fVal > fMax)
+                fMax = fVal;
+        }
+    return fMax/fMin;
+}
+
+bool isPowerOfTwo(double fVal)
+{
+    int nExp;
+    return ::std::frexp(fVal, &nExp) == 0.5;
+}
+
+/**
+ * max c x, A x <= b, x >= 0, where the columns are in units that differ by
+ * up to six orders of magnitude, and so are the rows.
+ */
+void buildBadlyScaledModel(Model& model, size_t nRows, size_t nCols, unsigned long seed)
+{
+    const double units[] = { 1.0, 1000.0, 0.001, 100.0, 0.01 };
+    vector<double> cost(nCols);
+    for (size_t j = 0; j < nCols; ++j)
+        cost[j] = (1.0 + nextValue(seed))*units[j % 5];
+    model.setCostVector(cost);
+    model.setGoal(GOAL_MAXIMIZE);
+    model.setVarPositive(true);
+
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        double fRowUnit = units[(i*3) % 5];
+        vector<double> row(nCols);
+        for (size_t j = 0; j < nCols; ++j)
+            row[j] = nextValue(seed) < 0.3 ? (1.0 + 9.0*nextValue(seed))*units[j % 5]*fRowUnit : 0.0;
+        model.addConstraint(row, LESS_EQUAL, (10.0 + 90.0*nextValue(seed))*fRowUnit);
+    }
+}
+
+void scaleFactors()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("scale factors\n");
+
+    Model model;
+    buildBadlyScaledModel(model, 15, 60, 42);
+
+    Scaler scaler;
+    scaler.scale(model);
+    Model scaled = scaler.getScaledModel();
+    double fRatio = getRatio(model.getConstraintMatrix());
+    double fScaledRatio = getRatio(scaled.getConstraintMatrix());
+    printf("coefficient ratio: %g -> %g\n", fRatio, fScaledRatio);
+    check(fScaledRatio*1000.0 < fRatio, "coefficient range reduced");
+
+    bool bPowerOfTwo = true;
+    for (size_t i = 0; i < 15; ++i)
+        bPowerOfTwo = bPowerOfTwo && isPowerOfTwo(scaler.getRowScale(i));
+    for (size_t j = 0; j < 60; ++j)
+        bPowerOfTwo = bPowerOfTwo && isPowerOfTwo(scaler.getColScale(j));
+    check(bPowerOfTwo, "factors are powers of two");
+
+    // Integer variables keep their scale.
+    model.setVarInteger(true);
+    scaler.scale(model);
+    bool bUnscaled = true;
+    for (size_t j = 0; j < 60; ++j)
+        bUnscaled = bUnscaled && scaler.getColScale(j) == 1.0;
+    check(bUnscaled, "integer columns not scaled");
+}
+
+void scaledAlgorithm()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("scaled algorithm\n");
+
+    Model model;
+    buildBadlyScaledModel(model, 15, 60, 7);
+
+    DualSimplex reference;
+    reference.setModel(&model);
+    reference.solve();
+    double fRefObj = getObjective(model, reference.getSolution());
+
+    auto_ptr<BaseAlgorithm> p(new DualSimplex);
+    ScaledAlgorithm algorithm(p);
+    algorithm.setModel(&model);
+    algorithm.solve();
+    Matrix sol = algorithm.getSolution();
+    DualSimplex* pDual = static_cast<DualSimplex*>(algorithm.getAlgorithm());
+    printf("dual simplex: objective = %.10g, %lu iterations (unscaled: %.10g, %lu iterations)\n",
+           getObjective(model, sol), static_cast<unsigned long>(pDual->getIterationCount()),
+           fRefObj, static_cast<unsigned long>(reference.getIterationCount()));
+    check(sol.rows() == 60 && isFeasible(model, sol), "feasible solution");
+    check(isNear(getObjective(model, sol), fRefObj, 1e-8), "same optimum as unscaled");
+
+    // The basis of the scaled model is a basis of the original model.
+    algorithm.setStartBasis(algorithm.getBasis());
+    algorithm.solve();
+    check(pDual->getIterationCount() == 0, "no pivot from the optimal basis");
+
+    auto_ptr<BaseAlgorithm> pRevised(new RevisedSimplex);
+    ScaledAlgorithm revised(pRevised);
+    revised.setModel(&model);
+    revised.solve();
+    sol = revised.getSolution();
+    check(isFeasible(model, sol), "revised simplex feasible solution");
+    check(isNear(getObjective(model, sol), fRefObj, 1e-8), "revised simplex same optimum");
+
+    // Variable bounds are scaled along with the variables.
+    Model bounded;
+    vector<double> cost(2);
+    cost[0] = 3000;
+    cost[1] = 0.005;
+    bounded.setCostVector(cost);
+    bounded.setGoal(GOAL_MAXIMIZE);
+    bounded.setVarPositive(true);
+    bounded.setVarBound(0, BOUND_UPPER, 0.004);
+    bounded.setVarBound(1, BOUND_UPPER, 6000);
+    vector<double> row(2);
+    row[0] = 3000;
+    row[1] = 0.002;
+    bounded.addConstraint(row, LESS_EQUAL, 18);
+    row[0] = 1000;
+    row[1] = 0.001;
+    bounded.addConstraint(row, LESS_EQUAL, 7);
+
+    auto_ptr<BaseAlgorithm> pBounded(new DualSimplex);
+    ScaledAlgorithm boundedAlgorithm(pBounded);
+    boundedAlgorithm.setModel(&bounded);
+    boundedAlgorithm.solve();
+    sol = boundedAlgorithm.getSolution();
+    sol.trans().print();
+    check(isNear(sol(0, 0), 0.001, 1e-8) && isNear(sol(1, 0), 6000.0, 1e-8), "bounded optimum");
+
+    // An infeasible model leaves no pointer to the scaled copy behind.
+    row[0] = 1000;
+    row[1] = 0.001;
+    bounded.addConstraint(row, GREATER_EQUAL, 20);
+    bool bThrown = false;
+    try
+    {
+        boundedAlgorithm.solve();
+    }
+    catch (const ModelInfeasible&)
+    {
+        bThrown = true;
+    }
+    check(bThrown && boundedAlgorithm.getAlgorithm()->getModel() == NULL, "scaled model released");
+}
+
+}
+
+int main()
+{
+    printf("unit test: scaling\n");
+    scaleFactors();
+    scaledAlgorithm();
+    printf("Unit test passed!\n");
+}
@@ -15,10 +15,11 @@
  * <http://www.gnu.org/licenses/>.
  ****************************************************************************/
 
-#include <osl/diagnose.h>
-
 #include "numeric/lpsimplex.hxx"
 #include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/exception.hxx"
+#include "numeric/solvecontrol.hxx"
 #include "tool/global.hxx"
 
 #include <memory>
@@ -28,18 +29,57 @@
 #include <vector>
 #include <map>
 #include <list>
+#include <cmath>
 
 using ::std::vector;
 using ::std::string;
 using ::std::cout;
 using ::std::endl;
-	
+using ::std::auto_ptr;
+
 namespace scsolver { namespace numeric { namespace lp {
 
 typedef vector<size_t>				uInt32Container;
 typedef uInt32Container::iterator		uInt32Iter;
 typedef uInt32Container::const_iterator	uInt32CIter;
 
+/** marks a variable that is not in the non-basic list. */
+static const size_t NOT_NONBASIC = static_cast<size_t>(-1);
+
+/** marks a missing row or column. */
+static const size_t NO_INDEX = static_cast<size_t>(-1);
+
+/** the crash only pivots on entries at least this large relative to the
+	largest entry of the column. */
+static const double CRASH_PIVOT_TOL = 0.1;
+
+/** step direction entries smaller than this in magnitude do not block the
+	ratio test. */
+static const double PIVOT_TOL = 1e-9;
+
+/** default primal and dual feasibility tolerance. */
+static const double DEFAULT_FEASIBILITY_TOL = 1e-9;
+
+/** number of consecutive degenerate iterations after which the basic
+	variables are perturbed. */
+static const size_t PERTURB_AFTER = 5;
+
+/** magnitude of the perturbation relative to the value it is applied to. */
+static const double PERTURB_SCALE = 1e-6;
+
+/**
+ * Draw the next perturbation from a linear congruential sequence, so that
+ * every solve of the same model follows the same path.
+ *
+ * @return double value in [0.5, 1) times PERTURB_SCALE (1 + |fVal|)
+ */
+static double lcl_nextPerturbation( unsigned long& rSeed, double fVal )
+{
+	rSeed = ( rSeed*1103515245UL + 12345UL ) & 0x7fffffffUL;
+	double fRandom = static_cast<double>( rSeed )/0x7fffffff;
+	return PERTURB_SCALE*( 1.0 + ::std::fabs( fVal ) )*( 0.5 + 0.5*fRandom );
+}
+
 typedef vector<BoundType>					BoundContainer;
 typedef BoundContainer::iterator		BoundIter;
 typedef BoundContainer::const_iterator	BoundCIter;
@@ -52,6 +92,228 @@ class IllegalTwoPhaseSearch : public ::std::exception
 	}
 };
 
+//---------------------------------------------------------------------------
+// PricingWeights
+
+/**
+ * Edge weights of the non-basic variables for Devex and steepest edge
+ * pricing.  An attractive column j is ranked by d_j^2 / w_j, where d_j is
+ * its reduced cost and w_j is either the squared norm of its edge direction
+ * 1 + ||B^-1 A_j||^2 (steepest edge) or an approximation of that norm
+ * restricted to a reference framework of variables (Devex).  Weights are
+ * indexed by variable ID, and updated at each basis change instead of being
+ * recomputed.  With any other pricing strategy all weights are 1 and the
+ * ranking is by the raw reduced cost.
+ */
+class PricingWeights
+{
+public:
+	PricingWeights();
+
+	/**
+	 * Initialize the weights for the current basis.  For steepest edge this
+	 * computes the exact norms; for Devex the non-basic variables become the
+	 * reference framework.
+	 */
+	template<typename BasicCont, typename NonBasicCont>
+	void reset( PricingType eType, const Matrix& mxA, const Matrix& mxBasicInv,
+				const BasicCont& aBasicVarId, const NonBasicCont& aNonBasicVarId );
+
+	/**
+	 * Update the weights for a pivot in which nEnterVarId replaces
+	 * nLeaveVarId in the basis.  This must be called before the basic
+	 * inverse and the variable lists are updated.  Nothing is done when the
+	 * leaving variable is not basic (i.e. a bound flip).
+	 */
+	template<typename BasicCont, typename NonBasicCont>
+	void update( size_t nEnterVarId, size_t nLeaveVarId, const Matrix& mxA,
+				 const Matrix& mxBasicInv, const BasicCont& aBasicVarId,
+				 const NonBasicCont& aNonBasicVarId );
+
+	/**
+	 * @param fScore positive improvement score of a variable, typically the
+	 *               absolute value of its reduced cost
+	 * @return double merit of the variable; the larger the better.
+	 */
+	double getMerit( double fScore, size_t nId ) const
+	{
+		return m_bActive ? fScore*fScore/m_aWeights[nId] : fScore;
+	}
+
+private:
+	template<typename BasicCont>
+	void resetReference( const BasicCont& aBasicVarId, size_t nEnterVarId, size_t nLeaveVarId );
+
+	static void getColumn( const Matrix& mxA, const Matrix& mxBasicInv, size_t nId, vector<double>& rAlpha );
+
+	PricingType m_eType;
+	bool m_bActive;
+	vector<double> m_aWeights;
+
+	/** Devex reference framework. */
+	vector<bool> m_aReference;
+};
+
+PricingWeights::PricingWeights() :
+	m_eType( PRICING_DANTZIG ), m_bActive( false )
+{
+}
+
+/**
+ * Calculate alpha = B^-1 A_j.
+ */
+void PricingWeights::getColumn( const Matrix& mxA, const Matrix& mxBasicInv, size_t nId, vector<double>& rAlpha )
+{
+	size_t nRows = mxBasicInv.rows();
+	rAlpha.assign( nRows, 0.0 );
+	for ( size_t k = 0; k < nRows; ++k )
+	{
+		double fA = mxA( k, nId );
+		if ( fA == 0.0 )
+			continue;
+		for ( size_t i = 0; i < nRows; ++i )
+			rAlpha[i] += mxBasicInv( i, k )*fA;
+	}
+}
+
+template<typename BasicCont, typename NonBasicCont>
+void PricingWeights::reset( PricingType eType, const Matrix& mxA, const Matrix& mxBasicInv,
+							const BasicCont& aBasicVarId, const NonBasicCont& aNonBasicVarId )
+{
+	m_eType = eType;
+	m_bActive = eType == PRICING_DEVEX || eType == PRICING_STEEPEST_EDGE;
+	m_aWeights.assign( mxA.cols(), 1.0 );
+	m_aReference.clear();
+	if ( !m_bActive )
+		return;
+
+	if ( m_eType == PRICING_DEVEX )
+	{
+		m_aReference.assign( mxA.cols(), true );
+		typename BasicCont::const_iterator itr, itrEnd = aBasicVarId.end();
+		for ( itr = aBasicVarId.begin(); itr != itrEnd; ++itr )
+			m_aReference[*itr] = false;
+		return;
+	}
+
+	vector<double> aAlpha;
+	typename NonBasicCont::const_iterator itr, itrEnd = aNonBasicVarId.end();
+	for ( itr = aNonBasicVarId.begin(); itr != itrEnd; ++itr )
+	{
+		getColumn( mxA, mxBasicInv, *itr, aAlpha );
+		double fWeight = 1.0;
+		for ( size_t i = 0; i < aAlpha.size(); ++i )
+			fWeight += aAlpha[i]*aAlpha[i];
+		m_aWeights[*itr] = fWeight;
+	}
+}
+
+/**
+ * Start a new Devex reference framework made of the non-basic variables
+ * after the pivot, with all weights reset to 1.
+ */
+template<typename BasicCont>
+void PricingWeights::resetReference( const BasicCont& aBasicVarId, size_t nEnterVarId, size_t nLeaveVarId )
+{
+	m_aWeights.assign( m_aWeights.size(), 1.0 );
+	m_aReference.assign( m_aReference.size(), true );
+	typename BasicCont::const_iterator itr, itrEnd = aBasicVarId.end();
+	for ( itr = aBasicVarId.begin(); itr != itrEnd; ++itr )
+		m_aReference[*itr] = false;
+	m_aReference[nLeaveVarId] = true;
+	m_aReference[nEnterVarId] = false;
+}
+
+template<typename BasicCont, typename NonBasicCont>
+void PricingWeights::update( size_t nEnterVarId, size_t nLeaveVarId, const Matrix& mxA,
+							 const Matrix& mxBasicInv, const BasicCont& aBasicVarId,
+							 const NonBasicCont& aNonBasicVarId )
+{
+	if ( !m_bActive )
+		return;
+
+	typename BasicCont::const_iterator itrB = aBasicVarId.begin(), itrBEnd = aBasicVarId.end();
+	size_t nLeaveRow = 0;
+	for ( ; itrB != itrBEnd && *itrB != nLeaveVarId; ++itrB )
+		++nLeaveRow;
+	if ( itrB == itrBEnd )
+		return;
+
+	size_t nRows = mxBasicInv.rows();
+	vector<double> aAlpha;
+	getColumn( mxA, mxBasicInv, nEnterVarId, aAlpha );
+	double fPivot = aAlpha[nLeaveRow];
+	if ( fPivot == 0.0 )
+		return;
+
+	double fEnterWeight = m_aWeights[nEnterVarId];
+	bool bResetReference = false;
+	vector<double> aW;
+	if ( m_eType == PRICING_STEEPEST_EDGE )
+	{
+		// Use the exact norm of the entering column, and w = B^-T alpha.
+		fEnterWeight = 1.0;
+		for ( size_t i = 0; i < nRows; ++i )
+			fEnterWeight += aAlpha[i]*aAlpha[i];
+
+		aW.assign( nRows, 0.0 );
+		for ( size_t i = 0; i < nRows; ++i )
+		{
+			if ( aAlpha[i] == 0.0 )
+				continue;
+			for ( size_t k = 0; k < nRows; ++k )
+				aW[k] += mxBasicInv( i, k )*aAlpha[i];
+		}
+	}
+	else
+	{
+		// The Devex weight of the entering column may be compared with its
+		// exact value in the reference framework.  Reset the framework when
+		// the two differ too much.
+		double fExact = m_aReference[nEnterVarId] ? 1.0 : 0.0;
+		size_t i = 0;
+		for ( itrB = aBasicVarId.begin(); itrB != itrBEnd; ++itrB, ++i )
+			if ( m_aReference[*itrB] )
+				fExact += aAlpha[i]*aAlpha[i];
+		if ( fEnterWeight > 3.0*fExact )
+			bResetReference = true;
+		fEnterWeight = ::std::max( fEnterWeight, fExact );
+	}
+
+	typename NonBasicCont::const_iterator itr, itrEnd = aNonBasicVarId.end();
+	for ( itr = aNonBasicVarId.begin(); itr != itrEnd; ++itr )
+	{
+		size_t nId = *itr;
+		if ( nId == nEnterVarId )
+			continue;
+
+		// alpha_rj: element of B^-1 A_j in the pivot row.
+		double fRowVal = 0.0;
+		for ( size_t k = 0; k < nRows; ++k )
+			fRowVal += mxBasicInv( nLeaveRow, k )*mxA( k, nId );
+		if ( fRowVal == 0.0 )
+			continue;
+
+		double fRatio = fRowVal/fPivot;
+		double& rWeight = m_aWeights[nId];
+		if ( m_eType == PRICING_STEEPEST_EDGE )
+		{
+			double fDot = 0.0;
+			for ( size_t k = 0; k < nRows; ++k )
+				fDot += mxA( k, nId )*aW[k];
+			rWeight = ::std::max( rWeight - 2.0*fRatio*fDot + fRatio*fRatio*fEnterWeight,
+								  1.0 + fRatio*fRatio );
+		}
+		else
+			rWeight = ::std::max( rWeight, fRatio*fRatio*fEnterWeight );
+	}
+
+	m_aWeights[nLeaveVarId] = ::std::max( fEnterWeight/(fPivot*fPivot), 1.0 );
+
+	if ( bResetReference )
+		resetReference( aBasicVarId, nEnterVarId, nLeaveVarId );
+}
+
 //---------------------------------------------------------------------------
 // RevisedSimplexImpl
 
@@ -65,22 +327,80 @@ public:
 	void setEnableTwoPhaseSearch( bool b ) { m_bTwoPhaseAllowed = b; }
 	bool isTwoPhaseSearchEnabled() { return m_bTwoPhaseAllowed; }
 
+	void setPricing( PricingType e ) { m_ePricing = e; }
+	PricingType getPricing() const { return m_ePricing; }
+	void setPricingBlockSize( size_t n ) { m_nPricingBlockSize = n; }
+	size_t getPricingBlockSize() const { return m_nPricingBlockSize; }
+	void setCrash( bool b ) { m_bCrash = b; }
+	bool getCrash() const { return m_bCrash; }
+	void setPrimalTolerance( double f ) { m_fPrimalTol = f; }
+	double getPrimalTolerance() const { return m_fPrimalTol; }
+	void setDualTolerance( double f ) { m_fDualTol = f; }
+	double getDualTolerance() const { return m_fDualTol; }
+	void setPerturbation( bool b ) { m_bPerturbation = b; }
+	bool getPerturbation() const { return m_bPerturbation; }
+	size_t getIterationCount() const { return m_nIter; }
+	size_t getPhaseOneIterationCount() const { return m_nPhaseOneIter; }
+
 private:
 	RevisedSimplex* m_pSelf;
 
 	bool m_bTwoPhaseAllowed;	// is two-phase initial search allowed ?
+	bool m_bCrash;
+
+	double m_fPrimalTol;
+	double m_fDualTol;
+	bool m_bPerturbation;
+
+	/** whether the basic variables may still be perturbed in this solve. */
+	bool m_bPerturbAllowed;
+
+	/** whether the basic variables are currently perturbed. */
+	bool m_bPerturbed;
+
+	/** number of consecutive degenerate iterations. */
+	size_t m_nDegenerateIter;
+	unsigned long m_nPerturbSeed;
+
+	PricingType m_ePricing;
+	size_t m_nPricingBlockSize;
+
+	/** position in the non-basic list where the next partial pricing pass
+		starts. */
+	size_t m_nPricingStart;
+
+	/** candidate list for multiple pricing. */
+	std::vector<size_t> m_aPricingCandidates;
+
+	/** edge weights for Devex and steepest edge pricing. */
+	PricingWeights m_aPricingWeights;
 
 	Matrix m_aBasicInv;
 	Matrix m_aUpdateMatrix;
 	Matrix m_aPriceVector;
 	Matrix m_aX;
 	size_t m_nIter;
+	size_t m_nPhaseOneIter;
 
 	Model m_Model;
 	Matrix m_A, m_B, m_C;
 	std::vector<bool> m_aBasicVar;
 	std::vector<size_t> m_aBasicVarId;
 
+	/** non-basic variable IDs, updated in place at each pivot. */
+	std::vector<size_t> m_aNonBasicVarId;
+
+	/** position of each variable in m_aNonBasicVarId, or NOT_NONBASIC. */
+	std::vector<size_t> m_aNonBasicPos;
+
+	/** rows added by convertVarRange() for the lower and upper bound of each
+		decision variable, or NO_INDEX. */
+	std::vector<size_t> m_aLowerBoundRow;
+	std::vector<size_t> m_aUpperBoundRow;
+
+	/** slack column of each row, or NO_INDEX for an equality. */
+	std::vector<size_t> m_aSlackCol;
+
     /** permutation of variable indices */
 	std::list<size_t> m_cnPermVarIndex;
 
@@ -97,10 +417,25 @@ private:
 	Model* getModel() const { return m_pSelf->getModel(); }
 
 	void convertVarRange( Model& );
+	bool applyStartBasis( size_t nRowCount );
+	const Basis buildBasis( size_t nVarCount, size_t nRowCount ) const;
 	void runNormalInitSearch();
 	void runTwoPhaseInitSearch( const std::vector<size_t>& );
+	const Basis crashPhaseOneBasis( const Matrix&, const std::vector<size_t>& ) const;
 	void printIterateHeader() const;
 	bool iterate();
+	void pivot( size_t nEnterVarId, size_t nLeaveVarId, const Matrix& dX );
+	void perturb();
+	void removePerturbation();
+
+	void initNonBasicVars();
+	double getReducedCost( size_t nId ) const;
+	double getPriceScore( double fPrice ) const;
+	size_t getPricingSize() const;
+	bool priceFull( size_t& rEnterVarId );
+	bool pricePartial( size_t& rEnterVarId );
+	bool priceMultiple( size_t& rEnterVarId );
+	bool selectEnteringVar( size_t& rEnterVarId );
 
 	Matrix solvePriceVector( std::vector<size_t>, const Matrix&, const Matrix& );
 	void getLambda( const Matrix&, const Matrix&, double&, size_t& ) const;
@@ -108,9 +443,13 @@ private:
 
 
 RevisedSimplexImpl::RevisedSimplexImpl( RevisedSimplex* p ) : m_pSelf( p ),
-	m_bTwoPhaseAllowed( true ),
+	m_bTwoPhaseAllowed( true ), m_bCrash( true ),
+	m_fPrimalTol( DEFAULT_FEASIBILITY_TOL ), m_fDualTol( DEFAULT_FEASIBILITY_TOL ),
+	m_bPerturbation( true ), m_bPerturbAllowed( false ), m_bPerturbed( false ),
+	m_nDegenerateIter( 0 ), m_nPerturbSeed( 0 ),
+	m_ePricing( PRICING_DANTZIG ), m_nPricingBlockSize( 0 ), m_nPricingStart( 0 ),
 	m_aBasicInv( 0, 0 ), m_aUpdateMatrix( 0, 0 ), m_aPriceVector( 0, 0 ),
-	m_aX( 0, 0 ), m_nIter( 0 )
+	m_aX( 0, 0 ), m_nIter( 0 ), m_nPhaseOneIter( 0 )
 {
 }
 
@@ -129,13 +468,17 @@ RevisedSimplexImpl::~RevisedSimplexImpl()
 void RevisedSimplexImpl::convertVarRange( Model& aModel )
 {
 	size_t nColSize = aModel.getCostVector().cols();
+	m_aLowerBoundRow.assign( nColSize, NO_INDEX );
+	m_aUpperBoundRow.assign( nColSize, NO_INDEX );
 
 	for ( size_t i = 0; i < nColSize; ++i )
 	{
 		if ( aModel.isVarBounded( i, BOUND_LOWER ) )
 		{
+			m_aLowerBoundRow[i] = aModel.getConstraintCount();
 			double fLBound = aModel.getVarBound( i, BOUND_LOWER );
-			cout << i << " lower bound: " << fLBound << endl;
+			if ( aModel.getVerbose() )
+				cout << i << " lower bound: " << fLBound << endl;
 
 			vector<double> v( nColSize );
 			v.at( i ) = 1.0;
@@ -144,8 +487,10 @@ void RevisedSimplexImpl::convertVarRange( Model& aModel )
 
 		if ( aModel.isVarBounded( i, BOUND_UPPER ) )
 		{
+			m_aUpperBoundRow[i] = aModel.getConstraintCount();
 			double fUBound = aModel.getVarBound( i, BOUND_UPPER );
-			cout << i << " upper bound: " << fUBound << endl;
+			if ( aModel.getVerbose() )
+				cout << i << " upper bound: " << fUBound << endl;
 
 			vector<double> v( nColSize );
 			v.at( i ) = 1.0;
@@ -163,16 +508,22 @@ void RevisedSimplexImpl::solve()
 	//     B = right hand side vector
 	//     C = expanded cost vector
 
-	Model aModel( *m_pSelf->getCanonicalModel() );
+	Model aModel( *m_pSelf->getModel() );
+	size_t nRowCount = aModel.getConstraintCount();
 	convertVarRange( aModel );
-	aModel.print();
+	if ( aModel.getVerbose() )
+		aModel.print();
+	size_t nVarCount = aModel.getCostVector().cols();
 	Matrix A( aModel.getConstraintMatrix() );
 	Matrix B( aModel.getRhsVector() );
 	Matrix C( aModel.getCostVector() );
 
+	m_aSlackCol.assign( A.rows(), NO_INDEX );
 	for ( size_t i = 0; i < A.rows(); ++i )
 	{
 		EqualityType eEq = aModel.getEquality( i );
+		if ( eEq != EQUAL )
+			m_aSlackCol[i] = A.cols();
 		switch( eEq )
 		{
 		case LESS_EQUAL:
@@ -280,7 +631,13 @@ void RevisedSimplexImpl::solve()
 	m_B = B;
 	m_C = C;
 
-	if ( aNonSatRows.size() > 0 )
+	m_nPhaseOneIter = 0;
+	if ( applyStartBasis( nRowCount ) )
+	{
+		if ( m_Model.getVerbose() )
+			Debug( "starting from the given basis" );
+	}
+	else if ( aNonSatRows.size() > 0 )
 		runTwoPhaseInitSearch( aNonSatRows );
 	else
 		runNormalInitSearch();
@@ -295,12 +652,27 @@ void RevisedSimplexImpl::solve()
 			m_aBasicVarId.push_back( distance( m_aBasicVar.begin(), pos ) );
 
 	m_aPriceVector = solvePriceVector( m_aBasicVarId, m_aBasicInv, C );
+	initNonBasicVars();
+	m_aPricingWeights.reset( m_ePricing, m_A, m_aBasicInv, m_aBasicVarId, m_aNonBasicVarId );
 
 	// Start iterations
 	m_nIter = 0;
-	while ( !iterate() );
+	m_bPerturbAllowed = m_bPerturbation;
+	m_bPerturbed = false;
+	m_nDegenerateIter = 0;
+	m_nPerturbSeed = 1;
+	while ( !iterate() )
+	{
+		m_pSelf->getSolveControl()->checkIteration( m_nIter );
+		m_pSelf->getSolveControl()->reportIteration( m_nIter );
+	}
 
-	m_pSelf->setCanonicalSolution( m_aX );
+	// Strip the slack variables.
+	Matrix mxSolution( nVarCount, 1 );
+	for ( size_t i = 0; i < nVarCount; ++i )
+		mxSolution( i, 0 ) = m_aX( i, 0 );
+	m_pSelf->setSolution( mxSolution );
+	m_pSelf->setBasis( buildBasis( nVarCount, nRowCount ) );
 	if ( m_Model.getVerbose() )
 	{
 		cout << "x = ";
@@ -308,6 +680,125 @@ void RevisedSimplexImpl::solve()
 	}
 }
 
+/**
+ * Set up the initial basis from the start basis of the algorithm, if there
+ * is one.  The start basis refers to the decision variables and the rows
+ * of the original model, with the variable bounds handled implicitly.
+ * Here a bound is a row of its own: a variable at its bound is basic, with
+ * the slack of the bound row non-basic.
+ *
+ * @param nRowCount number of rows in the original model
+ * @return bool true if the start basis was applied, or false if there is
+ *         none or it does not yield a feasible basis of this model, in
+ *         which case nothing is changed.
+ */
+bool RevisedSimplexImpl::applyStartBasis( size_t nRowCount )
+{
+	const Basis aBasis = m_pSelf->getStartBasis();
+	size_t nVarCount = m_aLowerBoundRow.size();
+	if ( aBasis.empty() || aBasis.getVarCount() != nVarCount ||
+		 aBasis.getRowCount() != nRowCount )
+		return false;
+
+	vector<bool> aBasicVar( m_A.cols(), false );
+	for ( size_t j = 0; j < nVarCount; ++j )
+	{
+		BasisStatus eStatus = aBasis.getVarStatus( j );
+		size_t nLower = m_aLowerBoundRow[j], nUpper = m_aUpperBoundRow[j];
+		if ( eStatus == BASIS_UPPER && nUpper == NO_INDEX )
+			return false;
+
+		aBasicVar[j] = eStatus == BASIS_BASIC ||
+			( eStatus == BASIS_LOWER && nLower != NO_INDEX ) || eStatus == BASIS_UPPER;
+		if ( nLower != NO_INDEX )
+			aBasicVar[m_aSlackCol[nLower]] = eStatus != BASIS_LOWER;
+		if ( nUpper != NO_INDEX )
+			aBasicVar[m_aSlackCol[nUpper]] = eStatus != BASIS_UPPER;
+	}
+
+	for ( size_t i = 0; i < nRowCount; ++i )
+	{
+		BasisStatus eStatus = aBasis.getRowStatus( i );
+		if ( m_aSlackCol[i] != NO_INDEX )
+			aBasicVar[m_aSlackCol[i]] = eStatus == BASIS_BASIC;
+		else if ( eStatus == BASIS_BASIC )
+			return false;
+	}
+
+	vector<size_t> aNonBasicVarId;
+	for ( size_t j = 0; j < aBasicVar.size(); ++j )
+		if ( !aBasicVar[j] )
+			aNonBasicVarId.push_back( j );
+	if ( aBasicVar.size() - aNonBasicVarId.size() != m_A.rows() )
+		return false;
+
+	Matrix ABasic( m_A );
+	ABasic.deleteColumns( aNonBasicVarId );
+	Matrix aBasicInv( 0, 0 );
+	try
+	{
+		aBasicInv = ABasic.inverse();
+	}
+	catch ( const SingularMatrix& )
+	{
+		return false;
+	}
+
+	// The primal simplex needs a feasible start.
+	Matrix XBasic = aBasicInv * m_B;
+	for ( size_t i = 0; i < XBasic.rows(); ++i )
+	{
+		if ( XBasic( i, 0 ) < -1e-9*( 1.0 + ::std::fabs( m_B( i, 0 ) ) ) )
+			return false;
+	}
+
+	size_t nRow = 0;
+	Matrix X( m_A.cols(), 1 );
+	for ( size_t j = 0; j < m_A.cols(); ++j )
+		if ( aBasicVar[j] )
+			X( j, 0 ) = ::std::max( XBasic( nRow++, 0 ), 0.0 );
+
+	m_aBasicVar = aBasicVar;
+	m_aX = X;
+	m_aBasicInv = aBasicInv;
+	return true;
+}
+
+/**
+ * Translate the current basis back into the terms of the original model.
+ * A basic variable whose bound row has a non-basic slack is at that bound.
+ */
+const Basis RevisedSimplexImpl::buildBasis( size_t nVarCount, size_t nRowCount ) const
+{
+	Basis aBasis( nVarCount, nRowCount );
+	for ( size_t j = 0; j < nVarCount; ++j )
+	{
+		BasisStatus eStatus = BASIS_LOWER;
+		size_t nLower = m_aLowerBoundRow[j], nUpper = m_aUpperBoundRow[j];
+		if ( m_aBasicVar[j] )
+		{
+			eStatus = BASIS_BASIC;
+			if ( nLower != NO_INDEX && !m_aBasicVar[m_aSlackCol[nLower]] )
+				eStatus = BASIS_LOWER;
+			else if ( nUpper != NO_INDEX && !m_aBasicVar[m_aSlackCol[nUpper]] )
+				eStatus = BASIS_UPPER;
+		}
+		aBasis.setVarStatus( j, eStatus );
+	}
+
+	for ( size_t i = 0; i < nRowCount; ++i )
+	{
+		size_t nSlack = m_aSlackCol[i];
+		if ( nSlack == NO_INDEX )
+			aBasis.setRowStatus( i, BASIS_LOWER );
+		else if ( m_aBasicVar[nSlack] )
+			aBasis.setRowStatus( i, BASIS_BASIC );
+		else
+			aBasis.setRowStatus( i, m_Model.getEquality( i ) == LESS_EQUAL ? BASIS_UPPER : BASIS_LOWER );
+	}
+	return aBasis;
+}
+
 /** Find an initial X via normal (non two-phase) search, and set the following 
 	member variables:
 		m_aBasicInv : an invert basic matrix
@@ -366,13 +857,15 @@ void RevisedSimplexImpl::runTwoPhaseInitSearch( const vector<size_t>& aNonSatRow
 		throw IllegalTwoPhaseSearch();
 		
 	static const bool bDebugTwoPhase = false;
+	bool bVerbose = m_Model.getVerbose();
 
-	if ( m_Model.getVerbose() )
+	if ( bVerbose )
 		Debug( "Entering a two-phase search for initial solution" );
 
 	Matrix A2( m_A );
 	
-	cout << "initial number of column(s): " << A2.cols() << endl;
+	if ( bVerbose )
+		cout << "initial number of column(s): " << A2.cols() << endl;
 	vector<size_t>::const_iterator nIter, end = aNonSatRows.end();
 	for ( nIter = aNonSatRows.begin(); nIter != end; ++nIter )
 	{
@@ -383,7 +876,8 @@ void RevisedSimplexImpl::runTwoPhaseInitSearch( const vector<size_t>& aNonSatRow
 			A2( nRowId, A2.cols() ) = -1;
 	}
 	
-	cout << A2.cols() - m_A.cols() << " column(s) added" << endl;
+	if ( bVerbose )
+		cout << A2.cols() - m_A.cols() << " column(s) added" << endl;
 
 	auto_ptr<Model> model( new Model );
 	model->setGoal( GOAL_MINIMIZE );
@@ -403,57 +897,112 @@ void RevisedSimplexImpl::runTwoPhaseInitSearch( const vector<size_t>& aNonSatRow
 
 	// This looks ugly, but necessary to prevent nested two-phase search during 
 	// two phase search. (TODO: find a better approach)
-	static_cast<RevisedSimplex*>(algorithm.get())->setEnableTwoPhaseSearch( false );
-
+	RevisedSimplex* pPhaseOne = static_cast<RevisedSimplex*>( algorithm.get() );
+	pPhaseOne->setEnableTwoPhaseSearch( false );
+	pPhaseOne->setPricing( m_ePricing );
+	pPhaseOne->setPricingBlockSize( m_nPricingBlockSize );
+	pPhaseOne->setPrimalTolerance( m_fPrimalTol );
+	pPhaseOne->setDualTolerance( m_fDualTol );
+	pPhaseOne->setPerturbation( m_bPerturbation );
+
+	if ( m_bCrash )
+		algorithm->setStartBasis( crashPhaseOneBasis( A2, aNonSatRows ) );
 	algorithm->setModel( model.get() );
 	algorithm->solve();
 	Matrix Xtmp( algorithm->getSolution() );
+	m_nPhaseOneIter = pPhaseOne->getIterationCount();
+	if ( bVerbose )
+		cout << "phase one iterations: " << m_nPhaseOneIter << endl;
 
 	size_t nANumRow = m_A.rows(), nANumCol = m_A.cols(), nA2NumCol = A2.cols();
+	double fTol = 0.0;
+	for ( size_t i = 0; i < nANumRow; ++i )
+		fTol = ::std::max( fTol, ::std::fabs( m_B( i, 0 ) ) );
+	fTol = 1e-9*( 1.0 + fTol );
 	for ( size_t i = nANumCol; i < nA2NumCol; ++i )
 	{
-		double f = Xtmp( i, 0 ); // Do I need to round this to precision ?
-		cout << "f = " << f << endl;
-		if ( f != 0.0 )
+		double f = Xtmp( i, 0 );
+		if ( bVerbose )
+			cout << "f = " << f << endl;
+		if ( f > fTol )
 			throw ModelInfeasible();
 	}
 
-	Matrix X( 0, 0 );
-	vector<size_t> aNonBasicVarId;
-	vector<bool> aBasicVar( m_aBasicVar );
-
-	size_t i = nANumCol;
-	do
+	// Take the basis of the phase one problem, and drive the artificial
+	// variables that are still basic (at zero) out of it.  When no
+	// structural column can replace one, its row is a linear combination
+	// of the other rows, and is dropped.
+	const Basis aPhaseOneBasis = algorithm->getBasis();
+	vector<size_t> aBasicVarId;
+	for ( size_t j = 0; j < nA2NumCol; ++j )
+		if ( aPhaseOneBasis.getVarStatus( j ) == BASIS_BASIC )
+			aBasicVarId.push_back( j );
+
+	vector<size_t> aDropRows;
+	for ( size_t nPos = 0; nPos < aBasicVarId.size(); ++nPos )
 	{
-		double f = Xtmp( --i, 0 );
-		X( i, 0 ) = f;
-		if ( aNonBasicVarId.size() < nANumCol - nANumRow && f == 0.0 )
+		if ( aBasicVarId[nPos] < nANumCol )
+			continue;
+
+		Matrix ABasic( nANumRow, aBasicVarId.size() );
+		for ( size_t k = 0; k < aBasicVarId.size(); ++k )
+			for ( size_t i = 0; i < nANumRow; ++i )
+				ABasic( i, k ) = A2( i, aBasicVarId[k] );
+		Matrix aBasicInv( ABasic.inverse() );
+
+		size_t nEnterVarId = NO_INDEX;
+		double fPivot = 1e-9;
+		for ( size_t j = 0; j < nANumCol; ++j )
 		{
-			aBasicVar[i] = false;
-			aNonBasicVarId.push_back( i );
+			if ( find( aBasicVarId.begin(), aBasicVarId.end(), j ) != aBasicVarId.end() )
+				continue;
+			double fVal = 0.0;
+			for ( size_t i = 0; i < nANumRow; ++i )
+				fVal += aBasicInv( nPos, i )*A2( i, j );
+			if ( ::std::fabs( fVal ) > fPivot )
+			{
+				fPivot = ::std::fabs( fVal );
+				nEnterVarId = j;
+			}
 		}
+
+		if ( nEnterVarId != NO_INDEX )
+			aBasicVarId[nPos] = nEnterVarId;
 		else
-			aBasicVar[i] = true;
+			aDropRows.push_back( aNonSatRows.at( aBasicVarId[nPos] - nANumCol ) );
 	}
-	while ( i != 0 );
-
-	sort( aNonBasicVarId.begin(), aNonBasicVarId.end() );
-	cout << "aNonBasicVarId = ";
-	printElements( aNonBasicVarId, " " );
 
-	Matrix ABasic( m_A );
-	ABasic.print( 0 );
+	vector<bool> aBasicVar( nANumCol, false );
+	Matrix X( nANumCol, 1 );
+	for ( size_t k = 0; k < aBasicVarId.size(); ++k )
+	{
+		size_t j = aBasicVarId[k];
+		if ( j < nANumCol )
+		{
+			aBasicVar[j] = true;
+			X( j, 0 ) = ::std::max( Xtmp( j, 0 ), 0.0 );
+		}
+	}
 
-	cout << "(" << ABasic.rows() << "," << ABasic.cols() << ")" << endl;
+	if ( !aDropRows.empty() )
+	{
+		if ( bVerbose )
+		{
+			cout << "redundant rows: ";
+			printElements( aDropRows, " " );
+			cout << endl;
+		}
+		m_A.deleteRows( aDropRows );
+		m_B.deleteRows( aDropRows );
+	}
 
+	vector<size_t> aNonBasicVarId;
+	for ( size_t j = 0; j < nANumCol; ++j )
+		if ( !aBasicVar[j] )
+			aNonBasicVarId.push_back( j );
+	Matrix ABasic( m_A );
 	ABasic.deleteColumns( aNonBasicVarId );
-	ABasic.print( 0 );
-
-	cout << "(" << ABasic.rows() << "," << ABasic.cols() << ")" << endl;
-
 	Matrix aBasicInv( ABasic.inverse() );
-	cout << "inverse" << endl;
-	aBasicInv.print();
 
 	// Update member variables.
 	
@@ -465,6 +1014,147 @@ void RevisedSimplexImpl::runTwoPhaseInitSearch( const vector<size_t>& aNonSatRow
 		Debug( "Two-phase search found an initial solution" );
 }
 
+/**
+ * Build a starting basis for the phase one problem A2 x = b, x >= 0, by a
+ * triangular crash in the style of Bixby's CPLEX crash.  Structural
+ * columns are considered sparsest first, cheapest first among columns of
+ * equal length, and each one replaces the artificial variable of one row,
+ * its pivot row.  A column is only accepted when it has no entry in any
+ * earlier pivot row, which keeps the basis triangular and therefore
+ * nonsingular, when its pivot is not small relative to the rest of the
+ * column, and when all basic variables stay non-negative.  Each accepted
+ * column thus removes one artificial variable without losing feasibility.
+ *
+ * @param A2 constraint matrix of the phase one problem
+ * @param aNonSatRows row of each artificial column
+ *
+ * @return Basis start basis of the phase one problem, or an empty basis
+ *         when no structural column could be brought in.
+ */
+const Basis RevisedSimplexImpl::crashPhaseOneBasis( const Matrix& A2, const vector<size_t>& aNonSatRows ) const
+{
+	const size_t nRowCount = A2.rows(), nColCount = m_A.cols();
+
+	// Unit column that covers each row in the initial basis, with its
+	// coefficient and its current value.
+	vector<size_t> aRowUnit( nRowCount, NO_INDEX );
+	vector<double> aRowCoef( nRowCount, 1.0 ), aRowVal( nRowCount, 0.0 );
+	vector<bool> aArtificial( nRowCount, false );
+	for ( size_t j = 0; j < nColCount; ++j )
+	{
+		if ( !m_aBasicVar[j] )
+			continue;
+		for ( size_t i = 0; i < nRowCount; ++i )
+			if ( A2( i, j ) != 0.0 )
+			{
+				aRowUnit[i] = j;
+				aRowCoef[i] = A2( i, j );
+				break;
+			}
+	}
+	for ( size_t k = 0; k < aNonSatRows.size(); ++k )
+	{
+		size_t i = aNonSatRows[k];
+		aRowUnit[i] = nColCount + k;
+		aRowCoef[i] = A2( i, nColCount + k );
+		aArtificial[i] = true;
+	}
+
+	vector<bool> aBasic( A2.cols(), false );
+	for ( size_t i = 0; i < nRowCount; ++i )
+	{
+		if ( aRowUnit[i] == NO_INDEX )
+			return Basis();
+		aBasic[aRowUnit[i]] = true;
+		aRowVal[i] = m_B( i, 0 )/aRowCoef[i];
+	}
+
+	double fSign = m_Model.getGoal() == GOAL_MAXIMIZE ? -1.0 : 1.0;
+	vector< ::std::pair< ::std::pair<size_t,double>, size_t > > aCandidates;
+	for ( size_t j = 0; j < nColCount; ++j )
+	{
+		if ( aBasic[j] )
+			continue;
+		size_t nCount = 0;
+		for ( size_t i = 0; i < nRowCount; ++i )
+			if ( A2( i, j ) != 0.0 )
+				++nCount;
+		if ( nCount > 0 )
+			aCandidates.push_back( ::std::make_pair( ::std::make_pair( nCount, fSign*m_C( 0, j ) ), j ) );
+	}
+	sort( aCandidates.begin(), aCandidates.end() );
+
+	vector<bool> aPivoted( nRowCount, false );
+	size_t nCrashed = 0;
+	for ( size_t nCand = 0; nCand < aCandidates.size(); ++nCand )
+	{
+		size_t j = aCandidates[nCand].second;
+		double fColMax = 0.0;
+		bool bTriangular = true;
+		for ( size_t i = 0; i < nRowCount && bTriangular; ++i )
+		{
+			double fVal = A2( i, j );
+			if ( fVal == 0.0 )
+				continue;
+			bTriangular = !aPivoted[i];
+			fColMax = ::std::max( fColMax, ::std::fabs( fVal ) );
+		}
+		if ( !bTriangular )
+			continue;
+
+		size_t nPivotRow = NO_INDEX;
+		double fPivot = 0.0, fPivotX = 0.0;
+		for ( size_t i = 0; i < nRowCount; ++i )
+		{
+			double fVal = A2( i, j );
+			if ( fVal == 0.0 || !aArtificial[i] || ::std::fabs( fVal ) < CRASH_PIVOT_TOL*fColMax ||
+				 ::std::fabs( fVal ) <= fPivot )
+				continue;
+
+			double fX = aRowCoef[i]*aRowVal[i]/fVal;
+			bool bFeasible = fX >= 0.0;
+			for ( size_t k = 0; k < nRowCount && bFeasible; ++k )
+			{
+				double fValK = A2( k, j );
+				if ( k != i && fValK != 0.0 )
+					bFeasible = aRowVal[k] - fValK*fX/aRowCoef[k] >= -1e-9*( 1.0 + ::std::fabs( aRowVal[k] ) );
+			}
+			if ( bFeasible )
+			{
+				nPivotRow = i;
+				fPivot = ::std::fabs( fVal );
+				fPivotX = fX;
+			}
+		}
+		if ( nPivotRow == NO_INDEX )
+			continue;
+
+		for ( size_t k = 0; k < nRowCount; ++k )
+		{
+			double fValK = A2( k, j );
+			if ( k != nPivotRow && fValK != 0.0 )
+				aRowVal[k] = ::std::max( aRowVal[k] - fValK*fPivotX/aRowCoef[k], 0.0 );
+		}
+		aBasic[aRowUnit[nPivotRow]] = false;
+		aBasic[j] = true;
+		aPivoted[nPivotRow] = true;
+		aArtificial[nPivotRow] = false;
+		++nCrashed;
+	}
+
+	if ( m_Model.getVerbose() )
+		cout << "crash: " << nCrashed << " of " << aNonSatRows.size() << " artificial variables replaced" << endl;
+	if ( nCrashed == 0 )
+		return Basis();
+
+	Basis aBasis( A2.cols(), nRowCount );
+	for ( size_t j = 0; j < A2.cols(); ++j )
+		aBasis.setVarStatus( j, aBasic[j] ? BASIS_BASIC : BASIS_LOWER );
+	for ( size_t i = 0; i < nRowCount; ++i )
+		aBasis.setRowStatus( i, BASIS_LOWER );
+	return aBasis;
+}
+
 void RevisedSimplexImpl::printIterateHeader() const
 {
 	cout << endl;
@@ -503,80 +1193,31 @@ bool RevisedSimplexImpl::iterate()
 	// m_aBasicVar, m_aBasicVarId, m_aBasicInv, m_aPriceVector
 	// m_aX, m_A, m_B, m_C
 
-	// Determine IDs of non-basic variables
-	vector<size_t> aNonBasicVarId;
-	vector<bool>::iterator bIter;
-	for ( bIter = m_aBasicVar.begin(); bIter != m_aBasicVar.end(); ++bIter )
-		if ( !*bIter )
-			aNonBasicVarId.push_back( distance( m_aBasicVar.begin(), bIter ) );
-
-	// Determine entering non-basic variable	
-	vector<size_t>::iterator nIter, nBegin = aNonBasicVarId.begin(), nEnd = aNonBasicVarId.end();
-	map<size_t,double> fEnterBasicVars;
-	double fMin, fMax;
-	size_t nMin, nMax;
-	for ( nIter = nBegin; nIter != nEnd; ++nIter )
-	{
-		size_t nId = *nIter;
-		double fPrice = m_C( 0, nId ) - 
-			( m_aPriceVector*m_A.getColumn( nId ) ).operator()( 0, 0 );
-
-		if ( bVerbose )
-			cout << "c(" << nId << ") = " << fPrice << endl;
-
-		fEnterBasicVars.insert( make_pair( nId, fPrice ) );
-		if ( nIter == nBegin )
+	size_t nEnterVarId = 0;
+	if ( selectEnteringVar( nEnterVarId ) )
+	{
+		if ( m_bPerturbed )
 		{
-			fMin = fMax = fPrice;
-			nMin = nMax = nId;
+			// Optimal for the perturbed model.  Restore the true values of
+			// the basic variables and carry on from there.
+			removePerturbation();
+			return false;
 		}
-		else
-		{
-			if ( fPrice > fMax )
-			{
-				fMax = fPrice;
-				nMax = nId;
-			}
-			if ( fPrice < fMin )
-			{
-				fMin = fPrice;
-				nMin = nId;
-			}
-		}			
-	}
-	
-	GoalType eGoal = m_Model.getGoal();
-	if ( ( eGoal == GOAL_MAXIMIZE && fMax <= 0.0 ) ||
-		 ( eGoal == GOAL_MINIMIZE && fMin >= 0.0 ) )
-	{
+
 		if ( bVerbose )
 			cout << "Optimum solution reached" << endl;
 		return true;
 	}
-	
-	size_t nEnterVarId = 0;
-	if ( eGoal == GOAL_MAXIMIZE )
-		nEnterVarId = nMax;
-	else if ( eGoal == GOAL_MINIMIZE )
-		nEnterVarId = nMin;
-	else
-		throw;
 
 	// Calculate dX (delta-X)
 	Matrix dXBasic = m_aBasicInv * m_A.getColumn( nEnterVarId ) * (-1);
-	Matrix dX( 0, 0 );
+	Matrix dX( m_A.cols(), 1 );
 	
 	OSL_ASSERT( dXBasic.rows() == m_aBasicVarId.size() );
 	
 	for ( size_t i = 0; i < dXBasic.rows(); ++i )
 		dX( m_aBasicVarId.at( i ), 0 ) = dXBasic( i, 0 );
-	
-	nEnd = aNonBasicVarId.end();
-	for ( nIter = aNonBasicVarId.begin(); nIter != nEnd; ++nIter )
-	{
-		size_t nId = *nIter;
-		dX( nId, 0 ) = nId == nEnterVarId ? 1.0 : 0.0;
-	}
+	dX( nEnterVarId, 0 ) = 1.0;
 	if ( bVerbose )
 	{
 		cout << "dX[" << nEnterVarId << "] = ";
@@ -587,7 +1228,7 @@ bool RevisedSimplexImpl::iterate()
 	// component.
 	bool bNegativeFound = false;
 	for ( size_t i = 0; i < dX.rows(); ++i )
-		if ( dX( i, 0 ) < 0.0 )
+		if ( dX( i, 0 ) < -PIVOT_TOL )
 		{
 			bNegativeFound = true;
 			break;
@@ -610,14 +1251,47 @@ bool RevisedSimplexImpl::iterate()
 			 << "x" << nLeaveVarId << " leaves" << endl;
 
 	m_aX += dX*fLambda;
-	m_aBasicVar[nEnterVarId].flip();
-	m_aBasicVar[nLeaveVarId].flip();
-	size_t nIndexLeaveVar;
-	for ( nIter = m_aBasicVarId.begin(); nIter < m_aBasicVarId.end(); ++nIter )
-		if ( *nIter == nLeaveVarId )
-		{
-			nIndexLeaveVar = distance( m_aBasicVarId.begin(), nIter );
-			*nIter = nEnterVarId;
+	m_aX( nLeaveVarId, 0 ) = 0.0;
+	pivot( nEnterVarId, nLeaveVarId, dX );
+	++m_nIter;
+
+	if ( fLambda*::std::fabs( dX( nLeaveVarId, 0 ) ) > m_fPrimalTol )
+		m_nDegenerateIter = 0;
+	else if ( ++m_nDegenerateIter >= PERTURB_AFTER && m_bPerturbAllowed )
+		perturb();
+	
+	return false;
+}
+
+/**
+ * Exchange the entering and the leaving variable in the basis, and update
+ * the basis inverse and the price vector accordingly.
+ *
+ * @param dX step direction of the entering variable
+ */
+void RevisedSimplexImpl::pivot( size_t nEnterVarId, size_t nLeaveVarId, const Matrix& dX )
+{
+	m_aPricingWeights.update( nEnterVarId, nLeaveVarId, m_A, m_aBasicInv,
+							  m_aBasicVarId, m_aNonBasicVarId );
+
+	m_aBasicVar[nEnterVarId].flip();
+	m_aBasicVar[nLeaveVarId].flip();
+
+	// The leaving variable takes the place of the entering one in the
+	// non-basic list.
+	size_t nEnterPos = m_aNonBasicPos.at( nEnterVarId );
+	OSL_ASSERT( nEnterPos != NOT_NONBASIC );
+	m_aNonBasicVarId[nEnterPos] = nLeaveVarId;
+	m_aNonBasicPos[nLeaveVarId] = nEnterPos;
+	m_aNonBasicPos[nEnterVarId] = NOT_NONBASIC;
+
+	size_t nIndexLeaveVar = 0;
+	vector<size_t>::iterator nIter;
+	for ( nIter = m_aBasicVarId.begin(); nIter < m_aBasicVarId.end(); ++nIter )
+		if ( *nIter == nLeaveVarId )
+		{
+			nIndexLeaveVar = distance( m_aBasicVarId.begin(), nIter );
+			*nIter = nEnterVarId;
 			break;
 		}
 
@@ -636,15 +1310,105 @@ bool RevisedSimplexImpl::iterate()
 	// Update invert matrix and price vector.
 	m_aBasicInv = E*m_aBasicInv;
 	m_aPriceVector = solvePriceVector( m_aBasicVarId, m_aBasicInv, m_C );
-	++m_nIter;
-	
-	return false;
+}
+
+/**
+ * Move every basic variable up by a small random amount, which amounts to
+ * perturbing the right hand side.  The vertex is then no longer
+ * degenerate, and the following iterations make progress instead of
+ * stalling.  The perturbation is bounded by PERTURB_SCALE relative to the
+ * values, and is applied at most once per solve.
+ */
+void RevisedSimplexImpl::perturb()
+{
+	if ( m_Model.getVerbose() )
+		cout << "perturbing after " << m_nDegenerateIter << " degenerate iterations" << endl;
+
+	vector<size_t>::const_iterator itr, itrEnd = m_aBasicVarId.end();
+	for ( itr = m_aBasicVarId.begin(); itr != itrEnd; ++itr )
+		m_aX( *itr, 0 ) += lcl_nextPerturbation( m_nPerturbSeed, m_aX( *itr, 0 ) );
+
+	m_bPerturbed = true;
+	m_bPerturbAllowed = false;
+	m_nDegenerateIter = 0;
+}
+
+/**
+ * Recompute the basic variables from the unperturbed right hand side.  The
+ * basis is optimal for the perturbed model, hence dual feasible, so any
+ * basic variable that has become negative is removed by dual simplex
+ * iterations.
+ */
+void RevisedSimplexImpl::removePerturbation()
+{
+	m_bPerturbed = false;
+	Matrix XBasic( m_aBasicInv*m_B );
+	m_aX = Matrix( m_A.cols(), 1 );
+	for ( size_t i = 0; i < m_aBasicVarId.size(); ++i )
+		m_aX( m_aBasicVarId[i], 0 ) = XBasic( i, 0 );
+
+	while ( true )
+	{
+		// Leaving row: the most negative basic variable.
+		size_t nRow = NO_INDEX;
+		double fMin = -m_fPrimalTol;
+		for ( size_t i = 0; i < m_aBasicVarId.size(); ++i )
+			if ( m_aX( m_aBasicVarId[i], 0 ) < fMin )
+			{
+				fMin = m_aX( m_aBasicVarId[i], 0 );
+				nRow = i;
+			}
+		if ( nRow == NO_INDEX )
+			break;
+
+		// Dual ratio test along the pivot row.
+		size_t nEnterVarId = NO_INDEX;
+		double fBestRatio = 0.0, fBestAlpha = 0.0;
+		vector<size_t>::const_iterator itr, itrEnd = m_aNonBasicVarId.end();
+		for ( itr = m_aNonBasicVarId.begin(); itr != itrEnd; ++itr )
+		{
+			double fAlpha = 0.0;
+			for ( size_t k = 0; k < m_A.rows(); ++k )
+				fAlpha += m_aBasicInv( nRow, k )*m_A( k, *itr );
+			if ( fAlpha > -PIVOT_TOL )
+				continue;
+
+			double fRatio = ::std::max( -getPriceScore( getReducedCost( *itr ) ), 0.0 )/( -fAlpha );
+			if ( nEnterVarId == NO_INDEX || fRatio < fBestRatio - m_fDualTol ||
+				 ( fRatio <= fBestRatio + m_fDualTol && -fAlpha > fBestAlpha ) )
+			{
+				nEnterVarId = *itr;
+				fBestRatio = fRatio;
+				fBestAlpha = -fAlpha;
+			}
+		}
+		if ( nEnterVarId == NO_INDEX )
+			throw ModelInfeasible();
+
+		Matrix dXBasic = m_aBasicInv * m_A.getColumn( nEnterVarId ) * (-1);
+		Matrix dX( m_A.cols(), 1 );
+		for ( size_t i = 0; i < dXBasic.rows(); ++i )
+			dX( m_aBasicVarId.at( i ), 0 ) = dXBasic( i, 0 );
+		dX( nEnterVarId, 0 ) = 1.0;
+
+		size_t nLeaveVarId = m_aBasicVarId[nRow];
+		m_aX += dX*( -m_aX( nLeaveVarId, 0 )/dX( nLeaveVarId, 0 ) );
+		m_aX( nLeaveVarId, 0 ) = 0.0;
+		pivot( nEnterVarId, nLeaveVarId, dX );
+		++m_nIter;
+		m_pSelf->getSolveControl()->checkIteration( m_nIter );
+		m_pSelf->getSolveControl()->reportIteration( m_nIter );
+	}
+
+	if ( m_Model.getVerbose() )
+		cout << "perturbation removed" << endl;
 }
 
 Matrix RevisedSimplexImpl::solvePriceVector( std::vector<size_t> aBasicVarId,
 		const Matrix& AInv, const Matrix& C )
 {
 	Matrix c;
+	c.reserve( 1, aBasicVarId.size() );
 	std::vector<size_t>::iterator pos;
 	for ( pos = aBasicVarId.begin(); pos != aBasicVarId.end(); ++pos )
 	{
@@ -655,34 +1419,47 @@ Matrix RevisedSimplexImpl::solvePriceVector( std::vector<size_t> aBasicVarId,
 	return c*AInv;
 }
 
+/**
+ * Harris two-pass ratio test.  The first pass finds the largest step for
+ * which no variable goes below zero by more than the primal tolerance.
+ * The second pass picks, among the variables that block within that step,
+ * the one with the largest change, which keeps the pivot element away
+ * from zero on degenerate vertices where many ratios tie.  The step is
+ * then the exact ratio of the chosen variable, so the other variables stay
+ * within the tolerance of zero.
+ */
 void RevisedSimplexImpl::getLambda( const Matrix& X, const Matrix& dX, 
 		double& rLambda, size_t& rLeaveVarId ) const
 {
 	OSL_ASSERT( X.rows() == dX.rows() );
 
-	double fLambda = 0.0;
-	size_t nId = 0;
 	bool bFirst = true;
+	double fMaxLambda = 0.0;
 	for ( size_t i = 0; i < X.rows(); ++i )
 	{
-		double fXVal = X( i, 0 );
 		double fdXVal = dX( i, 0 );
-		if ( fdXVal < 0 )
+		if ( fdXVal < -PIVOT_TOL )
 		{
-			double fVal = fXVal / fdXVal * (-1.0);
-			if ( bFirst )
+			double fVal = ( X( i, 0 ) + m_fPrimalTol ) / fdXVal * (-1.0);
+			if ( bFirst || fVal < fMaxLambda )
+				fMaxLambda = fVal;
+			bFirst = false;
+		}
+	}
+
+	double fLambda = 0.0, fPivot = 0.0;
+	size_t nId = 0;
+	for ( size_t i = 0; i < X.rows(); ++i )
+	{
+		double fdXVal = dX( i, 0 );
+		if ( fdXVal < -PIVOT_TOL )
+		{
+			double fVal = X( i, 0 ) / fdXVal * (-1.0);
+			if ( fVal <= fMaxLambda && -fdXVal > fPivot )
 			{
-				fLambda = fVal;
+				fLambda = ::std::max( fVal, 0.0 );
+				fPivot = -fdXVal;
 				nId = i;
-				bFirst = false;
-			}
-			else
-			{
-				if ( fVal < fLambda )
-				{
-					fLambda = fVal;
-					nId = i;
-				}
 			}
 		}
 	}
@@ -692,6 +1469,206 @@ void RevisedSimplexImpl::getLambda( const Matrix& X, const Matrix& dX,
 }
 
 
+void RevisedSimplexImpl::initNonBasicVars()
+{
+	m_aNonBasicVarId.clear();
+	m_aNonBasicPos.assign( m_aBasicVar.size(), NOT_NONBASIC );
+	for ( size_t i = 0; i < m_aBasicVar.size(); ++i )
+		if ( !m_aBasicVar[i] )
+		{
+			m_aNonBasicPos[i] = m_aNonBasicVarId.size();
+			m_aNonBasicVarId.push_back( i );
+		}
+
+	m_nPricingStart = 0;
+	m_aPricingCandidates.clear();
+}
+
+/**
+ * Calculate the reduced cost c_j - v A_j of a variable, where v is the
+ * current price vector.
+ */
+double RevisedSimplexImpl::getReducedCost( size_t nId ) const
+{
+	double fPrice = m_C( 0, nId );
+	for ( size_t i = 0; i < m_A.rows(); ++i )
+		fPrice -= m_aPriceVector( 0, i )*m_A( i, nId );
+	return fPrice;
+}
+
+/**
+ * Turn a reduced cost into a score which is positive if and only if the
+ * variable improves the objective upon entering the basis, and larger
+ * the more attractive the variable is.
+ */
+double RevisedSimplexImpl::getPriceScore( double fPrice ) const
+{
+	switch ( m_Model.getGoal() )
+	{
+	case GOAL_MAXIMIZE:
+		return fPrice;
+	case GOAL_MINIMIZE:
+		return -fPrice;
+	default:
+		throw AssertionWrong();
+	}
+	return 0.0;
+}
+
+/**
+ * Block size for partial pricing, or candidate list length for multiple
+ * pricing.
+ */
+size_t RevisedSimplexImpl::getPricingSize() const
+{
+	if ( m_nPricingBlockSize > 0 )
+		return m_nPricingBlockSize;
+
+	size_t nNonBasic = m_aNonBasicVarId.size();
+	if ( m_ePricing == PRICING_PARTIAL )
+		return ::std::max<size_t>( 8, nNonBasic/8 );
+	return ::std::max<size_t>( 4, ::std::min<size_t>( 16, nNonBasic/8 ) );
+}
+
+/**
+ * Price every non-basic column.  The reduced costs are scaled by the edge
+ * weights with Devex and steepest edge pricing.
+ */
+bool RevisedSimplexImpl::priceFull( size_t& rEnterVarId )
+{
+	double fBestMerit = 0.0;
+	bool bFound = false;
+	vector<size_t>::const_iterator itr, itrEnd = m_aNonBasicVarId.end();
+	for ( itr = m_aNonBasicVarId.begin(); itr != itrEnd; ++itr )
+	{
+		double fPrice = getReducedCost( *itr );
+		double fScore = getPriceScore( fPrice );
+		if ( fScore <= m_fDualTol )
+			continue;
+
+		double fMerit = m_aPricingWeights.getMerit( fScore, *itr );
+		if ( fMerit > fBestMerit )
+		{
+			fBestMerit = fMerit;
+			rEnterVarId = *itr;
+			bFound = true;
+		}
+	}
+	return bFound;
+}
+
+bool RevisedSimplexImpl::pricePartial( size_t& rEnterVarId )
+{
+	size_t nNonBasic = m_aNonBasicVarId.size();
+	if ( nNonBasic == 0 )
+		return false;
+
+	size_t nBlockSize = getPricingSize();
+	size_t nPos = m_nPricingStart % nNonBasic;
+	double fBestScore = m_fDualTol;
+	bool bFound = false;
+	for ( size_t nPriced = 0; nPriced < nNonBasic; )
+	{
+		// Price one block.
+		for ( size_t k = 0; k < nBlockSize && nPriced < nNonBasic; ++k, ++nPriced )
+		{
+			size_t nId = m_aNonBasicVarId[nPos];
+			double fScore = getPriceScore( getReducedCost( nId ) );
+			if ( fScore > fBestScore )
+			{
+				fBestScore = fScore;
+				rEnterVarId = nId;
+				bFound = true;
+			}
+			nPos = ( nPos + 1 ) % nNonBasic;
+		}
+
+		if ( bFound )
+			break;
+	}
+
+	m_nPricingStart = nPos;
+	return bFound;
+}
+
+bool RevisedSimplexImpl::priceMultiple( size_t& rEnterVarId )
+{
+	// Re-price the remaining candidates first.
+	double fBestScore = 0.0;
+	bool bFound = false;
+	vector<size_t>::iterator itr = m_aPricingCandidates.begin();
+	while ( itr != m_aPricingCandidates.end() )
+	{
+		double fScore = m_aNonBasicPos[*itr] == NOT_NONBASIC ? 0.0 :
+			getPriceScore( getReducedCost( *itr ) );
+		if ( fScore <= m_fDualTol )
+		{
+			itr = m_aPricingCandidates.erase( itr );
+			continue;
+		}
+
+		if ( fScore > fBestScore )
+		{
+			fBestScore = fScore;
+			rEnterVarId = *itr;
+			bFound = true;
+		}
+		++itr;
+	}
+
+	if ( bFound )
+		return true;
+
+	// Candidate list exhausted.  Do a full pass and keep the most attractive
+	// columns.
+	vector< ::std::pair<double, size_t> > aScores;
+	vector<size_t>::const_iterator itrNB, itrNBEnd = m_aNonBasicVarId.end();
+	for ( itrNB = m_aNonBasicVarId.begin(); itrNB != itrNBEnd; ++itrNB )
+	{
+		double fScore = getPriceScore( getReducedCost( *itrNB ) );
+		if ( fScore > m_fDualTol )
+			aScores.push_back( ::std::make_pair( -fScore, *itrNB ) );
+	}
+
+	if ( aScores.empty() )
+		return false;
+
+	size_t nKeep = ::std::min( getPricingSize(), aScores.size() );
+	::std::partial_sort( aScores.begin(), aScores.begin() + nKeep, aScores.end() );
+	m_aPricingCandidates.clear();
+	for ( size_t i = 0; i < nKeep; ++i )
+		m_aPricingCandidates.push_back( aScores[i].second );
+
+	rEnterVarId = aScores[0].second;
+	return true;
+}
+
+/**
+ * Select the entering variable according to the pricing strategy.
+ *
+ * @return bool true if no non-basic variable improves the objective i.e. the
+ *         current solution is optimal, false otherwise.
+ */
+bool RevisedSimplexImpl::selectEnteringVar( size_t& rEnterVarId )
+{
+	bool bFound = false;
+	switch ( m_ePricing )
+	{
+	case PRICING_PARTIAL:
+		bFound = pricePartial( rEnterVarId );
+		break;
+	case PRICING_MULTIPLE:
+		bFound = priceMultiple( rEnterVarId );
+		break;
+	case PRICING_DANTZIG:
+	case PRICING_DEVEX:
+	case PRICING_STEEPEST_EDGE:
+	default:
+		bFound = priceFull( rEnterVarId );
+	}
+	return !bFound;
+}
+
 //---------------------------------------------------------------------------
 // RevisedSimplex
 
@@ -714,6 +1691,76 @@ void RevisedSimplex::setEnableTwoPhaseSearch( bool b )
 	m_pImpl->setEnableTwoPhaseSearch( b );
 }
 
+void RevisedSimplex::setPricing( PricingType e )
+{
+	m_pImpl->setPricing( e );
+}
+
+PricingType RevisedSimplex::getPricing() const
+{
+	return m_pImpl->getPricing();
+}
+
+void RevisedSimplex::setPricingBlockSize( size_t n )
+{
+	m_pImpl->setPricingBlockSize( n );
+}
+
+size_t RevisedSimplex::getPricingBlockSize() const
+{
+	return m_pImpl->getPricingBlockSize();
+}
+
+void RevisedSimplex::setCrash( bool b )
+{
+	m_pImpl->setCrash( b );
+}
+
+bool RevisedSimplex::getCrash() const
+{
+	return m_pImpl->getCrash();
+}
+
+void RevisedSimplex::setPrimalTolerance( double f )
+{
+	m_pImpl->setPrimalTolerance( f );
+}
+
+double RevisedSimplex::getPrimalTolerance() const
+{
+	return m_pImpl->getPrimalTolerance();
+}
+
+void RevisedSimplex::setDualTolerance( double f )
+{
+	m_pImpl->setDualTolerance( f );
+}
+
+double RevisedSimplex::getDualTolerance() const
+{
+	return m_pImpl->getDualTolerance();
+}
+
+void RevisedSimplex::setPerturbation( bool b )
+{
+	m_pImpl->setPerturbation( b );
+}
+
+bool RevisedSimplex::getPerturbation() const
+{
+	return m_pImpl->getPerturbation();
+}
+
+size_t RevisedSimplex::getIterationCount() const
+{
+	return m_pImpl->getIterationCount();
+}
+
+size_t RevisedSimplex::getPhaseOneIterationCount() const
+{
+	return m_pImpl->getPhaseOneIterationCount();
+}
+
 //---------------------------------------------------------------------------
 // BoundedRevisedSimplexImpl
 
@@ -726,21 +1773,22 @@ public:
 	~BoundedRevisedSimplexImpl();
 	
 	void solve();
+
+	void setPricing( PricingType e ) { m_ePricing = e; }
+	PricingType getPricing() const { return m_ePricing; }
+	void setLongStep( bool b ) { m_bLongStep = b; }
+	bool getLongStep() const { return m_bLongStep; }
+	void setPrimalTolerance( double f ) { m_fPrimalTol = f; }
+	double getPrimalTolerance() const { return m_fPrimalTol; }
+	void setDualTolerance( double f ) { m_fDualTol = f; }
+	double getDualTolerance() const { return m_fDualTol; }
+	void setPerturbation( bool b ) { m_bPerturbation = b; }
+	bool getPerturbation() const { return m_bPerturbation; }
+	size_t getIterationCount() const { return m_nIter; }
+	size_t getPhaseOneIterationCount() const { return m_nPhaseOneIter; }
 	
 private:
 
-	/**
-	 * This structure represents a variable boundary i.e. the position
-	 * (ID) of the corresponding variable, whether it is a upper boundary
-	 * or a lower boundary, and the value of the boundary.
-	 */
-	struct VarBoundary
-	{
-		size_t Id;
-		double Value;
-		BoundType BoundData;
-	};
-	
 	struct EnterBasicVar
 	{
 		size_t Id;
@@ -749,12 +1797,30 @@ private:
 	};
 
 	BoundedRevisedSimplex* m_pSelf;
+
+	PricingType m_ePricing;
+	bool m_bLongStep;
+
+	double m_fPrimalTol;
+	double m_fDualTol;
+	bool m_bPerturbation;
+	bool m_bPerturbAllowed;
+	bool m_bPerturbed;
+	size_t m_nDegenerateIter;
+	unsigned long m_nPerturbSeed;
+
+	/** edge weights for Devex and steepest edge pricing. */
+	PricingWeights m_aPricingWeights;
 	
 	Matrix m_mxBasicInv;
 	Matrix m_mxUpdateMatrix;
 	Matrix m_mxPriceVector;
 	Matrix m_mxX;
 	size_t m_nIter;
+	size_t m_nPhaseOneIter;
+
+	/** flags the artificial columns during phase one, empty otherwise. */
+	std::vector<bool> m_aArtificialVar;
 
 	Matrix m_mxA, m_mxB, m_mxC;
 	std::vector<bool> m_aBasicVar;
@@ -762,32 +1828,43 @@ private:
 	SizeTypeContainer m_aNonBasicVarId;
 	std::vector<size_t> m_aSkipBasicVarId;
 	std::vector<BoundType> m_aNonBasicVarBoundType;
+
+	/** slack column of each row, or NO_INDEX for an equality. */
+	std::vector<size_t> m_aSlackCol;
 	
 	std::auto_ptr<Model> m_pModel; // A copy of original model
 
 	Model* getModel() const { return m_pSelf->getModel(); }
 	
 	bool findInitialSolution();
-	bool buildInitialVars( vector<VarBoundary>& );
+	bool applyStartBasis();
+	const Basis buildBasis() const;
 	void initialize();
-	bool iterateVarBoundary( size_t, size_t, vector<VarBoundary>& );
 	bool isSolutionFeasible( const Matrix& ) const;
 	const Matrix solvePriceVector( const SizeTypeContainer&, const Matrix&, const Matrix& ) const;
 	
 	bool iterate();
 	bool queryEnteringNBVar( EnterBasicVar& );
-	void calculateNewX( const EnterBasicVar&, size_t&, Matrix& );
+	double calculateNewX( const EnterBasicVar&, size_t&, Matrix& );
+	void perturb();
+	void removePerturbation();
+	bool repairBasis( const vector<double>& );
 	void updateNBVars( const EnterBasicVar&, size_t );
 	void updateInverseBasicMatrix( const EnterBasicVar&, size_t, const Matrix& );
 	void printIterateHeader() const;
 	bool isPriceBoundEligible( const EnterBasicVar& ) const;
-	void getLambda( const Matrix&, const Matrix&, double&, size_t& ) const;
+	void getLambda( const Matrix&, const Matrix&, double&, size_t&, bool bSkipArtificial = false ) const;
+	void getLongStep( const Matrix&, const Matrix&, double&, size_t&, vector<size_t>& ) const;
+	void flipArtificialVars( const vector<size_t>&, Matrix& );
 
 };
 
 BoundedRevisedSimplexImpl::BoundedRevisedSimplexImpl( BoundedRevisedSimplex* p ) :
-	m_pSelf( p ), m_mxBasicInv( 0, 0 ), m_mxUpdateMatrix( 0, 0 ), m_mxPriceVector( 0, 0 ),
-	m_mxX( 0, 0 ), m_nIter( 0 ), m_mxA( 0, 0 ), m_mxB( 0, 0 ), m_mxC( 0, 0 )
+	m_pSelf( p ), m_ePricing( PRICING_DANTZIG ), m_bLongStep( true ),
+	m_fPrimalTol( DEFAULT_FEASIBILITY_TOL ), m_fDualTol( DEFAULT_FEASIBILITY_TOL ),
+	m_bPerturbation( true ), m_bPerturbAllowed( false ), m_bPerturbed( false ),
+	m_nDegenerateIter( 0 ), m_nPerturbSeed( 0 ), m_mxBasicInv( 0, 0 ), m_mxUpdateMatrix( 0, 0 ), m_mxPriceVector( 0, 0 ),
+	m_mxX( 0, 0 ), m_nIter( 0 ), m_nPhaseOneIter( 0 ), m_mxA( 0, 0 ), m_mxB( 0, 0 ), m_mxC( 0, 0 )
 {
 }
 
@@ -798,8 +1875,11 @@ BoundedRevisedSimplexImpl::~BoundedRevisedSimplexImpl()
 void BoundedRevisedSimplexImpl::solve()
 {
 	initialize();
+	m_nPhaseOneIter = 0;
+	m_bPerturbAllowed = false;
+	m_bPerturbed = false;
 
-	if ( !findInitialSolution() )
+	if ( !applyStartBasis() && !findInitialSolution() )
 	{
 		if ( m_pModel->getVerbose() )
 			cout << "Initial solution not found" << endl;
@@ -810,11 +1890,19 @@ void BoundedRevisedSimplexImpl::solve()
 		cout << "Initial solution found" << endl;
 
 	m_mxPriceVector = solvePriceVector( m_aBasicVarId, m_mxBasicInv, m_mxC );
+	m_aPricingWeights.reset( m_ePricing, m_mxA, m_mxBasicInv, m_aBasicVarId, m_aNonBasicVarId );
 
 	m_nIter = 0;
 	m_aSkipBasicVarId.clear();
+	m_bPerturbAllowed = m_bPerturbation;
+	m_nDegenerateIter = 0;
+	m_nPerturbSeed = 1;
 	
-	while ( !iterate() );
+	while ( !iterate() )
+	{
+		m_pSelf->getSolveControl()->checkIteration( m_nIter );
+		m_pSelf->getSolveControl()->reportIteration( m_nIter );
+	}
 	
 	Matrix mxSolution;
 	for ( size_t i = 0; i < m_pModel->getCostVector().cols(); ++i )
@@ -833,7 +1921,8 @@ void BoundedRevisedSimplexImpl::solve()
 		Debug( "Solution not feasible!?" );
 #endif
 
-	m_pSelf->setCanonicalSolution( mxSolution );
+	m_pSelf->setSolution( mxSolution );
+	m_pSelf->setBasis( buildBasis() );
 }
 
 void BoundedRevisedSimplexImpl::initialize()
@@ -848,7 +1937,7 @@ void BoundedRevisedSimplexImpl::initialize()
 	m_mxBasicInv.clear();
 	m_mxUpdateMatrix.clear();
 
-	auto_ptr<Model> ptr( new Model( *m_pSelf->getCanonicalModel() ) );
+	auto_ptr<Model> ptr( new Model( *m_pSelf->getModel() ) );
 	m_pModel = ptr; // Note: transfer of ownership
 
 	m_mxA = m_pModel->getConstraintMatrix();
@@ -866,9 +1955,12 @@ void BoundedRevisedSimplexImpl::initialize()
 	}
 
 	const size_t nRowSizeA = m_mxA.rows();
+	m_aSlackCol.assign( nRowSizeA, NO_INDEX );
 	for ( size_t i = 0; i < nRowSizeA; ++i )
 	{
 		EqualityType eEq = m_pModel->getEquality( i );
+		if ( eEq != EQUAL )
+			m_aSlackCol[i] = m_mxA.cols();
 		switch( eEq )
 		{
 		case LESS_EQUAL:
@@ -957,16 +2049,16 @@ bool BoundedRevisedSimplexImpl::isPriceBoundEligible( const EnterBasicVar& aVar
 		// A maximizing model requires either a lower-bounded non-basic with a 
 		// positive price or a upper-bounded non-basic with a negative price.
 
-		b = ( aVar.Price > 0.0 && aVar.BoundData == BOUND_LOWER ) ||
-			( aVar.Price < 0.0 && aVar.BoundData == BOUND_UPPER );
+		b = ( aVar.Price > m_fDualTol && aVar.BoundData == BOUND_LOWER ) ||
+			( aVar.Price < -m_fDualTol && aVar.BoundData == BOUND_UPPER );
 		break;
 
 	case GOAL_MINIMIZE:
 		// A minimizing model requires a lower-bounded non-basic with a negative 
 		// price or an upper-bounded non-basic with a positive price.
 
-		b = ( aVar.Price < 0.0 && aVar.BoundData == BOUND_LOWER ) ||
-			( aVar.Price > 0.0 && aVar.BoundData == BOUND_UPPER );
+		b = ( aVar.Price < -m_fDualTol && aVar.BoundData == BOUND_LOWER ) ||
+			( aVar.Price > m_fDualTol && aVar.BoundData == BOUND_UPPER );
 		break;
 	default:
 		OSL_ASSERT( !"wrong goal" );
@@ -975,58 +2067,143 @@ bool BoundedRevisedSimplexImpl::isPriceBoundEligible( const EnterBasicVar& aVar
 	return b;
 }
 
+/**
+ * Harris two-pass ratio test.  The first pass finds the largest step along
+ * dX for which no variable leaves its bounds by more than the primal
+ * tolerance.  The second pass picks, among the variables that block
+ * within that step, the one with the largest change, and the step is its
+ * exact ratio.  The entering variable itself is included, in which case
+ * the step is a bound flip.
+ *
+ * @param rLambda step length
+ * @param rLeaveVarId blocking variable, or NO_INDEX when nothing blocks,
+ *                    i.e. the model is unbounded in this direction.
+ * @param bSkipArtificial if true, the artificial variables of phase one
+ *                        do not block.
+ */
 void BoundedRevisedSimplexImpl::getLambda( const Matrix& X, const Matrix& dX, 
-		double& rLambda, size_t& rLeaveVarId ) const
+		double& rLambda, size_t& rLeaveVarId, bool bSkipArtificial ) const
 {
 	OSL_ASSERT( X.rows() == dX.rows() );
-	double fLmdPos = 0.0, fLmdNeg = 0.0, fLmd = 0.0;
-	size_t nId;
-	
+
+	// Exact ratio and ratio with the bound relaxed by the tolerance, of
+	// every blocking variable.
+	vector<size_t> aId;
+	vector<double> aRatio;
+	double fMaxLmd = 0.0;
 	for ( size_t i = 0; i < X.rows(); ++i )
 	{
+		if ( bSkipArtificial && i < m_aArtificialVar.size() && m_aArtificialVar[i] )
+			continue;
+
 		double fXVal  = X( i, 0 );
 		double fdXVal = dX( i, 0 );
-		if ( fdXVal > 0.0 && m_pModel->isVarBounded( i, BOUND_UPPER ) )
+		double fTmp;
+		if ( fdXVal > PIVOT_TOL && m_pModel->isVarBounded( i, BOUND_UPPER ) )
+			fTmp = ( m_pModel->getVarBound( i, BOUND_UPPER ) - fXVal ) / fdXVal;
+		else if ( fdXVal < -PIVOT_TOL && m_pModel->isVarBounded( i, BOUND_LOWER ) )
+			fTmp = ( fXVal - m_pModel->getVarBound( i, BOUND_LOWER ) ) / ( fdXVal*(-1) );
+		else
+			continue;
+
+		double fRelaxed = fTmp + m_fPrimalTol/::std::fabs( fdXVal );
+		if ( aId.empty() || fRelaxed < fMaxLmd )
+			fMaxLmd = fRelaxed;
+		aId.push_back( i );
+		aRatio.push_back( fTmp );
+	}
+
+	double fLmd = 0.0, fPivot = 0.0;
+	size_t nId = NO_INDEX;
+	for ( size_t k = 0; k < aId.size(); ++k )
+	{
+		double fAbsdX = ::std::fabs( dX( aId[k], 0 ) );
+		if ( aRatio[k] <= fMaxLmd && fAbsdX > fPivot )
 		{
-			// dX positive
-			double fUpper = m_pModel->getVarBound( i, BOUND_UPPER );
-			double fTmp = ( fUpper - fXVal ) / fdXVal;
-			if ( ( fLmdPos != 0.0 && fLmdPos > fTmp ) || fLmdPos == 0.0 )
-			{
-				cout << "pos: " << fTmp << " " << i << endl;
-				fLmdPos = fTmp;
-			}
+			fLmd = ::std::max( aRatio[k], 0.0 );
+			fPivot = fAbsdX;
+			nId = aId[k];
 		}
-		else if ( fdXVal < 0.0 && m_pModel->isVarBounded( i, BOUND_LOWER ) )
+	}
+	rLambda = fLmd;
+	rLeaveVarId = nId;
+}
+
+/**
+ * Long-step ratio test of phase one.  The phase one objective is the sum
+ * of the artificial variables, and an artificial variable that would go
+ * negative can equally be taken with its sign reversed, as its column is a
+ * unit vector.  The objective is then piecewise linear along dX, with a
+ * breakpoint where each decreasing basic artificial variable reaches zero,
+ * and its slope grows by twice the rate of that variable at each
+ * breakpoint.  The step passes over breakpoints while the slope stays
+ * negative, and stops at the first one where it does not, or at the first
+ * ordinary bound, whichever comes first.
+ *
+ * @param rPassed artificial variables that pass through zero, and must have
+ *                their sign reversed after the step.
+ */
+void BoundedRevisedSimplexImpl::getLongStep( const Matrix& X, const Matrix& dX, 
+		double& rLambda, size_t& rLeaveVarId, vector<size_t>& rPassed ) const
+{
+	double fHardLmd;
+	size_t nHardId;
+	getLambda( X, dX, fHardLmd, nHardId, true );
+
+	double fSlope = 0.0;
+	vector< ::std::pair<double, size_t> > aBreakpoints;
+	for ( size_t i = 0; i < X.rows(); ++i )
+	{
+		fSlope += m_mxC( 0, i )*dX( i, 0 );
+		if ( i < m_aArtificialVar.size() && m_aArtificialVar[i] && dX( i, 0 ) < -PIVOT_TOL )
 		{
-			// dX negative
-			double fLower = m_pModel->getVarBound( i, BOUND_LOWER );
-			double fTmp = ( fXVal - fLower ) / ( fdXVal*(-1) );
-			if ( ( fLmdNeg != 0.0 && fLmdNeg > fTmp ) || fLmdNeg == 0.0 )
-			{
-				cout << "neg: " << fTmp << " " << i << endl;
-				fLmdNeg = fTmp;
-			}
+			double fLmd = ::std::max( X( i, 0 ), 0.0 )/( dX( i, 0 )*(-1) );
+			if ( nHardId == NO_INDEX || fLmd <= fHardLmd )
+				aBreakpoints.push_back( ::std::make_pair( fLmd, i ) );
 		}
-		
-		double fLmdTmp;
-		if ( fLmdPos != 0.0 && fLmdNeg != 0.0 )
-			fLmdTmp = min( fLmdPos, fLmdNeg );
-		else if ( fLmdPos != 0.0 )
-			fLmdTmp = fLmdPos;
-		else if ( fLmdNeg != 0.0 )
-			fLmdTmp = fLmdNeg;
-		else
-			fLmdTmp = 0.0;
-			
-		if ( ( fLmdTmp != 0.0 && fLmdTmp < fLmd ) || fLmd == 0.0 )
+	}
+	sort( aBreakpoints.begin(), aBreakpoints.end() );
+
+	rPassed.clear();
+	for ( size_t k = 0; k < aBreakpoints.size(); ++k )
+	{
+		size_t nId = aBreakpoints[k].second;
+		fSlope += 2.0*dX( nId, 0 )*(-1);
+		if ( fSlope >= -m_fDualTol )
 		{
-			fLmd = fLmdTmp;
-			nId = i;
+			rLambda = aBreakpoints[k].first;
+			rLeaveVarId = nId;
+			return;
 		}
+		rPassed.push_back( nId );
 	}
-	std::swap( fLmd, rLambda );
-	std::swap( nId, rLeaveVarId );
+	rLambda = fHardLmd;
+	rLeaveVarId = nHardId;
+}
+
+/**
+ * Reverse the sign of the given basic artificial variables after a long
+ * step has taken them through zero.  Negating a basic column negates the
+ * corresponding row of the basis inverse and of the step direction.
+ */
+void BoundedRevisedSimplexImpl::flipArtificialVars( const vector<size_t>& aVarId, Matrix& mxDX )
+{
+	for ( size_t k = 0; k < aVarId.size(); ++k )
+	{
+		size_t nVarId = aVarId[k];
+		SizeTypeContainer::iterator itrBeg = m_aBasicVarId.begin(),
+			itr = find( itrBeg, m_aBasicVarId.end(), nVarId );
+		OSL_ASSERT( itr != m_aBasicVarId.end() );
+		size_t nRow = distance( itrBeg, itr );
+		for ( size_t i = 0; i < m_mxA.rows(); ++i )
+			m_mxA( i, nVarId ) *= -1.0;
+		for ( size_t i = 0; i < m_mxBasicInv.cols(); ++i )
+			m_mxBasicInv( nRow, i ) *= -1.0;
+		m_mxX( nVarId, 0 ) = ::std::max( -m_mxX( nVarId, 0 ), 0.0 );
+		mxDX( nVarId, 0 ) *= -1.0;
+	}
+	if ( !aVarId.empty() )
+		m_mxPriceVector = solvePriceVector( m_aBasicVarId, m_mxBasicInv, m_mxC );
 }
 
 bool BoundedRevisedSimplexImpl::iterate()
@@ -1036,18 +2213,227 @@ bool BoundedRevisedSimplexImpl::iterate()
 
 	EnterBasicVar aEnterVar; // Entering basic variable (ID, Price and BoundType)
 	if ( queryEnteringNBVar( aEnterVar ) )
-		return true;
+	{
+		if ( !m_bPerturbed )
+			return true;
+
+		// Optimal for the perturbed model.  Restore the true values of the
+		// basic variables and carry on from there.
+		removePerturbation();
+		return false;
+	}
 
 	size_t nLeaveVarId;	// Leaving basic variable ID
 	Matrix mxDX;
-	calculateNewX( aEnterVar, nLeaveVarId, mxDX );
+	double fLambda = calculateNewX( aEnterVar, nLeaveVarId, mxDX );
+	m_aPricingWeights.update( aEnterVar.Id, nLeaveVarId, m_mxA, m_mxBasicInv,
+							  m_aBasicVarId, m_aNonBasicVarId );
 	updateNBVars( aEnterVar, nLeaveVarId );
 	updateInverseBasicMatrix( aEnterVar, nLeaveVarId, mxDX );
 
 	++m_nIter;
+
+	if ( fLambda*::std::fabs( mxDX( nLeaveVarId, 0 ) ) > m_fPrimalTol )
+		m_nDegenerateIter = 0;
+	else if ( ++m_nDegenerateIter >= PERTURB_AFTER && m_bPerturbAllowed )
+		perturb();
 	return false;
 }
 
+/**
+ * Move every basic variable into the interior of its bounds by a small
+ * random amount, which amounts to perturbing the right hand side, so that
+ * the following iterations are no longer degenerate.  The perturbation is
+ * bounded by PERTURB_SCALE relative to the values, never goes past the
+ * middle of a range, and is applied at most once per solve.
+ */
+void BoundedRevisedSimplexImpl::perturb()
+{
+	if ( m_pModel->getVerbose() )
+		cout << "perturbing after " << m_nDegenerateIter << " degenerate iterations" << endl;
+
+	SizeTypeContainer::const_iterator itr, itrEnd = m_aBasicVarId.end();
+	for ( itr = m_aBasicVarId.begin(); itr != itrEnd; ++itr )
+	{
+		size_t nId = *itr;
+		bool bLower = m_pModel->isVarBounded( nId, BOUND_LOWER );
+		bool bUpper = m_pModel->isVarBounded( nId, BOUND_UPPER );
+		if ( !bLower && !bUpper )
+			continue;
+
+		double fVal = m_mxX( nId, 0 );
+		double fDelta = lcl_nextPerturbation( m_nPerturbSeed, fVal );
+		if ( bLower && bUpper )
+		{
+			double fLower = m_pModel->getVarBound( nId, BOUND_LOWER );
+			double fUpper = m_pModel->getVarBound( nId, BOUND_UPPER );
+			fDelta = ::std::min( fDelta, 0.5*( fUpper - fLower ) );
+			if ( fUpper - fVal < fVal - fLower )
+				fDelta *= -1.0;
+		}
+		else if ( bUpper )
+			fDelta *= -1.0;
+		m_mxX( nId, 0 ) = fVal + fDelta;
+	}
+
+	m_bPerturbed = true;
+	m_bPerturbAllowed = false;
+	m_nDegenerateIter = 0;
+}
+
+/**
+ * Recompute the basic variables from the unperturbed right hand side.  If
+ * they are within their bounds, the iteration carries on from the same
+ * basis.  Otherwise the basis is repaired by a phase one that starts from
+ * it (see repairBasis).
+ */
+void BoundedRevisedSimplexImpl::removePerturbation()
+{
+	m_bPerturbed = false;
+
+	Matrix mxNonBasicX( m_mxX );
+	SizeTypeContainer::const_iterator itr, itrBeg = m_aBasicVarId.begin(),
+		itrEnd = m_aBasicVarId.end();
+	for ( itr = itrBeg; itr != itrEnd; ++itr )
+		mxNonBasicX( *itr, 0 ) = 0.0;
+	Matrix mxBaseX( m_mxBasicInv*( m_mxB - m_mxA*mxNonBasicX ) );
+
+	// Clip the basic variables to their bounds, and keep the amount each
+	// one is clipped by.
+	vector<double> aExcess( m_aBasicVarId.size(), 0.0 );
+	bool bFeasible = true;
+	for ( itr = itrBeg; itr != itrEnd; ++itr )
+	{
+		size_t nId = *itr, nRow = distance( itrBeg, itr );
+		double fVal = mxBaseX( nRow, 0 );
+		if ( m_pModel->isVarBounded( nId, BOUND_LOWER ) )
+		{
+			double fBound = m_pModel->getVarBound( nId, BOUND_LOWER );
+			bFeasible = bFeasible && fVal >= fBound - m_fPrimalTol;
+			fVal = ::std::max( fVal, fBound );
+		}
+		if ( m_pModel->isVarBounded( nId, BOUND_UPPER ) )
+		{
+			double fBound = m_pModel->getVarBound( nId, BOUND_UPPER );
+			bFeasible = bFeasible && fVal <= fBound + m_fPrimalTol;
+			fVal = ::std::min( fVal, fBound );
+		}
+		aExcess[nRow] = mxBaseX( nRow, 0 ) - fVal;
+		m_mxX( nId, 0 ) = fVal;
+	}
+
+	if ( !bFeasible )
+	{
+		if ( m_pModel->getVerbose() )
+			cout << "basis infeasible without perturbation, repairing it" << endl;
+		if ( !repairBasis( aExcess ) )
+			throw ModelInfeasible();
+		m_mxPriceVector = solvePriceVector( m_aBasicVarId, m_mxBasicInv, m_mxC );
+		m_aPricingWeights.reset( m_ePricing, m_mxA, m_mxBasicInv, m_aBasicVarId, m_aNonBasicVarId );
+	}
+	else if ( m_pModel->getVerbose() )
+		cout << "perturbation removed" << endl;
+}
+
+/**
+ * Restore feasibility of the current basis after its basic variables have
+ * been clipped to their bounds.  The clipped amounts d make up the single
+ * artificial column B d, which takes the residual of the rows at a value
+ * of one.  It replaces the basic variable clipped the most, which stays at
+ * its bound, and phase one then drives it to zero from the rest of the
+ * basis.  The artificial column is dropped again when it ends non-basic,
+ * and fixed at zero like those of findInitialSolution otherwise.
+ *
+ * @param aExcess amount by which each basic variable was clipped.
+ *
+ * @return bool true if a feasible basis is found, false if the model is
+ *         infeasible.
+ */
+bool BoundedRevisedSimplexImpl::repairBasis( const vector<double>& aExcess )
+{
+	const size_t nRowCount = m_mxA.rows(), nArtCol = m_mxA.cols();
+
+	size_t nPivotRow = 0;
+	for ( size_t i = 1; i < aExcess.size(); ++i )
+		if ( ::std::fabs( aExcess[i] ) > ::std::fabs( aExcess[nPivotRow] ) )
+			nPivotRow = i;
+	double fPivot = aExcess[nPivotRow];
+
+	SizeTypeContainer::iterator itr, itrBeg = m_aBasicVarId.begin(), itrEnd = m_aBasicVarId.end();
+	for ( size_t i = 0; i < nRowCount; ++i )
+	{
+		double fVal = 0.0;
+		for ( itr = itrBeg; itr != itrEnd; ++itr )
+			fVal += m_mxA( i, *itr )*aExcess[distance( itrBeg, itr )];
+		m_mxA( i, nArtCol ) = fVal;
+	}
+	m_pModel->setVarBound( nArtCol, BOUND_LOWER, 0.0 );
+	m_mxX( nArtCol, 0 ) = 1.0;
+
+	// B^-1 B d = d, so the new inverse takes one eta update.
+	Matrix mxE( nRowCount, nRowCount, true );
+	for ( size_t i = 0; i < nRowCount; ++i )
+		mxE( i, nPivotRow ) = i == nPivotRow ? 1.0/fPivot : -aExcess[i]/fPivot;
+	m_mxBasicInv = mxE*m_mxBasicInv;
+
+	itr = itrBeg;
+	advance( itr, nPivotRow );
+	size_t nLeaveVarId = *itr;
+	*itr = nArtCol;
+	m_aNonBasicVarId.push_back( nLeaveVarId );
+	m_aNonBasicVarBoundType.push_back( fPivot < 0.0 ? BOUND_LOWER : BOUND_UPPER );
+
+	// Phase one: minimize the artificial variable.
+	Matrix mxC( m_mxC );
+	const GoalType eGoal = m_pModel->getGoal();
+	m_mxC = Matrix( 1, m_mxA.cols() );
+	m_mxC( 0, nArtCol ) = 1.0;
+	m_pModel->setGoal( GOAL_MINIMIZE );
+	m_aArtificialVar.assign( m_mxA.cols(), false );
+	m_aArtificialVar[nArtCol] = true;
+
+	m_mxPriceVector = solvePriceVector( m_aBasicVarId, m_mxBasicInv, m_mxC );
+	m_aPricingWeights.reset( m_ePricing, m_mxA, m_mxBasicInv, m_aBasicVarId, m_aNonBasicVarId );
+	size_t nIter = m_nIter;
+	while ( !iterate() )
+	{
+		m_pSelf->getSolveControl()->checkIteration( m_nIter );
+		m_pSelf->getSolveControl()->reportIteration( m_nIter );
+	}
+	m_nPhaseOneIter += m_nIter - nIter;
+	m_aArtificialVar.clear();
+	m_pModel->setGoal( eGoal );
+	m_mxC = mxC;
+
+	double fTol = 0.0;
+	for ( size_t i = 0; i < nRowCount; ++i )
+		fTol = ::std::max( fTol, ::std::fabs( m_mxB( i, 0 ) ) );
+	fTol = 1e-9*( 1.0 + fTol );
+	double fInfeasibility = m_mxX( nArtCol, 0 );
+	m_mxX( nArtCol, 0 ) = 0.0;
+
+	itrBeg = m_aNonBasicVarId.begin();
+	itr = find( itrBeg, m_aNonBasicVarId.end(), nArtCol );
+	if ( itr != m_aNonBasicVarId.end() )
+	{
+		BoundIter itrBound = m_aNonBasicVarBoundType.begin();
+		advance( itrBound, distance( itrBeg, itr ) );
+		m_aNonBasicVarBoundType.erase( itrBound );
+		m_aNonBasicVarId.erase( itr );
+		m_mxA.resize( nRowCount, nArtCol );
+		m_mxX.resize( nArtCol, 1 );
+	}
+	else
+	{
+		m_pModel->setVarBound( nArtCol, BOUND_UPPER, 0.0 );
+		m_mxC.resize( 1, m_mxA.cols() );
+	}
+
+	if ( m_pModel->getVerbose() )
+		cout << "basis repair: " << m_nIter - nIter << " iterations, infeasibility " << fInfeasibility << endl;
+	return fInfeasibility <= fTol;
+}
+
 /**
  * This method determines an entering non-basic (NB) variable if any. If
  * there is no entering non-basic, then that means an optimum solution is
@@ -1091,12 +2477,22 @@ bool BoundedRevisedSimplexImpl::queryEnteringNBVar( EnterBasicVar& rEnterVar )
 		aVar.Price = m_mxC( 0, nId ) - 
 				( m_mxPriceVector*m_mxA.getColumn( nId ) ).operator()( 0, 0 );
 
+		// A free non-basic variable may move in either direction.
+		if ( !m_pModel->isVarBounded( nId, BOUND_LOWER ) &&
+			 !m_pModel->isVarBounded( nId, BOUND_UPPER ) )
+		{
+			aVar.BoundData = BOUND_LOWER;
+			if ( !isPriceBoundEligible( aVar ) )
+				aVar.BoundData = BOUND_UPPER;
+		}
+
 		if ( getModel()->getVerbose() )
 			cout << "c(" << aVar.Id << ") = " << aVar.Price << endl;
 		aEnterBasicVars.push_back( aVar );
 	}
 
 	bool bFirstEnterVarFound = false;		
+	double fBestMerit = 0.0;
 	itrBeg = aEnterBasicVarId.begin();
 	itrEnd = aEnterBasicVarId.end();
 	for ( itr = itrBeg; itr != itrEnd; ++itr )
@@ -1107,13 +2503,18 @@ bool BoundedRevisedSimplexImpl::queryEnteringNBVar( EnterBasicVar& rEnterVar )
 		
 		if ( isPriceBoundEligible( aVar ) )
 		{
+			double fMerit = m_aPricingWeights.getMerit( ::std::fabs( aVar.Price ), aVar.Id );
 			if ( !bFirstEnterVarFound )
 			{
 				bFirstEnterVarFound = true;
 				rEnterVar = aVar;
+				fBestMerit = fMerit;
 			}
-			else if ( abs( rEnterVar.Price ) < abs( aVar.Price ) )
+			else if ( fBestMerit < fMerit )
+			{
 				rEnterVar = aVar;
+				fBestMerit = fMerit;
+			}
 		}
 	}
 	
@@ -1123,6 +2524,12 @@ bool BoundedRevisedSimplexImpl::queryEnteringNBVar( EnterBasicVar& rEnterVar )
 			cout << "Optimum solution reached" << endl;
 		return true;
 	}
+
+	// Record the direction picked for a free variable.
+	BoundIter itrBound = m_aNonBasicVarBoundType.begin();
+	for ( itr = m_aNonBasicVarId.begin(); itr != m_aNonBasicVarId.end(); ++itr, ++itrBound )
+		if ( *itr == rEnterVar.Id )
+			*itrBound = rEnterVar.BoundData;
 	return false;
 }
 
@@ -1131,7 +2538,7 @@ bool BoundedRevisedSimplexImpl::queryEnteringNBVar( EnterBasicVar& rEnterVar )
  * lambda, and leaving non-basic variable.  It then calculates a new X from
  * them.
  */
-void BoundedRevisedSimplexImpl::calculateNewX( const EnterBasicVar& aEnterVar,
+double BoundedRevisedSimplexImpl::calculateNewX( const EnterBasicVar& aEnterVar,
 		size_t& nLeaveVarId, Matrix& mxDX )
 {
 	Matrix mxB = m_mxA.getColumn( aEnterVar.Id );
@@ -1176,9 +2583,13 @@ void BoundedRevisedSimplexImpl::calculateNewX( const EnterBasicVar& aEnterVar,
 	}
 
 	double fLambda;
-	getLambda( m_mxX, dX, fLambda, nLeaveVarId );
+	vector<size_t> aPassed;
+	if ( m_bLongStep && !m_aArtificialVar.empty() )
+		getLongStep( m_mxX, dX, fLambda, nLeaveVarId, aPassed );
+	else
+		getLambda( m_mxX, dX, fLambda, nLeaveVarId );
 
-	if ( fLambda == 0.0 )
+	if ( nLeaveVarId == NO_INDEX )
 	{
 		if ( m_pModel->getVerbose() )
 			cout << "Unbounded model with no solution";
@@ -1189,8 +2600,18 @@ void BoundedRevisedSimplexImpl::calculateNewX( const EnterBasicVar& aEnterVar,
 		cout << "lambda = " << fLambda << "  x_" << nLeaveVarId << " leaves and x_"
 			 << aEnterVar.Id << " enters" << endl;
 
+	if ( m_pModel->getVerbose() && !aPassed.empty() )
+		cout << aPassed.size() << " artificial variable(s) passed through zero" << endl;
+
 	m_mxX += dX*fLambda;
+
+	// Put the leaving variable exactly on the bound it has reached.
+	m_mxX( nLeaveVarId, 0 ) = m_pModel->getVarBound( nLeaveVarId, 
+		dX( nLeaveVarId, 0 ) > 0.0 ? BOUND_UPPER : BOUND_LOWER );
+
+	flipArtificialVars( aPassed, dX );
 	mxDX = dX;
+	return fLambda;
 }
 
 /** Given entering and leaving basic variables, update corresponding member containers 
@@ -1280,221 +2701,273 @@ void BoundedRevisedSimplexImpl::updateInverseBasicMatrix( const EnterBasicVar& a
 }
 
 /**
- * The goal of this method is to find a good feasible point to start from.
- * Such feasible point must satisfy all variable boundaries and
- * constraints.
- * 
- * @return bool
+ * Set up the initial basis and solution from the start basis of the
+ * algorithm, if there is one.  A row at either bound has its slack
+ * non-basic at zero.
+ *
+ * @return bool true if the start basis was applied, or false if there is
+ *         none or it does not yield a feasible basis of this model.
  */
-bool BoundedRevisedSimplexImpl::findInitialSolution()
+bool BoundedRevisedSimplexImpl::applyStartBasis()
 {
-	m_pModel->print();
-	size_t nNumInitNonBasic = m_mxA.cols() - m_mxB.rows();
-	if ( m_pModel->getVerbose() )
+	const Basis aBasis = m_pSelf->getStartBasis();
+	size_t nVarCount = m_pSelf->getModel()->getCostVector().cols();
+	size_t nRowCount = m_mxA.rows();
+	if ( aBasis.empty() || aBasis.getVarCount() != nVarCount ||
+		 aBasis.getRowCount() != nRowCount )
+		return false;
+
+	vector<BasisStatus> aStatus( m_mxA.cols(), BASIS_LOWER );
+	for ( size_t j = 0; j < nVarCount; ++j )
+		aStatus[j] = aBasis.getVarStatus( j );
+	for ( size_t i = 0; i < nRowCount; ++i )
 	{
-		const string line = repeatString( "-", 70 );
-		cout << endl << line << endl;
-		cout << "Initial solution search" << endl << line << endl;
-		cout << "nNumInitNonBasic = " << nNumInitNonBasic << endl;
+		BasisStatus eStatus = aBasis.getRowStatus( i );
+		if ( m_aSlackCol[i] != NO_INDEX )
+			aStatus[m_aSlackCol[i]] = eStatus == BASIS_BASIC ? BASIS_BASIC : BASIS_LOWER;
+		else if ( eStatus == BASIS_BASIC )
+			return false;
 	}
 
-	vector<VarBoundary> aArray;
-	return iterateVarBoundary( 0, nNumInitNonBasic, aArray );
-}
-
-/**
- * Go through all individual elements in a given array containing initial
- * non-basic (NB) variables with boundary values.  It is a precondition that
- * by the time this method gets called the array already contains the exact
- * number of bounded non-basic variables needed to start iteration.
- * 
- * As I go through the elements, I need to keep track of the sum of
- * (constraint coefficient) x (NB variable value) for each constraint row
- * as a vector (i.e. one-dimentional matrix), and subtract it from the RHS
- * vector in the end in order to solve for a set of initial basic variables.
- * 
- * It may be necessary to check for its feasiblity after the values of the
- * basic variables are computed if one or more of these basic variables
- * happen to be bounded, otherwise no feasiblity check is necessary.
- * 
- * @param aArray array containing all initial non-basic variables and their
- *               attributes.
- * 
- * @return bool true if intial solution is found, false otherwise.
- */
-bool BoundedRevisedSimplexImpl::buildInitialVars( vector<VarBoundary>& cnNonBasic )
-{
-	Debug( "buildInitialVars" );
-	Debug( "mxA" );
-	m_mxA.print();
-	Debug( "mxB" );
-	m_mxB.print();
-	Debug( "mxC" );
-	m_mxC.print();
-
-	size_t nCostSize = m_mxC.cols();
-
-	std::list<size_t> cnBasicId; // permutation of basic variable IDs
-	for ( size_t i = 0; i < nCostSize; ++i )
-		cnBasicId.push_back( i );
-
-	Matrix mxInitX( nCostSize, 1 );
-
-	Debug( "All IDs: " );
-	printElements( cnBasicId );
+	SizeTypeContainer cnBasicId, cnNBColId;
+	vector<BoundType> cnNBBoundType;
+	Matrix mxX( m_mxA.cols(), 1 );
+	Matrix mxLHSSum( nRowCount, 1 );
+	for ( size_t j = 0; j < aStatus.size(); ++j )
+	{
+		if ( aStatus[j] == BASIS_BASIC )
+		{
+			cnBasicId.push_back( j );
+			continue;
+		}
 
-	Matrix mxLHSSum( m_mxA.rows(), 1 ); // matrix to keep track of left-hand-side sums
-	SizeTypeContainer cnNBColId;        // non-basic variable IDs
-	std::vector<BoundType> cnNBBoundType;   // non-basic bound type
-	cout << "NonBasicID: ";
+		// A non-basic variable must sit at one of its bounds.
+		BoundType eBound = aStatus[j] == BASIS_UPPER ? BOUND_UPPER : BOUND_LOWER;
+		if ( !m_pModel->isVarBounded( j, eBound ) )
+			return false;
 
-	std::vector<VarBoundary>::const_iterator itr, 
-		itrBeg = cnNonBasic.begin(), itrEnd = cnNonBasic.end();
-	for ( itr = itrBeg; itr != itrEnd; ++itr )
-	{
-		double fNBVal = itr->Value;
-		size_t nColId = itr->Id;
-		cout << nColId << " ";
-		mxInitX( nColId, 0 ) = fNBVal;
-		cnNBBoundType.push_back( itr->BoundData );
-		cnNBColId.push_back( nColId );
-		cnBasicId.remove( nColId );
-		for ( size_t nRowId = 0; nRowId < m_mxA.rows(); ++nRowId )
-			mxLHSSum( nRowId, 0 ) += m_mxA( nRowId, nColId ) * fNBVal;
+		double fVal = m_pModel->getVarBound( j, eBound );
+		mxX( j, 0 ) = fVal;
+		cnNBColId.push_back( j );
+		cnNBBoundType.push_back( eBound );
+		for ( size_t i = 0; i < nRowCount; ++i )
+			mxLHSSum( i, 0 ) += m_mxA( i, j )*fVal;
 	}
-	cout << endl;
 
-	Debug( "Basic IDs: " );
-	printElements( cnBasicId );
+	if ( cnBasicId.size() != nRowCount )
+		return false;
 
 	Matrix mxBasic( m_mxA );
-	mxBasic.deleteColumns( toVector<SizeTypeContainer, size_t>(cnNBColId) );
-
-	// Now solve for initial basic variables (mxX).
-	Matrix mxBasicInv = mxBasic.inverse();
-	Matrix mxNewRHS = m_mxB - mxLHSSum;
-	Matrix mxBaseX = mxBasicInv*mxNewRHS;
-
-	mxBasic.print();
-	mxLHSSum.print();
-	Debug( "initial basic variable:" );
-	mxBaseX.print();
-
-	// Transfer basic variables into initial X vector.  For each variable,
-	// make sure that the value satisfies its boundary condition if it's
-	// bounded.
-
-	// TODO: Find a way to back-track if an initial basic variable does not
-	// satisfy its boundary condition.
-
-	std::list<size_t>::const_iterator itrLt, 
-		itrLtBeg = cnBasicId.begin(), itrLtEnd = cnBasicId.end();
-	for ( itrLt = itrLtBeg; itrLt != itrLtEnd; ++itrLt )
+	mxBasic.deleteColumns( vector<size_t>( cnNBColId.begin(), cnNBColId.end() ) );
+	Matrix mxBasicInv( 0, 0 );
+	try
+	{
+		mxBasicInv = mxBasic.inverse();
+	}
+	catch ( const SingularMatrix& )
 	{
-		size_t nVarId = *itrLt;
-		double fBaseVal = mxBaseX( distance( itrLtBeg, itrLt ), 0 );
+		return false;
+	}
 
-		// check lower boundary condition
+	// The basic variables must be within their bounds.
+	Matrix mxBaseX = mxBasicInv*( m_mxB - mxLHSSum );
+	SizeTypeContainer::const_iterator itr, itrBeg = cnBasicId.begin(), itrEnd = cnBasicId.end();
+	for ( itr = itrBeg; itr != itrEnd; ++itr )
+	{
+		size_t nVarId = *itr;
+		double fVal = mxBaseX( distance( itrBeg, itr ), 0 );
 		if ( m_pModel->isVarBounded( nVarId, BOUND_LOWER ) )
 		{
 			double fBound = m_pModel->getVarBound( nVarId, BOUND_LOWER );
-			if ( fBaseVal < fBound )
-			{
-				cout << nVarId << " basic variable (" << fBaseVal << ") < lower bound (" 
-					 << fBound << ")" << endl;
+			if ( fVal < fBound - 1e-9*( 1.0 + ::std::fabs( fBound ) ) )
 				return false;
-			}
+			fVal = ::std::max( fVal, fBound );
 		}
-
-		// check upper boundary condition
 		if ( m_pModel->isVarBounded( nVarId, BOUND_UPPER ) )
 		{
 			double fBound = m_pModel->getVarBound( nVarId, BOUND_UPPER );
-			if ( fBaseVal > fBound )
-			{
-				cout << nVarId << " basic variable (" << fBaseVal << ") > upper bound (" 
-					 << fBound << ")" << endl;
+			if ( fVal > fBound + 1e-9*( 1.0 + ::std::fabs( fBound ) ) )
 				return false;
-			}
+			fVal = ::std::min( fVal, fBound );
 		}
-		mxInitX( nVarId, 0 ) = fBaseVal;
+		mxX( nVarId, 0 ) = fVal;
 	}
 
-	Debug( "initial X:" );
-	mxInitX.trans().print();
-
-	m_mxX.swap( mxInitX );
+	m_mxX.swap( mxX );
 	m_mxBasicInv.swap( mxBasicInv );
 	swap( m_aBasicVarId, cnBasicId );
 	swap( m_aNonBasicVarId, cnNBColId );
 	swap( m_aNonBasicVarBoundType, cnNBBoundType );
-
 	return true;
 }
 
 /**
- * Iterate through all decision variables and pick up boundary
- * values to use as initial values, then check if the values are
- * feasible.
- * 
- * @param nIdx
- * @param nUpper
- * @param aArray
- * 
- * @return bool returns true if a feasible initial solution is found, else
- *         returns false.
+ * Translate the current basis into the terms of the original model, where
+ * a row whose slack is non-basic is at its bound.
  */
-bool BoundedRevisedSimplexImpl::iterateVarBoundary( size_t nIdx, size_t nUpper, 
-		vector<VarBoundary>& aArray )
-{	
-	if ( aArray.size() == nUpper )
+const Basis BoundedRevisedSimplexImpl::buildBasis() const
+{
+	size_t nVarCount = m_pSelf->getModel()->getCostVector().cols();
+	size_t nRowCount = m_mxA.rows();
+
+	vector<BasisStatus> aStatus( m_mxA.cols(), BASIS_BASIC );
+	SizeTypeContainer::const_iterator itr, itrBeg = m_aNonBasicVarId.begin(),
+		itrEnd = m_aNonBasicVarId.end();
+	for ( itr = itrBeg; itr != itrEnd; ++itr )
+		aStatus[*itr] = m_aNonBasicVarBoundType.at( distance( itrBeg, itr ) ) == BOUND_UPPER ?
+			BASIS_UPPER : BASIS_LOWER;
+
+	Basis aBasis( nVarCount, nRowCount );
+	for ( size_t j = 0; j < nVarCount; ++j )
+		aBasis.setVarStatus( j, aStatus[j] );
+
+	for ( size_t i = 0; i < nRowCount; ++i )
 	{
-		cout << "array size maxed: " << aArray.size() << endl;
-		return buildInitialVars( aArray );
+		size_t nSlack = m_aSlackCol[i];
+		if ( nSlack == NO_INDEX )
+			aBasis.setRowStatus( i, BASIS_LOWER );
+		else if ( aStatus[nSlack] == BASIS_BASIC )
+			aBasis.setRowStatus( i, BASIS_BASIC );
+		else
+			aBasis.setRowStatus( i, m_pModel->getEquality( i ) == LESS_EQUAL ? BASIS_UPPER : BASIS_LOWER );
 	}
+	return aBasis;
+}
 
-	if ( nIdx > m_mxC.cols() )
-		// Not enough non-basic variables found
-		return false;
+/**
+ * Find a feasible basis to start from by a bounded phase one.  Every
+ * column starts non-basic at one of its bounds, or at zero if it is free.
+ * Each row is then covered by its slack if the slack can absorb the
+ * residual of the row, and by an artificial variable otherwise.  Phase one
+ * minimizes the sum of the artificial variables with the same bounded
+ * iteration as phase two, so that non-basic variables move from bound to
+ * bound, and bound flips happen without a basis change.
+ *
+ * When phase one succeeds, the artificial variables are fixed at zero and
+ * stay in the model.  Any that are still basic leave the basis as soon as
+ * a pivot touches their row, and the remaining ones belong to redundant
+ * rows.
+ *
+ * @return bool true if a feasible basis is found, false if the model is
+ *         infeasible.
+ */
+bool BoundedRevisedSimplexImpl::findInitialSolution()
+{
+	const size_t nRowCount = m_mxA.rows(), nColCount = m_mxA.cols();
+	const bool bVerbose = m_pModel->getVerbose();
+	if ( bVerbose )
+	{
+		const string line = repeatString( "-", 70 );
+		cout << endl << line << endl;
+		cout << "Initial solution search" << endl << line << endl;
+	}
 
-	// Check both boundaries of a variable at the current ID, and if either 
-	// one is bounded, then get that value and its side and store it into 
-	// the array.
-	BoundType e[2] = { BOUND_LOWER, BOUND_UPPER };
-	for ( size_t i = 0; i < 2; ++i )
-		if ( m_pModel->isVarBounded( nIdx, e[i] ) )
+	Matrix mxX( nColCount, 1 );
+	vector<BoundType> aBoundType( nColCount, BOUND_LOWER );
+	for ( size_t j = 0; j < nColCount; ++j )
+	{
+		if ( m_pModel->isVarBounded( j, BOUND_LOWER ) )
+			mxX( j, 0 ) = m_pModel->getVarBound( j, BOUND_LOWER );
+		else if ( m_pModel->isVarBounded( j, BOUND_UPPER ) )
 		{
-			cout << "index: a" << nIdx << "a\tarray size: " << aArray.size() << "\t";
-			if ( i == 0 )
-				cout << "lower" << endl;
-			else
-				cout << "upper" << endl;
-			VarBoundary temp;
-			temp.Id = nIdx;
-			temp.Value = m_pModel->getVarBound( nIdx, e[i] );
-			temp.BoundData = e[i];
-			aArray.push_back( temp );
-			if ( m_pModel->getVerbose() )
-			{
-				cout << nIdx << " bounded at ";
-				if ( e[i] == BOUND_LOWER )
-					cout << "lower end";
-				else
-					cout <<	"upper end";
-				cout << " (" << temp.Value << ")" << endl;
-			}
-			break;
-#if 0
-			if ( iterateVarBoundary( nIdx+1, nUpper, aArray ) )
-				return true;
-			aArray.pop_back();
-#endif
+			mxX( j, 0 ) = m_pModel->getVarBound( j, BOUND_UPPER );
+			aBoundType[j] = BOUND_UPPER;
 		}
-		
-	return iterateVarBoundary( nIdx+1, nUpper, aArray );
-#if 0
-	return false;
-#endif
+	}
+	Matrix mxResidual( m_mxB - m_mxA*mxX );
+
+	vector<size_t> aArtificial;
+	vector<bool> aBasicVar( nColCount, false );
+	SizeTypeContainer cnBasicId;
+	Matrix mxBasicInv( nRowCount, nRowCount );
+	for ( size_t i = 0; i < nRowCount; ++i )
+	{
+		double fResidual = mxResidual( i, 0 );
+		size_t nSlack = m_aSlackCol[i];
+		if ( nSlack != NO_INDEX && m_mxA( i, nSlack )*fResidual >= 0.0 )
+		{
+			double fCoef = m_mxA( i, nSlack );
+			mxX( nSlack, 0 ) = fResidual/fCoef;
+			aBasicVar[nSlack] = true;
+			cnBasicId.push_back( nSlack );
+			mxBasicInv( i, i ) = 1.0/fCoef;
+		}
+		else
+		{
+			size_t nCol = m_mxA.cols();
+			double fCoef = fResidual >= 0.0 ? 1.0 : -1.0;
+			m_mxA( i, nCol ) = fCoef;
+			m_pModel->setVarBound( nCol, BOUND_LOWER, 0.0 );
+			mxX( nCol, 0 ) = ::std::fabs( fResidual );
+			aArtificial.push_back( nCol );
+			cnBasicId.push_back( nCol );
+			mxBasicInv( i, i ) = fCoef;
+		}
+	}
+
+	SizeTypeContainer cnNBColId;
+	vector<BoundType> cnNBBoundType;
+	for ( size_t j = 0; j < nColCount; ++j )
+		if ( !aBasicVar[j] )
+		{
+			cnNBColId.push_back( j );
+			cnNBBoundType.push_back( aBoundType[j] );
+		}
+
+	m_mxX.swap( mxX );
+	m_mxBasicInv.swap( mxBasicInv );
+	swap( m_aBasicVarId, cnBasicId );
+	swap( m_aNonBasicVarId, cnNBColId );
+	swap( m_aNonBasicVarBoundType, cnNBBoundType );
+
+	if ( bVerbose )
+		cout << "artificial variables: " << aArtificial.size() << endl;
+	if ( aArtificial.empty() )
+		return true;
+
+	// Phase one: minimize the sum of the artificial variables.
+	Matrix mxC( m_mxC );
+	const GoalType eGoal = m_pModel->getGoal();
+	m_mxC = Matrix( 1, m_mxA.cols() );
+	for ( size_t k = 0; k < aArtificial.size(); ++k )
+		m_mxC( 0, aArtificial[k] ) = 1.0;
+	m_pModel->setGoal( GOAL_MINIMIZE );
+
+	m_aArtificialVar.assign( m_mxA.cols(), false );
+	for ( size_t k = 0; k < aArtificial.size(); ++k )
+		m_aArtificialVar[aArtificial[k]] = true;
+
+	m_mxPriceVector = solvePriceVector( m_aBasicVarId, m_mxBasicInv, m_mxC );
+	m_aPricingWeights.reset( m_ePricing, m_mxA, m_mxBasicInv, m_aBasicVarId, m_aNonBasicVarId );
+	m_nIter = 0;
+	while ( !iterate() )
+	{
+		m_pSelf->getSolveControl()->checkIteration( m_nIter );
+		m_pSelf->getSolveControl()->reportIteration( m_nIter );
+	}
+	m_nPhaseOneIter = m_nIter;
+	m_aArtificialVar.clear();
+
+	m_pModel->setGoal( eGoal );
+	m_mxC = mxC;
+	m_mxC.resize( 1, m_mxA.cols() );
+
+	double fTol = 0.0;
+	for ( size_t i = 0; i < nRowCount; ++i )
+		fTol = ::std::max( fTol, ::std::fabs( m_mxB( i, 0 ) ) );
+	fTol = 1e-9*( 1.0 + fTol );
+	double fInfeasibility = 0.0;
+	for ( size_t k = 0; k < aArtificial.size(); ++k )
+	{
+		size_t nCol = aArtificial[k];
+		fInfeasibility += m_mxX( nCol, 0 );
+		m_mxX( nCol, 0 ) = 0.0;
+		m_pModel->setVarBound( nCol, BOUND_UPPER, 0.0 );
+	}
+
+	if ( bVerbose )
+		cout << "phase one: " << m_nIter << " iterations, infeasibility " << fInfeasibility << endl;
+	return fInfeasibility <= fTol;
 }
 
 bool BoundedRevisedSimplexImpl::isSolutionFeasible( const Matrix& mxX ) const
@@ -1551,5 +3024,65 @@ void BoundedRevisedSimplex::solve()
 	m_pImpl->solve();
 }
 
+void BoundedRevisedSimplex::setPricing( PricingType e )
+{
+	m_pImpl->setPricing( e );
+}
+
+PricingType BoundedRevisedSimplex::getPricing() const
+{
+	return m_pImpl->getPricing();
+}
+
+void BoundedRevisedSimplex::setLongStep( bool b )
+{
+	m_pImpl->setLongStep( b );
+}
+
+bool BoundedRevisedSimplex::getLongStep() const
+{
+	return m_pImpl->getLongStep();
+}
+
+void BoundedRevisedSimplex::setPrimalTolerance( double f )
+{
+	m_pImpl->setPrimalTolerance( f );
+}
+
+double BoundedRevisedSimplex::getPrimalTolerance() const
+{
+	return m_pImpl->getPrimalTolerance();
+}
+
+void BoundedRevisedSimplex::setDualTolerance( double f )
+{
+	m_pImpl->setDualTolerance( f );
+}
+
+double BoundedRevisedSimplex::getDualTolerance() const
+{
+	return m_pImpl->getDualTolerance();
+}
+
+void BoundedRevisedSimplex::setPerturbation( bool b )
+{
+	m_pImpl->setPerturbation( b );
+}
+
+bool BoundedRevisedSimplex::getPerturbation() const
+{
+	return m_pImpl->getPerturbation();
+}
+
+size_t BoundedRevisedSimplex::getIterationCount() const
+{
+	return m_pImpl->getIterationCount();
+}
+
+size_t BoundedRevisedSimplex::getPhaseOneIterationCount() const
+{
+	return m_pImpl->getPhaseOneIterationCount();
+}
+
 
-}}}}
+}}}
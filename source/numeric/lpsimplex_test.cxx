@@ -0,0 +1,667 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/lpsimplex.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/exception.hxx"
+#include "lptestutil.hxx"
+
+#include <vector>
+#include <cmath>
+#include <stdio.h>
+
+using namespace ::scsolver::numeric;
+using namespace ::scsolver::numeric::lp;
+using namespace ::scsolver::numeric::lp::test;
+using ::std::vector;
+
+namespace {
+
+void smallModels()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("small models\n");
+
+    {
+        // max 3x + 5y, x <= 4, 2y <= 12, 3x + 2y <= 18  ->  (2, 6), 36
+        Model model;
+        vector<double> cost(2);
+        cost[0] = 3;
+        cost[1] = 5;
+        model.setCostVector(cost);
+        model.setGoal(GOAL_MAXIMIZE);
+        model.setVarPositive(true);
+        addConstraint(model, 1, 0, LESS_EQUAL, 4);
+        addConstraint(model, 0, 2, LESS_EQUAL, 12);
+        addConstraint(model, 3, 2, LESS_EQUAL, 18);
+
+        RevisedSimplex algorithm;
+        algorithm.setModel(&model);
+        algorithm.solve();
+        Matrix sol = algorithm.getSolution();
+        sol.trans().print();
+        check(::std::fabs(sol(0, 0) - 2.0) < 1e-12 && ::std::fabs(sol(1, 0) - 6.0) < 1e-12,
+              "maximize with slack basis");
+    }
+
+    {
+        // min 2x + 3y, x + y >= 4, x + 3y >= 6  ->  (3, 1), 9
+        Model model;
+        vector<double> cost(2);
+        cost[0] = 2;
+        cost[1] = 3;
+        model.setCostVector(cost);
+        model.setGoal(GOAL_MINIMIZE);
+        model.setVarPositive(true);
+        addConstraint(model, 1, 1, GREATER_EQUAL, 4);
+        addConstraint(model, 1, 3, GREATER_EQUAL, 6);
+
+        RevisedSimplex algorithm;
+        algorithm.setModel(&model);
+        algorithm.solve();
+        Matrix sol = algorithm.getSolution();
+        sol.trans().print();
+        check(::std::fabs(sol(0, 0) - 3.0) < 1e-12 && ::std::fabs(sol(1, 0) - 1.0) < 1e-12,
+              "minimize with two-phase search");
+    }
+}
+
+void pricing()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("pricing strategies\n");
+
+    Model model;
+    buildWideModel(model, 15, 80, 42);
+
+    const char* names[] = { "Dantzig", "partial", "multiple", "Devex", "steepest edge" };
+    PricingType types[] = { PRICING_DANTZIG, PRICING_PARTIAL, PRICING_MULTIPLE,
+                            PRICING_DEVEX, PRICING_STEEPEST_EDGE };
+    const size_t nTypes = sizeof(types)/sizeof(types[0]);
+    double fRefObj = 0.0;
+    for (size_t k = 0; k < nTypes; ++k)
+    {
+        RevisedSimplex algorithm;
+        algorithm.setPricing(types[k]);
+        algorithm.setModel(&model);
+        algorithm.solve();
+        Matrix sol = algorithm.getSolution();
+        double fObj = getObjective(model, sol);
+        printf("%s pricing: objective = %.10g\n", names[k], fObj);
+        check(sol.rows() == 80 && isFeasible(model, sol), "feasible solution");
+        if (k == 0)
+            fRefObj = fObj;
+        else
+            check(::std::fabs(fObj - fRefObj) < 1e-8*::std::fabs(fRefObj), "same optimum as Dantzig");
+    }
+
+    // Block size smaller than the number of non-basic variables, and a
+    // two-phase model.
+    Model minModel;
+    vector<double> cost(2);
+    cost[0] = 2;
+    cost[1] = 3;
+    minModel.setCostVector(cost);
+    minModel.setGoal(GOAL_MINIMIZE);
+    minModel.setVarPositive(true);
+    addConstraint(minModel, 1, 1, GREATER_EQUAL, 4);
+    addConstraint(minModel, 1, 3, GREATER_EQUAL, 6);
+    for (size_t k = 1; k < 3; ++k)
+    {
+        RevisedSimplex algorithm;
+        algorithm.setPricing(types[k]);
+        algorithm.setPricingBlockSize(1);
+        algorithm.setModel(&minModel);
+        algorithm.solve();
+        Matrix sol = algorithm.getSolution();
+        printf("%s pricing, block size 1: ", names[k]);
+        check(::std::fabs(getObjective(minModel, sol) - 9.0) < 1e-12, "two-phase optimum");
+    }
+
+    // Badly scaled columns, where the raw reduced costs mislead Dantzig's
+    // rule.
+    Model scaledModel;
+    buildWideModel(scaledModel, 15, 80, 7, true);
+    for (size_t k = 0; k < nTypes; ++k)
+    {
+        RevisedSimplex algorithm;
+        algorithm.setPricing(types[k]);
+        algorithm.setModel(&scaledModel);
+        algorithm.solve();
+        Matrix sol = algorithm.getSolution();
+        double fObj = getObjective(scaledModel, sol);
+        printf("%s pricing, scaled model: objective = %.10g\n", names[k], fObj);
+        check(isFeasible(scaledModel, sol), "feasible solution");
+        if (k == 0)
+            fRefObj = fObj;
+        else
+            check(::std::fabs(fObj - fRefObj) < 1e-8*::std::fabs(fRefObj), "same optimum as Dantzig");
+    }
+}
+
+void boundedPricing()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("bounded revised simplex pricing\n");
+
+    // max 3x + 5y, 0 <= x <= 4, 0 <= y <= 6, 3x + 2y <= 18, x + y <= 7
+    //   ->  (1, 6), 33
+    Model model;
+    vector<double> cost(2);
+    cost[0] = 3;
+    cost[1] = 5;
+    model.setCostVector(cost);
+    model.setGoal(GOAL_MAXIMIZE);
+    model.setVarPositive(true);
+    model.setVarBound(0, BOUND_LOWER, 0);
+    model.setVarBound(0, BOUND_UPPER, 4);
+    model.setVarBound(1, BOUND_LOWER, 0);
+    model.setVarBound(1, BOUND_UPPER, 6);
+    addConstraint(model, 3, 2, LESS_EQUAL, 18);
+    addConstraint(model, 1, 1, LESS_EQUAL, 7);
+
+    PricingType types[] = { PRICING_DANTZIG, PRICING_DEVEX, PRICING_STEEPEST_EDGE };
+    for (size_t k = 0; k < sizeof(types)/sizeof(types[0]); ++k)
+    {
+        BoundedRevisedSimplex algorithm;
+        algorithm.setPricing(types[k]);
+        algorithm.setModel(&model);
+        algorithm.solve();
+        Matrix sol = algorithm.getSolution();
+        check(::std::fabs(sol(0, 0) - 1.0) < 1e-12 && ::std::fabs(sol(1, 0) - 6.0) < 1e-12,
+              "bounded optimum");
+    }
+}
+
+void warmStart()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("warm start\n");
+
+    Model model;
+    buildWideModel(model, 15, 80, 42);
+
+    RevisedSimplex algorithm;
+    algorithm.setModel(&model);
+    algorithm.solve();
+    Basis aBasis = algorithm.getBasis();
+    check(aBasis.getVarCount() == 80 && aBasis.getRowCount() == 15, "basis size");
+    size_t nBasic = 0;
+    for (size_t j = 0; j < 80; ++j)
+        if (aBasis.getVarStatus(j) == BASIS_BASIC)
+            ++nBasic;
+    for (size_t i = 0; i < 15; ++i)
+        if (aBasis.getRowStatus(i) == BASIS_BASIC)
+            ++nBasic;
+    check(nBasic == 15, "one basic entry per row");
+
+    // Tighten the right hand side of a few rows, and re-solve from the
+    // previous optimal basis.  The basis may have become infeasible, in
+    // which case it is ignored.
+    for (size_t i = 0; i < 15; i += 4)
+        model.setRhsValue(i, model.getRhsValue(i)*0.8);
+
+    RevisedSimplex cold;
+    cold.setModel(&model);
+    cold.solve();
+    double fRefObj = getObjective(model, cold.getSolution());
+
+    algorithm.setStartBasis(aBasis);
+    algorithm.solve();
+    Matrix sol = algorithm.getSolution();
+    check(isFeasible(model, sol), "feasible solution from warm start");
+    check(::std::fabs(getObjective(model, sol) - fRefObj) < 1e-8*::std::fabs(fRefObj),
+          "same optimum from warm start");
+
+    // Re-solve from the new optimal basis.
+    algorithm.setStartBasis(algorithm.getBasis());
+    algorithm.solve();
+    check(::std::fabs(getObjective(model, algorithm.getSolution()) - fRefObj) < 1e-8*::std::fabs(fRefObj),
+          "same optimum from optimal basis");
+
+    // A basis of the wrong size is ignored.
+    algorithm.setStartBasis(Basis(3, 2));
+    algorithm.solve();
+    check(::std::fabs(getObjective(model, algorithm.getSolution()) - fRefObj) < 1e-8*::std::fabs(fRefObj),
+          "mismatching basis ignored");
+
+    // Bounded revised simplex, re-solved from its own optimal basis.
+    Model bounded;
+    vector<double> cost(2);
+    cost[0] = 3;
+    cost[1] = 5;
+    bounded.setCostVector(cost);
+    bounded.setGoal(GOAL_MAXIMIZE);
+    bounded.setVarPositive(true);
+    bounded.setVarBound(0, BOUND_LOWER, 0);
+    bounded.setVarBound(0, BOUND_UPPER, 4);
+    bounded.setVarBound(1, BOUND_LOWER, 0);
+    bounded.setVarBound(1, BOUND_UPPER, 6);
+    addConstraint(bounded, 3, 2, LESS_EQUAL, 18);
+    addConstraint(bounded, 1, 1, LESS_EQUAL, 7);
+
+    BoundedRevisedSimplex boundedAlgorithm;
+    boundedAlgorithm.setModel(&bounded);
+    boundedAlgorithm.solve();
+    boundedAlgorithm.setStartBasis(boundedAlgorithm.getBasis());
+    boundedAlgorithm.solve();
+    sol = boundedAlgorithm.getSolution();
+    check(::std::fabs(sol(0, 0) - 1.0) < 1e-12 && ::std::fabs(sol(1, 0) - 6.0) < 1e-12,
+          "bounded optimum from warm start");
+}
+
+/**
+ * max c x over a box l <= x <= u, with rows of all three types built
+ * around a point inside the box, so that the model is feasible but not at
+ * any corner of the box.
+ */
+void buildBoxModel(Model& model, size_t nRows, size_t nCols, unsigned long seed)
+{
+    vector<double> cost(nCols), x0(nCols);
+    for (size_t j = 0; j < nCols; ++j)
+    {
+        cost[j] = 10.0*nextValue(seed) - 3.0;
+        double fLower = j % 3 == 0 ? 0.0 : 1.0 + 2.0*nextValue(seed);
+        double fUpper = fLower + 1.0 + 9.0*nextValue(seed);
+        model.setVarBound(j, BOUND_LOWER, fLower);
+        model.setVarBound(j, BOUND_UPPER, fUpper);
+        x0[j] = fLower + (fUpper - fLower)*nextValue(seed);
+    }
+    model.setCostVector(cost);
+    model.setGoal(GOAL_MAXIMIZE);
+    model.setVarPositive(true);
+
+    EqualityType eqs[] = { LESS_EQUAL, GREATER_EQUAL, EQUAL };
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        vector<double> row(nCols, 0.0);
+        double lhs = 0.0;
+        for (size_t j = 0; j < nCols; ++j)
+            if (nextValue(seed) < 0.4)
+            {
+                row[j] = 10.0*nextValue(seed) - 5.0;
+                lhs += row[j]*x0[j];
+            }
+        EqualityType eq = eqs[i % 3];
+        double fGap = eq == EQUAL ? 0.0 : 1.0 + 5.0*nextValue(seed);
+        model.addConstraint(row, eq, eq == GREATER_EQUAL ? lhs - fGap : lhs + fGap);
+    }
+}
+
+bool isWithinBounds(const Model& model, const Matrix& sol, size_t nCols)
+{
+    for (size_t j = 0; j < nCols; ++j)
+        if (sol(j, 0) < model.getVarBound(j, BOUND_LOWER) - 1e-9 ||
+            sol(j, 0) > model.getVarBound(j, BOUND_UPPER) + 1e-9)
+            return false;
+    return true;
+}
+
+void boundedPhaseOne()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("bounded phase one\n");
+
+    // No corner of the box is feasible, so the bounded revised simplex
+    // needs phase one to find its start.
+    Model model;
+    buildBoxModel(model, 12, 30, 5);
+
+    BoundedRevisedSimplex algorithm;
+    algorithm.setModel(&model);
+    algorithm.solve();
+    Matrix sol = algorithm.getSolution();
+    check(isFeasible(model, sol) && isWithinBounds(model, sol, 30), "feasible solution");
+
+    RevisedSimplex reference;
+    reference.setModel(&model);
+    reference.solve();
+    double fRefObj = getObjective(model, reference.getSolution());
+    printf("objective = %.10g (revised simplex: %.10g)\n", getObjective(model, sol), fRefObj);
+    check(::std::fabs(getObjective(model, sol) - fRefObj) < 1e-8*::std::fabs(fRefObj),
+          "same optimum as revised simplex");
+
+    // min x + y, x free, -2 <= y <= 5, x - y >= 1, x + 2y = 4  ->  (2, 1), 3
+    Model freeModel;
+    vector<double> cost(2);
+    cost[0] = 1;
+    cost[1] = 1;
+    freeModel.setCostVector(cost);
+    freeModel.setGoal(GOAL_MINIMIZE);
+    freeModel.setVarPositive(false);
+    freeModel.setVarBound(1, BOUND_LOWER, -2);
+    freeModel.setVarBound(1, BOUND_UPPER, 5);
+    addConstraint(freeModel, 1, -1, GREATER_EQUAL, 1);
+    addConstraint(freeModel, 1, 2, EQUAL, 4);
+
+    BoundedRevisedSimplex freeAlgorithm;
+    freeAlgorithm.setModel(&freeModel);
+    freeAlgorithm.solve();
+    sol = freeAlgorithm.getSolution();
+    check(::std::fabs(sol(0, 0) - 2.0) < 1e-12 && ::std::fabs(sol(1, 0) - 1.0) < 1e-12,
+          "free variable optimum");
+
+    // 0 <= x, y <= 1, x + y >= 3
+    Model infeasible;
+    infeasible.setCostVector(cost);
+    infeasible.setGoal(GOAL_MAXIMIZE);
+    infeasible.setVarPositive(true);
+    for (size_t j = 0; j < 2; ++j)
+    {
+        infeasible.setVarBound(j, BOUND_LOWER, 0);
+        infeasible.setVarBound(j, BOUND_UPPER, 1);
+    }
+    addConstraint(infeasible, 1, 1, GREATER_EQUAL, 3);
+
+    BoundedRevisedSimplex infeasibleAlgorithm;
+    infeasibleAlgorithm.setModel(&infeasible);
+    bool bInfeasible = false;
+    try
+    {
+        infeasibleAlgorithm.solve();
+    }
+    catch (const ModelInfeasible&)
+    {
+        bInfeasible = true;
+    }
+    check(bInfeasible, "infeasible model detected");
+}
+
+void longStep()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("long-step ratio test\n");
+
+    Model model;
+    buildBoxModel(model, 20, 60, 2);
+
+    BoundedRevisedSimplex shortStep;
+    shortStep.setLongStep(false);
+    shortStep.setModel(&model);
+    shortStep.solve();
+    double fRefObj = getObjective(model, shortStep.getSolution());
+
+    BoundedRevisedSimplex algorithm;
+    check(algorithm.getLongStep(), "long step enabled by default");
+    algorithm.setModel(&model);
+    algorithm.solve();
+    Matrix sol = algorithm.getSolution();
+    double fObj = getObjective(model, sol);
+    printf("objective = %.10g, %d phase one iterations (short step: %.10g, %d)\n",
+           fObj, int(algorithm.getPhaseOneIterationCount()),
+           fRefObj, int(shortStep.getPhaseOneIterationCount()));
+    check(isFeasible(model, sol) && isWithinBounds(model, sol, 60), "feasible solution");
+    check(::std::fabs(fObj - fRefObj) < 1e-8*::std::fabs(fRefObj), "same optimum as short step");
+    check(algorithm.getPhaseOneIterationCount() < shortStep.getPhaseOneIterationCount(),
+          "fewer phase one iterations");
+}
+
+/**
+ * Shift scheduling over nPeriods hours in a cyclic day, with 8, 4 and 6
+ * hour shifts starting at every hour, minimizing the paid hours while
+ * covering the demand of every hour.  The demands are multiples of 5,
+ * which makes the model highly degenerate.
+ */
+void buildStaffingModel(Model& model, size_t nPeriods, unsigned long seed, bool bBounded)
+{
+    const size_t lengths[] = { 8, 4, 6 };
+    size_t nCols = 3*nPeriods;
+    vector<double> cost(nCols);
+    for (size_t k = 0; k < 3; ++k)
+        for (size_t j = 0; j < nPeriods; ++j)
+            cost[k*nPeriods + j] = k == 1 ? 5.0 : lengths[k];
+    model.setCostVector(cost);
+    model.setGoal(GOAL_MINIMIZE);
+    model.setVarPositive(true);
+    if (bBounded)
+        for (size_t j = 0; j < nCols; ++j)
+            model.setVarBound(j, BOUND_LOWER, 0);
+
+    for (size_t t = 0; t < nPeriods; ++t)
+    {
+        vector<double> row(nCols, 0.0);
+        for (size_t k = 0; k < 3; ++k)
+            for (size_t j = 0; j < nPeriods; ++j)
+                if ((t + nPeriods - j) % nPeriods < lengths[k])
+                    row[k*nPeriods + j] = 1.0;
+        double demand = 10.0 + 5.0*static_cast<int>(3.0*nextValue(seed));
+        model.addConstraint(row, GREATER_EQUAL, demand);
+    }
+}
+
+/**
+ * Random model with nCols variables and nRows rows, mostly packing rows
+ * whose right hand sides are multiples of 5*fScale, and a few covering
+ * rows.  The many ties in the ratio test make it highly degenerate, and
+ * with a large scale the perturbation moves the basic variables by more
+ * than the primal tolerance.
+ */
+void buildPackingModel(Model& model, size_t nCols, size_t nRows, unsigned long seed, double fScale)
+{
+    vector<double> cost(nCols);
+    for (size_t j = 0; j < nCols; ++j)
+        cost[j] = -(1 + static_cast<int>(4*nextValue(seed)));
+    model.setCostVector(cost);
+    model.setGoal(GOAL_MINIMIZE);
+    model.setVarPositive(true);
+    for (size_t j = 0; j < nCols; ++j)
+        model.setVarBound(j, BOUND_LOWER, 0);
+
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        vector<double> row(nCols, 0.0);
+        for (size_t j = 0; j < nCols; ++j)
+            if (nextValue(seed) < 0.4)
+                row[j] = 1 + static_cast<int>(2*nextValue(seed));
+        EqualityType eq = nextValue(seed) < 0.3 ? GREATER_EQUAL : LESS_EQUAL;
+        double rhs = eq == LESS_EQUAL ? 5*static_cast<int>(1 + 2*nextValue(seed)) :
+            static_cast<int>(2*nextValue(seed));
+        model.addConstraint(row, eq, rhs*fScale);
+    }
+}
+
+void degeneracy()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("degenerate models\n");
+
+    RevisedSimplex defaults;
+    check(defaults.getPrimalTolerance() == 1e-9 && defaults.getDualTolerance() == 1e-9 &&
+          defaults.getPerturbation(), "default tolerances");
+
+    // Beale's example, on which the textbook ratio test cycles forever.
+    //   ->  (1, 0, 1, 0), 5/4
+    Model beale;
+    vector<double> cost(4);
+    cost[0] = 0.75;
+    cost[1] = -20;
+    cost[2] = 0.5;
+    cost[3] = -6;
+    beale.setCostVector(cost);
+    beale.setGoal(GOAL_MAXIMIZE);
+    beale.setVarPositive(true);
+    for (size_t j = 0; j < 4; ++j)
+        beale.setVarBound(j, BOUND_LOWER, 0);
+    double rows[3][4] = { { 0.25, -8, -1, 9 }, { 0.5, -12, -0.5, 3 }, { 0, 0, 1, 0 } };
+    double rhs[3] = { 0, 0, 1 };
+    for (size_t i = 0; i < 3; ++i)
+        beale.addConstraint(vector<double>(rows[i], rows[i] + 4), LESS_EQUAL, rhs[i]);
+
+    for (size_t k = 0; k < 2; ++k)
+    {
+        RevisedSimplex algorithm;
+        algorithm.setPerturbation(k == 0);
+        algorithm.setModel(&beale);
+        algorithm.solve();
+        check(::std::fabs(getObjective(beale, algorithm.getSolution()) - 1.25) < 1e-12,
+              "Beale's example, revised simplex");
+
+        BoundedRevisedSimplex bounded;
+        bounded.setPerturbation(k == 0);
+        bounded.setModel(&beale);
+        bounded.solve();
+        check(::std::fabs(getObjective(beale, bounded.getSolution()) - 1.25) < 1e-12,
+              "Beale's example, bounded revised simplex");
+    }
+
+    // Staffing models, where perturbation kicks in and is removed again.
+    for (size_t k = 0; k < 2; ++k)
+    {
+        Model model;
+        buildStaffingModel(model, 24, 2, k == 1);
+
+        RevisedSimplex plain;
+        plain.setPerturbation(false);
+        plain.setModel(&model);
+        plain.solve();
+        double fRefObj = getObjective(model, plain.getSolution());
+
+        RevisedSimplex algorithm;
+        algorithm.setModel(&model);
+        algorithm.solve();
+        Matrix sol = algorithm.getSolution();
+        printf("staffing: objective = %.10g (without perturbation: %.10g)\n",
+               getObjective(model, sol), fRefObj);
+        check(isFeasible(model, sol), "feasible solution");
+        check(::std::fabs(getObjective(model, sol) - fRefObj) < 1e-8*fRefObj,
+              "same optimum as without perturbation");
+
+        if (k == 1)
+        {
+            BoundedRevisedSimplex bounded;
+            bounded.setModel(&model);
+            bounded.solve();
+            sol = bounded.getSolution();
+            check(isFeasible(model, sol), "bounded feasible solution");
+            check(::std::fabs(getObjective(model, sol) - fRefObj) < 1e-8*fRefObj,
+                  "bounded same optimum");
+        }
+    }
+
+    // A packing model whose basis is infeasible once the perturbation is
+    // removed, and is repaired by a phase one starting from it.
+    Model model;
+    buildPackingModel(model, 33, 26, 13, 1e6);
+
+    BoundedRevisedSimplex plain;
+    plain.setPerturbation(false);
+    plain.setModel(&model);
+    plain.solve();
+    double fRefObj = getObjective(model, plain.getSolution());
+
+    BoundedRevisedSimplex bounded;
+    bounded.setModel(&model);
+    bounded.solve();
+    Matrix sol = bounded.getSolution();
+    printf("packing: objective = %.10g (without perturbation: %.10g)\n", getObjective(model, sol), fRefObj);
+    check(::std::fabs(getObjective(model, sol) - fRefObj) < 1e-8*::std::fabs(fRefObj),
+          "same optimum after repair");
+}
+
+/**
+ * Transportation model with nSupply sources and nDemand sinks, or
+ * assignment model of nSupply agents to nDemand tasks when bAssignment is
+ * true.  Variable i*nDemand + j is the flow from source i to sink j.
+ */
+void buildTransportModel(Model& model, size_t nSupply, size_t nDemand, unsigned long seed,
+                         bool bAssignment)
+{
+    size_t nCols = nSupply*nDemand;
+    vector<double> cost(nCols);
+    for (size_t k = 0; k < nCols; ++k)
+        cost[k] = 1.0 + 9.0*nextValue(seed);
+    model.setCostVector(cost);
+    model.setGoal(GOAL_MINIMIZE);
+    model.setVarPositive(true);
+
+    vector<double> demand(nDemand);
+    double fTotal = 0.0;
+    for (size_t j = 0; j < nDemand; ++j)
+    {
+        demand[j] = bAssignment ? 1.0 : 10.0 + 20.0*nextValue(seed);
+        fTotal += demand[j];
+    }
+
+    for (size_t i = 0; i < nSupply; ++i)
+    {
+        vector<double> row(nCols, 0.0);
+        for (size_t j = 0; j < nDemand; ++j)
+            row[i*nDemand + j] = 1.0;
+        if (bAssignment)
+            model.addConstraint(row, EQUAL, 1.0);
+        else
+            model.addConstraint(row, LESS_EQUAL, fTotal/nSupply*1.2);
+    }
+    for (size_t j = 0; j < nDemand; ++j)
+    {
+        vector<double> row(nCols, 0.0);
+        for (size_t i = 0; i < nSupply; ++i)
+            row[i*nDemand + j] = 1.0;
+        model.addConstraint(row, bAssignment ? EQUAL : GREATER_EQUAL, demand[j]);
+    }
+}
+
+void crash()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("crash basis\n");
+
+    const char* names[] = { "transportation", "assignment" };
+    for (size_t k = 0; k < 2; ++k)
+    {
+        Model model;
+        size_t n = k == 0 ? 6 : 8;
+        buildTransportModel(model, n, 8, 11, k == 1);
+
+        RevisedSimplex slack;
+        slack.setCrash(false);
+        slack.setModel(&model);
+        slack.solve();
+        double fRefObj = getObjective(model, slack.getSolution());
+
+        RevisedSimplex algorithm;
+        check(algorithm.getCrash(), "crash enabled by default");
+        algorithm.setModel(&model);
+        algorithm.solve();
+        Matrix sol = algorithm.getSolution();
+        double fObj = getObjective(model, sol);
+        printf("%s: objective = %.10g, %d phase one iterations (without crash: %.10g, %d)\n",
+               names[k], fObj, int(algorithm.getPhaseOneIterationCount()),
+               fRefObj, int(slack.getPhaseOneIterationCount()));
+        check(isFeasible(model, sol), "feasible solution");
+        check(::std::fabs(fObj - fRefObj) < 1e-8*::std::fabs(fRefObj), "same optimum as without crash");
+        check(2*algorithm.getPhaseOneIterationCount() <= slack.getPhaseOneIterationCount(),
+              "fewer phase one iterations");
+    }
+}
+
+}
+
+int main()
+{
+    printf("unit test: revised simplex\n");
+    smallModels();
+    pricing();
+    boundedPricing();
+    boundedPhaseOne();
+    longStep();
+    degeneracy();
+    warmStart();
+    crash();
+    printf("Unit test passed!\n");
+}
@@ -19,6 +19,7 @@
 #include "numeric/lpmodel.hxx"
 #include "numeric/exception.hxx"
 #include "numeric/matrix.hxx"
+#include "numeric/solvecontrol.hxx"
 #include "unoglobal.hxx"
 #include "tool/global.hxx"
 #include "numeric/type.hxx"
@@ -27,6 +28,9 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
 #include <iostream>
 #include <stdio.h>
 
@@ -37,166 +41,438 @@ namespace scsolver {
 
 namespace numeric { namespace lp {
 
+namespace {
+
+const double INF = ::std::numeric_limits<double>::infinity();
+
+/**
+ * Abort callback, which lp_solve calls regularly while it solves.  It
+ * also reports the progress, with the objective of the best solution
+ * found so far once there is one.
+ */
+int __WINAPI abortSolve(lprec* lp, void* pHandle)
+{
+    const SolveControl* pControl = static_cast<const SolveControl*>(pHandle);
+    if (pControl->isCancelled() || pControl->isTimedOut())
+        return TRUE;
+
+    SolveProgress aProgress;
+    aProgress.Iteration = static_cast<size_t>(get_total_iter(lp));
+    aProgress.Objective = get_working_objective(lp);
+    aProgress.HasObjective = ::std::fabs(aProgress.Objective) < get_infinite(lp);
+    pControl->reportProgress(aProgress);
+    return FALSE;
+}
+
+}
+
+/**
+ * The LP as loaded into lp_solve, with the extra row of a solve-to-value
+ * model included.  It is kept to find what changed by the next solve.
+ */
+struct LpSolveData
+{
+	size_t Rows;
+	size_t Cols;
+	vector<double> Coefs;   // row-major
+	vector<double> Rhs;
+	vector<int> Types;
+	vector<double> Cost;
+	vector<double> Lower;
+	vector<double> Upper;
+	bool Integer;
+	bool Maximize;
+
+	LpSolveData() : Rows( 0 ), Cols( 0 ), Integer( false ), Maximize( false ) {}
+};
+
+/**
+ * The lprec stays alive between solves.  When the next model has the same
+ * size, only the coefficients, right hand sides, bounds and costs that
+ * differ are passed to lp_solve, which then starts from the basis of its
+ * last solve unless a valid start basis is given.
+ */
 class LpSolveImpl
 {
 public:
-	LpSolveImpl() {}
-	~LpSolveImpl() throw() {}
+	LpSolveImpl() : m_pModel( NULL ), m_pControl( NULL ), m_pLp( NULL ), m_bDumpModel( false ), m_bOptimal( false ) {}
+	~LpSolveImpl() throw();
 
-    void adjustModel(Model& rModel) const;
 	void solve();
 	Matrix getSolution() const { return m_mxSolution; }
 
 	void setModel( Model* model ) { m_pModel = model; }
     Model* getModel() const { return m_pModel; }	
 
+	void setStartBasis( const Basis& aBasis ) { m_aStartBasis = aBasis; }
+	void setSolveControl( const SolveControl* p ) { m_pControl = p; }
+	const Basis& getBasis() const { return m_aBasis; }
+
+	void setDumpModel( bool b ) { m_bDumpModel = b; }
+	bool getDumpModel() const { return m_bDumpModel; }
+	bool isOptimal() const { return m_bOptimal; }
+
 private:
+    void getData(const Model& rModel, LpSolveData& rData) const;
+    double toLpSolve(double fVal) const;
+    void createLp(const LpSolveData& rData);
+    size_t updateLp(const LpSolveData& rData);
+    void applyStartBasis(lprec* lp, size_t nRows, size_t nCols) const;
+    void storeBasis(lprec* lp, size_t nRows, size_t nCols);
+    void applySolveControl();
+
 	Matrix m_mxSolution;
 	Model* m_pModel;
+	const SolveControl* m_pControl;
+	Basis m_aStartBasis;
+	Basis m_aBasis;
+
+	lprec* m_pLp;
+	LpSolveData m_aData;
+	bool m_bDumpModel;
+	bool m_bOptimal;
 };
 
-void LpSolveImpl::adjustModel(Model& rModel) const
+LpSolveImpl::~LpSolveImpl() throw()
+{
+	if ( m_pLp )
+		delete_lp( m_pLp );
+}
+
+/**
+ * Pass the start basis to lp_solve.  lp_solve numbers the rows 1 to Nrows
+ * and the columns Nrows + 1 to Nrows + Ncolumns; the first Nrows elements
+ * of the basis array are the basic variables, and the rest the non-basic
+ * ones, negative when at the lower bound.  The bounds of a row refer to the
+ * row as stored, which is sign-changed for a >= row.
+ */
+void LpSolveImpl::applyStartBasis(lprec* lp, size_t nRows, size_t nCols) const
 {
-    if (rModel.getGoal() == GOAL_TOVALUE)
+    if (m_aStartBasis.empty() || m_aStartBasis.getRowCount() != nRows ||
+        m_aStartBasis.getVarCount() != nCols)
+        return;
+
+    vector<int> aBasic, aNonBasic;
+    for (size_t i = 0; i < nRows + nCols; ++i)
     {
-        // Convert this model to simulate solving to a specific value by 
-        // adding an additional constraint.
+        int nIndex = static_cast<int>(i) + 1;
+        BasisStatus eStatus;
+        if (i < nRows)
+        {
+            eStatus = m_aStartBasis.getRowStatus(i);
+            if (eStatus != BASIS_BASIC && is_chsign(lp, nIndex))
+                eStatus = eStatus == BASIS_LOWER ? BASIS_UPPER : BASIS_LOWER;
+        }
+        else
+            eStatus = m_aStartBasis.getVarStatus(i - nRows);
+
+        if (eStatus == BASIS_BASIC)
+            aBasic.push_back(-nIndex);
+        else
+            aNonBasic.push_back(eStatus == BASIS_LOWER ? -nIndex : nIndex);
+    }
 
-        Matrix costs = rModel.getCostVector();
-        double value = rModel.getSolveToValue();
+    if (aBasic.size() != nRows)
+        return;
 
-        size_t costSize = costs.cols(); // cost matrix is a single-row matrix.
-        vector<double> v;
-        v.reserve(costSize);
-        for (size_t i = 0; i < costSize; ++i)
-            v.push_back(costs(0, i));
-        rModel.addConstraint(v, EQUAL, value);
+    vector<int> aBasis(1, 0);
+    aBasis.insert(aBasis.end(), aBasic.begin(), aBasic.end());
+    aBasis.insert(aBasis.end(), aNonBasic.begin(), aNonBasic.end());
+
+    // lp_solve rejects an invalid basis, and then keeps the one it has.
+    set_basis(lp, &aBasis[0], TRUE);
+}
+
+void LpSolveImpl::storeBasis(lprec* lp, size_t nRows, size_t nCols)
+{
+    vector<int> aBasis(1 + nRows + nCols);
+    if (!get_basis(lp, &aBasis[0], TRUE))
+    {
+        m_aBasis = Basis();
+        return;
+    }
 
-        // does it matter whether to set this to minimize or maximize?  
-        rModel.setGoal(GOAL_MINIMIZE); 
+    Basis aNewBasis(nCols, nRows);
+    for (size_t k = 1; k <= nRows + nCols; ++k)
+    {
+        int nIndex = aBasis[k] < 0 ? -aBasis[k] : aBasis[k];
+        BasisStatus eStatus = BASIS_BASIC;
+        if (k > nRows)
+            eStatus = aBasis[k] < 0 ? BASIS_LOWER : BASIS_UPPER;
+
+        if (static_cast<size_t>(nIndex) <= nRows)
+        {
+            if (eStatus != BASIS_BASIC && is_chsign(lp, nIndex))
+                eStatus = eStatus == BASIS_LOWER ? BASIS_UPPER : BASIS_LOWER;
+            aNewBasis.setRowStatus(nIndex - 1, eStatus);
+        }
+        else
+            aNewBasis.setVarStatus(nIndex - nRows - 1, eStatus);
     }
+    m_aBasis = aNewBasis;
 }
 
-void LpSolveImpl::solve()
+/**
+ * Read the LP to load from the model.  A solve-to-value model is turned
+ * into a minimization with an extra row that fixes the objective at the
+ * requested value; whether it minimizes or maximizes does not matter.
+ */
+void LpSolveImpl::getData(const Model& rModel, LpSolveData& rData) const
 {
-    using ::std::vector;
+    size_t nCols = rModel.getDecisionVarSize();
+    size_t nRows = rModel.getConstraintCount();
+    bool bToValue = rModel.getGoal() == GOAL_TOVALUE;
+    if (rModel.getGoal() != GOAL_MAXIMIZE && rModel.getGoal() != GOAL_MINIMIZE && !bToValue)
+        throw RuntimeError( ascii("Unknown goal") );
+
+    rData.Rows = bToValue ? nRows + 1 : nRows;
+    rData.Cols = nCols;
+    rData.Coefs.assign(rData.Rows*nCols, 0.0);
+    rData.Rhs.assign(rData.Rows, 0.0);
+    rData.Types.assign(rData.Rows, EQ);
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        for (size_t j = 0; j < nCols; ++j)
+            rData.Coefs[i*nCols + j] = rModel.getConstraint(i, j);
+        rData.Rhs[i] = rModel.getRhsValue(i);
+        switch (rModel.getEquality(i))
+        {
+        case GREATER_EQUAL:
+            rData.Types[i] = GE;
+            break;
+        case LESS_EQUAL:
+            rData.Types[i] = LE;
+            break;
+        case EQUAL:
+            rData.Types[i] = EQ;
+            break;
+        }
+    }
 
-	Model model(*getModel());
-    adjustModel(model);
-	size_t nDecVarSize = model.getDecisionVarSize();
-	size_t nConstCount = model.getConstraintCount();
+    rData.Cost.assign(nCols, 0.0);
+    for (size_t j = 0; j < nCols; ++j)
+        rData.Cost[j] = rModel.getCost(j);
+    if (bToValue)
+    {
+        for (size_t j = 0; j < nCols; ++j)
+            rData.Coefs[nRows*nCols + j] = rData.Cost[j];
+        rData.Rhs[nRows] = rModel.getSolveToValue();
+    }
 
-#if SCSOLVER_DEBUG	
-	printf("decision var (%d)\n", nDecVarSize);
-	printf("constraint   (%d)\n", nConstCount);
-#endif	
+    rData.Lower.assign(nCols, rModel.getVarPositive() ? 0.0 : -INF);
+    rData.Upper.assign(nCols, INF);
+    for (size_t j = 0; j < nCols; ++j)
+    {
+        if (rModel.isVarBounded(j, BOUND_LOWER))
+            rData.Lower[j] = rModel.getVarBound(j, BOUND_LOWER);
+        if (rModel.isVarBounded(j, BOUND_UPPER))
+            rData.Upper[j] = rModel.getVarBound(j, BOUND_UPPER);
+    }
 
-	lprec* lp = make_lp(0, nDecVarSize);
-	if ( lp == NULL )
-		throw RuntimeError( ascii("Initialization error") );
+    rData.Integer = rModel.getVarInteger();
+    rData.Maximize = rModel.getGoal() == GOAL_MAXIMIZE;
+}
 
-	for (size_t i = 1; i <= nDecVarSize; ++i)
-	{
-		if( model.getVarPositive() )
-			set_lowbo(lp, static_cast<int>(i), 0.0); // positive variable constraint
-		else
-			set_unbounded(lp, static_cast<int>(i));
-		if ( model.getVarInteger() )
-			set_int(lp, static_cast<int>(i), 1);
-		else
-			set_int(lp, static_cast<int>(i), 0);
-	}
+double LpSolveImpl::toLpSolve(double fVal) const
+{
+    if (fVal == INF)
+        return get_infinite(m_pLp);
+    if (fVal == -INF)
+        return -get_infinite(m_pLp);
+    return fVal;
+}
+
+void LpSolveImpl::createLp(const LpSolveData& rData)
+{
+    if (m_pLp)
+    {
+        delete_lp(m_pLp);
+        m_pLp = NULL;
+    }
+
+    int nCols = static_cast<int>(rData.Cols);
+    m_pLp = make_lp(0, nCols);
+    if ( m_pLp == NULL )
+        throw RuntimeError( ascii("Initialization error") );
+
+    set_add_rowmode(m_pLp, true);
+    vector<int> aCols(rData.Cols);
+    for (size_t j = 0; j < rData.Cols; ++j)
+        aCols[j] = static_cast<int>(j) + 1;
+    for (size_t i = 0; i < rData.Rows; ++i)
+    {
+        // add_constraintex does not modify the row, though it is not const.
+        REAL* pRow = rData.Cols > 0 ? const_cast<REAL*>(&rData.Coefs[i*rData.Cols]) : NULL;
+        add_constraintex(m_pLp, nCols, pRow, &aCols[0], rData.Types[i], rData.Rhs[i]);
+    }
+    set_add_rowmode(m_pLp, false);
+
+    if (rData.Cols > 0)
+        set_obj_fnex(m_pLp, nCols, const_cast<REAL*>(&rData.Cost[0]), &aCols[0]);
+    for (size_t j = 0; j < rData.Cols; ++j)
+    {
+        int nCol = static_cast<int>(j) + 1;
+        set_bounds(m_pLp, nCol, toLpSolve(rData.Lower[j]), toLpSolve(rData.Upper[j]));
+        set_int(m_pLp, nCol, rData.Integer ? TRUE : FALSE);
+    }
+
+    if (rData.Maximize)
+        set_maxim(m_pLp);
+    else
+        set_minim(m_pLp);
+
+    m_aData = rData;
+}
+
+/**
+ * Pass the differences between the loaded LP and the given one, which
+ * has the same size, to lp_solve.
+ *
+ * @return size_t number of values changed
+ */
+size_t LpSolveImpl::updateLp(const LpSolveData& rData)
+{
+    size_t nChanged = 0;
+    for (size_t i = 0; i < rData.Rows; ++i)
+    {
+        int nRow = static_cast<int>(i) + 1;
+        for (size_t j = 0; j < rData.Cols; ++j)
+        {
+            size_t k = i*rData.Cols + j;
+            if (rData.Coefs[k] == m_aData.Coefs[k])
+                continue;
+            set_mat(m_pLp, nRow, static_cast<int>(j) + 1, rData.Coefs[k]);
+            ++nChanged;
+        }
+        if (rData.Types[i] != m_aData.Types[i])
+        {
+            set_constr_type(m_pLp, nRow, rData.Types[i]);
+            ++nChanged;
+        }
+        // A change of type may flip the sign of the row as stored, so the
+        // right hand side is set again along with it.
+        if (rData.Rhs[i] != m_aData.Rhs[i] || rData.Types[i] != m_aData.Types[i])
+        {
+            set_rh(m_pLp, nRow, rData.Rhs[i]);
+            ++nChanged;
+        }
+    }
+
+    for (size_t j = 0; j < rData.Cols; ++j)
+    {
+        int nCol = static_cast<int>(j) + 1;
+        if (rData.Cost[j] != m_aData.Cost[j])
+        {
+            set_obj(m_pLp, nCol, rData.Cost[j]);
+            ++nChanged;
+        }
+        if (rData.Lower[j] != m_aData.Lower[j] || rData.Upper[j] != m_aData.Upper[j])
+        {
+            set_bounds(m_pLp, nCol, toLpSolve(rData.Lower[j]), toLpSolve(rData.Upper[j]));
+            ++nChanged;
+        }
+        if (rData.Integer != m_aData.Integer)
+            set_int(m_pLp, nCol, rData.Integer ? TRUE : FALSE);
+    }
+
+    if (rData.Maximize != m_aData.Maximize)
+    {
+        if (rData.Maximize)
+            set_maxim(m_pLp);
+        else
+            set_minim(m_pLp);
+        ++nChanged;
+    }
+
+    m_aData = rData;
+    return nChanged;
+}
+
+/**
+ * lp_solve takes the time limit in whole seconds, so it is rounded up;
+ * the abort callback stops it closer to the limit, and on cancellation.
+ * lp_solve has no limit on the number of iterations.
+ */
+void LpSolveImpl::applySolveControl()
+{
+    double fRemaining = m_pControl->getRemainingTime(0.0);
+    long nTimeout = 0;
+    if (m_pControl->getTimeLimit() > 0.0)
+        nTimeout = ::std::max(1L, static_cast<long>(::std::ceil(fRemaining)));
+    set_timeout(m_pLp, nTimeout);
+    put_abortfunc(m_pLp, abortSolve, const_cast<SolveControl*>(m_pControl));
+}
+
+void LpSolveImpl::solve()
+{
+	m_pControl->check();
+
+	const Model& rModel = *getModel();
+	LpSolveData aData;
+	getData(rModel, aData);
 
-	// map constraints
-	set_add_rowmode( lp, true );
-	vector<double> row( nDecVarSize );
-	vector<int>   cols( nDecVarSize );
-	try
-	{
-		for (size_t i = 0; i < nDecVarSize; ++i)
-			cols.at(i) = static_cast<int>(i) + 1;
-
-		for (size_t i = 0; i < nConstCount; ++i)
-		{
-			for (size_t j = 0; j < nDecVarSize; ++j)
-				row.at(j) = model.getConstraint(i, j);
-			int nEqual = EQ;
-			switch ( model.getEquality(i) )
-			{
-			case GREATER_EQUAL:
-				nEqual = GE;
-				break;
-			case LESS_EQUAL:
-				nEqual = LE;
-				break;
-			case EQUAL:
-				nEqual = EQ;
-				break;
-			}
-			add_constraintex( lp, nDecVarSize, &row[0], &cols[0], nEqual,
-							  model.getRhsValue(i) );
-		}
-
-		set_add_rowmode( lp, false );
-
-		// set objective function
-		for (size_t i = 0; i < nDecVarSize; ++i)
-		{
 #if SCSOLVER_DEBUG
-			printf("var %d = %f\n", i+1, model.getCost(i));
+	printf("decision var (%lu)\n", static_cast<unsigned long>(aData.Cols));
+	printf("constraint   (%lu)\n", static_cast<unsigned long>(aData.Rows));
 #endif
-			row.at(i) = model.getCost(i);
-		}
-		set_obj_fnex( lp, nDecVarSize,  &row[0],  &cols[0] );
-	}
-	catch ( ::std::out_of_range& e )
-	{
-		Debug( e.what() );
-		delete_lp(lp);
-		throw RuntimeError( ascii(e.what()) );
-	}
 
-	// set goal
-	switch ( model.getGoal() )
+	if ( m_pLp && aData.Rows == m_aData.Rows && aData.Cols == m_aData.Cols )
 	{
-	case GOAL_MAXIMIZE:
-		set_maxim(lp);
-		break;
-	case GOAL_MINIMIZE:
-		set_minim(lp);
-		break;
-	default:
-		delete_lp(lp);
-		throw RuntimeError( ascii("Unknown goal") );
+		size_t nChanged = updateLp(aData);
+#if SCSOLVER_DEBUG
+		printf("lp_solve: %lu value(s) changed since the last solve\n",
+			   static_cast<unsigned long>(nChanged));
+#else
+		(void)nChanged;
+#endif
 	}
+	else
+		createLp(aData);
+
+	if ( m_bDumpModel )
+		write_LP(m_pLp, stdout);
 
-	write_LP(lp, stdout);
+    // The extra row of a solve-to-value model is not part of the user's
+    // model, so its basis is not kept.
+    size_t nRows = rModel.getConstraintCount();
+    bool bKeepBasis = rModel.getGoal() != GOAL_TOVALUE;
+    if (bKeepBasis)
+        applyStartBasis(m_pLp, nRows, aData.Cols);
 
 #if SCSOLVER_DEBUG	
-    set_verbose(lp, IMPORTANT);
+    set_verbose(m_pLp, IMPORTANT);
 #else
-    set_verbose(lp, NEUTRAL);
+    set_verbose(m_pLp, NEUTRAL);
 #endif    
 
-	if ( ::solve(lp) == OPTIMAL )
-	{
-		// solution found
-
-		// variable values
-		get_variables(lp, &row[0]);
-		Matrix mxSolution( nDecVarSize, 1 );
-		for ( size_t i = 0; i < nDecVarSize; ++i )
-			mxSolution( i, 0 ) = row[i];
-		m_mxSolution.swap( mxSolution );
-	}
-	else
+    applySolveControl();
+	m_bOptimal = false;
+	int nResult = ::solve(m_pLp);
+	if ( nResult == USERABORT )
 	{
-		// solution not found
-		delete_lp(lp);
-		throw ModelInfeasible();
+		m_pControl->check();
+		throw SolveCancelled();
 	}
+	if ( nResult == TIMEOUT )
+		throw IterationTimedOut();
 
-	delete_lp(lp);
+	// An integer model stopped early returns the best solution so far.
+	if ( nResult != OPTIMAL && nResult != SUBOPTIMAL )
+		throw ModelInfeasible();
+	m_bOptimal = nResult == OPTIMAL;
+
+	vector<double> aValues( aData.Cols );
+	if ( aData.Cols > 0 )
+		get_variables(m_pLp, &aValues[0]);
+	Matrix mxSolution( aData.Cols, 1 );
+	for ( size_t i = 0; i < aData.Cols; ++i )
+		mxSolution( i, 0 ) = aValues[i];
+	m_mxSolution.swap( mxSolution );
+
+	if (bKeepBasis)
+		storeBasis(m_pLp, nRows, aData.Cols);
+	else
+		m_aBasis = Basis();
 }
 
 //-----------------------------------------------------------------
@@ -212,8 +488,26 @@ LpSolve::~LpSolve() throw()
 void LpSolve::solve()
 {
 	m_pImpl->setModel( getModel() );
+	m_pImpl->setStartBasis( getStartBasis() );
+	m_pImpl->setSolveControl( getSolveControl() );
 	m_pImpl->solve();
 	setSolution( m_pImpl->getSolution() );
+	setBasis( m_pImpl->getBasis() );
+}
+
+bool LpSolve::isOptimal() const
+{
+	return m_pImpl->isOptimal();
+}
+
+void LpSolve::setDumpModel( bool bDump )
+{
+	m_pImpl->setDumpModel( bDump );
+}
+
+bool LpSolve::getDumpModel() const
+{
+	return m_pImpl->getDumpModel();
 }
 
 
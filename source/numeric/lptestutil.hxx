@@ -0,0 +1,205 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef _LPTESTUTIL_HXX_
+#define _LPTESTUTIL_HXX_
+
+// Helpers shared by the unit tests of the LP algorithms.
+
+#include "numeric/lpmodel.hxx"
+#include "numeric/matrix.hxx"
+
+#include <vector>
+#include <cmath>
+#include <stdio.h>
+
+class TestFailed {};
+
+namespace scsolver { namespace numeric { namespace lp { namespace test {
+
+/**
+ * Linear congruential generator, so that the random models are the same
+ * on every platform.
+ *
+ * @return double next value in [0, 1].
+ */
+inline double nextValue(unsigned long& seed)
+{
+    seed = (seed*1103515245UL + 12345UL) & 0x7fffffffUL;
+    return static_cast<double>(seed) / 0x7fffffff;
+}
+
+inline void check(bool bCond, const char* msg)
+{
+    if (!bCond)
+    {
+        printf("%s: failed\n", msg);
+        throw TestFailed();
+    }
+    printf("%s: passed\n", msg);
+}
+
+inline bool isNear(double a, double b, double tol = 1e-9)
+{
+    return ::std::fabs(a - b) <= tol*(1.0 + ::std::fabs(b));
+}
+
+inline double getObjective(const Model& model, const Matrix& sol)
+{
+    Matrix cost = model.getCostVector();
+    double f = 0.0;
+    for (size_t j = 0; j < cost.cols(); ++j)
+        f += cost(0, j)*sol(j, 0);
+    return f;
+}
+
+inline bool isIntegral(const Matrix& sol)
+{
+    for (size_t j = 0; j < sol.rows(); ++j)
+        if (sol(j, 0) != ::std::floor(sol(j, 0)))
+            return false;
+    return true;
+}
+
+/**
+ * Check that the solution satisfies all constraints and bounds, each up
+ * to tol relative to its right hand side or bound.
+ */
+inline bool isFeasible(const Model& model, const Matrix& sol, double tol = 1e-9)
+{
+    Matrix A = model.getConstraintMatrix();
+    for (size_t i = 0; i < A.rows(); ++i)
+    {
+        double lhs = 0.0;
+        for (size_t j = 0; j < A.cols(); ++j)
+            lhs += A(i, j)*sol(j, 0);
+
+        double rhs = model.getRhsValue(i), fTol = tol*(1.0 + ::std::fabs(rhs));
+        switch (model.getEquality(i))
+        {
+            case LESS_EQUAL:
+                if (lhs > rhs + fTol)
+                    return false;
+                break;
+            case GREATER_EQUAL:
+                if (lhs < rhs - fTol)
+                    return false;
+                break;
+            case EQUAL:
+                if (::std::fabs(lhs - rhs) > fTol)
+                    return false;
+                break;
+        }
+    }
+
+    for (size_t j = 0; j < sol.rows(); ++j)
+    {
+        double x = sol(j, 0);
+        if (model.getVarPositive() && x < -tol)
+            return false;
+        if (model.isVarBounded(j, BOUND_LOWER))
+        {
+            double lower = model.getVarBound(j, BOUND_LOWER);
+            if (x < lower - tol*(1.0 + ::std::fabs(lower)))
+                return false;
+        }
+        if (model.isVarBounded(j, BOUND_UPPER))
+        {
+            double upper = model.getVarBound(j, BOUND_UPPER);
+            if (x > upper + tol*(1.0 + ::std::fabs(upper)))
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Add the row a0 x0 + a1 x1 (eq) rhs to a model of two variables.
+ */
+inline void addConstraint(Model& model, double a0, double a1, EqualityType eq, double rhs)
+{
+    ::std::vector<double> v(2);
+    v[0] = a0;
+    v[1] = a1;
+    model.addConstraint(v, eq, rhs);
+}
+
+inline void setCost(Model& model, double c0, double c1, GoalType eGoal)
+{
+    ::std::vector<double> cost(2);
+    cost[0] = c0;
+    cost[1] = c1;
+    model.setCostVector(cost);
+    model.setGoal(eGoal);
+}
+
+/**
+ * max c x, A x <= b, x >= 0 with positive A, b and c.  The origin is
+ * feasible, so this needs no two-phase search.  When badly scaled, every
+ * third column is multiplied by either 1000 or 0.001.
+ */
+inline void buildWideModel(Model& model, size_t nRows, size_t nCols, unsigned long seed,
+                           bool bBadlyScaled = false)
+{
+    ::std::vector<double> scale(nCols, 1.0);
+    if (bBadlyScaled)
+        for (size_t j = 0; j < nCols; j += 3)
+            scale[j] = j % 2 ? 1000.0 : 0.001;
+
+    ::std::vector<double> cost(nCols);
+    for (size_t j = 0; j < nCols; ++j)
+        cost[j] = (1.0 + nextValue(seed))*scale[j];
+    model.setCostVector(cost);
+    model.setGoal(GOAL_MAXIMIZE);
+    model.setVarPositive(true);
+
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        ::std::vector<double> row(nCols);
+        for (size_t j = 0; j < nCols; ++j)
+            row[j] = nextValue(seed) < 0.3 ? (1.0 + 9.0*nextValue(seed))*scale[j] : 0.0;
+        model.addConstraint(row, LESS_EQUAL, 10.0 + 90.0*nextValue(seed));
+    }
+}
+
+/**
+ * max c x, A x <= b, 0 <= x <= 4 integer, with positive A, b and c.
+ */
+inline void buildKnapsackModel(Model& model, size_t nRows, size_t nCols, unsigned long seed)
+{
+    ::std::vector<double> cost(nCols);
+    for (size_t j = 0; j < nCols; ++j)
+        cost[j] = 1.0 + ::std::floor(9.0*nextValue(seed));
+    model.setCostVector(cost);
+    model.setGoal(GOAL_MAXIMIZE);
+    model.setVarPositive(true);
+    model.setVarInteger(true);
+    for (size_t j = 0; j < nCols; ++j)
+        model.setVarBound(j, BOUND_UPPER, 4);
+
+    for (size_t i = 0; i < nRows; ++i)
+    {
+        ::std::vector<double> row(nCols);
+        for (size_t j = 0; j < nCols; ++j)
+            row[j] = 1.0 + 9.0*nextValue(seed);
+        model.addConstraint(row, LESS_EQUAL, 10.0 + 20.0*nextValue(seed));
+    }
+}
+
+}}}}
+
+#endif
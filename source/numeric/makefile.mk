@@ -20,14 +20,27 @@ SLOFILES =  \
 	$(SLO)$/lpmodel.obj \
 	$(SLO)$/matrix.obj \
 	$(SLO)$/nlpbase.obj \
+	$(SLO)$/solvecontrol.obj \
 	$(SLO)$/nlpmodel.obj \
 	$(SLO)$/quasinewton.obj \
 	$(SLO)$/hookejeeves.obj \
+	$(SLO)$/multistart.obj \
 	$(SLO)$/baselinesearch.obj \
 	$(SLO)$/quadfitlinesearch.obj \
 	$(SLO)$/lpsolve.obj \
+	$(SLO)$/lpsimplex.obj \
+	$(SLO)$/lpdualsimplex.obj \
+	$(SLO)$/lppresolve.obj \
+	$(SLO)$/lpscaling.obj \
+	$(SLO)$/lpinteriorpoint.obj \
+	$(SLO)$/lpbranchbound.obj \
+	$(SLO)$/lpcuts.obj \
+	$(SLO)$/lpheuristic.obj \
+	$(SLO)$/lpportfolio.obj \
 	$(SLO)$/exception.obj \
-	$(SLO)$/polyeqnsolver.obj
+	$(SLO)$/polyeqnsolver.obj \
+	$(SLO)$/decomposition.obj \
+	$(SLO)$/sparsematrix.obj
 
 # --- Tagets -------------------------------------------------------
 
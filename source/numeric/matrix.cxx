@@ -16,6 +16,7 @@
  ****************************************************************************/
 
 #include "numeric/matrix.hxx"
+#include "numeric/fixedmatrix.hxx"
 #include "tool/global.hxx"
 #include <iostream>
 #include <iomanip>
@@ -24,6 +25,7 @@
 #include <exception>
 #include <iterator>
 #include <sstream>
+#include <algorithm>
 
 #define USE_BOOST_1_30_2 1
 
@@ -74,6 +76,11 @@ const char* NonSquareMatrix::what() const throw()
     return "Matrix not square where a square matrix is required";
 }
 
+const char* MatrixNotPositiveDefinite::what() const throw()
+{
+    return "Matrix not positive definite";
+}
+
 //---------------------------------------------------------------------------
 // Local helper functions
 
@@ -100,7 +107,8 @@ typedef bnu::matrix_range< bnu::matrix<double> >  MxRange;
 typedef bnu::matrix_row< bnu::matrix<double> >    MxRow;
 typedef bnu::matrix_column< bnu::matrix<double> > MxColumn;
 
-bool isRowEmpty( const bnu::matrix<double>& A, size_t nRowId )
+template<typename MatrixType>
+bool isRowEmpty( const MatrixType& A, size_t nRowId )
 {
     if ( nRowId >= A.size1() )
         throw MatrixSizeMismatch();
@@ -113,7 +121,8 @@ bool isRowEmpty( const bnu::matrix<double>& A, size_t nRowId )
     return true;
 }
 
-bool isColumnEmpty( const bnu::matrix<double>& A, size_t nColId )
+template<typename MatrixType>
+bool isColumnEmpty( const MatrixType& A, size_t nColId )
 {
     if ( nColId >= A.size2() )
         throw MatrixSizeMismatch();
@@ -374,44 +383,53 @@ void inverse( const bnu::matrix<double>& mxA, bnu::matrix<double>& mxInv )
 //---------------------------------------------------------------------------
 
 Matrix::Matrix() : 
-    m_bResizable(true)
+    m_bResizable(true),
+    m_aArray(0, 0),
+    m_nRows(0),
+    m_nCols(0)
 {
-    bnu::matrix<double> m( 0, 0 );
-    m_aArray = m;
 }
 
 Matrix::Matrix(size_t row, size_t col, bool identity_matrix) :
-    m_bResizable(true)
+    m_bResizable(true),
+    m_aArray(row, col),
+    m_nRows(row),
+    m_nCols(col)
 {   
-    bnu::matrix<double> m(row, col);
-    for ( unsigned int i = 0; i < m.size1(); ++i )
+    for ( size_t i = 0; i < row; ++i )
     {
-        for ( unsigned int j = 0; j < m.size2(); ++j )
+        for ( size_t j = 0; j < col; ++j )
         {
             if (identity_matrix && i == j)
-                m( i, j ) = 1.0;
+                m_aArray( i, j ) = 1.0;
             else
-                m( i, j ) = 0.0;
+                m_aArray( i, j ) = 0.0;
         }
     }
-    m_aArray = m;
 }
 
 Matrix::Matrix( const Matrix& other ) :
     m_bResizable( other.m_bResizable ),
-    m_aArray( other.m_aArray )
+    m_aArray( other.getRange() ),
+    m_nRows( other.m_nRows ),
+    m_nCols( other.m_nCols )
 {
 }
 
 Matrix::Matrix( const Matrix* p ) :
     m_bResizable( p->m_bResizable ),
-    m_aArray( p->m_aArray )
+    m_aArray( p->getRange() ),
+    m_nRows( p->m_nRows ),
+    m_nCols( p->m_nCols )
 {
 }
 
-Matrix::Matrix( bnu::matrix<double> m ) : m_bResizable( true )
+Matrix::Matrix( bnu::matrix<double> m ) : 
+    m_bResizable( true ),
+    m_aArray( m ),
+    m_nRows( m.size1() ),
+    m_nCols( m.size2() )
 {
-    m_aArray = m;
 }
 
 Matrix::~Matrix() throw()
@@ -427,11 +445,15 @@ void Matrix::swap( Matrix& other ) throw()
 {
     m_aArray.swap( other.m_aArray );
     std::swap( m_bResizable, other.m_bResizable );
+    std::swap( m_nRows, other.m_nRows );
+    std::swap( m_nCols, other.m_nCols );
 }
 
 void Matrix::clear()
 {
-    m_aArray.resize( 0, 0 );
+    m_aArray.resize( 0, 0, false );
+    m_nRows = 0;
+    m_nCols = 0;
 }
 
 void Matrix::copy( const Matrix& other )
@@ -448,32 +470,20 @@ Matrix Matrix::clone() const
 
 const double Matrix::getValue(size_t row, size_t col) const
 {
-    try
-    {
-        return m_aArray(row, col);
-    }
-    catch (const ::boost::numeric::ublas::bad_index&)
-    {
-        throw BadIndex();
-    }
+    throwIfOutOfBound(row, col);
+    return m_aArray(row, col);
 }
 
 double& Matrix::getValue(size_t row, size_t col)
 {
-    try
-    {
-        return m_aArray(row, col);
-    }
-    catch (const ::boost::numeric::ublas::bad_index&)
-    {
-        throw BadIndex();
-    }
+    throwIfOutOfBound(row, col);
+    return m_aArray(row, col);
 }
 
 void Matrix::setValue(size_t row, size_t col, double val)
 {
     maybeExpand(row, col);
-    m_aArray(row, col) = val;
+    getValue(row, col) = val;
 }
 
 Matrix Matrix::getColumn(size_t col)
@@ -498,22 +508,20 @@ Matrix Matrix::getRow(size_t row)
 
 void Matrix::deleteColumn( size_t nColId )
 {
-    if ( nColId >= m_aArray.size2() )
+    if ( nColId >= m_nCols )
     {
         Debug( "deleteColumn" );
         throw MatrixSizeMismatch();
     }
 
-    bnu::matrix<double> m( m_aArray.size1(), m_aArray.size2()-1 );
-    for ( size_t i = 0; i < m_aArray.size1(); ++i )
-        for ( size_t j = 0; j < m_aArray.size2(); ++j )
-        {
-            if ( j == nColId )
-                continue;
-            size_t j2 = j > nColId ? j - 1 : j;
-            m( i, j2 ) = m_aArray( i, j );
-        }
-    m_aArray = m;
+    // Shift the columns to the right of the deleted one in place.  The 
+    // storage is kept as spare capacity.
+    for ( size_t i = 0; i < m_nRows; ++i )
+    {
+        for ( size_t j = nColId + 1; j < m_nCols; ++j )
+            m_aArray( i, j - 1 ) = m_aArray( i, j );
+    }
+    --m_nCols;
 }
 
 void Matrix::deleteColumns( const std::vector<size_t>& cnColIds )
@@ -533,21 +541,18 @@ void Matrix::deleteColumns( const std::vector<size_t>& cnColIds )
 
 void Matrix::deleteRow( size_t nRowId )
 {
-    if ( nRowId >= m_aArray.size1() )
+    if ( nRowId >= m_nRows )
     {
         Debug( "deleteRow" );
         throw MatrixSizeMismatch();
     }
 
-    bnu::matrix<double> m( m_aArray.size1()-1, m_aArray.size2() );
-    for ( size_t i = 0; i < m_aArray.size1(); ++i )
-        if ( i != nRowId )
-        {
-            size_t i2 = i > nRowId ? i - 1 : i;
-            for ( size_t j = 0; j < m_aArray.size2(); ++j )
-                m( i2, j ) = m_aArray( i, j );
-        }
-    m_aArray = m;
+    for ( size_t i = nRowId + 1; i < m_nRows; ++i )
+    {
+        for ( size_t j = 0; j < m_nCols; ++j )
+            m_aArray( i - 1, j ) = m_aArray( i, j );
+    }
+    --m_nRows;
 }
 
 void Matrix::deleteRows( const std::vector<size_t>& cnRowIds )
@@ -595,17 +600,14 @@ double Matrix::det() const
         throw NonSquareMatrix();
     }
 
+    // Small matrices are copied onto the stack and use the closed-form
+    // expressions.
     if ( cols() == 1 )
         return getValue( 0, 0 );
     else if ( cols() == 2 )
-        return getValue( 0, 0 )*getValue( 1, 1 ) - getValue( 0, 1 )*getValue( 1, 0 );
+        return FixedMatrix<2, 2>( *this ).det();
     else if ( cols() == 3 )
-        return getValue( 0, 0 )*getValue( 1, 1 )*getValue( 2, 2 ) - 
-            getValue( 0, 0 )*getValue( 1, 2 )*getValue( 2, 1 ) - 
-            getValue( 1, 0 )*getValue( 0, 1 )*getValue( 2, 2 ) +
-            getValue( 1, 0 )*getValue( 0, 2 )*getValue( 2, 1 ) +
-            getValue( 2, 0 )*getValue( 0, 1 )*getValue( 1, 2 ) -
-            getValue( 2, 0 )*getValue( 0, 2 )*getValue( 1, 1 );
+        return FixedMatrix<3, 3>( *this ).det();
 
     double fSum = 0.0;
     
@@ -633,8 +635,8 @@ const Matrix Matrix::inverse() const
         throw MatrixSizeMismatch();
     }
 
-    bnu::matrix<double> mxAInv( m_aArray.size1(), m_aArray.size2() );
-    mxhelper::inverse( m_aArray, mxAInv );
+    bnu::matrix<double> mxAInv( m_nRows, m_nCols );
+    mxhelper::inverse( getRange(), mxAInv );
     Matrix mxInv( mxAInv );
     mxInv.setResizable( m_bResizable );
 
@@ -644,7 +646,7 @@ const Matrix Matrix::inverse() const
 const Matrix Matrix::trans() const
 {
     throwIfEmpty();
-    Matrix m( ::boost::numeric::ublas::trans( m_aArray ) );
+    Matrix m( ::boost::numeric::ublas::trans( getRange() ) );
     m.m_bResizable = m_bResizable;
     return m;
 }
@@ -670,31 +672,44 @@ double Matrix::minors( size_t iSkip, size_t jSkip ) const
 
 void Matrix::resize(size_t row, size_t col)
 {
-#if USE_BOOST_1_30_2
-#ifdef __GNUC__
-#warning "using workaround for boost 1.30.2 which has a buggy resize"
-#endif
-    bnu::matrix<double, bnu::row_major, std::vector<double> > aArray(row, col);
+    if ( row > m_aArray.size1() || col > m_aArray.size2() )
+        reallocate( ::std::max(row, m_aArray.size1()), ::std::max(col, m_aArray.size2()) );
 
-    size_t nRowSize = m_aArray.size1() < row ? m_aArray.size1() : row;
-    size_t nColSize = m_aArray.size2() < col ? m_aArray.size2() : col;
-    for ( size_t nRowId = 0; nRowId < nRowSize; ++nRowId )
-        for ( size_t nColId = 0; nColId < nColSize; ++nColId )
-            aArray( nRowId, nColId ) = m_aArray( nRowId, nColId );
-    
-    m_aArray.swap( aArray );
-#else
-    // boost 1.30.2 has a bug in resize().  Works in 1.32.0.
-    m_aArray.resize( row, col, true );
-#endif
+    // Zero out the elements that become visible by this resize, since they
+    // may still hold stale values from before the last shrink.
+    for ( size_t i = 0; i < row; ++i )
+    {
+        size_t nColStart = i < m_nRows ? m_nCols : 0;
+        for ( size_t j = nColStart; j < col; ++j )
+            m_aArray( i, j ) = 0.0;
+    }
+
+    m_nRows = row;
+    m_nCols = col;
+}
+
+void Matrix::reserve(size_t row, size_t col)
+{
+    if ( row > m_aArray.size1() || col > m_aArray.size2() )
+        reallocate( ::std::max(row, m_aArray.size1()), ::std::max(col, m_aArray.size2()) );
 }
 
 size_t Matrix::rows() const 
 { 
-    return m_aArray.size1(); 
+    return m_nRows; 
 }
 
 size_t Matrix::cols() const
+{
+    return m_nCols;
+}
+
+size_t Matrix::rowCapacity() const
+{
+    return m_aArray.size1();
+}
+
+size_t Matrix::colCapacity() const
 {
     return m_aArray.size2();
 }
@@ -706,12 +721,12 @@ bool Matrix::empty() const
 
 bool Matrix::isRowEmpty( size_t nRow ) const
 {
-    return mxhelper::isRowEmpty( m_aArray, nRow );
+    return mxhelper::isRowEmpty( getRange(), nRow );
 }
 
 bool Matrix::isColumnEmpty( size_t nCol ) const
 {
-    return mxhelper::isColumnEmpty( m_aArray, nCol );
+    return mxhelper::isColumnEmpty( getRange(), nCol );
 }
 
 bool Matrix::isSameSize( const Matrix& r ) const
@@ -785,7 +800,7 @@ const Matrix Matrix::operator*( const Matrix& r ) const
         throw MatrixSizeMismatch();
     }
     
-    Matrix m( prod( m_aArray, r.m_aArray ) );
+    Matrix m( prod( getRange(), r.getRange() ) );
     return m;
 }
 
@@ -862,17 +877,39 @@ bool Matrix::operator!=( const Matrix& other ) const
 
 void Matrix::maybeExpand(size_t row, size_t col)
 {
-    if ( m_bResizable )
+    if ( !m_bResizable || (row < m_nRows && col < m_nCols) )
+        return;
+
+    size_t nNewRowSize = row + 1 > m_nRows ? row + 1 : m_nRows;
+    size_t nNewColSize = col + 1 > m_nCols ? col + 1 : m_nCols;
+
+    // Grow the capacity geometrically so that filling a matrix one element
+    // at a time only triggers a logarithmic number of re-allocations.
+    size_t nRowCap = m_aArray.size1(), nColCap = m_aArray.size2();
+    if ( nNewRowSize > nRowCap || nNewColSize > nColCap )
     {
-        size_t nRowSize = m_aArray.size1();
-        size_t nColSize = m_aArray.size2();
-        if ( row >= nRowSize || col >= nColSize )
-        {
-            size_t nNewRowSize = row + 1 > nRowSize ? row + 1 : nRowSize;
-            size_t nNewColSize = col + 1 > nColSize ? col + 1 : nColSize;
-            resize( nNewRowSize, nNewColSize );
-        }
+        if ( nNewRowSize > nRowCap )
+            nRowCap = ::std::max(nNewRowSize, nRowCap*2);
+        if ( nNewColSize > nColCap )
+            nColCap = ::std::max(nNewColSize, nColCap*2);
+        reallocate( nRowCap, nColCap );
     }
+
+    resize( nNewRowSize, nNewColSize );
+}
+
+/**
+ * Move the logical content into a new storage array of specified
+ * capacity.  The logical size stays the same.
+ */
+void Matrix::reallocate(size_t row, size_t col)
+{
+    NumericMatrixType aArray(row, col);
+    for ( size_t i = 0; i < m_nRows; ++i )
+        for ( size_t j = 0; j < m_nCols; ++j )
+            aArray( i, j ) = m_aArray( i, j );
+
+    m_aArray.swap( aArray );
 }
 
 void Matrix::throwIfEmpty() const
@@ -881,6 +918,17 @@ void Matrix::throwIfEmpty() const
         throw OperationOnEmptyMatrix();
 }
 
+void Matrix::throwIfOutOfBound(size_t row, size_t col) const
+{
+    if ( row >= m_nRows || col >= m_nCols )
+        throw BadIndex();
+}
+
+Matrix::ConstRangeType Matrix::getRange() const
+{
+    return ConstRangeType( m_aArray, bnu::range(0, m_nRows), bnu::range(0, m_nCols) );
+}
+
 Matrix::StringMatrixType Matrix::getDisplayElements( 
         int prec, size_t nColSpace, bool bFormula) const
 {
@@ -889,13 +937,13 @@ Matrix::StringMatrixType Matrix::getDisplayElements(
 
     // Set all column widths to 0.
     std::vector<unsigned int> aColLen;
-    for ( unsigned int j = 0; j < m_aArray.size2(); ++j )
+    for ( unsigned int j = 0; j < m_nCols; ++j )
         aColLen.push_back( 0 );
     
     // Get string matrix.
-    StringMatrixType mxElements( m_aArray.size1(), m_aArray.size2() );
-    for ( unsigned int i = 0; i < m_aArray.size1(); ++i )
-        for ( unsigned int j = 0; j < m_aArray.size2(); ++j )
+    StringMatrixType mxElements( m_nRows, m_nCols );
+    for ( unsigned int i = 0; i < m_nRows; ++i )
+        for ( unsigned int j = 0; j < m_nCols; ++j )
         {
             ::std::ostringstream osElem;
             double fVal = m_aArray( i, j );
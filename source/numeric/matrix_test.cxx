@@ -16,10 +16,14 @@
  ****************************************************************************/
 
 #include "numeric/matrix.hxx"
+#include "numeric/fixedmatrix.hxx"
+#include <cmath>
 #include <stdio.h>
 
 using namespace ::scsolver::numeric;
 
+class TestFailed {};
+
 void basicIO()
 {
     printf("Original empty matrix\n");
@@ -100,9 +104,116 @@ void basicIO()
     mxi.print();
 }
 
+void incrementalGrowth()
+{
+    printf("Filling a column matrix one element at a time\n");
+    Matrix mx;
+    size_t nRealloc = 0, nCap = mx.rowCapacity();
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        mx(i, 0) = static_cast<double>(i);
+        if (mx.rowCapacity() != nCap)
+        {
+            ++nRealloc;
+            nCap = mx.rowCapacity();
+        }
+    }
+    printf("size = (%lu, %lu)  capacity = (%lu, %lu)  re-allocations = %lu\n",
+           static_cast<unsigned long>(mx.rows()), static_cast<unsigned long>(mx.cols()),
+           static_cast<unsigned long>(mx.rowCapacity()), static_cast<unsigned long>(mx.colCapacity()),
+           static_cast<unsigned long>(nRealloc));
+    if (mx.rows() != 1000 || mx.cols() != 1 || nRealloc > 12)
+        throw TestFailed();
+    for (size_t i = 0; i < 1000; ++i)
+        if (mx(i, 0) != static_cast<double>(i))
+            throw TestFailed();
+
+    printf("Shrinking and expanding within capacity\n");
+    mx.resize(10, 1);
+    mx.resize(20, 2);
+    for (size_t i = 10; i < 20; ++i)
+        if (mx(i, 0) != 0.0)
+            throw TestFailed(); // stale value exposed
+    for (size_t i = 0; i < 20; ++i)
+        if (mx(i, 1) != 0.0)
+            throw TestFailed();
+
+    printf("Reserving space up front\n");
+    Matrix mx2;
+    mx2.reserve(50, 50);
+    if (!mx2.empty() || mx2.rowCapacity() != 50 || mx2.colCapacity() != 50)
+        throw TestFailed();
+    for (size_t i = 0; i < 50; ++i)
+        mx2(0, i) = 1.0;
+    if (mx2.rowCapacity() != 50 || mx2.colCapacity() != 50)
+        throw TestFailed();
+
+    printf("Deleting rows and columns\n");
+    Matrix mx3(3, 3);
+    for (size_t i = 0; i < 3; ++i)
+        for (size_t j = 0; j < 3; ++j)
+            mx3(i, j) = i*3 + j;
+    mx3.deleteRow(1);
+    mx3.deleteColumn(0);
+    mx3.print();
+    if (mx3.rows() != 2 || mx3.cols() != 2 || mx3(0, 0) != 1.0 || mx3(1, 1) != 8.0)
+        throw TestFailed();
+    mx3(2, 2) = 5.0;
+    if (mx3(2, 0) != 0.0 || mx3(0, 2) != 0.0 || mx3(1, 2) != 0.0)
+        throw TestFailed();
+}
+
+void fixedSize()
+{
+    printf("Fixed-size matrices\n");
+    FixedMatrix<3, 3> A;
+    A(0, 0) = 2.0; A(0, 1) = 1.0; A(0, 2) = -1.0;
+    A(1, 0) = -3.0; A(1, 1) = -1.0; A(1, 2) = 2.0;
+    A(2, 0) = -2.0; A(2, 1) = 1.0; A(2, 2) = 2.0;
+    A.print();
+
+    // The determinant must agree with the dynamically-sized matrix.
+    Matrix mx = A.toMatrix();
+    printf("det = %g (fixed)  %g (dynamic)\n", A.det(), mx.det());
+    if (A.det() != mx.det() || std::fabs(A.det() + 1.0) > 1e-12)
+        throw TestFailed();
+
+    FixedMatrix<3, 1> b;
+    b(0, 0) = 8.0; b(1, 0) = -11.0; b(2, 0) = -3.0;
+    FixedMatrix<3, 1> x = A.solve(b);
+    printf("x = ");
+    x.trans().print();
+    if (std::fabs(x(0, 0) - 2.0) > 1e-12 || std::fabs(x(1, 0) - 3.0) > 1e-12 || 
+        std::fabs(x(2, 0) + 1.0) > 1e-12)
+        throw TestFailed();
+
+    FixedMatrix<3, 1> r = A*x - b;
+    if (std::fabs((r.trans()*r)(0, 0)) > 1e-20)
+        throw TestFailed();
+
+    if (FixedMatrix<3, 3>(mx) != A)
+        throw TestFailed();
+
+    FixedMatrix<4, 4> I(true);
+    if (I.det() != 1.0)
+        throw TestFailed();
+
+    try
+    {
+        FixedMatrix<2, 2> bad(mx);
+        throw TestFailed();
+    }
+    catch (const MatrixSizeMismatch&)
+    {
+        printf("MatrixSizeMismatch exception caught on size mismatch.\n");
+    }
+}
+
 int main()
 {
     printf("unit test: Matrix\n");
     basicIO();
+    incrementalGrowth();
+    fixedSize();
     printf("Unit test passed!\n");
 }
@@ -0,0 +1,615 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/multistart.hxx"
+#include "numeric/nlpmodel.hxx"
+#include "numeric/funcobj.hxx"
+#include "numeric/exception.hxx"
+#include "numeric/solvecontrol.hxx"
+#include "tool/thread.hxx"
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using ::std::vector;
+using ::std::string;
+using ::std::auto_ptr;
+using ::std::cout;
+using ::std::endl;
+
+namespace scsolver { namespace numeric { namespace nlp {
+
+namespace {
+
+const size_t DEFAULT_START_COUNT = 20;
+const double DEFAULT_BASIN_RADIUS = 0.1;
+
+/** local optima closer than this, relative to the sampled ranges, are
+	taken to be the same one. */
+const double SAME_OPTIMUM_DISTANCE = 1e-4;
+
+/** time limit of a local run, when the search has almost none left. */
+const double MIN_TIME_LIMIT = 1e-3;
+
+double nextRandom( unsigned long& nSeed )
+{
+	nSeed = ( nSeed*1103515245UL + 12345UL ) & 0x7fffffffUL;
+	return static_cast<double>( nSeed )/0x7fffffff;
+}
+
+enum RunResult
+{
+	RUN_OPTIMUM,
+	RUN_SKIPPED,
+	RUN_MAX_ITERATION,
+	RUN_TIMED_OUT,
+	RUN_CANCELLED,
+	RUN_FAILED
+};
+
+/** Local optimum, and how many runs have ended in it. */
+struct Basin
+{
+	vector<double> Point;
+	double Value;
+	size_t Hits;
+};
+
+}
+
+class MultiStartImpl;
+
+/**
+ * Runs the local algorithm from the starts it takes from the search, with
+ * its own copy of the model and of the function object.  The first worker
+ * runs in the calling thread, the others in threads of their own.
+ */
+class MultiStartWorker : public ::scsolver::Thread
+{
+public:
+	MultiStartWorker( MultiStartImpl* pImpl, const Model& rModel, auto_ptr<BaseFuncObj> pClone,
+					  auto_ptr<BaseAlgorithm> pAlgorithm );
+	virtual ~MultiStartWorker() throw() {}
+
+	void runStarts();
+
+	void releaseModel();
+
+protected:
+	virtual void run()
+	{
+		runStarts();
+	}
+
+private:
+	RunResult runStart( const vector<double>& rStart, vector<double>& rPoint, double& rValue,
+						string& rMessage );
+
+	MultiStartImpl* m_pImpl;
+	Model m_aModel;
+	auto_ptr<BaseFuncObj> m_pClone;
+	auto_ptr<BaseAlgorithm> m_pAlgorithm;
+	SolveControl m_aControl;
+};
+
+//---------------------------------------------------------------------------
+// MultiStartImpl
+
+/**
+ * The mutex protects the next start to hand out, the basins and the
+ * counters, which the workers update as their runs end, and the calls to
+ * the progress listener.
+ */
+class MultiStartImpl
+{
+public:
+	MultiStartImpl( MultiStart* pSelf, auto_ptr<AlgorithmFactory> pFactory );
+	~MultiStartImpl() throw();
+
+	void solve();
+
+	void setStartCount( size_t nCount ) { m_nStartCount = nCount; }
+	size_t getStartCount() const { return m_nStartCount; }
+	void setThreadCount( size_t nCount ) { m_nThreadCount = nCount; }
+	size_t getThreadCount() const { return m_nThreadCount; }
+	void setSeed( unsigned long nSeed ) { m_nSeed = nSeed; }
+	void setBasinRadius( double fRadius ) { m_fBasinRadius = fRadius; }
+	size_t getBasinCount() const { return m_aBasins.size(); }
+	size_t getSolvedCount() const { return m_nSolved; }
+	size_t getSkippedCount() const { return m_nSkipped; }
+
+	SolveControl& getControl() const { return *m_pSelf->getSolveControl(); }
+
+	/**
+	 * Hand out the next start.
+	 *
+	 * @return bool false when there is none left, or the search has to
+	 *         stop.
+	 */
+	bool takeStart( size_t& rStart );
+
+	const vector<double>& getStart( size_t nStart ) const { return m_aStarts[nStart]; }
+
+	/**
+	 * @return bool true if a known optimum near the start is at least as
+	 *         good as the start itself.
+	 */
+	bool isCovered( const vector<double>& rStart, double fValue );
+
+	/** Record the end of a run; called in the thread of its worker. */
+	void endStart( size_t nStart, RunResult eResult, const vector<double>& rPoint, double fValue,
+				   const string& rMessage );
+
+private:
+	void sampleStarts( const Model& rModel );
+	void createWorkers( size_t nThreads );
+	void runWorkers();
+	void clearWorkers();
+	double getDistance( const vector<double>& rA, const vector<double>& rB ) const;
+	bool isBetter( double fA, double fB ) const;
+	bool isStopRequested() const;
+	void throwResult( RunResult eResult, const string& rMessage ) const;
+
+	MultiStart* m_pSelf;
+	auto_ptr<AlgorithmFactory> m_pFactory;
+	size_t m_nStartCount;
+	size_t m_nThreadCount;
+	unsigned long m_nSeed;
+	double m_fBasinRadius;
+
+	GoalType m_eGoal;
+	vector< vector<double> > m_aStarts;
+	vector<double> m_aRange;
+	vector<MultiStartWorker*> m_aWorkers;
+
+	Mutex m_aMutex;
+	size_t m_nNextStart;
+	vector<Basin> m_aBasins;
+	size_t m_nBest;
+	size_t m_nSolved;
+	size_t m_nSkipped;
+	size_t m_nFirstError;
+	RunResult m_eFirstError;
+	string m_sFirstError;
+};
+
+MultiStartWorker::MultiStartWorker( MultiStartImpl* pImpl, const Model& rModel,
+									auto_ptr<BaseFuncObj> pClone, auto_ptr<BaseAlgorithm> pAlgorithm ) :
+	m_pImpl( pImpl ), m_aModel( rModel ), m_pClone( pClone ), m_pAlgorithm( pAlgorithm )
+{
+	if ( m_pClone.get() )
+		m_aModel.setFuncObject( m_pClone.get() );
+	m_aModel.setVerbose( false );
+
+	const SolveControl& rControl = m_pImpl->getControl();
+	m_aControl.setParent( &rControl );
+	m_aControl.setIterationLimit( rControl.getIterationLimit() );
+	m_aControl.setEvaluationLimit( rControl.getEvaluationLimit() );
+	m_pAlgorithm->setModel( &m_aModel );
+	m_pAlgorithm->setSolveControl( &m_aControl );
+}
+
+void MultiStartWorker::runStarts()
+{
+	size_t nStart;
+	while ( m_pImpl->takeStart( nStart ) )
+	{
+		vector<double> aPoint;
+		double fValue = 0.0;
+		string sMessage;
+		RunResult eResult = runStart( m_pImpl->getStart( nStart ), aPoint, fValue, sMessage );
+		m_pImpl->endStart( nStart, eResult, aPoint, fValue, sMessage );
+	}
+}
+
+RunResult MultiStartWorker::runStart( const vector<double>& rStart, vector<double>& rPoint,
+									  double& rValue, string& rMessage )
+{
+	try
+	{
+		BaseFuncObj& rFuncObj = *m_aModel.getFuncObject();
+		if ( m_pImpl->isCovered( rStart, rFuncObj( rStart ) ) )
+			return RUN_SKIPPED;
+
+		const SolveControl& rControl = m_pImpl->getControl();
+		if ( rControl.getTimeLimit() > 0.0 )
+			m_aControl.setTimeLimit( ::std::max( rControl.getRemainingTime( 0.0 ), MIN_TIME_LIMIT ) );
+		m_aControl.start();
+
+		m_aModel.setVars( rStart );
+		m_pAlgorithm->solve();
+		m_pAlgorithm->getSolution( rPoint );
+		rValue = rFuncObj( rPoint );
+		return RUN_OPTIMUM;
+	}
+	catch ( const MaxIterationReached& )
+	{
+		return RUN_MAX_ITERATION;
+	}
+	catch ( const IterationTimedOut& )
+	{
+		return RUN_TIMED_OUT;
+	}
+	catch ( const SolveCancelled& )
+	{
+		return RUN_CANCELLED;
+	}
+	catch ( const ::std::exception& e )
+	{
+		rMessage = e.what();
+	}
+	return RUN_FAILED;
+}
+
+void MultiStartWorker::releaseModel()
+{
+	m_pAlgorithm->setModel( NULL );
+	m_pAlgorithm->setSolveControl( NULL );
+}
+
+MultiStartImpl::MultiStartImpl( MultiStart* pSelf, auto_ptr<AlgorithmFactory> pFactory ) :
+	m_pSelf( pSelf ),
+	m_pFactory( pFactory ),
+	m_nStartCount( DEFAULT_START_COUNT ),
+	m_nThreadCount( 1 ),
+	m_nSeed( 1 ),
+	m_fBasinRadius( DEFAULT_BASIN_RADIUS ),
+	m_eGoal( GOAL_MINIMIZE ),
+	m_nNextStart( 0 ),
+	m_nBest( 0 ),
+	m_nSolved( 0 ),
+	m_nSkipped( 0 ),
+	m_nFirstError( 0 ),
+	m_eFirstError( RUN_OPTIMUM )
+{
+}
+
+MultiStartImpl::~MultiStartImpl() throw()
+{
+	clearWorkers();
+}
+
+/**
+ * The first start is the current point.  The others take, for each
+ * variable, one value from each of m equal slices of its range, m being
+ * their number, in an order shuffled per variable.
+ */
+void MultiStartImpl::sampleStarts( const Model& rModel )
+{
+	vector<double> aVars;
+	rModel.getVars( aVars );
+	size_t nVarCount = aVars.size();
+	size_t nSampleCount = m_nStartCount > 1 ? m_nStartCount - 1 : 0;
+
+	vector<double> aLower( nVarCount );
+	m_aRange.assign( nVarCount, 1.0 );
+	for ( size_t j = 0; j < nVarCount; ++j )
+	{
+		double fSpan = ::std::max( 1.0, ::std::fabs( aVars[j] ) );
+		bool bLower = rModel.isVarBounded( j, BOUND_LOWER );
+		bool bUpper = rModel.isVarBounded( j, BOUND_UPPER );
+		double fLower = bLower ? rModel.getVarBound( j, BOUND_LOWER ) : aVars[j] - fSpan;
+		double fUpper = bUpper ? rModel.getVarBound( j, BOUND_UPPER ) : aVars[j] + fSpan;
+		if ( !bLower && fLower >= fUpper )
+			fLower = fUpper - fSpan;
+		if ( !bUpper && fUpper <= fLower )
+			fUpper = fLower + fSpan;
+		aLower[j] = fLower;
+		if ( fUpper > fLower )
+			m_aRange[j] = fUpper - fLower;
+		else
+			m_aRange[j] = 0.0;
+	}
+
+	m_aStarts.assign( 1, aVars );
+	m_aStarts.resize( 1 + nSampleCount, vector<double>( nVarCount ) );
+	unsigned long nSeed = m_nSeed;
+	vector<size_t> aSlices( nSampleCount );
+	for ( size_t j = 0; j < nVarCount; ++j )
+	{
+		for ( size_t k = 0; k < nSampleCount; ++k )
+			aSlices[k] = k;
+		for ( size_t k = nSampleCount; k > 1; --k )
+		{
+			size_t nPick = static_cast<size_t>( nextRandom( nSeed )*k );
+			::std::swap( aSlices[k - 1], aSlices[::std::min( nPick, k - 1 )] );
+		}
+		for ( size_t k = 0; k < nSampleCount; ++k )
+			m_aStarts[k + 1][j] = aLower[j] +
+				m_aRange[j]*( aSlices[k] + nextRandom( nSeed ) )/nSampleCount;
+	}
+
+	// A fixed variable has no range to measure distances by.
+	for ( size_t j = 0; j < nVarCount; ++j )
+		if ( m_aRange[j] <= 0.0 )
+			m_aRange[j] = 1.0;
+}
+
+/**
+ * @return double root mean square of the differences, each relative to
+ *         the sampled range of its variable.
+ */
+double MultiStartImpl::getDistance( const vector<double>& rA, const vector<double>& rB ) const
+{
+	size_t n = ::std::min( rA.size(), rB.size() );
+	if ( n == 0 )
+		return 0.0;
+
+	double fSum = 0.0;
+	for ( size_t j = 0; j < n; ++j )
+	{
+		double fDiff = ( rA[j] - rB[j] )/m_aRange[j];
+		fSum += fDiff*fDiff;
+	}
+	return ::std::sqrt( fSum/n );
+}
+
+bool MultiStartImpl::isBetter( double fA, double fB ) const
+{
+	return m_eGoal == GOAL_MAXIMIZE ? fA > fB : fA < fB;
+}
+
+bool MultiStartImpl::isStopRequested() const
+{
+	const SolveControl& rControl = getControl();
+	return rControl.isCancelled() || rControl.isTimedOut();
+}
+
+bool MultiStartImpl::takeStart( size_t& rStart )
+{
+	MutexGuard aGuard( m_aMutex );
+	if ( m_nNextStart >= m_aStarts.size() || isStopRequested() )
+		return false;
+	rStart = m_nNextStart++;
+	return true;
+}
+
+bool MultiStartImpl::isCovered( const vector<double>& rStart, double fValue )
+{
+	if ( m_fBasinRadius <= 0.0 )
+		return false;
+
+	MutexGuard aGuard( m_aMutex );
+	for ( size_t i = 0; i < m_aBasins.size(); ++i )
+	{
+		const Basin& rBasin = m_aBasins[i];
+		if ( getDistance( rStart, rBasin.Point ) <= m_fBasinRadius && !isBetter( fValue, rBasin.Value ) )
+			return true;
+	}
+	return false;
+}
+
+void MultiStartImpl::endStart( size_t nStart, RunResult eResult, const vector<double>& rPoint,
+							   double fValue, const string& rMessage )
+{
+	MutexGuard aGuard( m_aMutex );
+	if ( eResult != RUN_SKIPPED )
+		++m_nSolved;
+
+	switch ( eResult )
+	{
+	case RUN_OPTIMUM:
+	{
+		size_t nBasin = 0;
+		while ( nBasin < m_aBasins.size() &&
+				getDistance( rPoint, m_aBasins[nBasin].Point ) > SAME_OPTIMUM_DISTANCE )
+			++nBasin;
+		if ( nBasin == m_aBasins.size() )
+		{
+			Basin aBasin;
+			aBasin.Point = rPoint;
+			aBasin.Value = fValue;
+			aBasin.Hits = 0;
+			m_aBasins.push_back( aBasin );
+		}
+		Basin& rBasin = m_aBasins[nBasin];
+		++rBasin.Hits;
+		if ( isBetter( fValue, rBasin.Value ) )
+		{
+			rBasin.Point = rPoint;
+			rBasin.Value = fValue;
+		}
+		if ( isBetter( rBasin.Value, m_aBasins[m_nBest].Value ) )
+			m_nBest = nBasin;
+		break;
+	}
+	case RUN_SKIPPED:
+		++m_nSkipped;
+		break;
+	default:
+		// Keep the error of the lowest start, whichever thread ran it.
+		if ( m_eFirstError == RUN_OPTIMUM || nStart < m_nFirstError )
+		{
+			m_nFirstError = nStart;
+			m_eFirstError = eResult;
+			m_sFirstError = rMessage;
+		}
+	}
+
+	SolveProgress aProgress;
+	aProgress.Iteration = m_nSolved + m_nSkipped;
+	if ( !m_aBasins.empty() )
+	{
+		aProgress.Objective = m_aBasins[m_nBest].Value;
+		aProgress.HasObjective = true;
+	}
+	getControl().reportProgress( aProgress );
+}
+
+void MultiStartImpl::createWorkers( size_t nThreads )
+{
+	Model* pModel = m_pSelf->getModel();
+	for ( size_t i = 0; i < nThreads; ++i )
+	{
+		auto_ptr<BaseFuncObj> pClone;
+		if ( nThreads > 1 )
+			pClone = pModel->getFuncObject()->clone();
+		m_aWorkers.push_back( new MultiStartWorker( this, *pModel, pClone, m_pFactory->create() ) );
+	}
+}
+
+/**
+ * Run the first worker in the calling thread and the others in threads
+ * of their own, and wait until all of them have ended.
+ */
+void MultiStartImpl::runWorkers()
+{
+	for ( size_t i = 1; i < m_aWorkers.size(); ++i )
+		if ( !m_aWorkers[i]->start() )
+			m_aWorkers[i]->runStarts();
+	m_aWorkers[0]->runStarts();
+	for ( size_t i = 1; i < m_aWorkers.size(); ++i )
+		m_aWorkers[i]->join();
+}
+
+void MultiStartImpl::clearWorkers()
+{
+	for ( size_t i = 0; i < m_aWorkers.size(); ++i )
+	{
+		m_aWorkers[i]->releaseModel();
+		delete m_aWorkers[i];
+	}
+	m_aWorkers.clear();
+}
+
+void MultiStartImpl::throwResult( RunResult eResult, const string& rMessage ) const
+{
+	switch ( eResult )
+	{
+	case RUN_MAX_ITERATION:
+		throw MaxIterationReached();
+	case RUN_TIMED_OUT:
+		throw IterationTimedOut();
+	case RUN_CANCELLED:
+		throw SolveCancelled();
+	default:
+		throw Exception( rMessage );
+	}
+}
+
+void MultiStartImpl::solve()
+{
+	Model* pModel = m_pSelf->getModel();
+	const SolveControl& rControl = getControl();
+	rControl.check();
+
+	m_eGoal = pModel->getGoal();
+	sampleStarts( *pModel );
+	m_nNextStart = 0;
+	m_aBasins.clear();
+	m_nBest = 0;
+	m_nSolved = 0;
+	m_nSkipped = 0;
+	m_eFirstError = RUN_OPTIMUM;
+	m_sFirstError.clear();
+
+	// Without a clone of the function object, the starts run one after
+	// another on the function object of the model.
+	size_t nThreads = m_nThreadCount > 0 ? m_nThreadCount : Thread::getProcessorCount();
+	nThreads = ::std::min( nThreads, m_aStarts.size() );
+	if ( nThreads > 1 && !pModel->getFuncObject()->clone().get() )
+		nThreads = 1;
+
+	createWorkers( nThreads );
+	runWorkers();
+	clearWorkers();
+
+	if ( m_aBasins.empty() )
+	{
+		if ( rControl.isCancelled() )
+			throw SolveCancelled();
+		if ( rControl.isTimedOut() )
+			throw IterationTimedOut();
+		throwResult( m_eFirstError, m_sFirstError );
+	}
+
+	const Basin& rBest = m_aBasins[m_nBest];
+	if ( pModel->getVerbose() )
+		cout << "multistart: " << m_nSolved << " run(s), " << m_nSkipped << " skipped, "
+			 << m_aBasins.size() << " local optimum(s), best f(x) = " << rBest.Value << endl;
+
+	// The solution is read from the function object of the model.
+	pModel->getFuncObject()->setVars( rBest.Point );
+}
+
+//---------------------------------------------------------------------------
+// MultiStart
+
+MultiStart::MultiStart( auto_ptr<AlgorithmFactory> pFactory ) :
+	BaseAlgorithm(),
+	m_pImpl( new MultiStartImpl( this, pFactory ) )
+{
+}
+
+MultiStart::~MultiStart() throw()
+{
+}
+
+void MultiStart::solve()
+{
+	m_pImpl->solve();
+}
+
+void MultiStart::setStartCount( size_t nCount )
+{
+	m_pImpl->setStartCount( nCount );
+}
+
+size_t MultiStart::getStartCount() const
+{
+	return m_pImpl->getStartCount();
+}
+
+void MultiStart::setThreadCount( size_t nCount )
+{
+	m_pImpl->setThreadCount( nCount );
+}
+
+size_t MultiStart::getThreadCount() const
+{
+	return m_pImpl->getThreadCount();
+}
+
+void MultiStart::setSeed( unsigned long nSeed )
+{
+	m_pImpl->setSeed( nSeed );
+}
+
+void MultiStart::setBasinRadius( double fRadius )
+{
+	m_pImpl->setBasinRadius( fRadius );
+}
+
+size_t MultiStart::getBasinCount() const
+{
+	return m_pImpl->getBasinCount();
+}
+
+size_t MultiStart::getSolvedCount() const
+{
+	return m_pImpl->getSolvedCount();
+}
+
+size_t MultiStart::getSkippedCount() const
+{
+	return m_pImpl->getSkippedCount();
+}
+
+}}}
@@ -0,0 +1,289 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/multistart.hxx"
+#include "numeric/quasinewton.hxx"
+#include "numeric/nlpmodel.hxx"
+#include "numeric/funcobj.hxx"
+#include "numeric/exception.hxx"
+#include "numeric/solvecontrol.hxx"
+#include "numeric/type.hxx"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cmath>
+#include <stdio.h>
+
+using namespace ::scsolver::numeric;
+using namespace ::scsolver::numeric::nlp;
+using ::std::vector;
+using ::std::string;
+using ::std::auto_ptr;
+
+class TestFailed {};
+
+namespace {
+
+void check(bool bCond, const char* msg)
+{
+    if (!bCond)
+    {
+        printf("%s: failed\n", msg);
+        throw TestFailed();
+    }
+    printf("%s: passed\n", msg);
+}
+
+/**
+ * (x^2 - 4)^2 + (y^2 - 1)^2 + x/2 + y/5, with four local minima near
+ * (+-2, +-1).  The global one is near (-2, -1).
+ */
+class DoubleWell : public SimpleFuncObj
+{
+public:
+    explicit DoubleWell(bool bClonable = true) :
+        SimpleFuncObj(2), m_bClonable(bClonable)
+    {
+        setVar(0, 3.0);
+        setVar(1, 1.5);
+    }
+
+    virtual ~DoubleWell() {}
+
+    virtual double eval() const
+    {
+        double x = getVar(0), y = getVar(1);
+        double a = x*x - 4.0, b = y*y - 1.0;
+        return a*a + b*b + 0.5*x + 0.2*y;
+    }
+
+    virtual const string getFuncString() const
+    {
+        return string("(x^2 - 4)^2 + (y^2 - 1)^2 + x/2 + y/5");
+    }
+
+    virtual auto_ptr<BaseFuncObj> clone() const
+    {
+        if (!m_bClonable)
+            return auto_ptr<BaseFuncObj>();
+        return auto_ptr<BaseFuncObj>(new DoubleWell(*this));
+    }
+
+private:
+    bool m_bClonable;
+};
+
+class FailingAlgorithm : public BaseAlgorithm
+{
+public:
+    virtual ~FailingAlgorithm() {}
+    virtual void solve() { throw MaxIterationReached(); }
+};
+
+/** Cancels the solve at the first progress report. */
+class Canceller : public SolveProgressListener
+{
+public:
+    explicit Canceller(SolveControl& rControl) : m_rControl(rControl), m_nCount(0) {}
+    virtual ~Canceller() throw() {}
+    virtual void progress(const SolveProgress&)
+    {
+        ++m_nCount;
+        m_rControl.cancel();
+    }
+    size_t getCount() const { return m_nCount; }
+
+private:
+    SolveControl& m_rControl;
+    size_t m_nCount;
+};
+
+void buildModel(Model& model, BaseFuncObj& func)
+{
+    model.setGoal(GOAL_MINIMIZE);
+    model.setFuncObject(&func);
+    vector<double> vars;
+    func.getVars(vars);
+    for (size_t i = 0; i < vars.size(); ++i)
+    {
+        model.pushVar(vars[i]);
+        model.setVarBound(i, BOUND_LOWER, -3.0);
+        model.setVarBound(i, BOUND_UPPER, 3.0);
+    }
+}
+
+auto_ptr<AlgorithmFactory> createFactory()
+{
+    return auto_ptr<AlgorithmFactory>(new DefaultAlgorithmFactory<QuasiNewton>);
+}
+
+bool isGlobalOptimum(const vector<double>& sol)
+{
+    return sol.size() == 2 && sol[0] < -1.9 && sol[0] > -2.1 && sol[1] < -0.9 && sol[1] > -1.1;
+}
+
+void globalOptimum()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("global optimum\n");
+
+    DoubleWell func;
+    Model model;
+    buildModel(model, func);
+
+    // On its own, the local algorithm stays in the basin of the start.
+    QuasiNewton local;
+    local.setModel(&model);
+    local.solve();
+    vector<double> sol;
+    local.getSolution(sol);
+    printf("local solution: (%g, %g)\n", sol[0], sol[1]);
+    check(!isGlobalOptimum(sol), "local algorithm misses the global optimum");
+
+    func.setVar(0, 3.0);
+    func.setVar(1, 1.5);
+    MultiStart search(createFactory());
+    search.setModel(&model);
+    search.solve();
+    search.getSolution(sol);
+    printf("multistart solution: (%g, %g), %lu run(s), %lu skipped, %lu optimum(s)\n", sol[0], sol[1],
+           static_cast<unsigned long>(search.getSolvedCount()),
+           static_cast<unsigned long>(search.getSkippedCount()),
+           static_cast<unsigned long>(search.getBasinCount()));
+    check(isGlobalOptimum(sol), "global optimum found");
+    check(search.getBasinCount() >= 2, "several local optima found");
+    check(search.getSolvedCount() + search.getSkippedCount() == search.getStartCount(), "all starts used");
+
+    // The same seed gives the same search.
+    size_t nSolved = search.getSolvedCount(), nSkipped = search.getSkippedCount();
+    vector<double> sol2;
+    search.solve();
+    search.getSolution(sol2);
+    check(sol2 == sol && search.getSolvedCount() == nSolved && search.getSkippedCount() == nSkipped,
+          "same search with the same seed");
+
+    // Without pruning, every start runs.
+    search.setBasinRadius(0.0);
+    search.solve();
+    search.getSolution(sol);
+    check(isGlobalOptimum(sol) && search.getSkippedCount() == 0 &&
+          search.getSolvedCount() == search.getStartCount(), "no start skipped without pruning");
+    check(nSkipped > 0, "starts skipped with pruning");
+}
+
+void threadPool()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("thread pool\n");
+
+    DoubleWell func;
+    Model model;
+    buildModel(model, func);
+
+    MultiStart search(createFactory());
+    search.setThreadCount(4);
+    search.setStartCount(40);
+    search.setModel(&model);
+    search.solve();
+    vector<double> sol;
+    search.getSolution(sol);
+    printf("solution: (%g, %g), %lu run(s), %lu skipped\n", sol[0], sol[1],
+           static_cast<unsigned long>(search.getSolvedCount()),
+           static_cast<unsigned long>(search.getSkippedCount()));
+    check(isGlobalOptimum(sol), "global optimum found by four threads");
+    check(search.getSolvedCount() + search.getSkippedCount() == 40, "all starts used");
+
+    // A function object without a clone runs in the calling thread only.
+    DoubleWell cells(false);
+    Model cellModel;
+    buildModel(cellModel, cells);
+    search.setModel(&cellModel);
+    search.solve();
+    search.getSolution(sol);
+    check(isGlobalOptimum(sol), "global optimum found without clones");
+}
+
+void stopping()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("stopping\n");
+
+    DoubleWell func;
+    Model model;
+    buildModel(model, func);
+
+    // A cancelled search keeps the result it has.
+    {
+        SolveControl control;
+        Canceller canceller(control);
+        control.setProgressListener(&canceller);
+        MultiStart search(createFactory());
+        search.setSolveControl(&control);
+        search.setModel(&model);
+        search.solve();
+        check(search.getSolvedCount() == 1 && canceller.getCount() == 1, "search stopped after the first run");
+    }
+
+    // Cancelled before any result.
+    {
+        SolveControl control;
+        control.cancel();
+        MultiStart search(createFactory());
+        search.setSolveControl(&control);
+        search.setModel(&model);
+        bool bThrown = false;
+        try
+        {
+            search.solve();
+        }
+        catch (const SolveCancelled&)
+        {
+            bThrown = true;
+        }
+        check(bThrown, "cancelled without result");
+    }
+
+    // When all runs fail, the error of the first one is thrown.
+    {
+        auto_ptr<AlgorithmFactory> pFactory(new DefaultAlgorithmFactory<FailingAlgorithm>);
+        MultiStart search(pFactory);
+        search.setThreadCount(2);
+        search.setModel(&model);
+        bool bThrown = false;
+        try
+        {
+            search.solve();
+        }
+        catch (const MaxIterationReached&)
+        {
+            bThrown = true;
+        }
+        check(bThrown, "all runs failed");
+    }
+}
+
+}
+
+int main()
+{
+    printf("unit test: multistart\n");
+    globalOptimum();
+    threadPool();
+    stopping();
+    printf("Unit test passed!\n");
+}
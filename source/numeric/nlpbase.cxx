@@ -18,20 +18,69 @@
 #include "numeric/nlpbase.hxx"
 #include "numeric/nlpmodel.hxx"
 #include "numeric/funcobj.hxx"
+#include "numeric/solvecontrol.hxx"
+
+#include <string>
 
 using ::std::vector;
+using ::std::string;
 
 namespace scsolver { namespace numeric { namespace nlp {
 
+namespace {
+
+/**
+ * Function object that forwards to another one, and checks the solve
+ * control at each evaluation.
+ */
+class ControlledFuncObj : public BaseFuncObj
+{
+public:
+    ControlledFuncObj(BaseFuncObj& rFuncObj, const SolveControl& rControl) :
+        m_rFuncObj(rFuncObj), m_rControl(rControl), m_nEvalCount(0)
+    {
+    }
+
+    virtual ~ControlledFuncObj() {}
+
+    virtual void getVars(vector<double>& rVars) const { m_rFuncObj.getVars(rVars); }
+    virtual double getVar(size_t index) const { return m_rFuncObj.getVar(index); }
+    virtual void setVars(const vector<double>& vars) { m_rFuncObj.setVars(vars); }
+    virtual void setVar(size_t index, double var) { m_rFuncObj.setVar(index, var); }
+    virtual size_t getVarCount() const { return m_rFuncObj.getVarCount(); }
+    virtual const string getFuncString() const { return m_rFuncObj.getFuncString(); }
+
+    virtual double eval() const
+    {
+        m_rControl.checkEvaluation(++m_nEvalCount);
+        return m_rFuncObj.eval();
+    }
+
+    void check() const
+    {
+        m_rControl.checkEvaluation(m_nEvalCount);
+    }
+
+private:
+    BaseFuncObj& m_rFuncObj;
+    const SolveControl& m_rControl;
+    mutable size_t m_nEvalCount;
+};
+
+}
+
 struct BaseAlgorithmImpl
 {
 	Model* pModel;
     vector<double> Solution;
     bool Debug;
+    SolveControl* pControl;
+    SolveControl DefaultControl;
 
     BaseAlgorithmImpl() :
         pModel(NULL),
-        Debug(false)
+        Debug(false),
+        pControl(NULL)
     {
     }
 };
@@ -69,5 +118,36 @@ bool BaseAlgorithm::isDebug() const
     return m_pImpl->Debug;
 }
 
+void BaseAlgorithm::setSolveControl(SolveControl* p)
+{
+    m_pImpl->pControl = p;
+}
+
+SolveControl* BaseAlgorithm::getSolveControl() const
+{
+    return m_pImpl->pControl ? m_pImpl->pControl : &m_pImpl->DefaultControl;
+}
+
+//---------------------------------------------------------------------------
+// EvaluationGuard
+
+BaseAlgorithm::EvaluationGuard::EvaluationGuard(BaseAlgorithm& rAlgorithm) :
+    m_pModel(rAlgorithm.getModel()),
+    m_pFuncObj(m_pModel->getFuncObject()),
+    m_pCounter(new ControlledFuncObj(*m_pFuncObj, *rAlgorithm.getSolveControl()))
+{
+    m_pModel->setFuncObject(m_pCounter.get());
+}
+
+BaseAlgorithm::EvaluationGuard::~EvaluationGuard() throw()
+{
+    m_pModel->setFuncObject(m_pFuncObj);
+}
+
+void BaseAlgorithm::EvaluationGuard::check() const
+{
+    static_cast<const ControlledFuncObj*>(m_pCounter.get())->check();
+}
+
 }}}
 
@@ -128,6 +128,13 @@ public:
         vars.swap(tmp);
     }
 
+    void setVars( const vector<double>& vars )
+    {
+        m_Vars.resize(vars.size());
+        for (size_t i = 0; i < vars.size(); ++i)
+            m_Vars[i].Value = vars[i];
+    }
+
     double getVarBound( size_t index, BoundType bound ) const
     {
         switch (bound)
@@ -197,7 +204,11 @@ ModelImpl::ModelImpl() :
 
 ModelImpl::ModelImpl(const ModelImpl& other) : 
     m_pFuncObj(other.m_pFuncObj),
-    m_nPrec(other.m_nPrec)
+    m_Vars(other.m_Vars),
+    m_Constraints(other.m_Constraints),
+    m_nPrec(other.m_nPrec),
+    m_eGoal(other.m_eGoal),
+    m_bVerbose(other.m_bVerbose)
 {
 }
 
@@ -348,6 +359,11 @@ void Model::getVars( vector<double>& vars ) const
     m_pImpl->getVars(vars);
 }
 
+void Model::setVars( const vector<double>& vars )
+{
+    m_pImpl->setVars(vars);
+}
+
 double Model::getVarBound( size_t index, BoundType bound ) const
 {
     return m_pImpl->getVarBound(index, bound);
@@ -17,6 +17,7 @@
 
 #include "numeric/polyeqnsolver.hxx"
 #include "numeric/matrix.hxx"
+#include "numeric/decomposition.hxx"
 #include <stdio.h>
 
 using ::std::list;
@@ -56,6 +57,13 @@ const Matrix PolyEqnSolver::solve()
         throw NotEnoughDataPoints();
     }
 
+    if (nDPSize == 3)
+    {
+        FixedMatrix<3, 1> coef;
+        solveQuadratic(coef);
+        return coef.toMatrix();
+    }
+
     Matrix mxRight(nDPSize, nDPSize), mxLeft(nDPSize, 1);
     list<DataPoint>::const_iterator itr = m_DataPoints.begin(), itrEnd = m_DataPoints.end();
     for (size_t nRow = 0; itr != itrEnd; ++itr, ++nRow)
@@ -72,6 +80,49 @@ const Matrix PolyEqnSolver::solve()
     return mxRight.inverse() * mxLeft;
 }
 
+const Matrix PolyEqnSolver::solveLeastSquares(size_t degree) const
+{
+    size_t nDPSize = m_DataPoints.size();
+    size_t nCoefSize = degree + 1;
+    if (nDPSize < 2 || nDPSize < nCoefSize)
+        throw NotEnoughDataPoints();
+
+    Matrix mxRight(nDPSize, nCoefSize), mxLeft(nDPSize, 1);
+    list<DataPoint>::const_iterator itr = m_DataPoints.begin(), itrEnd = m_DataPoints.end();
+    for (size_t nRow = 0; itr != itrEnd; ++itr, ++nRow)
+    {
+        double varTerm = 1.0;
+        for (size_t nCol = 0; nCol < nCoefSize; ++nCol)
+        {
+            mxRight(nRow, nCol) = varTerm;
+            varTerm *= itr->X;
+        }
+        mxLeft(nRow, 0) = itr->Y;
+    }
+
+    QRDecomposition qr(mxRight);
+    return qr.solve(mxLeft);
+}
+
+void PolyEqnSolver::solveQuadratic(FixedMatrix<3, 1>& coef) const
+{
+    if (m_DataPoints.size() != 3)
+        throw NotEnoughDataPoints();
+
+    FixedMatrix<3, 3> mxRight;
+    FixedMatrix<3, 1> mxLeft;
+    list<DataPoint>::const_iterator itr = m_DataPoints.begin(), itrEnd = m_DataPoints.end();
+    for (size_t nRow = 0; itr != itrEnd; ++itr, ++nRow)
+    {
+        mxRight(nRow, 0) = 1.0;
+        mxRight(nRow, 1) = itr->X;
+        mxRight(nRow, 2) = itr->X * itr->X;
+        mxLeft(nRow, 0) = itr->Y;
+    }
+
+    coef = mxRight.solve(mxLeft);
+}
+
 void PolyEqnSolver::clear()
 {
     m_DataPoints.clear();
@@ -94,4 +145,13 @@ void getQuadraticPeak(double& x, double& y, const Matrix& coef)
     y = x * x * a + x * b + c;
 }
 
+void getQuadraticPeak(double& x, double& y, const FixedMatrix<3, 1>& coef)
+{
+    double a = coef(2, 0);
+    double b = coef(1, 0);
+    double c = coef(0, 0);
+    x = b / (-2.0*a);
+    y = x * x * a + x * b + c;
+}
+
 }}
@@ -221,6 +221,38 @@ void runTest()
     }
 }
 
+void runLeastSquaresTest()
+{
+    printf("--------------------------------------------------------------------\n");
+
+    // Noisy samples of f(x) = 2x^2 - 3x + 1.  The noise sums to zero with
+    // each power of x, so the least squares quadratic recovers f exactly.
+    PolyEqnSolver polySolver;
+    double noise[] = { 0.1, -0.3, 0.2, 0.2, -0.3, 0.1 };
+    for (int i = 0; i < 6; ++i)
+    {
+        double x = i - 2.0;
+        polySolver.addDataPoint(x, 2.0*x*x - 3.0*x + 1.0 + noise[i]);
+    }
+
+    Matrix sol = polySolver.solveLeastSquares(2);
+    printf("least squares solution = ");
+    sol.trans().print(5);
+    if (sol.rows() != 3 || fabs(sol(0, 0) - 1.0) > 1e-12 ||
+        fabs(sol(1, 0) + 3.0) > 1e-12 || fabs(sol(2, 0) - 2.0) > 1e-12)
+        throw TestFailed();
+
+    try
+    {
+        polySolver.solveLeastSquares(6);
+        throw TestFailed();
+    }
+    catch( const NotEnoughDataPoints& )
+    {
+        printf("NotEnoughDataPoints exception caught on degree 6 with 6 data points (expected).\n");
+    }
+}
+
 void runQuadPeakTest()
 {
     QuadPeakTest qpt;
@@ -243,6 +275,7 @@ int main()
     try
     {
         runTest();
+        runLeastSquaresTest();
         runQuadPeakTest();
     }
     catch ( const TestFailed& )
@@ -527,7 +527,8 @@ double QuadFitLineSearch::solve()
         eqnSolver.addDataPoint(data.P1, F(data.P1));
         eqnSolver.addDataPoint(data.P2, F(data.P2));
         eqnSolver.addDataPoint(data.P3, F(data.P3));
-        Matrix sol = eqnSolver.solve();
+        FixedMatrix<3, 1> sol;
+        eqnSolver.solveQuadratic(sol);
         if (debug)
         {
             fprintf(stdout, "QuadFitLineSearch::solve:   3-pt quad equation: ");
@@ -22,6 +22,7 @@
 #include "numeric/funcobj.hxx"
 #include "numeric/matrix.hxx"
 #include "numeric/quadfitlinesearch.hxx"
+#include "numeric/solvecontrol.hxx"
 #include "tool/timer.hxx"
 #include "tool/global.hxx"
 
@@ -44,6 +45,16 @@ using ::std::setprecision;
 
 namespace scsolver { namespace numeric { namespace nlp {
 
+namespace {
+
+/** time limit used when the solve control sets none, in seconds. */
+const double DEFAULT_TIME_LIMIT = 20.0;
+
+/** iteration limit used when the solve control sets none. */
+const size_t DEFAULT_MAX_ITERATION = 500;
+
+}
+
 class QuasiNewtonImpl
 {
 	/**
@@ -68,6 +79,35 @@ class QuasiNewtonImpl
 #endif
 	}
 
+	/**
+	 * Calculate the inner product of two column matrices of identical size
+	 * without creating a temporary 1x1 matrix.
+	 */
+	static double dot( const Matrix& mxA, const Matrix& mxB )
+	{
+		double fSum = 0.0;
+		for ( size_t i = 0; i < mxA.rows(); ++i )
+			fSum += mxA( i, 0 )*mxB( i, 0 );
+		return fSum;
+	}
+
+	/**
+	 * Calculate x^T A x for a square matrix A and a column matrix x.
+	 */
+	static double quadForm( const Matrix& mxX, const Matrix& mxA )
+	{
+		double fSum = 0.0;
+		size_t n = mxX.rows();
+		for ( size_t i = 0; i < n; ++i )
+		{
+			double fRow = 0.0;
+			for ( size_t j = 0; j < n; ++j )
+				fRow += mxA( i, j )*mxX( j, 0 );
+			fSum += mxX( i, 0 )*fRow;
+		}
+		return fSum;
+	}
+
 	static double evalF( BaseFuncObj& oF, const Matrix& mxVars, vector<double>& fVars )
 	{
 		size_t nRows = mxVars.rows();
@@ -116,6 +156,7 @@ public:
 
 		vector<double>::const_iterator it, itBeg = cnVars.begin(), itEnd = cnVars.end();
 		m_mxVars.clear();
+		m_mxVars.reserve( cnVars.size(), 1 );
 		for ( it = itBeg; it != itEnd; ++it )
 			m_mxVars( distance( itBeg, it ), 0 ) = *it;
 
@@ -137,7 +178,7 @@ public:
 
 		m_nIter = 0;
 		cout << setprecision( m_pModel->getPrecision() );
-		::scsolver::Timer mytimer(20); // set timer to 20 sec
+		::scsolver::Timer mytimer( m_pSelf->getSolveControl()->getRemainingTime( DEFAULT_TIME_LIMIT ) );
 		mytimer.init();
 		while ( !runIteration(mytimer) );
         
@@ -177,6 +218,12 @@ private:
 		vector<double> fVars;
 		m_fF = QuasiNewtonImpl::evalF( *m_pFuncObj, m_mxVars, fVars );
 		size_t nRows = fVars.size();
+
+		SolveProgress aProgress;
+		aProgress.Iteration = m_nIter;
+		aProgress.Objective = m_fF;
+		aProgress.HasObjective = true;
+		m_pSelf->getSolveControl()->reportProgress( aProgress );
         if (m_debug)
         {
             fprintf(stdout, "QuasiNewtonImpl::evaluateFunc:   F = %g; var size = %d\n", 
@@ -246,7 +293,7 @@ private:
 			// Both mxD and mxG are columnar matrix.
 			Matrix mxD = m_mxVars - m_mxVarsOld;
 			Matrix mxG = m_mxdF - m_mxdFOld;
-			double fDG = ( mxD.trans()*mxG )( 0, 0 );
+			double fDG = dot( mxD, mxG );
 			if ( fDG == 0.0 )
 			{
 				if (m_debug)
@@ -255,8 +302,7 @@ private:
 			}
 
 			// Calculate new deflection matrix via BFGS formula
-			Matrix mxA = mxG.trans() * m_mxDOld * mxG;
-			double fA = 1.0 + mxA( 0, 0 ) / fDG;
+			double fA = 1.0 + quadForm( mxG, m_mxDOld ) / fDG;
 			Matrix mxB = mxD * mxD.trans() / fDG;
 			Matrix mxC = ( m_mxDOld * mxG * mxD.trans() + mxD * mxG.trans() * m_mxDOld ) / fDG;
 			m_mxD = m_mxDOld + mxB*fA - mxC;
@@ -310,8 +356,7 @@ private:
 		if ( timer.isTimedOut() )
 			throw IterationTimedOut();
 
-		if ( m_nIter > 500 )
-			throw MaxIterationReached();
+		m_pSelf->getSolveControl()->checkIteration( m_nIter, DEFAULT_MAX_ITERATION );
 
 		if (m_debug)
 		{
@@ -361,6 +406,7 @@ QuasiNewton::~QuasiNewton() throw()
 
 void QuasiNewton::solve()
 {
+	EvaluationGuard aGuard( *this );
 	m_pImpl->solve();
 }
 
@@ -20,7 +20,7 @@
 #include "numeric/nlpmodel.hxx"
 #include "numeric/funcobj.hxx"
 #include "numeric/quadfitlinesearch.hxx"
-#include "numeric/matrix.hxx"
+#include "numeric/solvecontrol.hxx"
 #include "tool/global.hxx"
 
 #include <sstream>
@@ -29,7 +29,6 @@
 #include <vector>
 #include <stdio.h>
 
-using ::scsolver::vectorToMatrix;
 using namespace ::scsolver::numeric;
 using ::std::vector;
 
@@ -99,127 +98,74 @@ static double calcDeltaDistance(const vector<double>& pt1, const vector<double>&
     return dist;
 }
 
-/** 
- * Calculate the norm of a vector.
- * 
- * @param mx matrix instance containing only a single row
- * 
- * @return double norm
- */
-static double calcNorm(const Matrix& mx)
-{
-    if (mx.rows() > 1 && mx.cols() > 1)
-        Exception("cannot calculate the norm of a non-vector matrix.");
-
-    if (mx.empty())
-        Exception("cannot calculate the norm of an empty matrix.");
-
-    size_t n = mx.cols();
-    double norm = 0.0;
-    for (size_t i = 0; i < n; ++i)
-        norm += mx(0, i)*mx(0, i);
-
-    norm = sqrt(norm);
-    return norm;
-}
-
-/** 
- * Update the coordinate vectors by the Gram-Schmidt procedure.
- * 
+/**
+ * Update the coordinate vectors by Palmer's formulation of the Gram-Schmidt
+ * procedure.  Let A_j = sum_{i>=j} lambda_i d_i and s_j^2 = sum_{i>=j}
+ * lambda_i^2.  Given orthonormal d_j, the Gram-Schmidt orthogonalization of
+ * A_0, ..., A_{n-1} is
+ *
+ *   d'_0 = A_0 / |A_0|
+ *   d'_j = (lambda_{j-1} A_j - s_j^2 d_{j-1}) / (s_{j-1} s_j)
+ *
+ * up to sign, which needs O(n^2) operations instead of O(n^3).  The sign is
+ * chosen so that d'_j points along A_j as in Gram-Schmidt.  When s_j is
+ * zero, i.e. no progress was made along any of the remaining directions,
+ * d_j is kept as is.  The vectors are updated in place from the last toward
+ * the first so that only A_j needs to be kept, in a buffer reused across
+ * iterations.
+ *
  * @param cvectors (reference) coordinate vectors
  * @param lambdas a set of lambda values.
+ * @param sum (reference) buffer for A_j; resized as needed.
  */
-static void updateCoordinateVectors(vector<CoordinateVector>& cvectors, const vector<double>& lambdas, bool debug=false)
+static void updateCoordinateVectors(vector<CoordinateVector>& cvectors, const vector<double>& lambdas,
+                                    vector<double>& sum, bool debug=false)
 {
     if (debug)
         fprintf(stdout, "nlp::updateCoordinateVectors: --begin\n");
 
-    // Assume that every matrix is a single row matrix unless stated otherwise.
-
     size_t n = cvectors.size();
-    vector<Matrix> newVectors;
-    newVectors.reserve(n);
-    for (size_t j = 0; j < n; ++j)
+    sum.assign(n, 0.0);
+    double sqSum = 0.0;
+    for (size_t j = n; j-- > 0; )
     {
-        if (debug)
-            fprintf(stdout, "nlp::updateCoordinateVectors: Iteration %d (lambda = %g)\n", j, lambdas[j]);
-
-        // First, calculate matrix a.
-        Matrix a;
-        if (lambdas[j] == 0)
-            vectorToMatrix(cvectors[j], a);
+        CoordinateVector& d = cvectors[j];
+        assert(d.size() == n);
+        double lambda = lambdas[j];
+        for (size_t k = 0; k < n; ++k)
+            sum[k] += lambda*d[k];
+
+        sqSum += lambda*lambda;
+        if (sqSum == 0.0)
+            // Keep the current direction.
+            continue;
+
+        if (j == 0)
+            d = sum;
         else
         {
-            Matrix tmpa(1, n);
-            for (size_t i = j; i < n; ++i)
-            {
-                if (debug)
-                    fprintf(stdout, "nlp::updateCoordinateVectors:     i = %d\n", i);
-                Matrix tmpd;
-                vectorToMatrix(cvectors[i], tmpd);
-                if (debug)
-                {
-                    fprintf(stdout, "nlp::updateCoordinateVectors:       tmpd = ");
-                    tmpd.print();
-                }
-                tmpa += lambdas[i] * tmpd;
-            }
-            a.swap(tmpa);
+            const CoordinateVector& prev = cvectors[j-1];
+            double prevLambda = lambdas[j-1];
+            double sqSumPrev = sqSum + prevLambda*prevLambda;
+            double denom = ::std::sqrt(sqSumPrev*sqSum);
+            if (prevLambda < 0.0)
+                // Point along A_j as Gram-Schmidt would.
+                denom = -denom;
+            for (size_t k = 0; k < n; ++k)
+                d[k] = (prevLambda*sum[k] - sqSum*prev[k])/denom;
         }
 
-        if (debug)
-        {
-            fprintf(stdout, "nlp::updateCoordinateVectors:   calculated a = ");
-            a.print();
-        }
-
-        // Next, calculate matrix b.
-        Matrix b = a;
-        for (size_t i = 0; i < j; ++i)
-        {
-            if (debug)
-                fprintf(stdout, "nlp::updateCoordinateVectors:     i = %d\n", i);
-            Matrix newd = newVectors[i];
-            Matrix tmp = a * newd.trans() * newd; // row mx * col mx * row mx
-            if (debug)
-            {
-                fprintf(stdout, "nlp::updateCoordinateVectors:       tmp = ");
-                tmp.print();
-            }
-            b -= tmp;
-        }
-        if (debug)
-        {
-            fprintf(stdout, "nlp::updateCoordinateVectors:   calculated b = ");
-            b.print();
-        }
-        double norm = calcNorm(b);
-        Matrix newd = b/norm;
-        newVectors.push_back(newd);
-    }
-
-    if (debug)
-    {
-        size_t n2 = newVectors.size();
-        for (size_t i = 0; i < n2; ++i)
-        {
-            fprintf(stdout, "nlp::updateCoordinateVectors: new d%d = ", i);
-            newVectors[i].print();
-        }
-    }
-
-    // Now, update the coordinate vectors.
-    assert(n == newVectors.size());
-    for (size_t i = 0; i < n; ++i)
-    {
-        vector<double>& dest = cvectors[i];
-        const Matrix& src  = newVectors[i];
-        size_t colSize = src.cols();
-        assert(colSize == dest.size());
-        for (size_t j = 0; j < colSize; ++j)
-            dest[j] = src(0, j);
+        // Normalize explicitly to keep rounding errors from accumulating
+        // over iterations.
+        double norm = 0.0;
+        for (size_t k = 0; k < n; ++k)
+            norm += d[k]*d[k];
+        norm = ::std::sqrt(norm);
+        for (size_t k = 0; k < n; ++k)
+            d[k] /= norm;
     }
 
+    printCoordinateVectors(cvectors, debug);
     if (debug)
         fprintf(stdout, "nlp::updateCoordinateVectors: --end\n");
 }
@@ -232,6 +178,8 @@ void Rosenbrock::solve()
     Model& model = *getModel();
     if (debug)
         model.print();
+    EvaluationGuard guard(*this);
+    const SolveControl& control = *getSolveControl();
     BaseFuncObj& F = *model.getFuncObject();
 
     vector<double> vars;
@@ -257,8 +205,11 @@ void Rosenbrock::solve()
 
     vector<double> prevVars(vars);
     vector<double> lambdas(varCount);
-    for (size_t i = 0; i < m_maxIteration; ++i)
+    vector<double> sumBuf(varCount);
+    for (size_t i = 0; ; ++i)
     {
+        control.checkIteration(i, m_maxIteration);
+        control.reportIteration(i);
         if (debug)
         {
             fprintf(stdout, "ITERATION %d\n", i);
@@ -281,8 +232,10 @@ void Rosenbrock::solve()
             }
             catch (const ::std::exception& e)
             {
-                // Keep going even if the line search fails.  In this case, just
-                // use the last good position to calculate the lambda.
+                // Keep going even if the line search fails, unless the solve
+                // has to stop.  In this case, just use the last good position
+                // to calculate the lambda.
+                guard.check();
                 if (debug)
                     fprintf(stdout, "  line search failed: %s\n", e.what());
 
@@ -304,12 +257,10 @@ void Rosenbrock::solve()
             return;
 
         // Construct a new set of coordinate vectors.
-        updateCoordinateVectors(directions, lambdas, false);
+        updateCoordinateVectors(directions, lambdas, sumBuf, false);
         
         prevVars = tmpVars;
     }
-
-    throw ModelInfeasible();
 }
 
 }}}
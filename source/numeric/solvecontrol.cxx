@@ -0,0 +1,189 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/solvecontrol.hxx"
+#include "numeric/exception.hxx"
+#include "tool/timer.hxx"
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace scsolver { namespace numeric {
+
+SolveProgress::SolveProgress() :
+	Iteration( 0 ),
+	Node( 0 ),
+	Objective( 0.0 ),
+	HasObjective( false ),
+	Gap( 0.0 ),
+	HasGap( false )
+{
+}
+
+//---------------------------------------------------------------------------
+// SolveControl
+
+SolveControl::SolveControl() :
+	m_pTimer( new Timer( 0.0 ) ),
+	m_fTimeLimit( 0.0 ),
+	m_nIterationLimit( 0 ),
+	m_nEvaluationLimit( 0 ),
+	m_nCancelled( 0 ),
+	m_pListener( NULL ),
+	m_pParent( NULL )
+{
+	m_pTimer->init();
+}
+
+SolveControl::~SolveControl() throw()
+{
+}
+
+void SolveControl::start()
+{
+	m_pTimer->init();
+#ifndef _WIN32
+	__sync_lock_test_and_set( &m_nCancelled, 0 );
+#else
+	InterlockedExchange( &m_nCancelled, 0 );
+#endif
+}
+
+void SolveControl::setTimeLimit( double fSeconds )
+{
+	m_fTimeLimit = fSeconds > 0.0 ? fSeconds : 0.0;
+}
+
+double SolveControl::getTimeLimit() const
+{
+	return m_fTimeLimit;
+}
+
+void SolveControl::setIterationLimit( size_t nLimit )
+{
+	m_nIterationLimit = nLimit;
+}
+
+size_t SolveControl::getIterationLimit() const
+{
+	return m_nIterationLimit;
+}
+
+void SolveControl::setEvaluationLimit( size_t nLimit )
+{
+	m_nEvaluationLimit = nLimit;
+}
+
+size_t SolveControl::getEvaluationLimit() const
+{
+	return m_nEvaluationLimit;
+}
+
+void SolveControl::cancel()
+{
+#ifndef _WIN32
+	__sync_lock_test_and_set( &m_nCancelled, 1 );
+#else
+	InterlockedExchange( &m_nCancelled, 1 );
+#endif
+}
+
+void SolveControl::setParent( const SolveControl* pParent )
+{
+	m_pParent = pParent;
+}
+
+bool SolveControl::isCancelled() const
+{
+	if ( m_pParent && m_pParent->isCancelled() )
+		return true;
+#ifndef _WIN32
+	return __sync_fetch_and_add( const_cast<volatile long*>( &m_nCancelled ), 0 ) != 0;
+#else
+	return InterlockedCompareExchange( const_cast<volatile long*>( &m_nCancelled ), 0, 0 ) != 0;
+#endif
+}
+
+double SolveControl::getElapsedTime() const
+{
+	return m_pTimer->getElapsedTime();
+}
+
+bool SolveControl::isTimedOut( double fDefaultLimit ) const
+{
+	double fLimit = m_fTimeLimit > 0.0 ? m_fTimeLimit : fDefaultLimit;
+	return fLimit > 0.0 && getElapsedTime() > fLimit;
+}
+
+double SolveControl::getRemainingTime( double fDefaultLimit ) const
+{
+	if ( m_fTimeLimit <= 0.0 )
+		return fDefaultLimit;
+	double fRemaining = m_fTimeLimit - getElapsedTime();
+	return fRemaining > 0.0 ? fRemaining : 0.0;
+}
+
+void SolveControl::check( double fDefaultTimeLimit ) const
+{
+	if ( isCancelled() )
+		throw SolveCancelled();
+	if ( isTimedOut( fDefaultTimeLimit ) )
+		throw IterationTimedOut();
+}
+
+void SolveControl::checkIteration( size_t nIteration, size_t nDefaultLimit ) const
+{
+	check();
+	size_t nLimit = m_nIterationLimit > 0 ? m_nIterationLimit : nDefaultLimit;
+	if ( nLimit > 0 && nIteration >= nLimit )
+		throw MaxIterationReached();
+}
+
+void SolveControl::checkEvaluation( size_t nEvaluation ) const
+{
+	check();
+	if ( m_nEvaluationLimit > 0 && nEvaluation > m_nEvaluationLimit )
+		throw MaxIterationReached();
+}
+
+void SolveControl::setProgressListener( SolveProgressListener* pListener )
+{
+	m_pListener = pListener;
+}
+
+SolveProgressListener* SolveControl::getProgressListener() const
+{
+	return m_pListener;
+}
+
+void SolveControl::reportProgress( const SolveProgress& rProgress ) const
+{
+	if ( m_pListener )
+		m_pListener->progress( rProgress );
+}
+
+void SolveControl::reportIteration( size_t nIteration ) const
+{
+	if ( !m_pListener )
+		return;
+
+	SolveProgress aProgress;
+	aProgress.Iteration = nIteration;
+	m_pListener->progress( aProgress );
+}
+
+}}
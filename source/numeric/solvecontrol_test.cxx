@@ -0,0 +1,411 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/solvecontrol.hxx"
+#include "numeric/lpbranchbound.hxx"
+#include "numeric/lpdualsimplex.hxx"
+#include "numeric/lpmodel.hxx"
+#include "numeric/hookejeeves.hxx"
+#include "numeric/rosenbrock.hxx"
+#include "numeric/quasinewton.hxx"
+#include "numeric/nlpmodel.hxx"
+#include "numeric/funcobj.hxx"
+#include "numeric/matrix.hxx"
+#include "numeric/exception.hxx"
+#include "lptestutil.hxx"
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <cmath>
+#include <stdio.h>
+
+using namespace ::scsolver::numeric;
+using ::scsolver::numeric::lp::test::nextValue;
+using ::scsolver::numeric::lp::test::check;
+using ::scsolver::numeric::lp::test::isFeasible;
+using ::scsolver::numeric::lp::test::buildKnapsackModel;
+using ::std::vector;
+using ::std::string;
+using ::std::auto_ptr;
+
+namespace {
+
+enum StopReason { STOP_NONE, STOP_ITERATION, STOP_TIME, STOP_CANCEL, STOP_OTHER };
+
+/**
+ * Run a solve, and tell how it ended.
+ */
+template<typename AlgorithmType>
+StopReason runSolve(AlgorithmType& algorithm)
+{
+    try
+    {
+        algorithm.solve();
+    }
+    catch (const MaxIterationReached&)
+    {
+        return STOP_ITERATION;
+    }
+    catch (const IterationTimedOut&)
+    {
+        return STOP_TIME;
+    }
+    catch (const SolveCancelled&)
+    {
+        return STOP_CANCEL;
+    }
+    catch (const ::std::exception&)
+    {
+        return STOP_OTHER;
+    }
+    return STOP_NONE;
+}
+
+/**
+ * Dual simplex that cancels its solve control after a number of solves,
+ * to stop a branch and bound search at a known point.
+ */
+class CancellingAlgorithm : public lp::BaseAlgorithm
+{
+public:
+    explicit CancellingAlgorithm(size_t nSolves) : m_nSolves(nSolves) {}
+
+    virtual void solve()
+    {
+        m_aSimplex.setModel(getModel());
+        m_aSimplex.setStartBasis(getStartBasis());
+        m_aSimplex.solve();
+        m_aSimplex.setModel(NULL);
+        setSolution(m_aSimplex.getSolution());
+        setBasis(m_aSimplex.getBasis());
+        if (m_nSolves > 0 && --m_nSolves == 0)
+            getSolveControl()->cancel();
+    }
+
+private:
+    lp::DualSimplex m_aSimplex;
+    size_t m_nSolves;
+};
+
+/**
+ * (x1 - 2)^4 + (x1 - 2*x2)^2, which cancels the solve control after a
+ * number of evaluations if given one.
+ */
+class TestFunc : public SimpleFuncObj
+{
+public:
+    TestFunc(SolveControl* pControl = NULL, size_t nEvals = 0) :
+        SimpleFuncObj(2), m_pControl(pControl), m_nEvals(nEvals)
+    {
+        setVar(0, 0);
+        setVar(1, 3);
+    }
+
+    virtual double eval() const
+    {
+        if (m_pControl && m_nEvals > 0 && --m_nEvals == 0)
+            m_pControl->cancel();
+
+        vector<double> vars;
+        getVars(vars);
+        double term1 = vars[0] - 2;
+        term1 *= term1*term1*term1;
+        double term2 = vars[0] - 2.0*vars[1];
+        term2 *= term2;
+        return term1 + term2;
+    }
+
+    virtual const string getFuncString() const
+    {
+        return string("(x1 - 2)^4 + (x1 - 2*x2)^2");
+    }
+
+private:
+    SolveControl* m_pControl;
+    mutable size_t m_nEvals;
+};
+
+/**
+ * Keeps all reports of a solve.
+ */
+class ProgressRecorder : public SolveProgressListener
+{
+public:
+    virtual void progress(const SolveProgress& rProgress)
+    {
+        m_aReports.push_back(rProgress);
+    }
+
+    const vector<SolveProgress>& getReports() const { return m_aReports; }
+    void clear() { m_aReports.clear(); }
+
+private:
+    vector<SolveProgress> m_aReports;
+};
+
+template<typename AlgorithmType>
+StopReason runNlp(SolveControl& control, BaseFuncObj& func)
+{
+    nlp::Model model;
+    model.setGoal(GOAL_MINIMIZE);
+    model.setFuncObject(&func);
+    vector<double> vars;
+    func.getVars(vars);
+    for (size_t i = 0; i < vars.size(); ++i)
+        model.pushVar(vars[i]);
+
+    AlgorithmType algorithm;
+    algorithm.setModel(&model);
+    algorithm.setSolveControl(&control);
+    control.start();
+    StopReason eReason = runSolve(algorithm);
+    check(model.getFuncObject() == &func, "function object restored");
+    return eReason;
+}
+
+void limits()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("limits\n");
+
+    SolveControl control;
+    check(control.getTimeLimit() == 0.0 && control.getIterationLimit() == 0 &&
+          control.getEvaluationLimit() == 0, "no limit by default");
+    check(!control.isTimedOut() && control.getRemainingTime(20.0) == 20.0, "default time limit");
+
+    bool bThrown = false;
+    try
+    {
+        control.checkIteration(1000000);
+        control.checkIteration(499, 500);
+        control.checkIteration(500, 500);
+    }
+    catch (const MaxIterationReached&)
+    {
+        bThrown = true;
+    }
+    check(bThrown, "default iteration limit");
+
+    control.setIterationLimit(10);
+    bThrown = false;
+    try
+    {
+        control.checkIteration(9, 500);
+        control.checkIteration(10, 500);
+    }
+    catch (const MaxIterationReached&)
+    {
+        bThrown = true;
+    }
+    check(bThrown, "iteration limit overrides the default");
+
+    control.cancel();
+    bThrown = false;
+    try
+    {
+        control.check();
+    }
+    catch (const SolveCancelled&)
+    {
+        bThrown = true;
+    }
+    check(bThrown && control.isCancelled(), "cancelled");
+    control.start();
+    check(!control.isCancelled(), "start clears the cancel flag");
+
+    control.setTimeLimit(0.05);
+    while (control.getElapsedTime() <= 0.05)
+        ;
+    bThrown = false;
+    try
+    {
+        control.check();
+    }
+    catch (const IterationTimedOut&)
+    {
+        bThrown = true;
+    }
+    check(bThrown && control.getRemainingTime(20.0) == 0.0, "time limit");
+}
+
+void linearProgram()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("linear program\n");
+
+    lp::Model model;
+    buildKnapsackModel(model, 10, 20, 3);
+    model.setVarInteger(false);
+
+    SolveControl control;
+    lp::DualSimplex simplex;
+    simplex.setModel(&model);
+    simplex.setSolveControl(&control);
+    check(runSolve(simplex) == STOP_NONE, "solved without limits");
+    printf("%lu iterations\n", static_cast<unsigned long>(simplex.getIterationCount()));
+
+    control.setIterationLimit(2);
+    check(runSolve(simplex) == STOP_ITERATION, "iteration limit");
+
+    control.setIterationLimit(0);
+    control.cancel();
+    check(runSolve(simplex) == STOP_CANCEL, "cancelled");
+    control.start();
+    check(runSolve(simplex) == STOP_NONE, "solved after restart");
+}
+
+void branchAndBound()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("branch and bound\n");
+
+    lp::Model model;
+    buildKnapsackModel(model, 3, 15, 7);
+
+    SolveControl control;
+    auto_ptr<lp::BaseAlgorithm> p(new CancellingAlgorithm(0));
+    lp::BranchAndBound search(p);
+    search.setModel(&model);
+    search.setCutRounds(0);
+    search.setHeuristicTimeLimit(0.0);
+    search.setNodeSelection(lp::NODESEL_DEPTH_FIRST);
+    search.setSolveControl(&control);
+    check(runSolve(search) == STOP_NONE && search.isOptimal(), "solved without limits");
+    size_t nNodes = search.getNodeCount();
+    printf("%lu nodes\n", static_cast<unsigned long>(nNodes));
+
+    // Cancelled in the middle of the search, it returns its incumbent.
+    auto_ptr<lp::BaseAlgorithm> pCancel(new CancellingAlgorithm(nNodes/2));
+    lp::BranchAndBound cancelled(pCancel);
+    cancelled.setModel(&model);
+    cancelled.setCutRounds(0);
+    cancelled.setHeuristicTimeLimit(0.0);
+    cancelled.setNodeSelection(lp::NODESEL_DEPTH_FIRST);
+    cancelled.setSolveControl(&control);
+    control.start();
+    check(runSolve(cancelled) == STOP_NONE, "incumbent returned");
+    printf("%lu nodes\n", static_cast<unsigned long>(cancelled.getNodeCount()));
+    check(!cancelled.isOptimal() && cancelled.getNodeCount() < nNodes, "stopped at the cancel");
+    check(isFeasible(model, cancelled.getSolution()), "feasible incumbent");
+
+    // Without an incumbent, it throws.
+    control.start();
+    control.cancel();
+    check(runSolve(search) == STOP_CANCEL && !search.isOptimal(), "cancelled before the root");
+
+    control.start();
+    control.setTimeLimit(1e-9);
+    check(runSolve(search) == STOP_TIME, "timed out before the root");
+}
+
+void nonLinearProgram()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("non-linear program\n");
+
+    SolveControl control;
+    TestFunc func;
+    check(runNlp<nlp::HookeJeeves>(control, func) == STOP_NONE, "Hooke-Jeeves solved");
+
+    control.setEvaluationLimit(20);
+    TestFunc func2;
+    check(runNlp<nlp::HookeJeeves>(control, func2) == STOP_ITERATION, "Hooke-Jeeves evaluation limit");
+    TestFunc func3;
+    check(runNlp<nlp::Rosenbrock>(control, func3) == STOP_ITERATION, "Rosenbrock evaluation limit");
+    control.setEvaluationLimit(0);
+
+    control.setIterationLimit(1);
+    TestFunc func4;
+    check(runNlp<nlp::QuasiNewton>(control, func4) == STOP_ITERATION, "quasi-Newton iteration limit");
+    control.setIterationLimit(0);
+
+    TestFunc func5(&control, 30);
+    check(runNlp<nlp::Rosenbrock>(control, func5) == STOP_CANCEL, "Rosenbrock cancelled");
+}
+
+void progress()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("progress\n");
+
+    ProgressRecorder recorder;
+    SolveControl control;
+    control.setProgressListener(&recorder);
+
+    lp::Model model;
+    buildKnapsackModel(model, 10, 20, 3);
+    model.setVarInteger(false);
+    lp::DualSimplex simplex;
+    simplex.setModel(&model);
+    simplex.setSolveControl(&control);
+    check(runSolve(simplex) == STOP_NONE, "solved");
+    const vector<SolveProgress>& reports = recorder.getReports();
+    bool bIterations = reports.size() == simplex.getIterationCount();
+    for (size_t i = 0; i < reports.size(); ++i)
+        bIterations = bIterations && reports[i].Iteration == i + 1 && reports[i].Node == 0;
+    check(bIterations, "one report per dual simplex iteration");
+
+    // The search reports its nodes, but not the iterations of the nodes.
+    recorder.clear();
+    lp::Model intModel;
+    buildKnapsackModel(intModel, 3, 15, 7);
+    auto_ptr<lp::BaseAlgorithm> p(new lp::DualSimplex);
+    lp::BranchAndBound search(p);
+    search.setModel(&intModel);
+    search.setSolveControl(&control);
+    check(runSolve(search) == STOP_NONE && search.isOptimal(), "integer model solved");
+    printf("%lu nodes, %lu reports\n", static_cast<unsigned long>(search.getNodeCount()),
+           static_cast<unsigned long>(reports.size()));
+    bool bNodes = !reports.empty();
+    for (size_t i = 0; i < reports.size(); ++i)
+        bNodes = bNodes && reports[i].Node > 0 && reports[i].Node <= search.getNodeCount() &&
+            (i == 0 || reports[i].Node >= reports[i-1].Node);
+    check(bNodes, "node reports only");
+
+    const SolveProgress& last = reports.back();
+    Matrix sol = search.getSolution();
+    Matrix cost = intModel.getCostVector();
+    double fObj = 0.0;
+    for (size_t j = 0; j < cost.cols(); ++j)
+        fObj += cost(0, j)*sol(j, 0);
+    printf("objective %g, gap %g\n", last.Objective, last.Gap);
+    check(last.HasObjective && ::std::fabs(last.Objective - fObj) < 1e-6, "objective of the incumbent");
+    check(last.HasGap && last.Gap == 0.0, "no gap at the optimum");
+    check(control.getProgressListener() == &recorder, "listener restored");
+
+    recorder.clear();
+    TestFunc func;
+    check(runNlp<nlp::QuasiNewton>(control, func) == STOP_NONE, "quasi-Newton solved");
+    bool bObjective = !reports.empty();
+    for (size_t i = 0; i < reports.size(); ++i)
+        bObjective = bObjective && reports[i].HasObjective && !reports[i].HasGap;
+    check(bObjective, "quasi-Newton reports its objective");
+}
+
+}
+
+int main()
+{
+    printf("unit test: solve control\n");
+    limits();
+    linearProgram();
+    branchAndBound();
+    nonLinearProgram();
+    progress();
+    printf("Unit test passed!\n");
+}
@@ -0,0 +1,939 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/sparsematrix.hxx"
+#include "numeric/matrix.hxx"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <cmath>
+
+using ::std::vector;
+using ::std::map;
+using ::std::set;
+
+namespace scsolver { namespace numeric {
+
+SparseMatrix::Triplet::Triplet(size_t row, size_t col, double val) :
+    Row(row), Col(col), Value(val)
+{
+}
+
+bool SparseMatrix::Triplet::operator<(const Triplet& r) const
+{
+    if (Col != r.Col)
+        return Col < r.Col;
+    return Row < r.Row;
+}
+
+SparseMatrix::SparseMatrix() :
+    m_nRows(0),
+    m_nCols(0),
+    m_aColPtr(1, 0),
+    m_bRowMirror(false),
+    m_bRowMirrorValid(false)
+{
+}
+
+SparseMatrix::SparseMatrix(size_t rows, size_t cols) :
+    m_nRows(rows),
+    m_nCols(cols),
+    m_aColPtr(cols + 1, 0),
+    m_bRowMirror(false),
+    m_bRowMirrorValid(false)
+{
+}
+
+SparseMatrix::SparseMatrix(const Matrix& mx, double fDropTol) :
+    m_nRows(mx.rows()),
+    m_nCols(mx.cols()),
+    m_aColPtr(mx.cols() + 1, 0),
+    m_bRowMirror(false),
+    m_bRowMirrorValid(false)
+{
+    for (size_t j = 0; j < m_nCols; ++j)
+    {
+        for (size_t i = 0; i < m_nRows; ++i)
+        {
+            double val = mx(i, j);
+            if (::std::fabs(val) > fDropTol)
+            {
+                m_aRowIds.push_back(i);
+                m_aValues.push_back(val);
+            }
+        }
+        m_aColPtr[j+1] = m_aRowIds.size();
+    }
+}
+
+SparseMatrix::~SparseMatrix() throw()
+{
+}
+
+void SparseMatrix::swap(SparseMatrix& r) throw()
+{
+    ::std::swap(m_nRows, r.m_nRows);
+    ::std::swap(m_nCols, r.m_nCols);
+    m_aPending.swap(r.m_aPending);
+    m_aColPtr.swap(r.m_aColPtr);
+    m_aRowIds.swap(r.m_aRowIds);
+    m_aValues.swap(r.m_aValues);
+    ::std::swap(m_bRowMirror, r.m_bRowMirror);
+    ::std::swap(m_bRowMirrorValid, r.m_bRowMirrorValid);
+    m_aRowPtr.swap(r.m_aRowPtr);
+    m_aColIds.swap(r.m_aColIds);
+    m_aRowValues.swap(r.m_aRowValues);
+}
+
+void SparseMatrix::clear(size_t rows, size_t cols)
+{
+    m_nRows = rows;
+    m_nCols = cols;
+    m_aPending.clear();
+    m_aColPtr.assign(cols + 1, 0);
+    m_aRowIds.clear();
+    m_aValues.clear();
+    m_bRowMirrorValid = false;
+}
+
+void SparseMatrix::insert(size_t row, size_t col, double val)
+{
+    if (row >= m_nRows || col >= m_nCols)
+        throw BadIndex();
+
+    m_aPending.push_back(Triplet(row, col, val));
+    m_bRowMirrorValid = false;
+}
+
+void SparseMatrix::reserve(size_t nNonZeros)
+{
+    m_aRowIds.reserve(nNonZeros);
+    m_aValues.reserve(nNonZeros);
+}
+
+size_t SparseMatrix::rows() const
+{
+    return m_nRows;
+}
+
+size_t SparseMatrix::cols() const
+{
+    return m_nCols;
+}
+
+size_t SparseMatrix::nonZeros() const
+{
+    compress();
+    return m_aValues.size();
+}
+
+double SparseMatrix::getValue(size_t row, size_t col) const
+{
+    if (row >= m_nRows || col >= m_nCols)
+        throw BadIndex();
+
+    compress();
+    vector<size_t>::const_iterator itrBeg = m_aRowIds.begin() + m_aColPtr[col];
+    vector<size_t>::const_iterator itrEnd = m_aRowIds.begin() + m_aColPtr[col+1];
+    vector<size_t>::const_iterator itr = ::std::lower_bound(itrBeg, itrEnd, row);
+    if (itr == itrEnd || *itr != row)
+        return 0.0;
+    return m_aValues[itr - m_aRowIds.begin()];
+}
+
+void SparseMatrix::setRowMirror(bool b)
+{
+    m_bRowMirror = b;
+    if (!b)
+    {
+        vector<size_t>().swap(m_aRowPtr);
+        vector<size_t>().swap(m_aColIds);
+        vector<double>().swap(m_aRowValues);
+        m_bRowMirrorValid = false;
+    }
+}
+
+bool SparseMatrix::hasRowMirror() const
+{
+    return m_bRowMirror;
+}
+
+void SparseMatrix::multiply(const vector<double>& x, vector<double>& y) const
+{
+    if (x.size() != m_nCols)
+        throw MatrixSizeMismatch();
+
+    compress();
+    if (m_bRowMirror)
+    {
+        buildRowMirror();
+        y.resize(m_nRows);
+        for (size_t i = 0; i < m_nRows; ++i)
+        {
+            double fSum = 0.0;
+            for (size_t k = m_aRowPtr[i]; k < m_aRowPtr[i+1]; ++k)
+                fSum += m_aRowValues[k]*x[m_aColIds[k]];
+            y[i] = fSum;
+        }
+        return;
+    }
+
+    y.assign(m_nRows, 0.0);
+    for (size_t j = 0; j < m_nCols; ++j)
+    {
+        double fX = x[j];
+        if (fX == 0.0)
+            continue;
+        for (size_t k = m_aColPtr[j]; k < m_aColPtr[j+1]; ++k)
+            y[m_aRowIds[k]] += m_aValues[k]*fX;
+    }
+}
+
+void SparseMatrix::multiplyTrans(const vector<double>& x, vector<double>& y) const
+{
+    if (x.size() != m_nRows)
+        throw MatrixSizeMismatch();
+
+    compress();
+    y.resize(m_nCols);
+    for (size_t j = 0; j < m_nCols; ++j)
+    {
+        double fSum = 0.0;
+        for (size_t k = m_aColPtr[j]; k < m_aColPtr[j+1]; ++k)
+            fSum += m_aValues[k]*x[m_aRowIds[k]];
+        y[j] = fSum;
+    }
+}
+
+void SparseMatrix::getColumn(size_t col, vector<double>& dense) const
+{
+    if (col >= m_nCols)
+        throw BadIndex();
+
+    compress();
+    dense.assign(m_nRows, 0.0);
+    for (size_t k = m_aColPtr[col]; k < m_aColPtr[col+1]; ++k)
+        dense[m_aRowIds[k]] = m_aValues[k];
+}
+
+void SparseMatrix::getColumn(size_t col, vector<size_t>& rowIds, vector<double>& vals) const
+{
+    if (col >= m_nCols)
+        throw BadIndex();
+
+    compress();
+    rowIds.assign(m_aRowIds.begin() + m_aColPtr[col], m_aRowIds.begin() + m_aColPtr[col+1]);
+    vals.assign(m_aValues.begin() + m_aColPtr[col], m_aValues.begin() + m_aColPtr[col+1]);
+}
+
+void SparseMatrix::getRow(size_t row, vector<size_t>& colIds, vector<double>& vals) const
+{
+    if (row >= m_nRows)
+        throw BadIndex();
+
+    compress();
+    if (m_bRowMirror)
+    {
+        buildRowMirror();
+        colIds.assign(m_aColIds.begin() + m_aRowPtr[row], m_aColIds.begin() + m_aRowPtr[row+1]);
+        vals.assign(m_aRowValues.begin() + m_aRowPtr[row], m_aRowValues.begin() + m_aRowPtr[row+1]);
+        return;
+    }
+
+    colIds.clear();
+    vals.clear();
+    for (size_t j = 0; j < m_nCols; ++j)
+    {
+        vector<size_t>::const_iterator itrBeg = m_aRowIds.begin() + m_aColPtr[j];
+        vector<size_t>::const_iterator itrEnd = m_aRowIds.begin() + m_aColPtr[j+1];
+        vector<size_t>::const_iterator itr = ::std::lower_bound(itrBeg, itrEnd, row);
+        if (itr != itrEnd && *itr == row)
+        {
+            colIds.push_back(j);
+            vals.push_back(m_aValues[itr - m_aRowIds.begin()]);
+        }
+    }
+}
+
+const SparseMatrix SparseMatrix::trans() const
+{
+    compress();
+    SparseMatrix mx(m_nCols, m_nRows);
+
+    // Counting sort by row gives the transpose with sorted indices directly.
+    vector<size_t>& colPtr = mx.m_aColPtr;
+    for (size_t k = 0; k < m_aRowIds.size(); ++k)
+        ++colPtr[m_aRowIds[k] + 1];
+    for (size_t i = 0; i < m_nRows; ++i)
+        colPtr[i+1] += colPtr[i];
+
+    mx.m_aRowIds.resize(m_aRowIds.size());
+    mx.m_aValues.resize(m_aValues.size());
+    vector<size_t> aNext(colPtr.begin(), colPtr.end() - 1);
+    for (size_t j = 0; j < m_nCols; ++j)
+    {
+        for (size_t k = m_aColPtr[j]; k < m_aColPtr[j+1]; ++k)
+        {
+            size_t nPos = aNext[m_aRowIds[k]]++;
+            mx.m_aRowIds[nPos] = j;
+            mx.m_aValues[nPos] = m_aValues[k];
+        }
+    }
+    mx.setRowMirror(m_bRowMirror);
+    return mx;
+}
+
+const Matrix SparseMatrix::toMatrix() const
+{
+    compress();
+    Matrix mx(m_nRows, m_nCols);
+    for (size_t j = 0; j < m_nCols; ++j)
+        for (size_t k = m_aColPtr[j]; k < m_aColPtr[j+1]; ++k)
+            mx(m_aRowIds[k], j) = m_aValues[k];
+    return mx;
+}
+
+void SparseMatrix::print(size_t prec, size_t colspace) const
+{
+    toMatrix().print(prec, colspace);
+}
+
+void SparseMatrix::compress() const
+{
+    if (m_aPending.empty())
+        return;
+
+    vector<Triplet> aAll;
+    aAll.reserve(m_aValues.size() + m_aPending.size());
+    for (size_t j = 0; j < m_nCols; ++j)
+        for (size_t k = m_aColPtr[j]; k < m_aColPtr[j+1]; ++k)
+            aAll.push_back(Triplet(m_aRowIds[k], j, m_aValues[k]));
+    aAll.insert(aAll.end(), m_aPending.begin(), m_aPending.end());
+    vector<Triplet>().swap(m_aPending);
+
+    // Stable sort keeps the order of insertion among duplicates, so that
+    // they are summed in a deterministic order.
+    ::std::stable_sort(aAll.begin(), aAll.end());
+
+    m_aRowIds.clear();
+    m_aValues.clear();
+    m_aColPtr.assign(m_nCols + 1, 0);
+    vector<Triplet>::const_iterator itr = aAll.begin(), itrEnd = aAll.end();
+    while (itr != itrEnd)
+    {
+        size_t nRow = itr->Row, nCol = itr->Col;
+        double fSum = 0.0;
+        for (; itr != itrEnd && itr->Row == nRow && itr->Col == nCol; ++itr)
+            fSum += itr->Value;
+
+        m_aRowIds.push_back(nRow);
+        m_aValues.push_back(fSum);
+        ++m_aColPtr[nCol+1];
+    }
+    for (size_t j = 0; j < m_nCols; ++j)
+        m_aColPtr[j+1] += m_aColPtr[j];
+
+    m_bRowMirrorValid = false;
+}
+
+void SparseMatrix::buildRowMirror() const
+{
+    if (m_bRowMirrorValid)
+        return;
+
+    size_t nNonZeros = m_aValues.size();
+    m_aRowPtr.assign(m_nRows + 1, 0);
+    for (size_t k = 0; k < nNonZeros; ++k)
+        ++m_aRowPtr[m_aRowIds[k] + 1];
+    for (size_t i = 0; i < m_nRows; ++i)
+        m_aRowPtr[i+1] += m_aRowPtr[i];
+
+    m_aColIds.resize(nNonZeros);
+    m_aRowValues.resize(nNonZeros);
+    vector<size_t> aNext(m_aRowPtr.begin(), m_aRowPtr.end() - 1);
+    for (size_t j = 0; j < m_nCols; ++j)
+    {
+        for (size_t k = m_aColPtr[j]; k < m_aColPtr[j+1]; ++k)
+        {
+            size_t nPos = aNext[m_aRowIds[k]]++;
+            m_aColIds[nPos] = j;
+            m_aRowValues[nPos] = m_aValues[k];
+        }
+    }
+    m_bRowMirrorValid = true;
+}
+
+// ----------------------------------------------------------------------------
+
+SparseLU::Entry::Entry(size_t index, double val) :
+    Index(index), Value(val)
+{
+}
+
+SparseLU::SparseLU() :
+    m_nSize(0),
+    m_fThreshold(0.1)
+{
+}
+
+SparseLU::SparseLU(const SparseMatrix& mxA) :
+    m_nSize(0),
+    m_fThreshold(0.1)
+{
+    factorize(mxA);
+}
+
+SparseLU::~SparseLU() throw()
+{
+}
+
+void SparseLU::setPivotThreshold(double u)
+{
+    m_fThreshold = u;
+}
+
+namespace {
+
+/** number of sparsest columns searched for a pivot at each step. */
+const size_t PIVOT_SEARCH_COLUMNS = 4;
+
+}
+
+void SparseLU::factorize(const SparseMatrix& mxA)
+{
+    if (mxA.rows() != mxA.cols())
+        throw NonSquareMatrix();
+
+    size_t n = mxA.rows();
+    m_nSize = n;
+    m_aPivotRows.clear();
+    m_aPivotCols.clear();
+    m_aPivots.clear();
+    m_aLCols.assign(n, EntryList());
+    m_aURows.assign(n, EntryList());
+
+    // Active submatrix: values by row, and the row pattern of each column.
+    vector< map<size_t, double> > aRows(n);
+    vector< set<size_t> > aColPattern(n);
+    vector<bool> aColActive(n, true);
+    {
+        vector<size_t> rowIds;
+        vector<double> vals;
+        for (size_t j = 0; j < n; ++j)
+        {
+            mxA.getColumn(j, rowIds, vals);
+            for (size_t k = 0; k < rowIds.size(); ++k)
+            {
+                if (vals[k] == 0.0)
+                    continue;
+                aRows[rowIds[k]][j] = vals[k];
+                aColPattern[j].insert(rowIds[k]);
+            }
+        }
+    }
+
+    vector<size_t> aSearchCols;
+    for (size_t nStep = 0; nStep < n; ++nStep)
+    {
+        // Pick the sparsest active columns.
+        aSearchCols.clear();
+        for (size_t j = 0; j < n; ++j)
+        {
+            if (!aColActive[j])
+                continue;
+
+            size_t nCount = aColPattern[j].size();
+            if (nCount == 0)
+                // structurally singular
+                throw SingularMatrix();
+
+            vector<size_t>::iterator itr = aSearchCols.begin();
+            while (itr != aSearchCols.end() && aColPattern[*itr].size() <= nCount)
+                ++itr;
+            if (static_cast<size_t>(itr - aSearchCols.begin()) < PIVOT_SEARCH_COLUMNS)
+            {
+                aSearchCols.insert(itr, j);
+                if (aSearchCols.size() > PIVOT_SEARCH_COLUMNS)
+                    aSearchCols.pop_back();
+            }
+        }
+
+        // Among the candidates that pass the threshold test, pick the one
+        // with the lowest Markowitz count, preferring larger magnitude.
+        size_t nPivRow = n, nPivCol = n;
+        size_t nBestCost = 0;
+        double fBestVal = 0.0;
+        for (size_t k = 0; k < aSearchCols.size(); ++k)
+        {
+            size_t j = aSearchCols[k];
+            const set<size_t>& rowIds = aColPattern[j];
+            double fColMax = 0.0;
+            set<size_t>::const_iterator itr = rowIds.begin(), itrEnd = rowIds.end();
+            for (; itr != itrEnd; ++itr)
+                fColMax = ::std::max(fColMax, ::std::fabs(aRows[*itr][j]));
+
+            if (fColMax == 0.0)
+                continue;
+
+            size_t nColCost = rowIds.size() - 1;
+            for (itr = rowIds.begin(); itr != itrEnd; ++itr)
+            {
+                double fVal = ::std::fabs(aRows[*itr][j]);
+                if (fVal < m_fThreshold*fColMax)
+                    continue;
+
+                size_t nCost = (aRows[*itr].size() - 1)*nColCost;
+                if (nPivRow == n || nCost < nBestCost || (nCost == nBestCost && fVal > fBestVal))
+                {
+                    nPivRow = *itr;
+                    nPivCol = j;
+                    nBestCost = nCost;
+                    fBestVal = fVal;
+                }
+            }
+        }
+
+        if (nPivRow == n)
+            // numerically singular
+            throw SingularMatrix();
+
+        map<size_t, double>& rPivRow = aRows[nPivRow];
+        double fPivot = rPivRow[nPivCol];
+        m_aPivotRows.push_back(nPivRow);
+        m_aPivotCols.push_back(nPivCol);
+        m_aPivots.push_back(fPivot);
+
+        // Move the pivot row into U.
+        EntryList& rURow = m_aURows[nStep];
+        map<size_t, double>::const_iterator itrRow = rPivRow.begin(), itrRowEnd = rPivRow.end();
+        for (; itrRow != itrRowEnd; ++itrRow)
+        {
+            aColPattern[itrRow->first].erase(nPivRow);
+            if (itrRow->first != nPivCol)
+                rURow.push_back(Entry(itrRow->first, itrRow->second));
+        }
+        rPivRow.clear();
+
+        // Eliminate the pivot column from the remaining rows.
+        EntryList& rLCol = m_aLCols[nStep];
+        set<size_t>& rPivColPattern = aColPattern[nPivCol];
+        set<size_t>::const_iterator itrCol = rPivColPattern.begin(), itrColEnd = rPivColPattern.end();
+        for (; itrCol != itrColEnd; ++itrCol)
+        {
+            size_t i = *itrCol;
+            map<size_t, double>& rRow = aRows[i];
+            map<size_t, double>::iterator itrElem = rRow.find(nPivCol);
+            double fMultiplier = itrElem->second / fPivot;
+            rRow.erase(itrElem);
+            rLCol.push_back(Entry(i, fMultiplier));
+
+            EntryList::const_iterator itrU = rURow.begin(), itrUEnd = rURow.end();
+            for (; itrU != itrUEnd; ++itrU)
+            {
+                map<size_t, double>::iterator itrFill = rRow.find(itrU->Index);
+                if (itrFill == rRow.end())
+                {
+                    // fill-in
+                    rRow.insert(::std::make_pair(itrU->Index, -fMultiplier*itrU->Value));
+                    aColPattern[itrU->Index].insert(i);
+                }
+                else
+                    itrFill->second -= fMultiplier*itrU->Value;
+            }
+        }
+        rPivColPattern.clear();
+        aColActive[nPivCol] = false;
+    }
+}
+
+void SparseLU::solve(vector<double>& b) const
+{
+    if (b.size() != m_nSize)
+        throw MatrixSizeMismatch();
+
+    // Apply the elimination steps to b (by original row index).
+    for (size_t k = 0; k < m_nSize; ++k)
+    {
+        double fPiv = b[m_aPivotRows[k]];
+        if (fPiv == 0.0)
+            continue;
+        const EntryList& rLCol = m_aLCols[k];
+        for (EntryList::const_iterator itr = rLCol.begin(); itr != rLCol.end(); ++itr)
+            b[itr->Index] -= itr->Value*fPiv;
+    }
+
+    // Back substitution on U, producing x by original column index.
+    vector<double> x(m_nSize);
+    for (size_t k = m_nSize; k-- > 0; )
+    {
+        double fSum = b[m_aPivotRows[k]];
+        const EntryList& rURow = m_aURows[k];
+        for (EntryList::const_iterator itr = rURow.begin(); itr != rURow.end(); ++itr)
+            fSum -= itr->Value*x[itr->Index];
+        x[m_aPivotCols[k]] = fSum / m_aPivots[k];
+    }
+    b.swap(x);
+}
+
+void SparseLU::solveTrans(vector<double>& b) const
+{
+    if (b.size() != m_nSize)
+        throw MatrixSizeMismatch();
+
+    // U^T v = b, with b indexed by original column and v by original row.
+    vector<double> v(m_nSize);
+    for (size_t k = 0; k < m_nSize; ++k)
+    {
+        double fVal = b[m_aPivotCols[k]] / m_aPivots[k];
+        v[m_aPivotRows[k]] = fVal;
+        if (fVal == 0.0)
+            continue;
+        const EntryList& rURow = m_aURows[k];
+        for (EntryList::const_iterator itr = rURow.begin(); itr != rURow.end(); ++itr)
+            b[itr->Index] -= itr->Value*fVal;
+    }
+
+    // Apply the transposed elimination steps in reverse order.
+    for (size_t k = m_nSize; k-- > 0; )
+    {
+        double fSum = 0.0;
+        const EntryList& rLCol = m_aLCols[k];
+        for (EntryList::const_iterator itr = rLCol.begin(); itr != rLCol.end(); ++itr)
+            fSum += itr->Value*v[itr->Index];
+        v[m_aPivotRows[k]] -= fSum;
+    }
+    b.swap(v);
+}
+
+size_t SparseLU::size() const
+{
+    return m_nSize;
+}
+
+size_t SparseLU::nonZeros() const
+{
+    size_t nCount = m_nSize;
+    for (size_t k = 0; k < m_nSize; ++k)
+        nCount += m_aLCols[k].size() + m_aURows[k].size();
+    return nCount;
+}
+
+// ----------------------------------------------------------------------------
+
+namespace {
+
+/** value that replaces a small pivot of the Cholesky factorization. */
+const double HUGE_PIVOT = 1e128;
+
+/**
+ * Minimum degree ordering of a symmetric pattern, given by the adjacency
+ * sets of its graph, which are consumed.  Eliminating a node joins its
+ * neighbors into a clique, which is the fill-in its elimination causes.
+ */
+void orderMinimumDegree(vector< set<size_t> >& rAdj, vector<size_t>& rPerm)
+{
+    typedef ::std::pair<size_t, size_t> DegreeNode;
+
+    size_t n = rAdj.size();
+    set<DegreeNode> aQueue;
+    for (size_t i = 0; i < n; ++i)
+        aQueue.insert(DegreeNode(rAdj[i].size(), i));
+
+    rPerm.clear();
+    rPerm.reserve(n);
+    while (!aQueue.empty())
+    {
+        size_t nNode = aQueue.begin()->second;
+        aQueue.erase(aQueue.begin());
+        rPerm.push_back(nNode);
+
+        set<size_t> aNeighbors;
+        aNeighbors.swap(rAdj[nNode]);
+        set<size_t>::const_iterator itr = aNeighbors.begin(), itrEnd = aNeighbors.end();
+        for (; itr != itrEnd; ++itr)
+        {
+            set<size_t>& rSet = rAdj[*itr];
+            aQueue.erase(DegreeNode(rSet.size(), *itr));
+            rSet.erase(nNode);
+            set<size_t>::const_iterator itr2 = aNeighbors.begin();
+            for (; itr2 != itrEnd; ++itr2)
+                if (*itr2 != *itr)
+                    rSet.insert(*itr2);
+            aQueue.insert(DegreeNode(rSet.size(), *itr));
+        }
+    }
+}
+
+}
+
+SparseCholesky::SparseCholesky() :
+    m_nSize(0),
+    m_fPivotTol(0.0),
+    m_nSmallPivots(0)
+{
+}
+
+SparseCholesky::~SparseCholesky() throw()
+{
+}
+
+void SparseCholesky::setPivotTolerance(double fTol)
+{
+    m_fPivotTol = fTol;
+}
+
+/**
+ * Extract the upper triangle of P A P^T, from the lower triangle of A.
+ */
+void SparseCholesky::buildUpper(const SparseMatrix& mxA, vector<size_t>& rColPtr,
+                                vector<size_t>& rRowIds, vector<double>& rValues) const
+{
+    size_t n = m_nSize;
+    vector<size_t> rowIds;
+    vector<double> vals;
+
+    rColPtr.assign(n + 1, 0);
+    for (size_t j = 0; j < n; ++j)
+    {
+        mxA.getColumn(j, rowIds, vals);
+        for (size_t k = 0; k < rowIds.size(); ++k)
+            if (rowIds[k] >= j)
+                ++rColPtr[::std::max(m_aPermInv[rowIds[k]], m_aPermInv[j]) + 1];
+    }
+    for (size_t j = 0; j < n; ++j)
+        rColPtr[j + 1] += rColPtr[j];
+
+    rRowIds.resize(rColPtr[n]);
+    rValues.resize(rColPtr[n]);
+    vector<size_t> aNext(rColPtr.begin(), rColPtr.end() - 1);
+    for (size_t j = 0; j < n; ++j)
+    {
+        mxA.getColumn(j, rowIds, vals);
+        for (size_t k = 0; k < rowIds.size(); ++k)
+        {
+            if (rowIds[k] < j)
+                continue;
+            size_t i1 = m_aPermInv[rowIds[k]], i2 = m_aPermInv[j];
+            size_t p = aNext[::std::max(i1, i2)]++;
+            rRowIds[p] = ::std::min(i1, i2);
+            rValues[p] = vals[k];
+        }
+    }
+}
+
+/**
+ * Find the pattern of row k of L, which is the set of nodes reachable in
+ * the elimination tree from the elements of column k of the upper
+ * triangle.
+ *
+ * @return size_t position in rStack where the pattern starts; it ends at
+ *         the end of the stack.
+ */
+size_t SparseCholesky::reach(const vector<size_t>& rColPtr, const vector<size_t>& rRowIds,
+                             size_t k, vector<size_t>& rStack, vector<size_t>& rMark) const
+{
+    size_t nTop = m_nSize;
+    rMark[k] = k;
+    for (size_t p = rColPtr[k]; p < rColPtr[k + 1]; ++p)
+    {
+        size_t nLen = 0;
+        for (size_t i = rRowIds[p]; rMark[i] != k; i = m_aParent[i])
+        {
+            rStack[nLen++] = i;
+            rMark[i] = k;
+        }
+        while (nLen > 0)
+            rStack[--nTop] = rStack[--nLen];
+    }
+    return nTop;
+}
+
+void SparseCholesky::analyze(const SparseMatrix& mxA)
+{
+    if (mxA.rows() != mxA.cols())
+        throw NonSquareMatrix();
+
+    size_t n = mxA.rows();
+    m_nSize = n;
+
+    vector< set<size_t> > aAdj(n);
+    {
+        vector<size_t> rowIds;
+        vector<double> vals;
+        for (size_t j = 0; j < n; ++j)
+        {
+            mxA.getColumn(j, rowIds, vals);
+            for (size_t k = 0; k < rowIds.size(); ++k)
+            {
+                if (rowIds[k] <= j)
+                    continue;
+                aAdj[rowIds[k]].insert(j);
+                aAdj[j].insert(rowIds[k]);
+            }
+        }
+    }
+    orderMinimumDegree(aAdj, m_aPerm);
+    m_aPermInv.resize(n);
+    for (size_t k = 0; k < n; ++k)
+        m_aPermInv[m_aPerm[k]] = k;
+
+    vector<size_t> aColPtr, aRowIds;
+    vector<double> aValues;
+    buildUpper(mxA, aColPtr, aRowIds, aValues);
+    m_aUpperColPtr = aColPtr;
+    m_aUpperRowIds = aRowIds;
+
+    // Elimination tree, with path compression through the ancestors.
+    m_aParent.assign(n, n);
+    vector<size_t> aAncestor(n, n);
+    for (size_t k = 0; k < n; ++k)
+    {
+        for (size_t p = aColPtr[k]; p < aColPtr[k + 1]; ++p)
+        {
+            size_t i = aRowIds[p];
+            while (i != n && i < k)
+            {
+                size_t nNext = aAncestor[i];
+                aAncestor[i] = k;
+                if (nNext == n)
+                    m_aParent[i] = k;
+                i = nNext;
+            }
+        }
+    }
+
+    // Column counts of L, from the pattern of each row.
+    vector<size_t> aCount(n, 1), aStack(n), aMark(n, n);
+    for (size_t k = 0; k < n; ++k)
+        for (size_t p = reach(aColPtr, aRowIds, k, aStack, aMark); p < n; ++p)
+            ++aCount[aStack[p]];
+
+    m_aColPtr.assign(n + 1, 0);
+    for (size_t k = 0; k < n; ++k)
+        m_aColPtr[k + 1] = m_aColPtr[k] + aCount[k];
+    m_aRowIds.resize(m_aColPtr[n]);
+    m_aValues.resize(m_aColPtr[n]);
+}
+
+void SparseCholesky::factorize(const SparseMatrix& mxA)
+{
+    if (mxA.rows() != m_nSize || mxA.cols() != m_nSize || m_aColPtr.empty())
+        analyze(mxA);
+
+    vector<size_t> aColPtr, aRowIds;
+    vector<double> aValues;
+    buildUpper(mxA, aColPtr, aRowIds, aValues);
+    if (aColPtr != m_aUpperColPtr || aRowIds != m_aUpperRowIds)
+    {
+        analyze(mxA);
+        buildUpper(mxA, aColPtr, aRowIds, aValues);
+    }
+
+    size_t n = m_nSize;
+    double fMaxDiag = 0.0;
+    for (size_t k = 0; k < n; ++k)
+        for (size_t p = aColPtr[k]; p < aColPtr[k + 1]; ++p)
+            if (aRowIds[p] == k)
+                fMaxDiag = ::std::max(fMaxDiag, aValues[p]);
+
+    // Up-looking factorization: row k of L is obtained by a triangular
+    // solve with the first k rows, whose pattern is given by reach().
+    vector<double> x(n, 0.0);
+    vector<size_t> aNext(m_aColPtr.begin(), m_aColPtr.end() - 1), aStack(n), aMark(n, n);
+    m_nSmallPivots = 0;
+    for (size_t k = 0; k < n; ++k)
+    {
+        size_t nTop = reach(aColPtr, aRowIds, k, aStack, aMark);
+        for (size_t p = aColPtr[k]; p < aColPtr[k + 1]; ++p)
+            x[aRowIds[p]] += aValues[p];
+
+        double fDiag = x[k];
+        x[k] = 0.0;
+        for (; nTop < n; ++nTop)
+        {
+            size_t i = aStack[nTop];
+            double fVal = x[i] / m_aValues[m_aColPtr[i]];
+            x[i] = 0.0;
+            for (size_t p = m_aColPtr[i] + 1; p < aNext[i]; ++p)
+                x[m_aRowIds[p]] -= m_aValues[p]*fVal;
+            fDiag -= fVal*fVal;
+
+            size_t p = aNext[i]++;
+            m_aRowIds[p] = k;
+            m_aValues[p] = fVal;
+        }
+
+        if (fDiag <= m_fPivotTol*fMaxDiag)
+        {
+            if (m_fPivotTol <= 0.0)
+                throw SingularMatrix();
+            fDiag = HUGE_PIVOT;
+            ++m_nSmallPivots;
+        }
+        size_t p = aNext[k]++;
+        m_aRowIds[p] = k;
+        m_aValues[p] = ::std::sqrt(fDiag);
+    }
+}
+
+void SparseCholesky::solve(vector<double>& b) const
+{
+    if (b.size() != m_nSize)
+        throw MatrixSizeMismatch();
+
+    size_t n = m_nSize;
+    vector<double> x(n);
+    for (size_t k = 0; k < n; ++k)
+        x[k] = b[m_aPerm[k]];
+
+    // L y = P b
+    for (size_t j = 0; j < n; ++j)
+    {
+        x[j] /= m_aValues[m_aColPtr[j]];
+        for (size_t p = m_aColPtr[j] + 1; p < m_aColPtr[j + 1]; ++p)
+            x[m_aRowIds[p]] -= m_aValues[p]*x[j];
+    }
+
+    // L^T (P x) = y
+    for (size_t j = n; j-- > 0; )
+    {
+        for (size_t p = m_aColPtr[j] + 1; p < m_aColPtr[j + 1]; ++p)
+            x[j] -= m_aValues[p]*x[m_aRowIds[p]];
+        x[j] /= m_aValues[m_aColPtr[j]];
+    }
+
+    for (size_t k = 0; k < n; ++k)
+        b[m_aPerm[k]] = x[k];
+}
+
+size_t SparseCholesky::size() const
+{
+    return m_nSize;
+}
+
+size_t SparseCholesky::nonZeros() const
+{
+    return m_aColPtr.empty() ? 0 : m_aColPtr[m_nSize];
+}
+
+size_t SparseCholesky::getSmallPivotCount() const
+{
+    return m_nSmallPivots;
+}
+
+}}
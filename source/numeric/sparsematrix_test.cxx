@@ -0,0 +1,326 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "numeric/sparsematrix.hxx"
+#include "numeric/matrix.hxx"
+
+#include <vector>
+#include <cmath>
+#include <stdio.h>
+
+using namespace ::scsolver::numeric;
+using ::std::vector;
+
+class TestFailed {};
+
+namespace {
+
+double nextValue(unsigned long& seed)
+{
+    seed = (seed*1103515245UL + 12345UL) & 0x7fffffffUL;
+    return static_cast<double>(seed) / 0x3fffffff - 1.0;
+}
+
+void check(bool bCond, const char* msg)
+{
+    if (!bCond)
+    {
+        printf("%s: failed\n", msg);
+        throw TestFailed();
+    }
+    printf("%s: passed\n", msg);
+}
+
+double maxAbsDiff(const vector<double>& a, const vector<double>& b)
+{
+    if (a.size() != b.size())
+        throw TestFailed();
+
+    double fMax = 0.0;
+    for (size_t i = 0; i < a.size(); ++i)
+        fMax = ::std::max(fMax, ::std::fabs(a[i] - b[i]));
+    return fMax;
+}
+
+/**
+ * Random sparse matrix with a strong diagonal so that it is non-singular,
+ * plus a few off-diagonal elements per column.
+ */
+const SparseMatrix makeSparse(size_t n, size_t nPerCol, unsigned long seed)
+{
+    SparseMatrix mx(n, n);
+    for (size_t j = 0; j < n; ++j)
+    {
+        mx.insert(j, j, 4.0 + nextValue(seed));
+        for (size_t k = 0; k < nPerCol; ++k)
+        {
+            size_t i = static_cast<size_t>((nextValue(seed) + 1.0)*0.5*n) % n;
+            mx.insert(i, j, nextValue(seed));
+        }
+    }
+    return mx;
+}
+
+void basic()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("basic operations\n");
+
+    SparseMatrix mx(3, 4);
+    mx.insert(2, 3, 5.0);
+    mx.insert(0, 0, 1.0);
+    mx.insert(1, 2, 2.0);
+    mx.insert(0, 0, 0.5); // accumulates
+    mx.insert(2, 1, -3.0);
+    mx.print();
+
+    check(mx.nonZeros() == 4, "duplicates merged");
+    check(mx.getValue(0, 0) == 1.5 && mx.getValue(2, 3) == 5.0 &&
+          mx.getValue(1, 1) == 0.0, "element access");
+
+    Matrix dense = mx.toMatrix();
+    check(SparseMatrix(dense).toMatrix() == dense, "dense round trip");
+    check(mx.trans().toMatrix() == dense.trans(), "transpose");
+
+    vector<double> x(4), y;
+    x[0] = 1; x[1] = 2; x[2] = 3; x[3] = 4;
+    mx.multiply(x, y);
+    check(y.size() == 3 && y[0] == 1.5 && y[1] == 6.0 && y[2] == 14.0, "A x");
+
+    mx.setRowMirror(true);
+    vector<double> y2;
+    mx.multiply(x, y2);
+    check(y2 == y, "A x with row mirror");
+
+    vector<double> z(3), w;
+    z[0] = 1; z[1] = -1; z[2] = 2;
+    mx.multiplyTrans(z, w);
+    check(w.size() == 4 && w[0] == 1.5 && w[1] == -6.0 && w[2] == -2.0 && w[3] == 10.0, "A^T x");
+
+    vector<size_t> ids;
+    vector<double> vals;
+    mx.getRow(2, ids, vals);
+    check(ids.size() == 2 && ids[0] == 1 && ids[1] == 3 && vals[1] == 5.0, "row extraction");
+
+    // Changes after the mirror was built must show up in it.
+    mx.insert(2, 0, 1.0);
+    mx.multiply(x, y2);
+    check(y2[2] == 15.0, "row mirror invalidated on insert");
+
+    mx.getColumn(0, ids, vals);
+    check(ids.size() == 2 && ids[0] == 0 && ids[1] == 2, "sparse column extraction");
+    vector<double> col;
+    mx.getColumn(3, col);
+    check(col.size() == 3 && col[2] == 5.0 && col[0] == 0.0, "dense column extraction");
+
+    bool bThrown = false;
+    try
+    {
+        mx.insert(3, 0, 1.0);
+    }
+    catch (const BadIndex&)
+    {
+        bThrown = true;
+    }
+    check(bThrown, "out of bound insertion rejected");
+}
+
+void lu()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("sparse LU\n");
+
+    // Arrow matrix: pivoting on the dense first row/column first would fill
+    // in the whole matrix; Markowitz pivoting must avoid that.
+    size_t n = 50;
+    SparseMatrix arrow(n, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        arrow.insert(i, i, 4.0);
+        if (i > 0)
+        {
+            arrow.insert(0, i, 1.0);
+            arrow.insert(i, 0, 1.0);
+        }
+    }
+    SparseLU luArrow(arrow);
+    printf("arrow: nnz(A) = %lu  nnz(L+U) = %lu\n", static_cast<unsigned long>(arrow.nonZeros()),
+           static_cast<unsigned long>(luArrow.nonZeros()));
+    check(luArrow.nonZeros() <= arrow.nonZeros(), "no fill-in on arrow matrix");
+
+    size_t aSizes[] = { 1, 10, 200 };
+    for (size_t k = 0; k < sizeof(aSizes)/sizeof(aSizes[0]); ++k)
+    {
+        n = aSizes[k];
+        SparseMatrix mx = makeSparse(n, 3, 7 + n);
+        SparseLU lu(mx);
+
+        unsigned long seed = n;
+        vector<double> x(n), b;
+        for (size_t i = 0; i < n; ++i)
+            x[i] = nextValue(seed);
+
+        mx.multiply(x, b);
+        lu.solve(b);
+        printf("n = %lu  ", static_cast<unsigned long>(n));
+        check(maxAbsDiff(b, x) < 1e-10, "solve");
+
+        mx.multiplyTrans(x, b);
+        lu.solveTrans(b);
+        printf("n = %lu  ", static_cast<unsigned long>(n));
+        check(maxAbsDiff(b, x) < 1e-10, "transposed solve");
+    }
+
+    // A permuted matrix needs off-diagonal pivots.
+    SparseMatrix perm(3, 3);
+    perm.insert(0, 2, 2.0);
+    perm.insert(1, 0, 3.0);
+    perm.insert(2, 1, 4.0);
+    perm.insert(2, 2, 1.0);
+    vector<double> b(3);
+    b[0] = 2.0; b[1] = 3.0; b[2] = 5.0;
+    SparseLU(perm).solve(b);
+    check(b[0] == 1.0 && b[1] == 1.0 && b[2] == 1.0, "off-diagonal pivots");
+
+    SparseMatrix singular(2, 2);
+    singular.insert(0, 0, 1.0);
+    singular.insert(1, 0, 2.0);
+    bool bThrown = false;
+    try
+    {
+        SparseLU luSingular(singular);
+    }
+    catch (const SingularMatrix&)
+    {
+        bThrown = true;
+    }
+    check(bThrown, "structurally singular matrix rejected");
+
+    singular.insert(0, 1, 2.0);
+    singular.insert(1, 1, 4.0);
+    bThrown = false;
+    try
+    {
+        SparseLU luSingular(singular);
+    }
+    catch (const SingularMatrix&)
+    {
+        bThrown = true;
+    }
+    check(bThrown, "numerically singular matrix rejected");
+}
+
+void cholesky()
+{
+    printf("--------------------------------------------------------------------\n");
+    printf("sparse Cholesky\n");
+
+    // Arrow matrix with the dense row and column first: the ordering must
+    // move them last to avoid filling in the whole factor.
+    size_t n = 50;
+    SparseMatrix arrow(n, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        arrow.insert(i, i, static_cast<double>(n));
+        if (i > 0)
+        {
+            arrow.insert(0, i, 1.0);
+            arrow.insert(i, 0, 1.0);
+        }
+    }
+    SparseCholesky chol;
+    chol.factorize(arrow);
+    printf("arrow: nnz(A) = %lu  nnz(L) = %lu\n", static_cast<unsigned long>(arrow.nonZeros()),
+           static_cast<unsigned long>(chol.nonZeros()));
+    check(chol.nonZeros() == 2*n - 1, "no fill-in on arrow matrix");
+
+    // B B^T + I for a random sparse B, factorized twice with different
+    // values in the same pattern.
+    n = 200;
+    SparseMatrix mxB = makeSparse(n, 3, 11);
+    for (size_t nPass = 0; nPass < 2; ++nPass)
+    {
+        SparseMatrix mxBT = mxB.trans();
+        SparseMatrix mx(n, n);
+        vector<double> col(n), prod;
+        for (size_t j = 0; j < n; ++j)
+        {
+            mxBT.getColumn(j, col);
+            mxB.multiply(col, prod);
+            for (size_t i = 0; i < n; ++i)
+                if (prod[i] != 0.0 || i == j)
+                    mx.insert(i, j, prod[i] + (i == j ? 1.0 + nPass : 0.0));
+        }
+        if (nPass == 0)
+            chol.analyze(mx);
+        chol.factorize(mx);
+
+        unsigned long seed = 3;
+        vector<double> x(n), b;
+        for (size_t i = 0; i < n; ++i)
+            x[i] = nextValue(seed);
+        mx.multiply(x, b);
+        chol.solve(b);
+        printf("pass %lu: nnz(A) = %lu  nnz(L) = %lu  ", static_cast<unsigned long>(nPass),
+               static_cast<unsigned long>(mx.nonZeros()), static_cast<unsigned long>(chol.nonZeros()));
+        check(maxAbsDiff(b, x) < 1e-10, "solve");
+    }
+
+    SparseMatrix indefinite(2, 2);
+    indefinite.insert(0, 0, 1.0);
+    indefinite.insert(1, 0, 2.0);
+    indefinite.insert(0, 1, 2.0);
+    indefinite.insert(1, 1, 1.0);
+    bool bThrown = false;
+    try
+    {
+        chol.factorize(indefinite);
+    }
+    catch (const SingularMatrix&)
+    {
+        bThrown = true;
+    }
+    check(bThrown, "indefinite matrix rejected");
+
+    // With a pivot tolerance, the dependent row is dropped instead.
+    SparseMatrix singular(2, 2);
+    singular.insert(0, 0, 1.0);
+    singular.insert(1, 0, 2.0);
+    singular.insert(0, 1, 2.0);
+    singular.insert(1, 1, 4.0);
+    chol.setPivotTolerance(1e-12);
+    chol.factorize(singular);
+    vector<double> b(2);
+    b[0] = 1.0;
+    b[1] = 2.0;
+    chol.solve(b);
+    vector<double> r;
+    singular.multiply(b, r);
+    check(chol.getSmallPivotCount() == 1 && ::std::fabs(r[0] - 1.0) < 1e-10 && ::std::fabs(r[1] - 2.0) < 1e-10,
+          "singular matrix with pivot tolerance");
+}
+
+}
+
+int main()
+{
+    printf("unit test: sparse matrix\n");
+    basic();
+    lu();
+    cholesky();
+    printf("Unit test passed!\n");
+}
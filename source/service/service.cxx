@@ -52,7 +52,8 @@ SolverImpl::SolverImpl( Reference< uno::XComponentContext > const & xContext ) :
     m_pDlg(NULL), 
     m_pCalc(new CalcInterface(xContext)),
     m_pOption(new OptionData),
-    m_pStringResMgr(new StringResMgr(m_pCalc.get()))
+    m_pStringResMgr(new StringResMgr(m_pCalc.get())),
+    m_pSolveModel(NULL)
 {
 }
 
@@ -178,17 +179,21 @@ sal_Bool SolverImpl::solveModel()
 {	
 	Debug("solveModel --------------------------------------------------------");
 
-	::std::auto_ptr<SolveModel> p( new SolveModel( this ) );
+	if ( !m_pSolveModel.get() )
+	{
+		::std::auto_ptr<SolveModel> p( new SolveModel( this ) );
+		m_pSolveModel = p;
+	}
 	try
 	{
-		p->solve();
+		m_pSolveModel->solve();
 	}
 	catch( const RuntimeError& e )
 	{
 		getMainDialog()->showMessage( e.getMessage() );
 	}
 
-	if ( p->isSolved() )
+	if ( m_pSolveModel->isSolved() )
 	{
 		Debug( "solution available" );
 		return true;
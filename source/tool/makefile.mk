@@ -14,6 +14,7 @@ ENABLE_EXCEPTIONS=TRUE
 
 SLOFILES =  \
         $(SLO)$/timer.obj \
+        $(SLO)$/thread.obj \
         $(SLO)$/global.obj
 
 # --- Tagets -------------------------------------------------------
@@ -0,0 +1,270 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ * 
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "tool/thread.hxx"
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+namespace scsolver {
+
+class MutexImpl
+{
+public:
+	MutexImpl()
+	{
+#ifndef _WIN32
+		pthread_mutex_init( &m_aMutex, NULL );
+#else
+		InitializeCriticalSection( &m_aMutex );
+#endif
+	}
+
+	~MutexImpl() throw()
+	{
+#ifndef _WIN32
+		pthread_mutex_destroy( &m_aMutex );
+#else
+		DeleteCriticalSection( &m_aMutex );
+#endif
+	}
+
+	void acquire()
+	{
+#ifndef _WIN32
+		pthread_mutex_lock( &m_aMutex );
+#else
+		EnterCriticalSection( &m_aMutex );
+#endif
+	}
+
+	void release()
+	{
+#ifndef _WIN32
+		pthread_mutex_unlock( &m_aMutex );
+#else
+		LeaveCriticalSection( &m_aMutex );
+#endif
+	}
+
+private:
+#ifndef _WIN32
+	pthread_mutex_t m_aMutex;
+#else
+	CRITICAL_SECTION m_aMutex;
+#endif
+
+	friend class ConditionImpl;
+};
+
+//-----------------------------------------------------------------
+
+class ConditionImpl
+{
+public:
+	ConditionImpl()
+	{
+#ifndef _WIN32
+		pthread_cond_init( &m_aCond, NULL );
+#else
+		InitializeConditionVariable( &m_aCond );
+#endif
+	}
+
+	~ConditionImpl() throw()
+	{
+#ifndef _WIN32
+		pthread_cond_destroy( &m_aCond );
+#endif
+	}
+
+	void wait( Mutex& rMutex )
+	{
+		MutexImpl* p = rMutex.m_pImpl.get();
+#ifndef _WIN32
+		pthread_cond_wait( &m_aCond, &p->m_aMutex );
+#else
+		SleepConditionVariableCS( &m_aCond, &p->m_aMutex, INFINITE );
+#endif
+	}
+
+	void notifyAll()
+	{
+#ifndef _WIN32
+		pthread_cond_broadcast( &m_aCond );
+#else
+		WakeAllConditionVariable( &m_aCond );
+#endif
+	}
+
+private:
+#ifndef _WIN32
+	pthread_cond_t m_aCond;
+#else
+	CONDITION_VARIABLE m_aCond;
+#endif
+};
+
+//-----------------------------------------------------------------
+
+class ThreadImpl
+{
+public:
+	ThreadImpl( Thread* pSelf ) :
+		m_pSelf( pSelf ), m_bRunning( false )
+	{
+	}
+
+	~ThreadImpl() throw()
+	{
+	}
+
+	bool start()
+	{
+		if ( m_bRunning )
+			return true;
+#ifndef _WIN32
+		m_bRunning = pthread_create( &m_aThread, NULL, &ThreadImpl::execute, m_pSelf ) == 0;
+#else
+		m_aThread = CreateThread( NULL, 0, &ThreadImpl::execute, m_pSelf, 0, NULL );
+		m_bRunning = m_aThread != NULL;
+#endif
+		return m_bRunning;
+	}
+
+	void join()
+	{
+		if ( !m_bRunning )
+			return;
+#ifndef _WIN32
+		pthread_join( m_aThread, NULL );
+#else
+		WaitForSingleObject( m_aThread, INFINITE );
+		CloseHandle( m_aThread );
+#endif
+		m_bRunning = false;
+	}
+
+private:
+#ifndef _WIN32
+	static void* execute( void* p )
+	{
+		static_cast<Thread*>( p )->run();
+		return NULL;
+	}
+
+	pthread_t m_aThread;
+#else
+	static DWORD WINAPI execute( LPVOID p )
+	{
+		static_cast<Thread*>( p )->run();
+		return 0;
+	}
+
+	HANDLE m_aThread;
+#endif
+
+	Thread* m_pSelf;
+	bool m_bRunning;
+};
+
+//-----------------------------------------------------------------
+
+Mutex::Mutex() :
+	m_pImpl( new MutexImpl )
+{
+}
+
+Mutex::~Mutex() throw()
+{
+}
+
+void Mutex::acquire()
+{
+	m_pImpl->acquire();
+}
+
+void Mutex::release()
+{
+	m_pImpl->release();
+}
+
+MutexGuard::MutexGuard( Mutex& rMutex ) :
+	m_rMutex( rMutex )
+{
+	m_rMutex.acquire();
+}
+
+MutexGuard::~MutexGuard() throw()
+{
+	m_rMutex.release();
+}
+
+Condition::Condition() :
+	m_pImpl( new ConditionImpl )
+{
+}
+
+Condition::~Condition() throw()
+{
+}
+
+void Condition::wait( Mutex& rMutex )
+{
+	m_pImpl->wait( rMutex );
+}
+
+void Condition::notifyAll()
+{
+	m_pImpl->notifyAll();
+}
+
+Thread::Thread() :
+	m_pImpl( new ThreadImpl( this ) )
+{
+}
+
+Thread::~Thread() throw()
+{
+}
+
+bool Thread::start()
+{
+	return m_pImpl->start();
+}
+
+void Thread::join()
+{
+	m_pImpl->join();
+}
+
+size_t Thread::getProcessorCount()
+{
+#ifndef _WIN32
+	long n = sysconf( _SC_NPROCESSORS_ONLN );
+	return n > 0 ? static_cast<size_t>( n ) : 1;
+#else
+	SYSTEM_INFO aInfo;
+	GetSystemInfo( &aInfo );
+	return aInfo.dwNumberOfProcessors > 0 ? aInfo.dwNumberOfProcessors : 1;
+#endif
+}
+
+}
@@ -43,7 +43,12 @@ public:
 
 	bool isTimedOut()
 	{
-		return (getTime() - m_fCurTime) > m_fDuration;
+		return getElapsedTime() > m_fDuration;
+	}
+
+	double getElapsedTime()
+	{
+		return getTime() - m_fCurTime;
 	}
 
 private:
@@ -105,4 +110,9 @@ bool Timer::isTimedOut() const
 	return m_pImpl->isTimedOut();
 }
 
+double Timer::getElapsedTime() const
+{
+	return m_pImpl->getElapsedTime();
+}
+
 }
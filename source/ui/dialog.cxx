@@ -512,6 +512,11 @@ void SolverDialog::initialize()
     addButton( 205, 90, 50, 15, ascii( "btnSave" ), getResStr(SCSOLVER_STR_BTN_SAVE_MODEL) );
     addButton( 205, 110, 50, 15, ascii( "btnLoad" ), getResStr(SCSOLVER_STR_BTN_LOAD_MODEL) );
 
+    p = addFixedText( 205, 130, 50, 45, ascii( "ftProgress" ), ascii( "" ) );
+    uno::Any aMultiLine;
+    aMultiLine <<= sal_True;
+    p->setPropertyValueAny( "MultiLine", aMultiLine );
+
     // Buttons at the bottom of the dialog.
     addButton( 150, 180, 50, 15, ascii("btnClose"), getResStr(SCSOLVER_STR_BTN_CLOSE) );
     addButton( 205, 180, 50, 15, ascii("btnHelp"),  ascii(""), awt::PushButtonType_HELP );
@@ -1114,4 +1119,27 @@ void SolverDialog::enableAllWidgets(bool enable)
     }
 }
 
+void SolverDialog::setSolveRunning(bool bRunning)
+{
+    WidgetProperty aSolveBtn(getWidgetModelByName(ascii("btnSolve")));
+    showProgress(ascii(""));
+    if (bRunning)
+    {
+        enableAllWidgets(false);
+        enableWidget(ascii("btnSolve"), true);
+        enableWidget(ascii("ftProgress"), true);
+        aSolveBtn.setLabel(getResStr(SCSOLVER_STR_BTN_STOP));
+    }
+    else
+    {
+        aSolveBtn.setLabel(getResStr(SCSOLVER_STR_BTN_SOLVE));
+        enableAllWidgets(true);
+    }
+}
+
+void SolverDialog::showProgress(const OUString& sProgress)
+{
+    WidgetProperty(getWidgetModelByName(ascii("ftProgress"))).setLabel(sProgress);
+}
+
 }
@@ -248,9 +248,6 @@ public:
     const rtl::OUString getTempCellFormula( const CellAddress& ) const;
     void setTempCellFormula( const table::CellAddress&, const rtl::OUString& );
 
-    void stripConstConstraint();
-    void stripZeroCostDecisionVar();
-
 private:
 
     numeric::GoalType m_eGoal;
@@ -287,9 +284,6 @@ LpModelBuilderImpl::~LpModelBuilderImpl() throw()
     return it to the caller when it's successfully created. */
 numeric::lp::Model LpModelBuilderImpl::getModel()
 {
-    //stripZeroCostDecisionVar();
-    //stripConstConstraint();
-
     numeric::lp::Model aModel;
     
     vector< DecisionVar >::const_iterator it,
@@ -485,84 +479,6 @@ void LpModelBuilderImpl::setTempCellFormula( const table::CellAddress& aAddr, co
     m_cnCellAttrs.push_back( aCellAttr );
 }
 
-/** Remove constraint and right-hand-side row(s) if all elements of the 
-    constraint row is zero and the constraint is already satisfied. */
-void LpModelBuilderImpl::stripConstConstraint()
-{
-    using namespace numeric;
-
-    Debug( "stripConstConstraint" );
-
-    Matrix mxConstraint( m_mxConstraint ), mxRHS( m_mxRHS );
-    OSL_ASSERT( mxConstraint.rows() == mxRHS.rows() );
-    size_t nRowSize = mxConstraint.rows();
-
-    vector<size_t> cnRowsToRemove;
-
-    // Scan the constraint matrix to find empty rows.
-    for ( size_t i = 0; i < nRowSize; ++i )
-        if ( mxConstraint.isRowEmpty( i ) )
-        {
-            double fRHS = mxRHS( i, 0 );
-            EqualityType eEq = getConstraintEquality( i );
-            if ( ( fRHS <= 0 && eEq == GREATER_EQUAL ) ||
-                 ( fRHS >= 0 && eEq == LESS_EQUAL ) ||
-                 ( fRHS == 0.0 && eEq == EQUAL ) )
-                cnRowsToRemove.push_back( i );
-        }
-
-    cout << "rows to remove: ";
-    printElements( cnRowsToRemove );
-
-    mxConstraint.deleteRows( cnRowsToRemove );
-    mxRHS.deleteRows( cnRowsToRemove );
-
-    m_mxConstraint.swap( mxConstraint );
-    m_mxRHS.swap( mxRHS );
-}
-
-/** Remove decision variables and their corresponding constraint columns if 
-    and only if they all have a zero cost coefficient and all elements in 
-    their constraint column. */
-void LpModelBuilderImpl::stripZeroCostDecisionVar()
-{
-    Debug( "stripZeroCostDecisionVar" );
-
-    vector< DecisionVar > cnNewVars;
-    Matrix mxConstraint( m_mxConstraint );
-    cnNewVars.reserve( m_cnDecisionVars.size() );
-    vector< size_t > cnColsToRemove;
-
-    vector< DecisionVar >::iterator it,
-            itBeg = m_cnDecisionVars.begin(), itEnd = m_cnDecisionVars.end();
-    cout << m_cnDecisionVars.size() << endl;
-    size_t nLastRow = mxConstraint.rows();
-    for ( it = itBeg; it != itEnd; ++it )
-    {
-        if ( it->Cost )
-            cnNewVars.push_back( *it );
-        else
-        {
-            size_t nCol = distance( itBeg, it );
-            if ( mxConstraint.isColumnEmpty( nCol ) )
-                cnColsToRemove.push_back( nCol );
-            else
-                cnNewVars.push_back( *it );
-        }
-    }
-
-    printElements( cnColsToRemove );
-    cout << "mxConstraint:" << endl;
-    mxConstraint.print( 0 );
-    
-    cout << "(" << nLastRow << ", " << mxConstraint.cols() << ")" << endl;
-    
-    mxConstraint.deleteColumns( cnColsToRemove );
-    mxConstraint.print( 0 );
-    swap( cnNewVars, m_cnDecisionVars );
-    m_mxConstraint.swap( mxConstraint );
-}
-
 //---------------------------------------------------------------------------
 // LpModelBuilder
 
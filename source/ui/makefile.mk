@@ -26,6 +26,7 @@ SLOFILES =  \
 	$(SLO)$/msgdlg.obj \
 	$(SLO)$/resmgr.obj \
 	$(SLO)$/solvemodel.obj \
+	$(SLO)$/solvethread.obj \
 	$(SLO)$/unoglobal.obj \
 	$(SLO)$/unohelper.obj \
 	$(SLO)$/xcalc.obj \
@@ -28,7 +28,8 @@ struct OptionDataImpl
 	OptionDataImpl() :
 		VarPositive(true),
 		VarInteger(false),
-		ModelType(OPTMODELTYPE_LP)
+		ModelType(OPTMODELTYPE_LP),
+		LpAlgorithm(OPTLPALGORITHM_SIMPLEX)
 	{
 	}
 
@@ -37,6 +38,7 @@ struct OptionDataImpl
 	bool VarPositive:1;
 	bool VarInteger:1;
 	OptModelType ModelType;
+	OptLpAlgorithm LpAlgorithm;
 };
 
 //-----------------------------------------------------------------
@@ -79,4 +81,14 @@ OptModelType OptionData::getModelType() const
 	return m_pImpl->ModelType;
 }
 
+void OptionData::setLpAlgorithm( OptLpAlgorithm algorithm )
+{
+	m_pImpl->LpAlgorithm = algorithm;
+}
+
+OptLpAlgorithm OptionData::getLpAlgorithm() const
+{
+	return m_pImpl->LpAlgorithm;
+}
+
 }
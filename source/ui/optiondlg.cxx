@@ -24,6 +24,7 @@
 #include <memory>
 
 #include "com/sun/star/awt/XCheckBox.hpp"
+#include "com/sun/star/awt/XRadioButton.hpp"
 
 #include "scsolver.hrc"
 
@@ -56,6 +57,7 @@ public:
         pOption->setModelType(p->getModelType());
         pOption->setVarPositive(p->isVarPositive());
         pOption->setVarInteger(p->isVarInteger());
+        pOption->setLpAlgorithm(p->getLpAlgorithm());
 	}
 };
 
@@ -122,6 +124,20 @@ void OptionDialog::initialize()
 	addCheckBox( nX, nY+2, nWidth-nX-nMargin, 12, ascii("cbIntegerValue"),
                  getResStr(SCSOLVER_STR_OPTION_VAR_INTEGER) );
 
+    // The LP engines exclude each other, so they form one group of
+    // radio buttons.
+    nY += 13;
+	addRadioButton( nX, nY+2, nWidth-nX-nMargin, 12, ascii("rbDefaultEngine"),
+                    getResStr(SCSOLVER_STR_OPTION_DEFAULT_ENGINE) );
+
+    nY += 13;
+	addRadioButton( nX, nY+2, nWidth-nX-nMargin, 12, ascii("rbBuiltinEngine"),
+                    getResStr(SCSOLVER_STR_OPTION_BUILTIN_ENGINE) );
+
+    nY += 13;
+	addRadioButton( nX, nY+2, nWidth-nX-nMargin, 12, ascii("rbPortfolio"),
+                    getResStr(SCSOLVER_STR_OPTION_PORTFOLIO) );
+
 	addButton( nWidth-110, nHeight-20, 50, 15, ascii("btnOK"), 
 			   getResStr(SCSOLVER_STR_BTN_OK) );
 
@@ -140,6 +156,7 @@ void OptionDialog::initOptionData()
     setVarPositive(pData->getVarPositive());
     setVarInteger(pData->getVarInteger());
     setModelType(pData->getModelType());
+    setLpAlgorithm(pData->getLpAlgorithm());
 }
 
 void OptionDialog::registerListeners()
@@ -225,4 +242,30 @@ void OptionDialog::setVarInteger(bool b)
     xCB->setState(b);
 }
 
+OptLpAlgorithm OptionDialog::getLpAlgorithm() const
+{
+    Reference<uno::XInterface> oWgt = getWidgetByName( ascii("rbBuiltinEngine") );
+    Reference<awt::XRadioButton> xRB( oWgt, UNO_QUERY );
+    if ( xRB->getState() )
+        return OPTLPALGORITHM_BUILTIN;
+
+    Reference<uno::XInterface> oPortfolio = getWidgetByName( ascii("rbPortfolio") );
+    Reference<awt::XRadioButton> xPortfolio( oPortfolio, UNO_QUERY );
+    return xPortfolio->getState() ? OPTLPALGORITHM_PORTFOLIO : OPTLPALGORITHM_SIMPLEX;
+}
+
+void OptionDialog::setLpAlgorithm( OptLpAlgorithm algorithm )
+{
+    rtl::OUString sName = ascii("rbDefaultEngine");
+    if ( algorithm == OPTLPALGORITHM_BUILTIN )
+        sName = ascii("rbBuiltinEngine");
+    else if ( algorithm == OPTLPALGORITHM_PORTFOLIO )
+        sName = ascii("rbPortfolio");
+
+    // Checking one button of the group unchecks the others.
+    Reference<uno::XInterface> oWgt = getWidgetByName( sName );
+    Reference<awt::XRadioButton> xRB( oWgt, UNO_QUERY );
+    xRB->setState( true );
+}
+
 }
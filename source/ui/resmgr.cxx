@@ -334,7 +334,25 @@ OUString StringResMgr::getResNameByID(int resid)
         // SCSOLVER_STR_TARGET_NOT_SET
         ascii("Common.TargetNotSet.Label"),
         // SCSOLVER_STR_DECISIONVAR_NOT_SET
-        ascii("Common.DecisionNotSet.Label")
+        ascii("Common.DecisionNotSet.Label"),
+        // SCSOLVER_STR_OPTION_BUILTIN_ENGINE
+        ascii("OptionDialog.rbBuiltinEngine.Label"),
+        // SCSOLVER_STR_BTN_STOP
+        ascii("SolverDialog.btnStop.Label"),
+        // SCSOLVER_STR_MSG_SOLVE_CANCELLED
+        ascii("Common.SolveCancelled.Label"),
+        // SCSOLVER_STR_PROGRESS_ITERATION
+        ascii("SolverDialog.ftProgressIteration.Label"),
+        // SCSOLVER_STR_PROGRESS_NODE
+        ascii("SolverDialog.ftProgressNode.Label"),
+        // SCSOLVER_STR_PROGRESS_OBJECTIVE
+        ascii("SolverDialog.ftProgressObjective.Label"),
+        // SCSOLVER_STR_PROGRESS_GAP
+        ascii("SolverDialog.ftProgressGap.Label"),
+        // SCSOLVER_STR_OPTION_PORTFOLIO
+        ascii("OptionDialog.rbPortfolio.Label"),
+        // SCSOLVER_STR_OPTION_DEFAULT_ENGINE
+        ascii("OptionDialog.rbDefaultEngine.Label")
     };
 
     if (static_cast<size_t>(resid) - SCSOLVER_RES_START >= sizeof(resNameList)/sizeof(resNameList[0]))
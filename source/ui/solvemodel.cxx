@@ -23,25 +23,37 @@
 #include "nlpbuilder.hxx"
 #include "dialog.hxx"
 #include "xcalc.hxx"
+#include "solvethread.hxx"
 #include "option.hxx"
 #include "numeric/lpmodel.hxx"
 #include "numeric/nlpmodel.hxx"
 #include "numeric/matrix.hxx"
 #include "numeric/type.hxx"
 #include "numeric/lpbase.hxx"
+#include "numeric/lppresolve.hxx"
+#include "numeric/lpscaling.hxx"
+#include "numeric/lpinteriorpoint.hxx"
+#include "numeric/lpdualsimplex.hxx"
+#include "numeric/lpbranchbound.hxx"
+#include "numeric/lpportfolio.hxx"
 #include "numeric/exception.hxx"
 //#include "numeric/lpsimplex.hxx"
 #include "numeric/lpsolve.hxx"
 #include "numeric/quasinewton.hxx"
 #include "numeric/cellfuncobj.hxx"
+#include "numeric/solvecontrol.hxx"
 #ifdef ENABLE_SCSOLVER_UNO_ALGORITHM
 #include "numeric/lpuno.hxx"
 #endif
 
+#include <rtl/ustrbuf.hxx>
+
 #include <memory>
 #include <exception>
 #include <vector>
 #include <map>
+#include <sstream>
+#include <stdio.h>
 
 #include "scsolver.hrc"
 
@@ -54,6 +66,7 @@ using ::std::endl;
 using ::std::map;
 using ::std::auto_ptr;
 using ::std::distance;
+using ::std::ostringstream;
 
 namespace scsolver {
 
@@ -151,6 +164,73 @@ private:
 
 // ----------------------------------------------------------------------------
 
+/**
+ * Convert a basis into its string form, which has one character per
+ * decision variable, a '/', and one character per constraint row: 'B' for
+ * basic, 'L' and 'U' for non-basic at the lower and upper bound.
+ */
+rtl::OUString basisToString( const lp::Basis& aBasis )
+{
+	rtl::OUStringBuffer sb;
+	for ( size_t i = 0; i < aBasis.getVarCount() + aBasis.getRowCount(); ++i )
+	{
+		if ( i == aBasis.getVarCount() )
+			sb.append( sal_Unicode('/') );
+
+		lp::BasisStatus eStatus = i < aBasis.getVarCount() ?
+			aBasis.getVarStatus( i ) : aBasis.getRowStatus( i - aBasis.getVarCount() );
+		switch ( eStatus )
+		{
+		case lp::BASIS_BASIC:
+			sb.append( sal_Unicode('B') );
+			break;
+		case lp::BASIS_LOWER:
+			sb.append( sal_Unicode('L') );
+			break;
+		case lp::BASIS_UPPER:
+			sb.append( sal_Unicode('U') );
+			break;
+		}
+	}
+	return sb.makeStringAndClear();
+}
+
+/**
+ * Parse the string form of a basis.  It returns an empty basis if the
+ * string is malformed.
+ */
+const lp::Basis stringToBasis( const rtl::OUString& sBasis )
+{
+	sal_Int32 nSep = sBasis.indexOf( sal_Unicode('/') );
+	if ( nSep < 0 )
+		return lp::Basis();
+
+	size_t nVarCount = static_cast<size_t>( nSep );
+	size_t nRowCount = static_cast<size_t>( sBasis.getLength() - nSep - 1 );
+	lp::Basis aBasis( nVarCount, nRowCount );
+	for ( size_t i = 0; i < nVarCount + nRowCount; ++i )
+	{
+		sal_Unicode c = sBasis[i < nVarCount ? i : i + 1];
+		lp::BasisStatus eStatus;
+		if ( c == 'B' )
+			eStatus = lp::BASIS_BASIC;
+		else if ( c == 'L' )
+			eStatus = lp::BASIS_LOWER;
+		else if ( c == 'U' )
+			eStatus = lp::BASIS_UPPER;
+		else
+			return lp::Basis();
+
+		if ( i < nVarCount )
+			aBasis.setVarStatus( i, eStatus );
+		else
+			aBasis.setRowStatus( i - nVarCount, eStatus );
+	}
+	return aBasis;
+}
+
+// ----------------------------------------------------------------------------
+
 /** 
  * This class is used as a local variable to automatically perform pre- and 
  * post-process tasks of optimization run. 
@@ -180,60 +260,475 @@ private:
     CalcInterface*  mpCalc;
 };
 
+// ----------------------------------------------------------------------------
+
+/**
+ * Numeric phase of a solve, common to the LP and the NLP models.  It
+ * records how the solve has ended, so that the main thread can report it
+ * once the job has been handed back.
+ */
+class ModelSolveJob : public SolveJob
+{
+public:
+	enum Result
+	{
+		RESULT_SOLVED,
+		RESULT_INFEASIBLE,
+		RESULT_TIMED_OUT,
+		RESULT_MAX_ITERATION,
+		RESULT_CANCELLED,
+		RESULT_RUNTIME_ERROR,
+		RESULT_STD_EXCEPTION
+	};
+
+	ModelSolveJob() : m_eResult( RESULT_STD_EXCEPTION ) {}
+	virtual ~ModelSolveJob() throw() {}
+
+	virtual void run( SolveControl& rControl, MainThreadCaller& rCaller )
+	{
+		try
+		{
+			solve( rControl, rCaller );
+			m_eResult = RESULT_SOLVED;
+		}
+		catch ( const ModelInfeasible& )
+		{
+			Debug( "model infeasible" );
+			m_eResult = RESULT_INFEASIBLE;
+		}
+		catch ( const IterationTimedOut& )
+		{
+			m_eResult = RESULT_TIMED_OUT;
+		}
+		catch ( const MaxIterationReached& )
+		{
+			m_eResult = RESULT_MAX_ITERATION;
+		}
+		catch ( const SolveCancelled& )
+		{
+			m_eResult = RESULT_CANCELLED;
+		}
+		catch ( const RuntimeError& e )
+		{
+			// This error message is localizable.
+			m_eResult = RESULT_RUNTIME_ERROR;
+			m_sMessage = e.getMessage();
+		}
+		catch ( const ::std::exception& e )
+		{
+			// standard exception.  should rarely happen.
+			m_eResult = RESULT_STD_EXCEPTION;
+			fprintf(stdout, "ModelSolveJob::run:   std exception msg = '%s'\n", e.what());
+		}
+	}
+
+	Result getResult() const { return m_eResult; }
+	const rtl::OUString& getMessage() const { return m_sMessage; }
+
+	/** Update the document with the outcome; called on the main thread. */
+	virtual void finish( SolverImpl* pSolverImpl ) = 0;
+
+protected:
+	virtual void solve( SolveControl& rControl, MainThreadCaller& rCaller ) = 0;
+
+private:
+	Result m_eResult;
+	rtl::OUString m_sMessage;
+};
+
+class LpSolveJob : public ModelSolveJob
+{
+public:
+	LpSolveJob( auto_ptr<LpModelBuilder> pBuilder, const lp::Model& aModel,
+				auto_ptr<lp::BaseAlgorithm> pAlgorithm, const lp::Basis& aStartBasis,
+				bool bPresolve ) :
+		m_pBuilder( pBuilder ),
+		m_aModel( aModel ),
+		m_pAlgorithm( pAlgorithm ),
+		m_aStartBasis( aStartBasis ),
+		m_bPresolve( bPresolve ),
+		m_bOptimal( false )
+	{
+	}
+
+	virtual ~LpSolveJob() throw() {}
+
+	virtual void finish( SolverImpl* pSolverImpl )
+	{
+		if ( getResult() != RESULT_SOLVED )
+			return;
+
+		vector<CellAddress> cnAddrs = m_pBuilder->getAllDecisionVarAddresses();
+		CalcInterface* pCalc = pSolverImpl->getCalcInterface();
+		OSL_ASSERT( m_mxSolution.rows() == cnAddrs.size() );
+		vector<CellAddress>::iterator it, itEnd = cnAddrs.end();
+		size_t nIdx = 0;
+		for ( it = cnAddrs.begin(); it != itEnd; ++it )
+			pCalc->setCellValue( *it, m_mxSolution( nIdx++, 0 ) );
+	}
+
+	const lp::Basis& getBasis() const { return m_aBasis; }
+
+	/** @return bool true if the solve has ended with a proven optimum. */
+	bool isOptimal() const { return getResult() == RESULT_SOLVED && m_bOptimal; }
+
+	/**
+	 * Hand the algorithm back, so that it is reused by the next solve.
+	 */
+	auto_ptr<lp::BaseAlgorithm> releaseAlgorithm()
+	{
+		m_pAlgorithm->setModel( NULL );
+		m_pAlgorithm->setSolveControl( NULL );
+		return m_pAlgorithm;
+	}
+
+protected:
+	virtual void solve( SolveControl& rControl, MainThreadCaller& )
+	{
+		// Presolve relies on the objective to remove dominated
+		// columns, so it only runs when there is one to optimize.  The
+		// stored basis refers to the original model, so a warm start
+		// skips presolve.
+		bool bWarmStart = !m_aStartBasis.empty() &&
+			m_aStartBasis.getVarCount() == m_aModel.getDecisionVarSize() &&
+			m_aStartBasis.getRowCount() == m_aModel.getConstraintCount();
+		bool bPresolve = m_bPresolve && !bWarmStart;
+
+		lp::Presolver aPresolver;
+		if ( bPresolve )
+			aPresolver.presolve( m_aModel );
+		auto_ptr<lp::Model> p( new lp::Model( bPresolve ? aPresolver.getReducedModel() : m_aModel ) );
+		m_pSolveModel = p;
+
+		if ( m_pSolveModel->getDecisionVarSize() > 0 )
+		{
+			m_pAlgorithm->setModel( m_pSolveModel.get() );
+			m_pAlgorithm->setStartBasis( bPresolve ? lp::Basis() : m_aStartBasis );
+			m_pAlgorithm->setSolveControl( &rControl );
+			m_pAlgorithm->solve();
+			m_mxSolution = m_pAlgorithm->getSolution();
+			m_aBasis = m_pAlgorithm->getBasis();
+			if ( bPresolve )
+				m_aBasis = aPresolver.postsolveBasis( m_aBasis );
+			m_bOptimal = m_pAlgorithm->isOptimal();
+		}
+		else
+		{
+			// Presolve has determined the whole solution.
+			m_mxSolution = Matrix( 0, 0 );
+			m_bOptimal = true;
+		}
+
+		if ( bPresolve )
+			m_mxSolution = aPresolver.postsolve( m_mxSolution );
+	}
+
+private:
+	auto_ptr<LpModelBuilder> m_pBuilder;
+	lp::Model m_aModel;
+	auto_ptr<lp::Model> m_pSolveModel;
+	auto_ptr<lp::BaseAlgorithm> m_pAlgorithm;
+	lp::Basis m_aStartBasis;
+	bool m_bPresolve;
+	Matrix m_mxSolution;
+	lp::Basis m_aBasis;
+	bool m_bOptimal;
+};
+
+/**
+ * Function object that keeps the variables of the cells locally, and
+ * evaluates the target cell on the main thread, so that an NLP algorithm
+ * can run on the solver thread.
+ */
+class MarshalledFuncObj : public BaseFuncObj
+{
+public:
+	explicit MarshalledFuncObj( CellFuncObj& rCells ) :
+		m_rCells( rCells ),
+		m_pCaller( NULL )
+	{
+		m_rCells.getVars( m_aVars );
+	}
+
+	virtual ~MarshalledFuncObj() throw() {}
+
+	void setCaller( MainThreadCaller* p ) { m_pCaller = p; }
+
+	virtual void getVars( vector<double>& rVars ) const { rVars = m_aVars; }
+	virtual double getVar( size_t index ) const { return m_aVars.at( index ); }
+	virtual void setVars( const vector<double>& vars )
+	{
+		for ( size_t i = 0; i < m_aVars.size() && i < vars.size(); ++i )
+			m_aVars[i] = vars[i];
+	}
+	virtual void setVar( size_t index, double var )
+	{
+		if ( index < m_aVars.size() )
+			m_aVars[index] = var;
+	}
+	virtual size_t getVarCount() const { return m_aVars.size(); }
+
+	virtual double eval() const
+	{
+		EvalCall aCall( m_rCells, m_aVars );
+		m_pCaller->call( aCall );
+		return aCall.getValue();
+	}
+
+	virtual const ::std::string getFuncString() const { return m_rCells.getFuncString(); }
+
+private:
+	class EvalCall : public MainThreadCall
+	{
+	public:
+		EvalCall( CellFuncObj& rCells, const vector<double>& rVars ) :
+			m_rCells( rCells ), m_rVars( rVars ), m_fValue( 0.0 ) {}
+		virtual ~EvalCall() throw() {}
+
+		virtual void execute()
+		{
+			m_rCells.setVars( m_rVars );
+			m_fValue = m_rCells.eval();
+		}
+
+		double getValue() const { return m_fValue; }
+
+	private:
+		CellFuncObj& m_rCells;
+		const vector<double>& m_rVars;
+		double m_fValue;
+	};
+
+	CellFuncObj& m_rCells;
+	MainThreadCaller* m_pCaller;
+	vector<double> m_aVars;
+};
+
+class NlpSolveJob : public ModelSolveJob
+{
+public:
+	NlpSolveJob( auto_ptr<CellFuncObj> pCells, const nlp::Model& aModel,
+				 auto_ptr<nlp::BaseAlgorithm> pAlgorithm ) :
+		m_pCells( pCells ),
+		m_aFuncObj( *m_pCells ),
+		m_aModel( aModel ),
+		m_pAlgorithm( pAlgorithm )
+	{
+		m_aModel.setFuncObject( &m_aFuncObj );
+	}
+
+	virtual ~NlpSolveJob() throw() {}
+
+	/**
+	 * The cells end up with the last point the algorithm has evaluated,
+	 * as they would if it had worked on the cells directly.
+	 */
+	virtual void finish( SolverImpl* )
+	{
+		vector<double> aVars;
+		m_aFuncObj.getVars( aVars );
+		m_pCells->setVars( aVars );
+	}
+
+protected:
+	virtual void solve( SolveControl& rControl, MainThreadCaller& rCaller )
+	{
+		m_aFuncObj.setCaller( &rCaller );
+		m_pAlgorithm->setModel( &m_aModel );
+		m_pAlgorithm->setSolveControl( &rControl );
+		m_pAlgorithm->solve();
+	}
+
+private:
+	auto_ptr<CellFuncObj> m_pCells;
+	MarshalledFuncObj m_aFuncObj;
+	nlp::Model m_aModel;
+	auto_ptr<nlp::BaseAlgorithm> m_pAlgorithm;
+};
+
 }
 
-class SolveModelImpl
+class SolveModelImpl : public SolveThreadListener
 {
 public:
 	SolveModelImpl( SolverImpl* p ) :
 		m_pSolverImpl(p),
-		m_bSolved(false)
+		m_bSolved(false),
+		m_eLpAlgorithm(OPTLPALGORITHM_SIMPLEX),
+		m_bLpInteger(false),
+		m_bCellUpdatesDisabled(false)
 	{
 	}
 
-	~SolveModelImpl() throw()
+	virtual ~SolveModelImpl() throw()
 	{
+		// Cancel a running solve, and stop its events.
+		m_pThread.reset();
+		if ( m_bCellUpdatesDisabled )
+			m_pSolverImpl->getCalcInterface()->enableCellUpdates();
 	}
 
 	/**
-	 * This is the gateway method that calls either solveLp() or
-	 * solveNlp() as appropriate based on the corresponding option
-	 * setting.
+	 * This is the gateway method that builds the LP or the NLP model as
+	 * appropriate based on the corresponding option setting, and starts
+	 * solving it on the solver thread.  The dialog stays responsive while
+	 * the model is solved, and pressing the solve button again stops it.
 	 */
 	void solve()
 	{
-        PrePostProcessSwitch prePostSwitch(m_pSolverImpl);
+		if ( m_pThread.get() && m_pThread->isRunning() )
+		{
+			m_pThread->cancel();
+			return;
+		}
+
+		auto_ptr<SolveJob> pJob;
 		OptModelType type = getSolverImpl()->getOptionData()->getModelType();
-		switch (type)
 		{
-		case OPTMODELTYPE_LP:
-			solveLp();
+			PrePostProcessSwitch prePostSwitch(m_pSolverImpl);
+			m_bSolved = false;
+			switch (type)
+			{
+			case OPTMODELTYPE_LP:
+				pJob = createLpJob();
+				break;
+			case OPTMODELTYPE_NLP:
+				pJob = createNlpJob();
+				break;
+			default:
+				break;
+			}
+		}
+		if ( !pJob.get() )
+			return;
+
+		if ( !m_pThread.get() )
+		{
+			auto_ptr<SolveThread> p( new SolveThread( m_pSolverImpl->getCalcInterface(), this ) );
+			m_pThread = p;
+		}
+
+		// The NLP algorithm evaluates the model through the cells, which
+		// are not repainted until it is done.
+		if ( type == OPTMODELTYPE_NLP )
+		{
+			m_pSolverImpl->getCalcInterface()->disableCellUpdates();
+			m_bCellUpdatesDisabled = true;
+		}
+		getSolverImpl()->getMainDialog()->setSolveRunning( true );
+		m_pThread->start( pJob );
+	}
+
+	virtual void progress( const SolveProgress& rProgress )
+	{
+		SolverDialog* pMainDlg = getSolverImpl()->getMainDialog();
+		ostringstream os;
+		os.precision( 8 );
+		if ( rProgress.Node > 0 )
+			os << " " << rProgress.Node;
+		else
+			os << " " << rProgress.Iteration;
+
+		rtl::OUStringBuffer sb;
+		sb.append( pMainDlg->getResStr( rProgress.Node > 0 ?
+			SCSOLVER_STR_PROGRESS_NODE : SCSOLVER_STR_PROGRESS_ITERATION ) );
+		sb.appendAscii( os.str().c_str() );
+		if ( rProgress.HasObjective )
+		{
+			os.str( "" );
+			os << " " << rProgress.Objective;
+			sb.appendAscii( "\n" );
+			sb.append( pMainDlg->getResStr( SCSOLVER_STR_PROGRESS_OBJECTIVE ) );
+			sb.appendAscii( os.str().c_str() );
+		}
+		if ( rProgress.HasGap )
+		{
+			os.str( "" );
+			os.precision( 3 );
+			os << " " << rProgress.Gap*100.0 << "%";
+			sb.appendAscii( "\n" );
+			sb.append( pMainDlg->getResStr( SCSOLVER_STR_PROGRESS_GAP ) );
+			sb.appendAscii( os.str().c_str() );
+		}
+		pMainDlg->showProgress( sb.makeStringAndClear() );
+	}
+
+	/**
+	 * Put the outcome of a solve into the document and report it.
+	 */
+	virtual void finished( auto_ptr<SolveJob> pJob )
+	{
+		ModelSolveJob* pModelJob = static_cast<ModelSolveJob*>( pJob.get() );
+		if ( LpSolveJob* pLpJob = dynamic_cast<LpSolveJob*>( pModelJob ) )
+		{
+			m_pLpAlgorithm = pLpJob->releaseAlgorithm();
+			// A failed or stopped solve leaves the stored basis as it is.
+			if ( pLpJob->isOptimal() )
+				saveBasis( pLpJob->getBasis() );
+		}
+
+		SolverDialog* pMainDlg = getSolverImpl()->getMainDialog();
+		pMainDlg->setSolveRunning( false );
+		{
+			PrePostProcessSwitch prePostSwitch(m_pSolverImpl);
+			pModelJob->finish( m_pSolverImpl );
+		}
+		if ( m_bCellUpdatesDisabled )
+		{
+			m_pSolverImpl->getCalcInterface()->enableCellUpdates();
+			m_bCellUpdatesDisabled = false;
+		}
+
+		m_bSolved = false;
+		switch ( pModelJob->getResult() )
+		{
+		case ModelSolveJob::RESULT_SOLVED:
+			m_bSolved = true;
+			pMainDlg->showSolutionFound();
+			break;
+		case ModelSolveJob::RESULT_INFEASIBLE:
+			pMainDlg->showSolutionInfeasible();
+			break;
+		case ModelSolveJob::RESULT_TIMED_OUT:
+			pMainDlg->showMessage(
+				getSolverImpl()->getResStr(SCSOLVER_STR_MSG_ITERATION_TIMED_OUT) );
+			break;
+		case ModelSolveJob::RESULT_MAX_ITERATION:
+			pMainDlg->showMessage(
+				getSolverImpl()->getResStr(SCSOLVER_STR_MSG_MAX_ITERATION_REACHED) );
 			break;
-		case OPTMODELTYPE_NLP:
-			solveNlp();
+		case ModelSolveJob::RESULT_CANCELLED:
+			pMainDlg->showMessage(
+				getSolverImpl()->getResStr(SCSOLVER_STR_MSG_SOLVE_CANCELLED) );
 			break;
-		default:
+		case ModelSolveJob::RESULT_RUNTIME_ERROR:
+			pMainDlg->showMessage( pModelJob->getMessage() );
+			break;
+		case ModelSolveJob::RESULT_STD_EXCEPTION:
+			pMainDlg->showMessage(
+				getSolverImpl()->getResStr(SCSOLVER_STR_MSG_STD_EXCEPTION_CAUGHT) );
 			break;
 		}
 	}
 
 	/**
 	 * This method takes model parameters from the dialog,
-	 * constructs an internal representation of an LP model, chooses
-	 * an algorithm, solves it, and in case a feasible solution is
-	 * found it puts the solution back into the cells.
+	 * constructs an internal representation of an LP model, and
+	 * chooses an algorithm for it.  The job puts the solution back
+	 * into the cells in case a feasible solution is found.
 	 */
-	void solveLp()
+	auto_ptr<SolveJob> createLpJob()
 	{
 		using namespace numeric;
 
+		auto_ptr<SolveJob> pJob;
 		SolverDialog* pMainDlg = getSolverImpl()->getMainDialog();
 		GoalType eGoal = pMainDlg->getGoal();
 		if ( eGoal == GOAL_UNKNOWN )
 		{
 			pMainDlg->showMessage( 
 				pMainDlg->getResStr(SCSOLVER_STR_MSG_GOAL_NOT_SET) );
-			return;
+			return pJob;
 		}
 
 		auto_ptr<LpModelBuilder> pBuilder( new LpModelBuilder );
@@ -263,51 +758,29 @@ public:
         aModel.print(); // prints model to stdout
 #endif
 		aModel.setPrecision( 2 );
-		auto_ptr<lp::BaseAlgorithm> algorithm = getLpAlgorithm();
-
 		aModel.setVerbose(true);
-		m_bSolved = false;
-		try
-		{
-			algorithm->setModel( &aModel );
-			algorithm->solve();
-			m_bSolved = true;
-			m_mxSolution = algorithm->getSolution();
-			updateCells( pBuilder.get() );
-			pMainDlg->showSolutionFound();
-		}
-		catch( const ModelInfeasible& e )
-		{
-			Debug( "model infeasible" );
-			pMainDlg->showSolutionInfeasible();
-		}
-		catch( const scsolver::RuntimeError& e )
-		{
-			// This error message is localizable.
-			pMainDlg->showMessage( e.getMessage() );
-		}
-		catch( const ::std::exception& e )
-		{
-			// standard exception.  should rarely happen.
-			pMainDlg->showMessage(
-				pMainDlg->getResStr(SCSOLVER_STR_MSG_STD_EXCEPTION_CAUGHT) );
-		}
+
+		bool bPresolve = eGoal == GOAL_MINIMIZE || eGoal == GOAL_MAXIMIZE;
+		auto_ptr<lp::BaseAlgorithm> algorithm = getLpAlgorithm();
+		pJob.reset( new LpSolveJob( pBuilder, aModel, algorithm, loadBasis(), bPresolve ) );
+		return pJob;
 	}
 
 	/**
-	 * Solve non-linear model.  Still work in progress.
+	 * Build the non-linear model.  Still work in progress.
 	 */
-	void solveNlp()
+	auto_ptr<SolveJob> createNlpJob()
 	{
 		using namespace numeric;
 
+		auto_ptr<SolveJob> pJob;
 		SolverDialog* pMainDlg = getSolverImpl()->getMainDialog();
 		GoalType eGoal = pMainDlg->getGoal();
 		if (eGoal == GOAL_UNKNOWN || eGoal == GOAL_TOVALUE)
 		{
 			pMainDlg->showMessage(
                 pMainDlg->getResStr(SCSOLVER_STR_MSG_GOAL_NOT_SET) );
-			return;
+			return pJob;
 		}
 
         auto_ptr<numeric::CellFuncObj> pFuncObj(
@@ -328,36 +801,8 @@ public:
         model.setGoal(eGoal);
         model.print();
 
-		auto_ptr<nlp::BaseAlgorithm> algorithm = getNlpAlgorithm();
-		m_bSolved = false;
-		try
-		{
-			algorithm->setModel(&model);
-			algorithm->solve();
-			m_bSolved = true;
-			pMainDlg->showSolutionFound();
-		}
-		catch ( const IterationTimedOut& )
-		{
-			pMainDlg->showMessage(
-				getSolverImpl()->getResStr(SCSOLVER_STR_MSG_ITERATION_TIMED_OUT) );
-		}
-		catch ( const MaxIterationReached& )
-		{
-			pMainDlg->showMessage(
-				getSolverImpl()->getResStr(SCSOLVER_STR_MSG_MAX_ITERATION_REACHED) );
-		}
-		catch ( const RuntimeError& e )
-		{
-			pMainDlg->showMessage( e.getMessage() );
-		}
-		catch ( const ::std::exception& e )
-		{
-			pMainDlg->showMessage(
-				getSolverImpl()->getResStr(SCSOLVER_STR_MSG_STD_EXCEPTION_CAUGHT) );
-
-            fprintf(stdout, "SolveModelImpl::solveNlp:   std exception msg = '%s'\n", e.what());
-		}
+		pJob.reset( new NlpSolveJob( pFuncObj, model, getNlpAlgorithm() ) );
+		return pJob;
 	}
 
 	bool isSolved() const
@@ -368,14 +813,53 @@ public:
 private:
 	SolverImpl* m_pSolverImpl;
 	bool m_bSolved;
-	Matrix m_mxSolution;
+
+	/** LP algorithm of the last solve, and the options it was made for.
+	    It is lent to the job while a solve runs. */
+	auto_ptr<lp::BaseAlgorithm> m_pLpAlgorithm;
+	OptLpAlgorithm m_eLpAlgorithm;
+	bool m_bLpInteger;
+
+	auto_ptr<SolveThread> m_pThread;
+	bool m_bCellUpdatesDisabled;
 	
 	SolverImpl* getSolverImpl() const
 	{ 
 		return m_pSolverImpl; 
 	}
 
-	auto_ptr<lp::BaseAlgorithm> getLpAlgorithm() const;
+	auto_ptr<lp::BaseAlgorithm> getLpAlgorithm();
+	auto_ptr<lp::BaseAlgorithm> createLpAlgorithm() const;
+
+	/**
+	 * Retrieve the basis of the last LP solve stored with the document, so
+	 * that the next solve can start from it.  Returns an empty basis if
+	 * the document has none.
+	 */
+	const lp::Basis loadBasis() const
+	{
+		CalcInterface* pCalc = m_pSolverImpl->getCalcInterface();
+		try
+		{
+			rtl::OUString sBasis;
+			pCalc->getDocumentProperty( Global::MODEL_BASIS_NAME ) >>= sBasis;
+			return stringToBasis( sBasis );
+		}
+		catch ( const uno::Exception& )
+		{
+		}
+		return lp::Basis();
+	}
+
+	void saveBasis( const lp::Basis& aBasis ) const
+	{
+		if ( aBasis.empty() )
+			return;
+
+		uno::Any aVal;
+		aVal <<= basisToString( aBasis );
+		m_pSolverImpl->getCalcInterface()->setDocumentProperty( Global::MODEL_BASIS_NAME, aVal );
+	}
 
 	auto_ptr<nlp::BaseAlgorithm> getNlpAlgorithm() const
 	{
@@ -559,30 +1043,115 @@ private:
 		}
 		return cn;
 	}
-
-	void updateCells( LpModelBuilder* pBuilder );
 };
 
 /**
- * This method returns an algorithm object to use to solve a
- * given LP model.  While all this method does currently is
- * simply return the pre-selected algorithm, in future this
- * method may be used to pick a user-selected algorithm based on
- * his/her settings.
- * 
+ * This method returns the algorithm object to use to solve a
+ * given LP model.  The same object is used for all solves of the
+ * document as long as the algorithm options stay the same, so
+ * that an engine which keeps state between solves, such as
+ * lp_solve, only has to take in what changed.  The job solving
+ * the model hands it back when it has finished.
+ *
  * @return auto_ptr<lp::BaseAlgorithm>
  */
-auto_ptr<lp::BaseAlgorithm> SolveModelImpl::getLpAlgorithm() const
+auto_ptr<lp::BaseAlgorithm> SolveModelImpl::getLpAlgorithm()
+{
+	const OptionData* pOption = getSolverImpl()->getOptionData();
+	if ( !m_pLpAlgorithm.get() || m_eLpAlgorithm != pOption->getLpAlgorithm() ||
+		 m_bLpInteger != pOption->getVarInteger() )
+	{
+		m_pLpAlgorithm = createLpAlgorithm();
+		m_eLpAlgorithm = pOption->getLpAlgorithm();
+		m_bLpInteger = pOption->getVarInteger();
+	}
+	return m_pLpAlgorithm;
+}
+
+/**
+ * @return auto_ptr<lp::BaseAlgorithm> engine pre-selected at build time.
+ */
+static auto_ptr<lp::BaseAlgorithm> lcl_createDefaultLpAlgorithm( CalcInterface* pCalc )
 {
 #ifdef ENABLE_SCSOLVER_UNO_ALGORITHM
-	auto_ptr<lp::BaseAlgorithm> algorithm( new lp::UnoAlgorithm(
-		ascii("org.openoffice.sc.solver.LpSolve"), getSolverImpl()->getCalcInterface() ) );
+	auto_ptr<lp::BaseAlgorithm> p( new lp::UnoAlgorithm(
+		ascii("org.openoffice.sc.solver.LpSolve"), pCalc ) );
 #else
-	//auto_ptr<lp::BaseAlgorithm> algorithm( new lp::RevisedSimplex );
-	auto_ptr<lp::BaseAlgorithm> algorithm( new lp::LpSolve );
+	auto_ptr<lp::LpSolve> pLpSolve( new lp::LpSolve );
+#if SCSOLVER_DEBUG
+	pLpSolve->setDumpModel( true );
 #endif
+	auto_ptr<lp::BaseAlgorithm> p( pLpSolve );
+#endif
+	return p;
+}
 
-	return algorithm;
+/**
+ * The simplex engine is pre-selected at build time; the in-tree
+ * engines, the interior point method for large sparse models and
+ * branch and bound for integer ones, are picked when the user
+ * selects them in the options.  The portfolio races the pre-selected
+ * engine against the in-tree ones.
+ * 
+ * @return auto_ptr<lp::BaseAlgorithm>
+ */
+auto_ptr<lp::BaseAlgorithm> SolveModelImpl::createLpAlgorithm() const
+{
+	const OptionData* pOption = getSolverImpl()->getOptionData();
+	auto_ptr<lp::BaseAlgorithm> algorithm;
+	if ( pOption->getLpAlgorithm() == OPTLPALGORITHM_PORTFOLIO )
+	{
+		auto_ptr<lp::Portfolio> pPortfolio( new lp::Portfolio );
+		pPortfolio->addAlgorithm( lcl_createDefaultLpAlgorithm( getSolverImpl()->getCalcInterface() ) );
+		if ( pOption->getVarInteger() )
+		{
+			// Each engine already has a thread of its own, so the in-tree
+			// search keeps to one.
+			auto_ptr<lp::AlgorithmFactory> pFactory( new lp::DefaultAlgorithmFactory<lp::DualSimplex> );
+			auto_ptr<lp::BaseAlgorithm> pSearch( new lp::BranchAndBound( pFactory ) );
+			pPortfolio->addAlgorithm( pSearch );
+		}
+		else
+		{
+			// The revised simplex is left out, as it reports a model with
+			// free variables as infeasible, which would decide the race.
+			auto_ptr<lp::BaseAlgorithm> pDual( new lp::DualSimplex );
+			pPortfolio->addAlgorithm( pDual );
+			auto_ptr<lp::BaseAlgorithm> pInterior( new lp::InteriorPoint );
+			pPortfolio->addAlgorithm( pInterior );
+		}
+		auto_ptr<lp::BaseAlgorithm> p( pPortfolio );
+		algorithm = p;
+	}
+	else if ( pOption->getLpAlgorithm() == OPTLPALGORITHM_BUILTIN && pOption->getVarInteger() )
+	{
+		// The interior point method cannot start from the basis of the
+		// parent node, so the in-tree integer search uses the dual simplex,
+		// with one instance per processor.  The deterministic search bounds
+		// its heuristics by work rather than time, so it gives the same
+		// cell values each time the model is solved.
+		auto_ptr<lp::AlgorithmFactory> pFactory( new lp::DefaultAlgorithmFactory<lp::DualSimplex> );
+		auto_ptr<lp::BranchAndBound> pSearch( new lp::BranchAndBound( pFactory ) );
+		pSearch->setThreadCount( 0 );
+		pSearch->setParallelMode( lp::PARALLEL_DETERMINISTIC );
+		auto_ptr<lp::BaseAlgorithm> p( pSearch );
+		algorithm = p;
+	}
+	else if ( pOption->getLpAlgorithm() == OPTLPALGORITHM_BUILTIN )
+	{
+		// Crossover makes the cell values a vertex, as with the simplex.
+		// It is skipped for models with more constraints than its row
+		// limit, whose dense basis would take too long to invert.
+		auto_ptr<lp::BaseAlgorithm> p( new lp::InteriorPoint );
+		algorithm = p;
+	}
+	else
+		algorithm = lcl_createDefaultLpAlgorithm( getSolverImpl()->getCalcInterface() );
+
+	// Coefficients taken from the cells often differ by orders of
+	// magnitude, so the model is always solved in scaled form.
+	auto_ptr<lp::BaseAlgorithm> scaled( new lp::ScaledAlgorithm( algorithm ) );
+	return scaled;
 }
 
 static bool lcl_isNumeric( const rtl::OUString& sVal )
@@ -705,17 +1274,6 @@ void SolveModelImpl::resolveConstraintAddress( LpModelBuilder* pBuilder )
 	}
 }
 
-void SolveModelImpl::updateCells( LpModelBuilder* pBuilder )
-{
-	vector<CellAddress> cnAddrs = pBuilder->getAllDecisionVarAddresses();
-	CalcInterface* pCalc = m_pSolverImpl->getCalcInterface();
-	OSL_ASSERT( m_mxSolution.rows() == cnAddrs.size() );
-	vector<CellAddress>::iterator it, itEnd = cnAddrs.end();
-	size_t nIdx = 0;
-	for ( it = cnAddrs.begin(); it != itEnd; ++it )
-		pCalc->setCellValue( *it, m_mxSolution( nIdx++, 0 ) );
-}
-
 //---------------------------------------------------------------------------
 // SolveModel
 
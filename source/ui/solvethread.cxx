@@ -0,0 +1,414 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "solvethread.hxx"
+#include "xcalc.hxx"
+#include "unoglobal.hxx"
+#include "numeric/solvecontrol.hxx"
+#include "numeric/exception.hxx"
+#include "tool/thread.hxx"
+#include "tool/timer.hxx"
+
+#include <cppuhelper/implbase1.hxx>
+#include <com/sun/star/awt/XCallback.hpp>
+#include <com/sun/star/awt/XRequestCallback.hpp>
+#include <com/sun/star/lang/XMultiComponentFactory.hpp>
+
+using namespace ::com::sun::star;
+using ::com::sun::star::uno::Reference;
+using ::com::sun::star::uno::UNO_QUERY;
+using ::scsolver::numeric::SolveControl;
+using ::scsolver::numeric::SolveProgress;
+using ::std::auto_ptr;
+
+namespace scsolver {
+
+namespace {
+
+/** minimum time between two progress events, in seconds. */
+const double PROGRESS_INTERVAL = 0.2;
+
+enum CallbackType
+{
+	CALLBACK_PROGRESS,
+	CALLBACK_CALL,
+	CALLBACK_FINISHED
+};
+
+}
+
+class SolveWorker;
+
+//---------------------------------------------------------------------------
+// SolveThreadImpl
+
+/**
+ * The state shared by the main thread and the worker.  It is reference
+ * counted, since the worker and the posted events keep it alive after the
+ * SolveThread has gone.  The mutex is never held while an event is
+ * posted, since posting takes the solar mutex, which the main thread
+ * holds whenever it runs.
+ */
+class SolveThreadImpl :
+	public ::cppu::WeakImplHelper1< awt::XCallback >,
+	public numeric::SolveProgressListener,
+	public MainThreadCaller
+{
+public:
+	SolveThreadImpl( CalcInterface* pCalc, SolveThreadListener* pListener );
+	virtual ~SolveThreadImpl() throw();
+
+	void start( auto_ptr<SolveJob> pJob );
+	bool isRunning() const { return m_bRunning; }
+	void cancel();
+	void dispose();
+	SolveControl& getSolveControl() { return m_aControl; }
+
+	/** Run the job; called on the worker thread. */
+	void runJob();
+
+	// XCallback
+	virtual void SAL_CALL notify( const uno::Any& aData )
+		throw ( uno::RuntimeException );
+
+	// SolveProgressListener
+	virtual void progress( const SolveProgress& rProgress );
+
+	// MainThreadCaller
+	virtual void call( MainThreadCall& rCall );
+
+private:
+	bool post( CallbackType eType );
+	void notifyProgress();
+	void notifyCall();
+	void notifyFinished();
+
+	Reference< awt::XRequestCallback > m_xRequestCallback;
+
+	/** only accessed on the main thread. */
+	SolveThreadListener* m_pListener;
+	bool m_bRunning;
+	auto_ptr<SolveWorker> m_pWorker;
+
+	/** whether the job runs on the worker, so that its calls to the main
+		thread are posted as events; set before the worker starts. */
+	bool m_bWorkerRunning;
+
+	/** owned by the worker while it runs. */
+	auto_ptr<SolveJob> m_pJob;
+	SolveControl m_aControl;
+
+	/** The members below are protected by the mutex. */
+	Mutex m_aMutex;
+	Condition m_aCondition;
+	bool m_bDisposed;
+
+	SolveProgress m_aProgress;
+	bool m_bProgressPosted;
+	Timer m_aProgressTimer;
+
+	MainThreadCall* m_pCall;
+	bool m_bCallDone;
+	bool m_bCallFailed;
+};
+
+/**
+ * Thread running the job.  It holds a reference to the shared state, which
+ * is given up when the thread is deleted after it has finished.
+ */
+class SolveWorker : public Thread
+{
+public:
+	explicit SolveWorker( SolveThreadImpl* pImpl ) : m_pImpl( pImpl ) {}
+	virtual ~SolveWorker() throw() {}
+
+protected:
+	virtual void run()
+	{
+		m_pImpl->runJob();
+	}
+
+private:
+	::rtl::Reference<SolveThreadImpl> m_pImpl;
+};
+
+SolveThreadImpl::SolveThreadImpl( CalcInterface* pCalc, SolveThreadListener* pListener ) :
+	m_pListener( pListener ),
+	m_bRunning( false ),
+	m_bWorkerRunning( false ),
+	m_bDisposed( false ),
+	m_bProgressPosted( false ),
+	m_aProgressTimer( PROGRESS_INTERVAL ),
+	m_pCall( NULL ),
+	m_bCallDone( false ),
+	m_bCallFailed( false )
+{
+	try
+	{
+		m_xRequestCallback.set( pCalc->getServiceManager()->createInstanceWithContext(
+			ascii( "com.sun.star.awt.AsyncCallback" ), pCalc->getComponentContext() ), UNO_QUERY );
+	}
+	catch ( const uno::Exception& )
+	{
+	}
+}
+
+SolveThreadImpl::~SolveThreadImpl() throw()
+{
+}
+
+void SolveThreadImpl::start( auto_ptr<SolveJob> pJob )
+{
+	OSL_ASSERT( !m_bRunning );
+	m_pJob = pJob;
+	m_aControl.start();
+	m_aControl.setProgressListener( this );
+	m_bRunning = true;
+	{
+		MutexGuard aGuard( m_aMutex );
+		m_bProgressPosted = false;
+		m_aProgressTimer.init();
+	}
+
+	if ( m_xRequestCallback.is() )
+	{
+		auto_ptr<SolveWorker> p( new SolveWorker( this ) );
+		m_pWorker = p;
+		m_bWorkerRunning = true;
+		if ( m_pWorker->start() )
+			return;
+		m_bWorkerRunning = false;
+		m_pWorker.reset();
+	}
+
+	// Run the job right here, with the calls made directly.
+	runJob();
+	notifyFinished();
+}
+
+void SolveThreadImpl::cancel()
+{
+	m_aControl.cancel();
+}
+
+/**
+ * Cut the link to the SolveThread, which is being destroyed.  A running
+ * job is cancelled, and a call it waits for fails.
+ */
+void SolveThreadImpl::dispose()
+{
+	m_pListener = NULL;
+	m_aControl.cancel();
+	MutexGuard aGuard( m_aMutex );
+	m_bDisposed = true;
+	m_aCondition.notifyAll();
+}
+
+void SolveThreadImpl::runJob()
+{
+	try
+	{
+		m_pJob->run( m_aControl, *this );
+	}
+	catch ( ... )
+	{
+	}
+
+	if ( m_bWorkerRunning )
+		post( CALLBACK_FINISHED );
+}
+
+/**
+ * @return bool false if the event could not be posted, which happens only
+ *         when the office is shutting down.
+ */
+bool SolveThreadImpl::post( CallbackType eType )
+{
+	uno::Any aData;
+	aData <<= static_cast<sal_Int32>( eType );
+	try
+	{
+		m_xRequestCallback->addCallback( this, aData );
+	}
+	catch ( const uno::Exception& )
+	{
+		return false;
+	}
+	return true;
+}
+
+void SolveThreadImpl::progress( const SolveProgress& rProgress )
+{
+	if ( !m_bWorkerRunning )
+		return;
+
+	{
+		MutexGuard aGuard( m_aMutex );
+		m_aProgress = rProgress;
+		if ( m_bProgressPosted || m_aProgressTimer.getElapsedTime() < PROGRESS_INTERVAL )
+			return;
+		m_bProgressPosted = true;
+	}
+	if ( !post( CALLBACK_PROGRESS ) )
+	{
+		MutexGuard aGuard( m_aMutex );
+		m_bProgressPosted = false;
+	}
+}
+
+void SolveThreadImpl::call( MainThreadCall& rCall )
+{
+	if ( !m_bWorkerRunning )
+	{
+		rCall.execute();
+		return;
+	}
+
+	{
+		MutexGuard aGuard( m_aMutex );
+		if ( m_bDisposed )
+			throw numeric::SolveCancelled();
+		m_pCall = &rCall;
+		m_bCallDone = false;
+		m_bCallFailed = false;
+	}
+	if ( !post( CALLBACK_CALL ) )
+		throw numeric::SolveCancelled();
+
+	MutexGuard aGuard( m_aMutex );
+	while ( !m_bCallDone && !m_bDisposed )
+		m_aCondition.wait( m_aMutex );
+	m_pCall = NULL;
+	if ( !m_bCallDone )
+		throw numeric::SolveCancelled();
+	if ( m_bCallFailed )
+		throw RuntimeError( ascii( "call on the main thread failed" ) );
+}
+
+void SAL_CALL SolveThreadImpl::notify( const uno::Any& aData )
+	throw ( uno::RuntimeException )
+{
+	// Keep this object alive, as the end of the worker may release the
+	// last reference.
+	::rtl::Reference<SolveThreadImpl> xSelf( this );
+
+	sal_Int32 nType = CALLBACK_PROGRESS;
+	aData >>= nType;
+	switch ( nType )
+	{
+	case CALLBACK_PROGRESS:
+		notifyProgress();
+		break;
+	case CALLBACK_CALL:
+		notifyCall();
+		break;
+	case CALLBACK_FINISHED:
+		notifyFinished();
+		break;
+	}
+}
+
+void SolveThreadImpl::notifyProgress()
+{
+	SolveProgress aProgress;
+	{
+		MutexGuard aGuard( m_aMutex );
+		aProgress = m_aProgress;
+		m_bProgressPosted = false;
+		m_aProgressTimer.init();
+	}
+	if ( m_bRunning && m_pListener )
+		m_pListener->progress( aProgress );
+}
+
+void SolveThreadImpl::notifyCall()
+{
+	MainThreadCall* pCall = NULL;
+	{
+		MutexGuard aGuard( m_aMutex );
+		if ( m_bDisposed )
+			return;
+		pCall = m_pCall;
+	}
+
+	bool bFailed = false;
+	try
+	{
+		pCall->execute();
+	}
+	catch ( ... )
+	{
+		bFailed = true;
+	}
+
+	MutexGuard aGuard( m_aMutex );
+	m_bCallDone = true;
+	m_bCallFailed = bFailed;
+	m_aCondition.notifyAll();
+}
+
+void SolveThreadImpl::notifyFinished()
+{
+	// The worker has posted this as its last action, so it ends shortly.
+	if ( m_pWorker.get() )
+	{
+		m_pWorker->join();
+		m_pWorker.reset();
+	}
+	m_bWorkerRunning = false;
+
+	m_bRunning = false;
+	m_aControl.setProgressListener( NULL );
+	auto_ptr<SolveJob> pJob( m_pJob );
+	if ( m_pListener )
+		m_pListener->finished( pJob );
+}
+
+//---------------------------------------------------------------------------
+// SolveThread
+
+SolveThread::SolveThread( CalcInterface* pCalc, SolveThreadListener* pListener ) :
+	m_pImpl( new SolveThreadImpl( pCalc, pListener ) )
+{
+}
+
+SolveThread::~SolveThread() throw()
+{
+	m_pImpl->dispose();
+}
+
+void SolveThread::start( auto_ptr<SolveJob> pJob )
+{
+	m_pImpl->start( pJob );
+}
+
+bool SolveThread::isRunning() const
+{
+	return m_pImpl->isRunning();
+}
+
+void SolveThread::cancel()
+{
+	m_pImpl->cancel();
+}
+
+SolveControl& SolveThread::getSolveControl() const
+{
+	return m_pImpl->getSolveControl();
+}
+
+}
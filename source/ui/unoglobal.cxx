@@ -72,6 +72,7 @@ void split( const rtl::OUString& sStr, const rtl::OUString& sSep,
 
 const rtl::OUString Global::STRING_SEPARATOR = ascii( "," );
 const rtl::OUString Global::MODEL_METADATA_NAME = ascii( "us.kohei.ooo.solver:model" );
+const rtl::OUString Global::MODEL_BASIS_NAME = ascii( "us.kohei.ooo.solver:basis" );
 
 RuntimeError::RuntimeError( const rtl::OUString& umsg ) :
 	m_sUniMsg( umsg )
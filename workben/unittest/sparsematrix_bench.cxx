@@ -0,0 +1,136 @@
+/****************************************************************************
+ * Copyright (c) 2005-2009 Kohei Yoshida
+ *
+ * This code is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3 only,
+ * as published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License version 3 for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with this work.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+// Compare the sparse matrix operations against their dense counterparts.
+// Build with 'make bench'.
+
+#include "numeric/sparsematrix.hxx"
+#include "numeric/matrix.hxx"
+
+#include <vector>
+#include <ctime>
+#include <stdio.h>
+
+using namespace ::scsolver::numeric;
+using ::std::vector;
+
+namespace {
+
+double nextValue(unsigned long& seed)
+{
+    seed = (seed*1103515245UL + 12345UL) & 0x7fffffffUL;
+    return static_cast<double>(seed) / 0x3fffffff - 1.0;
+}
+
+double elapsed(clock_t start)
+{
+    return static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+}
+
+void build(size_t n, size_t nPerCol, SparseMatrix& sparse, Matrix& dense)
+{
+    unsigned long seed = 1;
+    sparse.clear(n, n);
+    dense.resize(n, n);
+    for (size_t j = 0; j < n; ++j)
+    {
+        double val = 4.0 + nextValue(seed);
+        sparse.insert(j, j, val);
+        dense(j, j) += val;
+        for (size_t k = 0; k < nPerCol; ++k)
+        {
+            size_t i = static_cast<size_t>((nextValue(seed) + 1.0)*0.5*n) % n;
+            val = nextValue(seed);
+            sparse.insert(i, j, val);
+            dense(i, j) += val;
+        }
+    }
+}
+
+void benchMultiply(size_t n, size_t nRepeat)
+{
+    SparseMatrix sparse;
+    Matrix dense;
+    build(n, 4, sparse, dense);
+
+    vector<double> x(n, 1.0), y;
+    Matrix mxX(n, 1);
+    for (size_t i = 0; i < n; ++i)
+        mxX(i, 0) = 1.0;
+
+    clock_t start = clock();
+    for (size_t r = 0; r < nRepeat; ++r)
+        sparse.multiply(x, y);
+    double fCsc = elapsed(start);
+
+    sparse.setRowMirror(true);
+    sparse.multiply(x, y);
+    start = clock();
+    for (size_t r = 0; r < nRepeat; ++r)
+        sparse.multiply(x, y);
+    double fCsr = elapsed(start);
+
+    start = clock();
+    for (size_t r = 0; r < nRepeat; ++r)
+        sparse.multiplyTrans(x, y);
+    double fTrans = elapsed(start);
+
+    start = clock();
+    for (size_t r = 0; r < nRepeat; ++r)
+        Matrix mxY = dense * mxX;
+    double fDense = elapsed(start);
+
+    printf("A x, n = %d, nnz = %d, %d times\n", n, sparse.nonZeros(), nRepeat);
+    printf("  sparse (CSC)  : %.3f s\n", fCsc);
+    printf("  sparse (CSR)  : %.3f s\n", fCsr);
+    printf("  sparse (A^T x): %.3f s\n", fTrans);
+    printf("  dense         : %.3f s\n", fDense);
+}
+
+void benchSolve(size_t n)
+{
+    SparseMatrix sparse;
+    Matrix dense;
+    build(n, 4, sparse, dense);
+
+    vector<double> b(n, 1.0);
+    Matrix mxB(n, 1);
+    for (size_t i = 0; i < n; ++i)
+        mxB(i, 0) = 1.0;
+
+    clock_t start = clock();
+    SparseLU lu(sparse);
+    lu.solve(b);
+    double fSparse = elapsed(start);
+
+    start = clock();
+    Matrix mxX = dense.inverse() * mxB;
+    double fDense = elapsed(start);
+
+    printf("A x = b, n = %d, nnz(A) = %d, nnz(L+U) = %d\n", n, sparse.nonZeros(), lu.nonZeros());
+    printf("  sparse LU     : %.3f s\n", fSparse);
+    printf("  dense inverse : %.3f s\n", fDense);
+}
+
+}
+
+int main()
+{
+    benchMultiply(1000, 50);
+    benchSolve(100);
+    benchSolve(200);
+}